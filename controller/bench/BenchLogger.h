@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+
+#include "logging/Logger.h"
+#include "logging/SpdlogLogger.h"
+
+namespace creatures::bench {
+
+/**
+ * A real logger, turned down to warnings, shared by every benchmark
+ *
+ * It's the real thing rather than a mock so that the "is this level on?"
+ * checks cost what they cost in production.
+ */
+inline std::shared_ptr<Logger> benchLogger() {
+    static std::shared_ptr<Logger> logger = [] {
+        auto l = std::make_shared<SpdlogLogger>();
+        l->init("bench");
+        l->setLevel("warn");
+        return std::shared_ptr<Logger>(l);
+    }();
+    return logger;
+}
+
+} // namespace creatures::bench
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "audio/RtcpPacket.h"
+#include "audio/RtcpTiming.h"
+#include "audio/RtpPacket.h"
+#include "audio/audio-config.h"
+
+using namespace creatures::audio;
+using namespace std::chrono_literals;
+
+/*
+ * Everything that happens to an audio packet on its way in, short of actually
+ * decoding the Opus in it
+ */
+
+namespace {
+
+constexpr int64_t NtpUnixEpochOffsetSeconds = 2'208'988'800LL;
+
+void appendU16(std::vector<uint8_t> &packet, uint16_t value) {
+    packet.push_back(static_cast<uint8_t>(value >> 8U));
+    packet.push_back(static_cast<uint8_t>(value));
+}
+
+void appendU32(std::vector<uint8_t> &packet, uint32_t value) {
+    packet.push_back(static_cast<uint8_t>(value >> 24U));
+    packet.push_back(static_cast<uint8_t>(value >> 16U));
+    packet.push_back(static_cast<uint8_t>(value >> 8U));
+    packet.push_back(static_cast<uint8_t>(value));
+}
+
+std::vector<uint8_t> makeRtpPacket(size_t payloadBytes) {
+    std::vector<uint8_t> packet{0x80, RTP_OPUS_PAYLOAD_TYPE};
+    appendU16(packet, 4242);
+    appendU32(packet, 960U * 4242U);
+    appendU32(packet, 0x0102'0304U);
+    packet.resize(packet.size() + payloadBytes, 0x5a);
+    return packet;
+}
+
+// A sender report and a CNAME, just like the server sends every few seconds
+std::vector<uint8_t> makeSenderReport() {
+    const std::string canonicalName = "creature-server@warren";
+
+    std::vector<uint8_t> packet{0x80, 200, 0x00, 0x06};
+    appendU32(packet, 0x0102'0304U);
+    appendU32(packet, static_cast<uint32_t>(1'700'000'000LL + NtpUnixEpochOffsetSeconds));
+    appendU32(packet, 0x8000'0000U);
+    appendU32(packet, 960U * 4242U);
+    appendU32(packet, 4242U);
+    appendU32(packet, 4242U * 160U);
+
+    const size_t sdesStart = packet.size();
+    packet.push_back(0x81);
+    packet.push_back(202);
+    appendU16(packet, 0);
+    appendU32(packet, 0x0102'0304U);
+    packet.push_back(1);
+    packet.push_back(static_cast<uint8_t>(canonicalName.size()));
+    packet.insert(packet.end(), canonicalName.begin(), canonicalName.end());
+    packet.push_back(0);
+    while ((packet.size() - sdesStart) % sizeof(uint32_t) != 0) {
+        packet.push_back(0);
+    }
+    const size_t sdesWords = (packet.size() - sdesStart) / sizeof(uint32_t);
+    packet[sdesStart + 2] = static_cast<uint8_t>((sdesWords - 1U) >> 8U);
+    packet[sdesStart + 3] = static_cast<uint8_t>(sdesWords - 1U);
+    return packet;
+}
+
+RtcpSenderReport makeReport() {
+    return {
+        .synchronizationSource = 0x0102'0304U,
+        .ntpTimestamp = static_cast<uint64_t>(1'700'000'000LL + NtpUnixEpochOffsetSeconds) << 32U,
+        .rtpTimestamp = 960U * 4242U,
+        .packetCount = 4242,
+        .octetCount = 4242U * 160U,
+        .canonicalName = "creature-server@warren",
+    };
+}
+
+void BM_ParseOpusRtpPacket(benchmark::State &state) {
+    const auto packet = makeRtpPacket(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseOpusRtpPacket(packet));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(packet.size()));
+}
+
+void BM_ParseRtcpSenderReport(benchmark::State &state) {
+    const auto packet = makeSenderReport();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parseRtcpSenderReport(packet));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_RtpSystemTime(benchmark::State &state) {
+    const auto report = makeReport();
+    uint32_t rtpTimestamp = report.rtpTimestamp;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rtpSystemTime(report, rtpTimestamp));
+        rtpTimestamp += FRAMES_PER_CHUNK;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// What the audio thread does for every frame it's about to queue up
+void BM_RtcpPlanAndClassify(benchmark::State &state) {
+    const auto report = makeReport();
+    const RtcpPlayoutPlanner planner(RtcpClockPair::capture(), 20ms, 3ms);
+    uint32_t rtpTimestamp = report.rtpTimestamp;
+
+    for (auto _ : state) {
+        const auto plan = planner.plan(report, rtpTimestamp, FRAMES_PER_CHUNK * 2);
+        if (plan.has_value()) {
+            benchmark::DoNotOptimize(classifyRtcpEnqueue(*plan, RtcpSteadyClock::now(), 2ms));
+        }
+        rtpTimestamp += FRAMES_PER_CHUNK;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_RtcpReportCache_StoreFind(benchmark::State &state) {
+    RtcpReportCache cache(8);
+    auto report = makeReport();
+    const auto receivedAt = RtcpSteadyClock::now();
+
+    for (auto _ : state) {
+        report.packetCount++;
+        benchmark::DoNotOptimize(cache.store(report, receivedAt));
+        benchmark::DoNotOptimize(cache.find(report.synchronizationSource));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ParseOpusRtpPacket)->Arg(40)->Arg(160)->Arg(1200);
+BENCHMARK(BM_ParseRtcpSenderReport);
+BENCHMARK(BM_RtpSystemTime);
+BENCHMARK(BM_RtcpPlanAndClassify);
+BENCHMARK(BM_RtcpReportCache_StoreFind);
@@ -0,0 +1,79 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchLogger.h"
+#include "config/UARTDevice.h"
+#include "controller/commands/PositionFrameEncoder.h"
+#include "controller/commands/SetServoPositions.h"
+#include "controller/commands/tokens/ServoPosition.h"
+#include "creature/MotorType.h"
+#include "device/Servo.h"
+#include "device/ServoSpecifier.h"
+#include "device/ServoTable.h"
+
+using creatures::bench::benchLogger;
+using creatures::config::UARTDevice;
+
+/*
+ * Building the POS line for one module, the old way and the way the control
+ * loop does it now. The argument is how many servos are on the module.
+ */
+
+namespace {
+
+std::vector<std::shared_ptr<Servo>> makeServos(size_t count) {
+    std::vector<std::shared_ptr<Servo>> servos;
+    for (size_t i = 0; i < count; i++) {
+        auto location = ServoSpecifier(UARTDevice::A, static_cast<u16>(i), creatures::creature::motor_type::servo);
+        servos.push_back(std::make_shared<Servo>(benchLogger(), "servo" + std::to_string(i), "Bench Servo", location,
+                                                 1000, 3000, 0.0, false, 50, static_cast<u16>(1500 + i)));
+    }
+    return servos;
+}
+
+void BM_SetServoPositions_ToMessageWithChecksum(benchmark::State &state) {
+    const auto servos = makeServos(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto command = creatures::commands::SetServoPositions(benchLogger());
+        for (const auto &servo : servos) {
+            command.addServoPosition(
+                creatures::ServoPosition(servo->getOutputLocation(), servo->getCurrentMicroseconds()));
+        }
+        benchmark::DoNotOptimize(command.toMessageWithChecksum());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_PositionFrameEncoder_Encode(benchmark::State &state) {
+    creatures::device::ServoTable table;
+    table.rebuild(makeServos(static_cast<size_t>(state.range(0))));
+    auto encoder = creatures::commands::PositionFrameEncoder(benchLogger(), UARTDevice::A, table);
+
+    for (auto _ : state) {
+        encoder.selectServos(0, true);
+        benchmark::DoNotOptimize(encoder.encode());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_PositionFrameEncoder_EncodeBinary(benchmark::State &state) {
+    creatures::device::ServoTable table;
+    table.rebuild(makeServos(static_cast<size_t>(state.range(0))));
+    auto encoder = creatures::commands::PositionFrameEncoder(benchLogger(), UARTDevice::A, table);
+
+    for (auto _ : state) {
+        encoder.selectServos(0, true);
+        benchmark::DoNotOptimize(encoder.encodeBinary());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_SetServoPositions_ToMessageWithChecksum)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(BM_PositionFrameEncoder_Encode)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(BM_PositionFrameEncoder_EncodeBinary)->Arg(4)->Arg(8)->Arg(16);
@@ -0,0 +1,43 @@
+#include <cstdint>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchLogger.h"
+#include "config/UARTDevice.h"
+#include "controller-config.h"
+#include "creature/MotorType.h"
+#include "device/Servo.h"
+#include "device/ServoSpecifier.h"
+
+using creatures::bench::benchLogger;
+
+/*
+ * One servo's smoothing step, which the creature does for every servo on
+ * every frame. It's sent from one end to the other once a second (at 50Hz)
+ * so it's always got somewhere to go.
+ */
+
+namespace {
+
+void BM_Servo_CalculateNextTick(benchmark::State &state) {
+    const auto type = static_cast<creatures::creature::motor_type>(state.range(0));
+    auto location = ServoSpecifier(creatures::config::UARTDevice::A, 0, type);
+    Servo servo(benchLogger(), "bench", "Bench Servo", location, 1000, 3000, 0.90, false, 50, 1500);
+
+    u64 tick = 0;
+    for (auto _ : state) {
+        if (tick++ % 50 == 0) {
+            servo.move((tick / 50) % 2 == 0 ? MIN_POSITION : MAX_POSITION);
+        }
+        servo.calculateNextTick();
+        benchmark::DoNotOptimize(servo.getCurrentMicroseconds());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_Servo_CalculateNextTick)
+    ->Arg(static_cast<int>(creatures::creature::motor_type::servo))
+    ->Arg(static_cast<int>(creatures::creature::motor_type::dynamixel));
@@ -0,0 +1,91 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchLogger.h"
+#include "config/UARTDevice.h"
+#include "controller/Controller.h"
+#include "controller/MotionLatency.h"
+#include "creature/Parrot.h"
+#include "dmx/E131Client.h"
+#include "io/MessageRouter.h"
+
+#include "e131.h"
+
+using creatures::bench::benchLogger;
+
+/*
+ * The path every E1.31 packet takes once it's off the socket: pick the newest
+ * one out of the batch, then copy its slots over to the controller
+ */
+
+namespace {
+
+constexpr u16 Universe = 42;
+
+e131_packet_t makePacket(u16 universe, u8 sequence, u8 value) {
+    e131_packet_t packet;
+    e131_pkt_init(&packet, universe, 16);
+    packet.frame.seq_number = sequence;
+    for (u16 slot = 1; slot < 16; slot++) {
+        packet.dmp.prop_val[slot] = static_cast<u8>(value + slot);
+    }
+    return packet;
+}
+
+std::shared_ptr<Parrot> makeParrot() {
+    auto parrot = std::make_shared<Parrot>(benchLogger());
+    parrot->setName("doug");
+
+    const std::vector<std::string> inputNames = {"head_height", "head_tilt", "neck_rotate", "body_lean",
+                                                 "beak",        "chest",     "stand_rotate"};
+    for (size_t i = 0; i < inputNames.size(); i++) {
+        parrot->addInput(creatures::Input(inputNames[i], static_cast<u16>(i + 1), 1, 0));
+    }
+    return parrot;
+}
+
+void BM_E131Client_HandlePacket(benchmark::State &state) {
+    auto logger = benchLogger();
+    auto parrot = makeParrot();
+    auto controller =
+        std::make_shared<Controller>(logger, parrot, std::make_shared<creatures::io::MessageRouter>(logger));
+
+    creatures::dmx::E131Client client(logger);
+    client.init(parrot, controller, Universe, "lo", 0, "127.0.0.1");
+
+    const auto packet = makePacket(Universe, 1, 100);
+    for (auto _ : state) {
+        client.handlePacket(packet, creatures::MotionLatency::now());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// A batch off recvmmsg(): picking the newest good packet out of it
+void BM_E131Client_NewestPacket(benchmark::State &state) {
+    auto logger = benchLogger();
+    const auto batchSize = static_cast<size_t>(state.range(0));
+
+    std::vector<e131_packet_t> packets;
+    for (size_t i = 0; i < batchSize; i++) {
+        packets.push_back(makePacket(Universe, static_cast<u8>(i), static_cast<u8>(i)));
+    }
+    const std::vector<u32> lengths(batchSize, sizeof(e131_packet_t));
+
+    u8 lastSequence = 0;
+    u64 skipped = 0;
+    for (auto _ : state) {
+        // Start each batch just before its first packet so none look stale
+        lastSequence = static_cast<u8>(packets.front().frame.seq_number - 1);
+        benchmark::DoNotOptimize(creatures::dmx::E131Client::newestPacket(
+            logger, packets.data(), lengths.data(), packets.size(), Universe, lastSequence, skipped));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(batchSize));
+}
+
+} // namespace
+
+BENCHMARK(BM_E131Client_HandlePacket);
+BENCHMARK(BM_E131Client_NewestPacket)->Arg(1)->Arg(8)->Arg(32);
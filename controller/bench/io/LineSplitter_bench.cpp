@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "io/LineSplitter.h"
+
+using creatures::io::LineSplitter;
+
+/*
+ * Splitting up what the firmware sends. A read usually brings in a line or
+ * two, but right after a STATS interval it's a whole pile of them at once.
+ */
+
+namespace {
+
+std::string burstOf(int lines) {
+    std::string burst;
+    for (int i = 0; i < lines; i++) {
+        burst += "DSENSE\tD1 96 128 7400 2048 1\tD2 95 -50 7350 1024 1\tD3 97 12 7390 3000 1\r\n";
+    }
+    return burst;
+}
+
+void BM_LineSplitter_Burst(benchmark::State &state) {
+    const std::string burst = burstOf(static_cast<int>(state.range(0)));
+    LineSplitter splitter;
+
+    size_t lines = 0;
+    for (auto _ : state) {
+        std::string_view remaining = burst;
+        while (!remaining.empty()) {
+            auto space = splitter.writable();
+            const size_t chunk = std::min(space.size(), remaining.size());
+            std::memcpy(space.data(), remaining.data(), chunk);
+            lines += splitter.commit(chunk, [](std::string_view line) { benchmark::DoNotOptimize(line.data()); });
+            remaining.remove_prefix(chunk);
+        }
+    }
+    benchmark::DoNotOptimize(lines);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(burst.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_LineSplitter_Burst)->Arg(1)->Arg(16)->Arg(64);
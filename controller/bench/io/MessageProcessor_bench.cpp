@@ -0,0 +1,83 @@
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchLogger.h"
+#include "config/UARTDevice.h"
+#include "controller/Controller.h"
+#include "controller/ServoModuleHandler.h"
+#include "creature/Parrot.h"
+#include "io/Message.h"
+#include "io/MessageProcessor.h"
+#include "io/MessageRouter.h"
+#include "server/ServerMessage.h"
+#include "util/MessageQueue.h"
+
+using creatures::bench::benchLogger;
+using creatures::config::UARTDevice;
+using creatures::io::Message;
+
+/*
+ * Handling the lines the firmware sends us the most of: its STATS report and
+ * the Dynamixel sensor report
+ */
+
+namespace {
+
+// What a HW4 board actually sends, give or take the numbers
+const std::string StatsLine = "STATS\tHEAP_FREE 182344\tUSB_CRECV 0\tUSB_MRECV 0\tUSB_SENT 0\tUART_CRECV 9381223\t"
+                              "UART_MRECV 120331\tUART_SENT 4021\tMP_RECV 120331\tMP_SENT 4021\tS_PARSE 120329\t"
+                              "F_PARSE 2\tCHKFAIL 0\tOUT_DROP 0\tIN_DROP 0\tPOS_PROC 118234\tPWM_WRAPS 5912233\t"
+                              "TEMP 98.4\tDXL_TX 40112\tDXL_RX 40108\tDXL_ERR 0\tDXL_CRC 0\tDXL_TO 4";
+
+const std::string DynamixelLine = "DSENSE\tD1 96 128 7400 2048 1\tD2 95 -50 7350 1024 1\tD3 97 12 7390 3000 1\t"
+                                  "D4 96 -230 7380 1900 1";
+
+class ProcessorFixture {
+  public:
+    ProcessorFixture() {
+        auto logger = benchLogger();
+        messageRouter = std::make_shared<creatures::io::MessageRouter>(logger);
+        creature = std::make_shared<Parrot>(logger);
+        controller = std::make_shared<Controller>(logger, creature, messageRouter);
+        websocketQueue = std::make_shared<creatures::MessageQueue<creatures::server::ServerMessage>>();
+        servoModuleHandler = std::make_shared<creatures::ServoModuleHandler>(
+            logger, controller, UARTDevice::A, "/dev/null", messageRouter, websocketQueue);
+        processor = std::make_shared<creatures::MessageProcessor>(logger, UARTDevice::A, servoModuleHandler,
+                                                                  websocketQueue);
+    }
+
+    std::shared_ptr<creatures::io::MessageRouter> messageRouter;
+    std::shared_ptr<Parrot> creature;
+    std::shared_ptr<Controller> controller;
+    std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> websocketQueue;
+    std::shared_ptr<creatures::ServoModuleHandler> servoModuleHandler;
+    std::shared_ptr<creatures::MessageProcessor> processor;
+};
+
+void processLine(benchmark::State &state, const std::string &line) {
+    ProcessorFixture fixture;
+    const Message message(UARTDevice::A, line);
+
+    u64 processed = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.processor->processMessage(message));
+
+        // Sensor reports pile up for the server, and nobody's sending them
+        if (++processed % 1024 == 0) {
+            fixture.websocketQueue->clear();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(line.size()));
+}
+
+void BM_MessageProcessor_Stats(benchmark::State &state) { processLine(state, StatsLine); }
+
+void BM_MessageProcessor_DynamixelSensors(benchmark::State &state) { processLine(state, DynamixelLine); }
+
+} // namespace
+
+BENCHMARK(BM_MessageProcessor_Stats);
+BENCHMARK(BM_MessageProcessor_DynamixelSensors);
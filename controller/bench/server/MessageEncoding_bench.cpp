@@ -0,0 +1,92 @@
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "BenchLogger.h"
+#include "server/DynamixelSensorReportMessage.h"
+#include "server/MessageEncoding.h"
+#include "server/MotorSensorReportMessage.h"
+
+using creatures::bench::benchLogger;
+using creatures::server::DynamixelSensorReportMessage;
+using creatures::server::MessageEncoding;
+using creatures::server::MotorSensorReportMessage;
+using creatures::server::ServerMessage;
+
+/*
+ * How long it takes to turn a sensor report into websocket bytes, and how many
+ * bytes it turns into, for each encoding. The payloads look like what the
+ * sensor handlers build from a real DSENSE / MSENSE line.
+ */
+
+namespace {
+
+// Eight Dynamixels, all online, all reporting position
+json dynamixelPayload() {
+    json payload;
+    for (int i = 0; i < 8; i++) {
+        payload["dynamixel_motors"].push_back({{"dxl_id", i + 1},
+                                               {"temperature_f", 98.6 + i},
+                                               {"present_load", -120 + (i * 37)},
+                                               {"voltage_mv", 7400 - i},
+                                               {"voltage_v", 7.4 - (i * 0.001)},
+                                               {"online", true},
+                                               {"present_position", 2048 + (i * 11)}});
+    }
+    return payload;
+}
+
+// A full MSENSE line's worth of PWM servos
+json motorPayload() {
+    json payload;
+    for (int i = 0; i < 8; i++) {
+        payload["motors"].push_back({{"number", i},
+                                     {"position", 1500 + (i * 25)},
+                                     {"voltage", 5.02 + (i * 0.01)},
+                                     {"current", 0.12 + (i * 0.03)},
+                                     {"power", 0.6 + (i * 0.15)}});
+    }
+    return payload;
+}
+
+void encodeReport(benchmark::State &state, const ServerMessage &message, MessageEncoding encoding) {
+    const std::string creatureId = "0fb2a2a6-7f42-4c31-b2b4-98b6d1c4e8a0";
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        auto result = message.toWebSocketMessage(creatureId, encoding);
+        bytes = result.getValue().value().size();
+        benchmark::DoNotOptimize(bytes);
+    }
+
+    state.counters["bytes_per_report"] = static_cast<double>(bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes));
+}
+
+void BM_EncodeDynamixelReport(benchmark::State &state) {
+    const DynamixelSensorReportMessage message(benchLogger(), dynamixelPayload(), "A");
+    encodeReport(state, message, static_cast<MessageEncoding>(state.range(0)));
+    state.SetLabel(creatures::server::messageEncodingToString(static_cast<MessageEncoding>(state.range(0))));
+}
+
+void BM_EncodeMotorReport(benchmark::State &state) {
+    const MotorSensorReportMessage message(benchLogger(), motorPayload(), "A");
+    encodeReport(state, message, static_cast<MessageEncoding>(state.range(0)));
+    state.SetLabel(creatures::server::messageEncodingToString(static_cast<MessageEncoding>(state.range(0))));
+}
+
+} // namespace
+
+BENCHMARK(BM_EncodeDynamixelReport)
+    ->Arg(static_cast<int>(MessageEncoding::json))
+    ->Arg(static_cast<int>(MessageEncoding::cbor))
+    ->Arg(static_cast<int>(MessageEncoding::msgpack));
+
+BENCHMARK(BM_EncodeMotorReport)
+    ->Arg(static_cast<int>(MessageEncoding::json))
+    ->Arg(static_cast<int>(MessageEncoding::cbor))
+    ->Arg(static_cast<int>(MessageEncoding::msgpack));
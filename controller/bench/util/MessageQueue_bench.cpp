@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "config/UARTDevice.h"
+#include "io/Message.h"
+#include "util/MessageQueue.h"
+#include "util/SpscQueue.h"
+
+using creatures::MessageQueue;
+using creatures::SpscQueue;
+using creatures::config::UARTDevice;
+using creatures::io::Message;
+
+/*
+ * What it costs to get a message from one thread to another. The SpscQueue
+ * runs are here so the two can be compared; it's what sits between each
+ * module and its serial port.
+ */
+
+namespace {
+
+constexpr size_t MaxWaiting = 512;
+
+// About what a POS frame for a full module looks like
+Message sampleMessage() {
+    return Message(UARTDevice::A,
+                   "POS\tA0 1500\tA1 1500\tA2 1500\tA3 1500\tA4 1500\tA5 1500\tA6 1500\tA7 1500\tCS 8123");
+}
+
+void BM_MessageQueue_PushPop(benchmark::State &state) {
+    MessageQueue<Message> queue;
+    const Message message = sampleMessage();
+
+    for (auto _ : state) {
+        queue.push(message);
+        benchmark::DoNotOptimize(queue.pop_timeout(std::chrono::milliseconds(1)));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_SpscQueue_PushPop(benchmark::State &state) {
+    SpscQueue<Message> queue(1024);
+    const Message message = sampleMessage();
+
+    for (auto _ : state) {
+        queue.push(message);
+        benchmark::DoNotOptimize(queue.try_pop());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/*
+ * One thread pushes, the benchmark thread pops. Each iteration is one message
+ * making it all the way across. The producer backs off once a few hundred are
+ * waiting, since a MessageQueue would otherwise grow until we ran out of RAM.
+ */
+template <typename Queue> void producerConsumer(benchmark::State &state, Queue &queue) {
+    const Message message = sampleMessage();
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            if (queue.size() >= MaxWaiting) {
+                std::this_thread::yield();
+                continue;
+            }
+            queue.push(message);
+        }
+    });
+
+    for (auto _ : state) {
+        auto received = queue.pop_timeout(std::chrono::milliseconds(100));
+        benchmark::DoNotOptimize(received);
+    }
+
+    done.store(true);
+    producer.join();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_MessageQueue_ProducerConsumer(benchmark::State &state) {
+    MessageQueue<Message> queue;
+    producerConsumer(state, queue);
+}
+
+void BM_SpscQueue_ProducerConsumer(benchmark::State &state) {
+    SpscQueue<Message> queue(1024);
+    producerConsumer(state, queue);
+}
+
+} // namespace
+
+BENCHMARK(BM_MessageQueue_PushPop);
+BENCHMARK(BM_SpscQueue_PushPop);
+BENCHMARK(BM_MessageQueue_ProducerConsumer)->UseRealTime();
+BENCHMARK(BM_SpscQueue_ProducerConsumer)->UseRealTime();
@@ -0,0 +1,30 @@
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchLogger.h"
+#include "util/ranges.h"
+
+using creatures::bench::benchLogger;
+
+/*
+ * Mapping a DMX value onto a servo's range, which happens for every input on
+ * every frame
+ */
+
+namespace {
+
+void BM_ConvertRange(benchmark::State &state) {
+    const auto logger = benchLogger();
+
+    int32_t input = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convertRange(logger, input, 0, 255, 1000, 3000));
+        input = (input + 1) & 0xFF;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_ConvertRange);
@@ -44,6 +44,13 @@ class AudioSubsystem : public StoppableThread {
     [[nodiscard]] std::string getStats() const;
     [[nodiscard]] bool isRunning() const { return running_.load(); }
 
+    /**
+     * The RTP client doing the actual work, for anyone who wants its numbers
+     *
+     * @return the client, or nullptr if we haven't been initialized
+     */
+    [[nodiscard]] std::shared_ptr<const OpusRtpAudioClient> getRtpClient() const { return rtpClient_; }
+
   private:
     void monitoringLoop();
 
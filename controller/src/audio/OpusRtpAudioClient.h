@@ -45,6 +45,19 @@ class OpusRtpAudioClient final : public StoppableThread {
     [[nodiscard]] uint64_t getRtcpFallbacks() const { return rtcpFallbacks_.load(); }
     [[nodiscard]] int64_t getLastStartLatenessMicroseconds() const { return lastStartLatenessMicroseconds_.load(); }
     [[nodiscard]] const char *getTimingModeName() const;
+    [[nodiscard]] uint64_t getPlayoutDeadlineMisses() const { return playoutDeadlineMisses_.load(); }
+    [[nodiscard]] uint64_t getRtcpLateFramesDropped() const { return rtcpLateFramesDropped_.load(); }
+
+    /* Summed across the dialog and BGM streams */
+    [[nodiscard]] uint64_t getConcealedFrames() const {
+        return dialogStats_.concealedFrames.load() + bgmStats_.concealedFrames.load();
+    }
+    [[nodiscard]] uint64_t getDecodeErrors() const {
+        return dialogStats_.decodeErrors.load() + bgmStats_.decodeErrors.load();
+    }
+    [[nodiscard]] uint64_t getBufferOverruns() const {
+        return dialogStats_.bufferOverruns.load() + bgmStats_.bufferOverruns.load();
+    }
 
   private:
     class RtpJitterBuffer;
@@ -96,6 +96,22 @@ Result<std::shared_ptr<config::Configuration>> CommandLine::parseCommandLine(int
         configResult.getValue().value()->setWatchdogDisabled(true);
     }
 
+    // Capturing and replaying are for chasing down glitches, so they're only
+    // ever turned on from here, never left on in a config file
+    auto captureFile = program.get<std::string>("--capture");
+    auto replayFile = program.get<std::string>("--replay");
+    if (!captureFile.empty() && !replayFile.empty()) {
+        std::string errorMessage = "--capture and --replay can't be used together";
+        logger->critical(errorMessage);
+        return Result<std::shared_ptr<config::Configuration>>(
+            ControllerError(ControllerError::InvalidConfiguration, errorMessage));
+    }
+    configResult.getValue().value()->setCaptureFile(captureFile);
+    configResult.getValue().value()->setCaptureSerial(program.get<bool>("--capture-serial"));
+    configResult.getValue().value()->setReplayFile(replayFile);
+    configResult.getValue().value()->setReplayAsFastAsPossible(program.get<bool>("--replay-fast"));
+    configResult.getValue().value()->setReplayModulesReady(program.get<bool>("--replay-modules-ready"));
+
     return configResult;
 }
 
@@ -124,6 +140,29 @@ void CommandLine::setupCommandLineArguments(argparse::ArgumentParser &program) {
         .default_value(false)
         .implicit_value(true);
 
+    program.add_argument("--capture")
+        .help("Capture the e1.31 frames we receive to this file, to replay later")
+        .default_value(std::string(""));
+
+    program.add_argument("--capture-serial")
+        .help("Capture serial traffic to and from the modules too (needs --capture)")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--replay")
+        .help("Play back a capture instead of listening for e1.31 (point the modules at a pty or /dev/null)")
+        .default_value(std::string(""));
+
+    program.add_argument("--replay-fast")
+        .help("Replay as fast as possible instead of in real time")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--replay-modules-ready")
+        .help("Treat the modules as ready during a replay, so positions go out with no firmware on the other end")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_description("This application is the Linux version of the Creature Controller that's part\n"
                             "of April's Creature Workshop! 🐰");
     program.add_epilog("This is version " + getVersion() + "\n\n" + "🦜 Bawk!");
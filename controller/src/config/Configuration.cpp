@@ -110,6 +110,114 @@ u16 Configuration::getServerPort() const { return serverPort; }
  */
 std::string Configuration::getLogLevel() const { return logLevel; }
 
+/**
+ * @brief Get how many log lines may wait for the writer thread
+ * @return The queue size, in lines
+ */
+u32 Configuration::getLogQueueSize() const { return logQueueSize; }
+
+/**
+ * @brief Get what happens to a log line when the queue is full
+ * @return "block" or "drop_oldest"
+ */
+std::string Configuration::getLogOverflowPolicy() const { return logOverflowPolicy; }
+
+/**
+ * @brief Get whether binary serial framing may be used
+ * @return true if modules that advertise binary framing should get it
+ */
+bool Configuration::getBinarySerialFraming() const { return binarySerialFraming; }
+
+/**
+ * @brief Get whether messages to the server may be batched into one frame
+ * @return true if the server can take batch frames
+ */
+bool Configuration::getBatchServerMessages() const { return batchServerMessages; }
+
+/**
+ * @brief Get the encoding we'd like to use for messages to the server
+ * @return "json", "cbor", or "msgpack"
+ */
+std::string Configuration::getServerMessageEncoding() const { return serverMessageEncoding; }
+
+/**
+ * @brief Get whether position frames only carry the servos that moved
+ * @return true if delta position frames are on
+ */
+bool Configuration::getDeltaPositionFrames() const { return deltaPositionFrames; }
+
+/**
+ * @brief Get how far a servo has to move before it's sent in a delta frame
+ * @return The deadband in microseconds
+ */
+u16 Configuration::getPositionDeadbandMicroseconds() const { return positionDeadbandMicroseconds; }
+
+/**
+ * @brief Get how often a full position frame is sent when delta frames are on
+ * @return The keyframe interval in milliseconds
+ */
+u32 Configuration::getPositionKeyframeIntervalMs() const { return positionKeyframeIntervalMs; }
+
+/**
+ * @brief Get the SCHED_FIFO priority for the control loop
+ * @return 1-99, or 0 if the control loop isn't realtime
+ */
+int Configuration::getControllerRealtimePriority() const { return controllerRealtimePriority; }
+
+/**
+ * @brief Get the CPU the control loop is pinned to
+ * @return the CPU, or -1 if it isn't pinned
+ */
+int Configuration::getControllerCpu() const { return controllerCpu; }
+
+/**
+ * @brief Get how long the control loop spins before each tick
+ * @return The spin in microseconds
+ */
+u32 Configuration::getControllerSpinMicroseconds() const { return controllerSpinMicroseconds; }
+
+/**
+ * @brief Get the port to serve metrics on
+ * @return the port, or 0 if metrics are turned off
+ */
+u16 Configuration::getMetricsPort() const { return metricsPort; }
+
+/**
+ * @brief Get the address to serve metrics on
+ * @return the address to listen on
+ */
+std::string Configuration::getMetricsAddress() const { return metricsAddress; }
+
+/**
+ * @brief Get the file to capture traffic to
+ * @return the file, or an empty string if we're not capturing
+ */
+std::string Configuration::getCaptureFile() const { return captureFile; }
+
+/**
+ * @brief Get whether serial traffic is captured along with e1.31 frames
+ * @return true if it is
+ */
+bool Configuration::getCaptureSerial() const { return captureSerial; }
+
+/**
+ * @brief Get the capture to play back
+ * @return the file, or an empty string if we're listening for e1.31 like usual
+ */
+std::string Configuration::getReplayFile() const { return replayFile; }
+
+/**
+ * @brief Get whether a replay ignores the captured timing
+ * @return true to play frames back to back, false for real time
+ */
+bool Configuration::getReplayAsFastAsPossible() const { return replayAsFastAsPossible; }
+
+/**
+ * @brief Get whether a replay treats the modules as ready without any firmware
+ * @return true to send positions to the modules' ports no matter what's on them
+ */
+bool Configuration::getReplayModulesReady() const { return replayModulesReady; }
+
 bool Configuration::getWatchdogDisabled() const { return watchdogDisabled; }
 
 /**
@@ -309,6 +417,168 @@ void Configuration::setLogLevel(std::string _logLevel) {
     logger->debug("Set log level to {}", this->logLevel);
 }
 
+/**
+ * @brief Set how many log lines may wait for the writer thread
+ * @param _logQueueSize The queue size, in lines
+ */
+void Configuration::setLogQueueSize(u32 _logQueueSize) {
+    this->logQueueSize = _logQueueSize;
+    logger->debug("Set logQueueSize to {}", this->logQueueSize);
+}
+
+/**
+ * @brief Set what happens to a log line when the queue is full
+ * @param _logOverflowPolicy "block" or "drop_oldest"
+ */
+void Configuration::setLogOverflowPolicy(std::string _logOverflowPolicy) {
+    this->logOverflowPolicy = std::move(_logOverflowPolicy);
+    logger->debug("Set logOverflowPolicy to {}", this->logOverflowPolicy);
+}
+
+/**
+ * @brief Set whether binary serial framing may be used
+ * @param _binarySerialFraming true to allow binary framing
+ */
+void Configuration::setBinarySerialFraming(bool _binarySerialFraming) {
+    this->binarySerialFraming = _binarySerialFraming;
+    logger->debug("Set binarySerialFraming to {}", this->binarySerialFraming);
+}
+
+/**
+ * @brief Set whether messages to the server may be batched into one frame
+ * @param _batchServerMessages true if the server can take batch frames
+ */
+void Configuration::setBatchServerMessages(bool _batchServerMessages) {
+    this->batchServerMessages = _batchServerMessages;
+    logger->debug("Set batchServerMessages to {}", this->batchServerMessages);
+}
+
+/**
+ * @brief Set the encoding we'd like to use for messages to the server
+ * @param _serverMessageEncoding "json", "cbor", or "msgpack"
+ */
+void Configuration::setServerMessageEncoding(std::string _serverMessageEncoding) {
+    this->serverMessageEncoding = std::move(_serverMessageEncoding);
+    logger->debug("Set serverMessageEncoding to {}", this->serverMessageEncoding);
+}
+
+/**
+ * @brief Set whether position frames only carry the servos that moved
+ * @param _deltaPositionFrames true to turn delta position frames on
+ */
+void Configuration::setDeltaPositionFrames(bool _deltaPositionFrames) {
+    this->deltaPositionFrames = _deltaPositionFrames;
+    logger->debug("Set deltaPositionFrames to {}", this->deltaPositionFrames);
+}
+
+/**
+ * @brief Set how far a servo has to move before it's sent in a delta frame
+ * @param _positionDeadbandMicroseconds The deadband in microseconds
+ */
+void Configuration::setPositionDeadbandMicroseconds(u16 _positionDeadbandMicroseconds) {
+    this->positionDeadbandMicroseconds = _positionDeadbandMicroseconds;
+    logger->debug("Set positionDeadbandMicroseconds to {}", this->positionDeadbandMicroseconds);
+}
+
+/**
+ * @brief Set how often a full position frame is sent when delta frames are on
+ * @param _positionKeyframeIntervalMs The keyframe interval in milliseconds
+ */
+void Configuration::setPositionKeyframeIntervalMs(u32 _positionKeyframeIntervalMs) {
+    this->positionKeyframeIntervalMs = _positionKeyframeIntervalMs;
+    logger->debug("Set positionKeyframeIntervalMs to {}", this->positionKeyframeIntervalMs);
+}
+
+/**
+ * @brief Set the SCHED_FIFO priority for the control loop
+ * @param _controllerRealtimePriority 1-99, or 0 to leave the scheduler alone
+ */
+void Configuration::setControllerRealtimePriority(int _controllerRealtimePriority) {
+    this->controllerRealtimePriority = _controllerRealtimePriority;
+    logger->debug("Set controllerRealtimePriority to {}", this->controllerRealtimePriority);
+}
+
+/**
+ * @brief Set the CPU the control loop is pinned to
+ * @param _controllerCpu the CPU, or -1 to not pin it
+ */
+void Configuration::setControllerCpu(int _controllerCpu) {
+    this->controllerCpu = _controllerCpu;
+    logger->debug("Set controllerCpu to {}", this->controllerCpu);
+}
+
+/**
+ * @brief Set how long the control loop spins before each tick
+ * @param _controllerSpinMicroseconds The spin in microseconds
+ */
+void Configuration::setControllerSpinMicroseconds(u32 _controllerSpinMicroseconds) {
+    this->controllerSpinMicroseconds = _controllerSpinMicroseconds;
+    logger->debug("Set controllerSpinMicroseconds to {}", this->controllerSpinMicroseconds);
+}
+
+/**
+ * @brief Set the port to serve metrics on
+ * @param _metricsPort the port, or 0 to turn metrics off
+ */
+void Configuration::setMetricsPort(u16 _metricsPort) {
+    this->metricsPort = _metricsPort;
+    logger->debug("Set metricsPort to {}", this->metricsPort);
+}
+
+/**
+ * @brief Set the address to serve metrics on
+ * @param _metricsAddress the address to listen on
+ */
+void Configuration::setMetricsAddress(std::string _metricsAddress) {
+    this->metricsAddress = std::move(_metricsAddress);
+    logger->debug("Set metricsAddress to {}", this->metricsAddress);
+}
+
+/**
+ * @brief Set the file to capture traffic to
+ * @param _captureFile the file, or an empty string to not capture
+ */
+void Configuration::setCaptureFile(std::string _captureFile) {
+    this->captureFile = std::move(_captureFile);
+    logger->debug("Set captureFile to {}", this->captureFile);
+}
+
+/**
+ * @brief Set whether serial traffic is captured along with e1.31 frames
+ * @param _captureSerial true to capture it
+ */
+void Configuration::setCaptureSerial(bool _captureSerial) {
+    this->captureSerial = _captureSerial;
+    logger->debug("Set captureSerial to {}", this->captureSerial);
+}
+
+/**
+ * @brief Set the capture to play back
+ * @param _replayFile the file, or an empty string to listen for e1.31
+ */
+void Configuration::setReplayFile(std::string _replayFile) {
+    this->replayFile = std::move(_replayFile);
+    logger->debug("Set replayFile to {}", this->replayFile);
+}
+
+/**
+ * @brief Set whether a replay ignores the captured timing
+ * @param _replayAsFastAsPossible true to play frames back to back
+ */
+void Configuration::setReplayAsFastAsPossible(bool _replayAsFastAsPossible) {
+    this->replayAsFastAsPossible = _replayAsFastAsPossible;
+    logger->debug("Set replayAsFastAsPossible to {}", this->replayAsFastAsPossible);
+}
+
+/**
+ * @brief Set whether a replay treats the modules as ready without any firmware
+ * @param _replayModulesReady true to send positions to the modules' ports no matter what's on them
+ */
+void Configuration::setReplayModulesReady(bool _replayModulesReady) {
+    this->replayModulesReady = _replayModulesReady;
+    logger->debug("Set replayModulesReady to {}", this->replayModulesReady);
+}
+
 void Configuration::setWatchdogDisabled(bool _watchdogDisabled) {
     this->watchdogDisabled = _watchdogDisabled;
     logger->debug("Set watchdogDisabled to {}", this->watchdogDisabled);
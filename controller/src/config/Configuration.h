@@ -44,6 +44,24 @@ class Configuration {
     u16 getServerPort() const;
 
     [[nodiscard]] std::string getLogLevel() const;
+    [[nodiscard]] u32 getLogQueueSize() const;
+    [[nodiscard]] std::string getLogOverflowPolicy() const;
+    [[nodiscard]] bool getBinarySerialFraming() const;
+    [[nodiscard]] bool getBatchServerMessages() const;
+    [[nodiscard]] std::string getServerMessageEncoding() const;
+    [[nodiscard]] bool getDeltaPositionFrames() const;
+    [[nodiscard]] u16 getPositionDeadbandMicroseconds() const;
+    [[nodiscard]] u32 getPositionKeyframeIntervalMs() const;
+    [[nodiscard]] int getControllerRealtimePriority() const;
+    [[nodiscard]] int getControllerCpu() const;
+    [[nodiscard]] u32 getControllerSpinMicroseconds() const;
+    [[nodiscard]] u16 getMetricsPort() const;
+    [[nodiscard]] std::string getMetricsAddress() const;
+    [[nodiscard]] std::string getCaptureFile() const;
+    [[nodiscard]] bool getCaptureSerial() const;
+    [[nodiscard]] std::string getReplayFile() const;
+    [[nodiscard]] bool getReplayAsFastAsPossible() const;
+    [[nodiscard]] bool getReplayModulesReady() const;
 
     // Watchdog configuration getters
     [[nodiscard]] bool getWatchdogDisabled() const;
@@ -82,6 +100,24 @@ class Configuration {
     void setServerPort(u16 _serverPort);
 
     void setLogLevel(std::string _logLevel);
+    void setLogQueueSize(u32 _logQueueSize);
+    void setLogOverflowPolicy(std::string _logOverflowPolicy);
+    void setBinarySerialFraming(bool _binarySerialFraming);
+    void setBatchServerMessages(bool _batchServerMessages);
+    void setServerMessageEncoding(std::string _serverMessageEncoding);
+    void setDeltaPositionFrames(bool _deltaPositionFrames);
+    void setPositionDeadbandMicroseconds(u16 _positionDeadbandMicroseconds);
+    void setPositionKeyframeIntervalMs(u32 _positionKeyframeIntervalMs);
+    void setControllerRealtimePriority(int _controllerRealtimePriority);
+    void setControllerCpu(int _controllerCpu);
+    void setControllerSpinMicroseconds(u32 _controllerSpinMicroseconds);
+    void setMetricsPort(u16 _metricsPort);
+    void setMetricsAddress(std::string _metricsAddress);
+    void setCaptureFile(std::string _captureFile);
+    void setCaptureSerial(bool _captureSerial);
+    void setReplayFile(std::string _replayFile);
+    void setReplayAsFastAsPossible(bool _replayAsFastAsPossible);
+    void setReplayModulesReady(bool _replayModulesReady);
 
     // Watchdog configuration setters
     void setWatchdogDisabled(bool _watchdogDisabled);
@@ -139,6 +175,48 @@ class Configuration {
     // Minimum log severity to emit (trace, debug, info, warn, error, critical, off)
     std::string logLevel = "info";
 
+    // How many log lines can wait for the writer thread, and what to do when
+    // it's full ("block" or "drop_oldest")
+    u32 logQueueSize = DEFAULT_LOG_QUEUE_SIZE;
+    std::string logOverflowPolicy = DEFAULT_LOG_OVERFLOW_POLICY;
+
+    // May we use binary framing to modules whose firmware supports it?
+    bool binarySerialFraming = false;
+
+    // May we send the server several messages in one websocket frame?
+    bool batchServerMessages = false;
+
+    // The encoding we'd like to use with the server, if it agrees
+    std::string serverMessageEncoding = DEFAULT_SERVER_MESSAGE_ENCODING;
+
+    // Only send the servos that moved? If so, how far do they have to move, and
+    // how often do we send all of them anyway?
+    bool deltaPositionFrames = false;
+    u16 positionDeadbandMicroseconds = 0;
+    u32 positionKeyframeIntervalMs = DEFAULT_POSITION_KEYFRAME_INTERVAL_MS;
+
+    // How the control loop is scheduled: SCHED_FIFO priority (0 is off), which
+    // CPU to stay on (-1 is any), and how long to spin before each tick
+    int controllerRealtimePriority = 0;
+    int controllerCpu = -1;
+    u32 controllerSpinMicroseconds = DEFAULT_CONTROLLER_SPIN_MICROSECONDS;
+
+    // Where to serve metrics (a port of 0 means don't)
+    u16 metricsPort = DEFAULT_METRICS_PORT;
+    std::string metricsAddress = DEFAULT_METRICS_ADDRESS;
+
+    // Where to capture e1.31 frames (and serial traffic, if asked) for playing
+    // back later. Empty means don't.
+    std::string captureFile;
+    bool captureSerial = false;
+
+    // A capture to play back instead of listening for e1.31, whether to
+    // ignore its timing and go as fast as we can, and whether to treat the
+    // modules as ready without hearing from their firmware
+    std::string replayFile;
+    bool replayAsFastAsPossible = false;
+    bool replayModulesReady = false;
+
     // Watchdog configuration
     bool watchdogDisabled = false;
     double powerDrawLimitWatts = 0.0;
@@ -12,6 +12,7 @@ using json = nlohmann::json;
 #include "config/ConfigurationBuilder.h"
 #include "config/UARTDevice.h"
 #include "logging/Logger.h"
+#include "server/MessageEncoding.h"
 #include "util/Result.h"
 
 namespace creatures ::config {
@@ -348,6 +349,152 @@ Result<std::shared_ptr<creatures::config::Configuration>> ConfigurationBuilder::
         logger->debug("no logLevel field found, using default '{}'", config->getLogLevel());
     }
 
+    if (j.contains("logQueueSize")) {
+        if (!j["logQueueSize"].is_number_integer()) {
+            return makeError("Field 'logQueueSize' must be an integer");
+        }
+        const int64_t queueSize = j["logQueueSize"].get<int64_t>();
+        if (queueSize < 1 || queueSize > MAX_LOG_QUEUE_SIZE) {
+            return makeError(fmt::format("Field 'logQueueSize' must be between 1 and {}", MAX_LOG_QUEUE_SIZE));
+        }
+        config->setLogQueueSize(static_cast<u32>(queueSize));
+    }
+
+    if (j.contains("logOverflowPolicy")) {
+        if (!j["logOverflowPolicy"].is_string()) {
+            return makeError("Field 'logOverflowPolicy' must be a string");
+        }
+        auto policy = j["logOverflowPolicy"].get<std::string>();
+        if (policy != "block" && policy != "drop_oldest") {
+            return makeError(
+                fmt::format("Field 'logOverflowPolicy' must be 'block' or 'drop_oldest', not '{}'", policy));
+        }
+        config->setLogOverflowPolicy(policy);
+    }
+
+    // Optional binary serial framing. Even when this is on, a module only gets
+    // binary frames if its firmware says it can handle them.
+    if (j.contains("binarySerialFraming")) {
+        if (j["binarySerialFraming"].is_boolean()) {
+            config->setBinarySerialFraming(j["binarySerialFraming"].get<bool>());
+        } else {
+            logger->warn("binarySerialFraming field is not a boolean, using default '{}'",
+                         config->getBinarySerialFraming());
+        }
+    } else {
+        logger->debug("no binarySerialFraming field found, using default '{}'", config->getBinarySerialFraming());
+    }
+
+    // Optional batched server messages. The server has to know how to unwrap
+    // them, so this stays off unless asked for.
+    if (j.contains("batchServerMessages")) {
+        if (!j["batchServerMessages"].is_boolean()) {
+            return makeError("Field 'batchServerMessages' must be a boolean");
+        }
+        config->setBatchServerMessages(j["batchServerMessages"].get<bool>());
+    }
+
+    // Optional binary encoding for the server. This is only what we'll ask
+    // for; the server gets the final say when we register.
+    if (j.contains("serverMessageEncoding")) {
+        if (!j["serverMessageEncoding"].is_string()) {
+            return makeError("Field 'serverMessageEncoding' must be a string");
+        }
+        auto encoding = j["serverMessageEncoding"].get<std::string>();
+        if (!server::messageEncodingFromString(encoding).has_value()) {
+            return makeError(
+                fmt::format("Field 'serverMessageEncoding' must be 'json', 'cbor', or 'msgpack', not '{}'", encoding));
+        }
+        config->setServerMessageEncoding(encoding);
+    }
+
+    // Optional delta position frames. Off unless asked for, since it changes
+    // what the firmware sees on the wire.
+    if (j.contains("deltaPositionFrames")) {
+        if (!j["deltaPositionFrames"].is_boolean()) {
+            return makeError("Field 'deltaPositionFrames' must be a boolean");
+        }
+        config->setDeltaPositionFrames(j["deltaPositionFrames"].get<bool>());
+    }
+
+    if (j.contains("positionDeadbandMicroseconds")) {
+        if (!j["positionDeadbandMicroseconds"].is_number_integer()) {
+            return makeError("Field 'positionDeadbandMicroseconds' must be an integer");
+        }
+        const int deadband = j["positionDeadbandMicroseconds"].get<int>();
+        if (deadband < 0 || deadband > UINT16_MAX) {
+            return makeError(fmt::format("Field 'positionDeadbandMicroseconds' must be between 0 and {}", UINT16_MAX));
+        }
+        config->setPositionDeadbandMicroseconds(static_cast<u16>(deadband));
+    }
+
+    if (j.contains("positionKeyframeIntervalMs")) {
+        if (!j["positionKeyframeIntervalMs"].is_number_integer()) {
+            return makeError("Field 'positionKeyframeIntervalMs' must be an integer");
+        }
+        const int64_t intervalMs = j["positionKeyframeIntervalMs"].get<int64_t>();
+        if (intervalMs < 1 || intervalMs > MAX_POSITION_KEYFRAME_INTERVAL_MS) {
+            return makeError(fmt::format("Field 'positionKeyframeIntervalMs' must be between 1 and {}",
+                                         MAX_POSITION_KEYFRAME_INTERVAL_MS));
+        }
+        config->setPositionKeyframeIntervalMs(static_cast<u32>(intervalMs));
+    }
+
+    // Optional control loop scheduling. These all default to off, since going
+    // realtime needs privileges and spinning costs CPU.
+    if (j.contains("controllerRealtimePriority")) {
+        if (!j["controllerRealtimePriority"].is_number_integer()) {
+            return makeError("Field 'controllerRealtimePriority' must be an integer");
+        }
+        const int priority = j["controllerRealtimePriority"].get<int>();
+        if (priority < 0 || priority > 99) {
+            return makeError("Field 'controllerRealtimePriority' must be between 0 (off) and 99");
+        }
+        config->setControllerRealtimePriority(priority);
+    }
+
+    if (j.contains("controllerCpu")) {
+        if (!j["controllerCpu"].is_number_integer()) {
+            return makeError("Field 'controllerCpu' must be an integer");
+        }
+        const int cpu = j["controllerCpu"].get<int>();
+        if (cpu < -1 || cpu > 1023) {
+            return makeError("Field 'controllerCpu' must be between -1 (any) and 1023");
+        }
+        config->setControllerCpu(cpu);
+    }
+
+    if (j.contains("controllerSpinMicroseconds")) {
+        if (!j["controllerSpinMicroseconds"].is_number_integer()) {
+            return makeError("Field 'controllerSpinMicroseconds' must be an integer");
+        }
+        const int64_t spin = j["controllerSpinMicroseconds"].get<int64_t>();
+        if (spin < 0 || spin > MAX_CONTROLLER_SPIN_MICROSECONDS) {
+            return makeError(fmt::format("Field 'controllerSpinMicroseconds' must be between 0 and {}",
+                                         MAX_CONTROLLER_SPIN_MICROSECONDS));
+        }
+        config->setControllerSpinMicroseconds(static_cast<u32>(spin));
+    }
+
+    // Optional metrics endpoint. Off unless a port is given.
+    if (j.contains("metricsPort")) {
+        if (!j["metricsPort"].is_number_integer()) {
+            return makeError("Field 'metricsPort' must be an integer");
+        }
+        const int port = j["metricsPort"].get<int>();
+        if (port < 0 || port > UINT16_MAX) {
+            return makeError(fmt::format("Field 'metricsPort' must be between 0 (off) and {}", UINT16_MAX));
+        }
+        config->setMetricsPort(static_cast<u16>(port));
+    }
+
+    if (j.contains("metricsAddress")) {
+        if (!j["metricsAddress"].is_string() || j["metricsAddress"].get<std::string>().empty()) {
+            return makeError("Field 'metricsAddress' must be a non-empty string");
+        }
+        config->setMetricsAddress(j["metricsAddress"].get<std::string>());
+    }
+
     logger->info("done parsing the main config file");
     return Result<std::shared_ptr<creatures::config::Configuration>>{config};
 }
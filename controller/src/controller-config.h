@@ -25,6 +25,20 @@ using u64 = std::uint64_t;
 #define SERIAL_PORT_MAX_RECONNECT_ATTEMPTS 10 // Maximum number of reconnect attempts
 #define SERIAL_PORT_RECONNECT_DELAY_MS 2000   // Wait 2 seconds between reconnect attempts
 
+// How many messages each module's incoming and outgoing rings can hold. This is
+// a power of two; anything past it is dropped (and counted) instead of blocking.
+#define SERIAL_QUEUE_CAPACITY 1024
+
+// The serial reader reads up to this much at a time, and throws away (and
+// counts) any line from the firmware that's longer than SERIAL_MAX_LINE_LENGTH
+#define SERIAL_READ_BUFFER_SIZE 4096
+#define SERIAL_MAX_LINE_LENGTH 1024
+
+// The serial writer sends everything that's waiting (up to this many messages)
+// in one writev(), and works out its bytes/s this often
+#define SERIAL_WRITE_BATCH_MAX_MESSAGES 32
+#define SERIAL_WRITE_STATS_INTERVAL_MS 1000
+
 // The most servos we can control
 #define MAX_NUMBER_OF_SERVOS 8
 
@@ -35,6 +49,42 @@ using u64 = std::uint64_t;
 #define CONTROLLER_LOG_LEVEL "spdlog::level::trace"
 #define RP2040_LOG_LEVEL "spdlog::level::trace"
 
+/*
+ * Log lines are written out by a background thread so a slow terminal (or
+ * journald having a moment) can't hold up the control loop. This is how many
+ * lines can be waiting, and what happens when that fills up: "block" waits
+ * for room like writing directly used to, "drop_oldest" throws away the oldest
+ * waiting line instead.
+ */
+#define DEFAULT_LOG_QUEUE_SIZE 8192
+#define MAX_LOG_QUEUE_SIZE 1048576
+#define DEFAULT_LOG_OVERFLOW_POLICY "drop_oldest"
+
+// The most lines a second we'll print from the chattiest spots
+#define FIRMWARE_LOG_LINES_PER_SECOND 50
+#define ROUTER_LOG_LINES_PER_SECOND 20
+
+/*
+ * Once a message for the server shows up, the websocket writer waits this long
+ * for others to join it, then sends them all at once. A batch frame is never
+ * built bigger than WEBSOCKET_BATCH_MAX_BYTES.
+ */
+#define WEBSOCKET_BATCH_WINDOW_MS 20
+#define WEBSOCKET_BATCH_MAX_MESSAGES 64
+#define WEBSOCKET_BATCH_MAX_BYTES 65536
+#define WEBSOCKET_STATS_INTERVAL_MS 30000
+
+/*
+ * The most messages that can be waiting for the websocket writer. A newer
+ * sensor report takes the place of an older one from the same spot that's
+ * still waiting, and if it fills up anyway, the oldest message goes.
+ */
+#define WEBSOCKET_QUEUE_CAPACITY 4096
+
+// What we'd like to send the server in ("json", "cbor", or "msgpack"). We only
+// get it if the server says yes when we register; otherwise it's JSON.
+#define DEFAULT_SERVER_MESSAGE_ENCODING "json"
+
 /*
  * Control loop reporting, counted in frames. The frame count is valuable when
  * something is wrong, so the fine-grained line stays available at debug; a
@@ -45,6 +95,40 @@ using u64 = std::uint64_t;
 #define CONTROLLER_FRAME_LOG_INTERVAL 100
 #define CONTROLLER_FRAME_SUMMARY_INTERVAL 3000
 
+/*
+ * When delta position frames are on, every servo is still sent at least this
+ * often so the firmware never goes long without hearing about one
+ */
+#define DEFAULT_POSITION_KEYFRAME_INTERVAL_MS 1000
+#define MAX_POSITION_KEYFRAME_INTERVAL_MS 60000
+
+/*
+ * The control loop sleeps until each tick's deadline. It can spin for the
+ * last little bit instead of trusting the kernel to wake it right on time,
+ * which trades some CPU for less jitter. Off unless configured.
+ */
+#define DEFAULT_CONTROLLER_SPIN_MICROSECONDS 0
+#define MAX_CONTROLLER_SPIN_MICROSECONDS 5000
+
+/*
+ * Where to serve metrics for Prometheus to scrape. A port of 0 turns it off.
+ * It only listens on loopback unless told otherwise.
+ */
+#define DEFAULT_METRICS_PORT 0
+#define DEFAULT_METRICS_ADDRESS "127.0.0.1"
+
+/*
+ * Capturing traffic to play back later. Records are written out in batches by
+ * a thread of their own, and if it falls this far behind, new ones are dropped
+ * rather than holding up the threads that are recording.
+ */
+#define CAPTURE_MAX_PENDING_RECORDS 65536
+#define CAPTURE_WRITE_BATCH_SIZE 256
+
+// Once a replay runs out of frames, how long to give the control loop and the
+// modules' writers to get the last of them out before we add up how it went
+#define REPLAY_SETTLE_MS 100
+
 // Firmware/protocol versions this controller can talk to. A HW3 board reports
 // version 3 (standard servos only); a HW4 board reports 4 (adds Dynamixel). A
 // single controller binary supports either, so it accepts the whole range.
@@ -104,6 +188,13 @@ using u64 = std::uint64_t;
 #define DEFAULT_NETWORK_INTERFACE_NAME "eth0"
 #define DEFAULT_UNIVERSE 3000
 
+/*
+ * How many e1.31 packets to pull off the socket at once. Only the newest good
+ * one in each batch is used, so a burst from the show server doesn't turn into
+ * a backlog of stale frames.
+ */
+#define E131_RECEIVE_BATCH_SIZE 16
+
 /**
  * These allow more than one creature to be controlled on the same
  * DMX universe!
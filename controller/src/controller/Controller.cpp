@@ -1,4 +1,6 @@
 
+#include <algorithm>
+#include <chrono>
 
 #include "controller-config.h"
 
@@ -14,7 +16,10 @@
 #include "controller/commands/SetServoPositions.h"
 #include "creature/Creature.h"
 #include "io/Message.h"
+#include "server/MotionLatencyReportMessage.h"
+#include "util/LoopTimer.h"
 #include "util/thread_name.h"
+#include "util/thread_priority.h"
 
 u64 number_of_moves = 0UL;
 
@@ -29,18 +34,95 @@ Controller::Controller(const std::shared_ptr<creatures::Logger> &logger,
     receivedFirstFrame = false;
     this->numberOfChannels = DMX_NUMBER_OF_CHANNELS;
 
-    // Create our input queue
-    inputQueue = std::make_shared<creatures::MessageQueue<std::unordered_map<std::string, creatures::Input>>>();
-    logger->debug("created the input queue");
+    // Create our input mailbox
+    inputMailbox = std::make_shared<creatures::LatestValueMailbox<creatures::InputFrame>>();
+    mappedTimestamps = std::make_shared<creatures::LatestValueMailbox<creatures::MotionTimestamps>>();
+    numberOfInputs = creature->getInputs().size();
+    logger->debug("created the input mailbox");
 
     logger->info("Controller for {} initialized", creature->getName());
 }
 
 void Controller::sendCommand(const std::shared_ptr<creatures::ICommand> &command,
                              creatures::config::UARTDevice::module_name destModule) {
-    logger->trace("sending command {}", command->toMessageWithChecksum());
+    auto message = command->toMessageWithChecksum();
+    logger->trace("sending command {}", message);
 
-    this->messageRouter->sendMessageToCreature(creatures::io::Message(destModule, command->toMessageWithChecksum()));
+    this->messageRouter->sendMessageToCreature(creatures::io::Message(destModule, std::move(message)));
+}
+
+void Controller::buildFrameEncoders() {
+
+    frameEncoders.clear();
+    for (auto &handlerId : messageRouter->getHandleIds()) {
+        if (creature->getServoTable().getModuleSpan(handlerId).count == 0) {
+            logger->warn("no servos on module {}, not sending it any positions",
+                         creatures::config::UARTDevice::moduleNameToString(handlerId));
+            continue;
+        }
+        frameEncoders.emplace_back(logger, handlerId, creature->getServoTable());
+    }
+
+    frameEncodersBuiltForHandlers = messageRouter->getNumberOfHandlers();
+    frameEncodersBuilt = true;
+    logger->info("built frame encoders for {} modules", frameEncoders.size());
+}
+
+void Controller::setDeltaPositionFrames(u32 deadbandMicroseconds, std::chrono::milliseconds keyframeInterval) {
+    deltaPositionFrames = true;
+    positionDeadbandMicroseconds = deadbandMicroseconds;
+
+    // Work the interval out in frames so the loop only has to count
+    keyframeIntervalFrames =
+        std::max<u64>(1, static_cast<u64>(keyframeInterval.count()) * creature->getServoUpdateFrequencyHz() / 1000);
+
+    logger->info("delta position frames on: deadband {}us, keyframe every {} frames", positionDeadbandMicroseconds,
+                 keyframeIntervalFrames);
+}
+
+void Controller::setLoopTiming(int _realtimePriority, int cpu, std::chrono::microseconds spin) {
+    realtimePriority = _realtimePriority;
+    loopCpu = cpu;
+    loopSpin = spin;
+
+    logger->info("control loop timing: SCHED_FIFO priority {}, CPU {}, spin {}us",
+                 realtimePriority > 0 ? fmt::format("{}", realtimePriority) : "off",
+                 loopCpu >= 0 ? fmt::format("{}", loopCpu) : "any", loopSpin.count());
+}
+
+void Controller::applyLoopScheduling() {
+
+    // Neither of these are fatal. We'll still run, just with more jitter.
+    if (loopCpu >= 0) {
+        auto result = creatures::pinThreadToCpu(loopCpu);
+        if (result.isSuccess()) {
+            logger->info("control loop pinned to CPU {}", loopCpu);
+        } else {
+            logger->warn("control loop couldn't be pinned: {}", result.getError()->getMessage());
+        }
+    }
+
+    if (realtimePriority > 0) {
+        auto result = creatures::setRealtimePriority(realtimePriority);
+        if (result.isSuccess()) {
+            logger->info("control loop running under SCHED_FIFO at priority {}", realtimePriority);
+        } else {
+            logger->warn("control loop couldn't go realtime: {} (Hint: run as root or grant CAP_SYS_NICE)",
+                         result.getError()->getMessage());
+        }
+    }
+}
+
+void Controller::reportMotionLatency() {
+    if (creatures::MotionLatency::getHistogram(creatures::MotionLatency::Stage::total).count() == 0) {
+        return;
+    }
+
+    logger->info("motion latency: {}", creatures::MotionLatency::summary());
+    if (serverQueue != nullptr) {
+        serverQueue->push(creatures::server::MotionLatencyReportMessage(logger, creatures::MotionLatency::toJson()));
+    }
+    creatures::MotionLatency::reset();
 }
 
 void Controller::start() {
@@ -48,31 +130,24 @@ void Controller::start() {
     creatures::StoppableThread::start();
 }
 
-bool Controller::acceptInput(const std::vector<creatures::Input> &inputs) {
+bool Controller::acceptInput(const creatures::InputFrame &frame) {
 
     // Don't waste time with empty sets
-    if (inputs.empty()) {
+    if (numberOfInputs == 0) {
         logger->warn("ignoring an empty set of inputs");
         return false;
     }
 
-    // The I/O handler cares about slots in the DMX stream, the creature
-    // cares about names. Let's build the map the creature actually wants
-    // here, so the creature doesn't have to do it.
-    std::unordered_map<std::string, creatures::Input> creatureInputs;
-    for (auto &input : inputs) {
-        creatureInputs[input.getName()] = input;
-    }
-
     // Is this first data we've gotten?
     if (!receivedFirstFrame) {
         logger->info("first frame received");
         receivedFirstFrame = true;
     }
 
-    // Assign this to the input queue and hope the creature sees it!
-    logger->trace("sending {} inputs to the input queue", creatureInputs.size());
-    inputQueue->push(creatureInputs);
+    // Drop this in the mailbox and hope the creature sees it! If it hasn't
+    // picked up the last one yet, this one replaces it.
+    logger->trace("sending {} inputs to the input mailbox", numberOfInputs);
+    inputMailbox->post(frame);
 
     return true;
 }
@@ -102,9 +177,16 @@ Controller::getServoConfigs(creatures::config::UARTDevice::module_name module) {
     return creatures::Result<std::vector<creatures::ServoConfig>>{configs};
 }
 
-std::shared_ptr<creatures::MessageQueue<std::unordered_map<std::string, creatures::Input>>>
-Controller::getInputQueue() {
-    return inputQueue;
+std::shared_ptr<creatures::LatestValueMailbox<creatures::InputFrame>> Controller::getInputMailbox() {
+    return inputMailbox;
+}
+
+std::shared_ptr<creatures::LatestValueMailbox<creatures::MotionTimestamps>> Controller::getMappedTimestampsMailbox() {
+    return mappedTimestamps;
+}
+
+void Controller::setServerQueue(std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> queue) {
+    serverQueue = std::move(queue);
 }
 
 std::shared_ptr<creatures::creature::Creature> Controller::getCreature() { return creature; }
@@ -129,8 +211,11 @@ void Controller::run() {
 
     logger->info("controller worker now running");
 
-    auto target_delta = microseconds(1000000 / creature->getServoUpdateFrequencyHz());
-    auto next_target_time = high_resolution_clock::now() + target_delta;
+    applyLoopScheduling();
+
+    creatures::LoopTimer timer(microseconds(1000000 / creature->getServoUpdateFrequencyHz()), loopSpin);
+    timer.start();
+    u64 lastSummaryOverruns = 0;
 
     // State for the periodic summary. Tracking the wall clock lets us report the
     // rate we actually achieved, which says far more about the health of the
@@ -154,15 +239,27 @@ void Controller::run() {
             const auto now = steady_clock::now();
             const auto elapsed = duration_cast<milliseconds>(now - lastSummaryTime).count();
 
+            // How on time we've been since last time. Lateness that wanders
+            // around from tick to tick is what makes servos buzz.
+            const u64 overruns = timer.getOverruns() - lastSummaryOverruns;
+            const auto lateness = fmt::format("woke up late by p50 {}us, p99 {}us, max {}us, {} ticks skipped",
+                                              wakeupLateness.percentile(50), wakeupLateness.percentile(99),
+                                              wakeupLateness.max(), overruns);
+
             if (elapsed > 0) {
                 const double fps = static_cast<double>(_frames - lastSummaryFrames) * 1000.0 / elapsed;
-                logger->info("frames: {} ({:.1f} fps)", _frames, fps);
+                logger->info("frames: {} ({:.1f} fps), {}", _frames, fps, lateness);
+                framesPerSecond.store(fps, std::memory_order_relaxed);
             } else {
-                logger->info("frames: {}", _frames);
+                logger->info("frames: {}, {}", _frames, lateness);
             }
 
             lastSummaryTime = now;
             lastSummaryFrames = _frames;
+            lastSummaryOverruns = timer.getOverruns();
+            wakeupLateness.reset();
+
+            reportMotionLatency();
         }
 
         // If we haven't received a frame yet, don't do anything
@@ -171,6 +268,7 @@ void Controller::run() {
         // Announce the transition either way. Being stalled is worth saying
         // once and worth repeating occasionally, but not every couple of
         // seconds for as long as it lasts.
+        const bool becameReady = ready && !wasReady;
         if (ready != wasReady) {
             if (ready) {
                 logger->info("sending frames now: receivedFirstFrame and all handlers are ready");
@@ -184,21 +282,54 @@ void Controller::run() {
 
         if (ready) {
 
-            // Go fetch the positions
+            // If the creature has mapped a new frame since last time, these
+            // positions are what it turned into. Pass its timestamps along.
+            creatures::MotionTimestamps timestamps{};
+            if (const auto *mapped = mappedTimestamps->take()) {
+                timestamps = *mapped;
+                timestamps.tickedNs = creatures::MotionLatency::now();
+            }
+
+            // The set of modules only changes at startup, so this is almost always a no-op
+            if (!frameEncodersBuilt || frameEncodersBuiltForHandlers != messageRouter->getNumberOfHandlers()) {
+                buildFrameEncoders();
+            }
+
+            // If a module's writer fell behind and a frame got replaced before
+            // it went out, whatever only that frame carried never made it
+            const u64 positionsReplaced = messageRouter->getPositionsReplaced();
+            const bool framesWereReplaced = positionsReplaced != positionsReplacedSeen;
+            positionsReplacedSeen = positionsReplaced;
+
+            // Send everything on a keyframe, or right after we (or a module
+            // that restarted) come back, or lost a frame. In between, only
+            // what moved.
+            const bool keyframe = !deltaPositionFrames || becameReady || framesWereReplaced ||
+                                  number_of_frames % keyframeIntervalFrames == 0;
 
-            // Look at each handler in the message router
-            for (auto &handlerId : messageRouter->getHandleIds()) {
+            // Go fetch the positions for each module and fire them off
+            for (auto &encoder : frameEncoders) {
 
-                std::vector<creatures::ServoPosition> requestedPositions =
-                    creature->getRequestedServoPositions(handlerId);
+                // Nothing moved on this module, so there's nothing to say
+                if (encoder.selectServos(positionDeadbandMicroseconds, keyframe) == 0) {
+                    continue;
+                }
+
+                // Use binary framing if this module's firmware and our config agreed to it
+                if (messageRouter->getHandlerFraming(encoder.getModule()) == creatures::io::SerialFraming::binary) {
+                    const auto frame = encoder.encodeBinary();
+                    logger->trace("sending a {} byte binary frame", frame.size());
 
-                auto command = std::make_shared<creatures::commands::SetServoPositions>(logger);
-                for (auto &position : requestedPositions) {
-                    command->addServoPosition(position);
+                    this->messageRouter->sendPositionToCreature(encoder.getModule(), frame,
+                                                                creatures::io::SerialFraming::binary, timestamps);
+                    continue;
                 }
 
-                // Fire this off to the controller
-                sendCommand(command, handlerId);
+                const auto frame = encoder.encode();
+                logger->trace("sending frame {}", frame);
+
+                this->messageRouter->sendPositionToCreature(encoder.getModule(), frame,
+                                                            creatures::io::SerialFraming::text, timestamps);
             }
 
             // Tell the creature to get ready for next time
@@ -215,17 +346,10 @@ void Controller::run() {
             }
         }
 
-        // Figure out how much time we have until the next tick
-        auto remaining_time = next_target_time - high_resolution_clock::now();
-
-        // If there's time left, wait.
-        if (remaining_time > nanoseconds(0)) {
-            // Sleep for the remaining time
-            std::this_thread::sleep_for(remaining_time);
-        }
-
-        // Update the target time for the next iteration
-        next_target_time += target_delta;
+        // Nap until the next tick
+        const auto late = timer.waitForNextTick();
+        wakeupLateness.record(static_cast<u64>(duration_cast<microseconds>(late).count()));
+        ticksSkipped.store(timer.getOverruns(), std::memory_order_relaxed);
     }
 
     logger->info("controller worker stopped");
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
@@ -9,7 +10,10 @@
 #include "controller-config.h"
 
 #include "controller/Input.h"
+#include "controller/InputFrame.h"
+#include "controller/MotionLatency.h"
 #include "controller/commands/ICommand.h"
+#include "controller/commands/PositionFrameEncoder.h"
 #include "controller/commands/SetServoPositions.h"
 #include "controller/commands/tokens/ServoConfig.h"
 #include "creature/Creature.h"
@@ -18,6 +22,9 @@
 #include "io/Message.h"
 #include "io/MessageRouter.h"
 #include "logging/Logger.h"
+#include "server/ServerMessage.h"
+#include "util/Histogram.h"
+#include "util/LatestValueMailbox.h"
 #include "util/MessageQueue.h"
 #include "util/Result.h"
 #include "util/StoppableThread.h"
@@ -64,25 +71,90 @@ class Controller : public creatures::StoppableThread {
     void powerToggle();
     [[nodiscard]] bool isPoweredOn();
 
+    /**
+     * Only send the servos that have moved since we last sent them
+     *
+     * Frames where nothing moved are skipped entirely. Every servo is still
+     * sent once a keyframe interval as a keepalive. Call this before `start()`.
+     *
+     * @param deadbandMicroseconds how far a servo has to move to be sent
+     * @param keyframeInterval how often to send every servo anyway
+     */
+    void setDeltaPositionFrames(u32 deadbandMicroseconds, std::chrono::milliseconds keyframeInterval);
+
+    /**
+     * How the control loop's thread should be scheduled, and how hard it
+     * should try to wake up right on time. Call this before `start()`.
+     *
+     * @param realtimePriority run under SCHED_FIFO at this priority (1-99), or
+     *                         0 to leave the scheduler alone
+     * @param cpu keep the loop on this CPU, or -1 to let it wander
+     * @param spin how long before each tick to stop sleeping and spin instead
+     */
+    void setLoopTiming(int realtimePriority, int cpu, std::chrono::microseconds spin);
+
+    /**
+     * How late the control loop has been waking up, in microseconds, since
+     * the last summary
+     */
+    [[nodiscard]] const creatures::Histogram &getWakeupLateness() const { return wakeupLateness; }
+
+    /**
+     * How many times the control loop has gone around
+     */
+    [[nodiscard]] u64 getNumberOfFrames() const { return number_of_frames.load(std::memory_order_relaxed); }
+
+    /**
+     * How many ticks the control loop has skipped because it fell a whole
+     * period (or more) behind
+     */
+    [[nodiscard]] u64 getTicksSkipped() const { return ticksSkipped.load(std::memory_order_relaxed); }
+
+    /**
+     * The frame rate we actually got, as of the last summary
+     */
+    [[nodiscard]] double getFramesPerSecond() const { return framesPerSecond.load(std::memory_order_relaxed); }
+
     [[nodiscard]] bool hasReceivedFirstFrame() const;
     void confirmFirstFrameReceived();
 
     /**
      * Accept input from an input handler
      *
-     * @param inputs a `std::vector<creatures::Input>` of input objects
+     * @param frame the newest values for every slot the creature listens to
      * @return true if it worked
      */
-    bool acceptInput(const std::vector<creatures::Input> &inputs);
+    bool acceptInput(const creatures::InputFrame &frame);
+
+    /**
+     * @brief Get a reference to the input mailbox
+     *
+     * The creature's worker takes frames out of this. It only ever holds the
+     * newest one.
+     *
+     * @return a `std::shared_ptr<creatures::LatestValueMailbox<creatures::InputFrame>>`
+     */
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::InputFrame>> getInputMailbox();
 
     /**
-     * @brief Get a reference to the input queue
+     * @brief Get a reference to the mapped timestamps mailbox
+     *
+     * Each time the creature's worker maps a frame to servo positions, it
+     * posts that frame's timestamps here, and the next tick takes them along
+     * with the positions it sends. That's how we know how long motion takes
+     * to get from the network to the servos.
      *
-     * @return a
-     * `std::shared_ptr<creatures::MessageQueue<std::unordered_map<std::string,
-     * creatures::Input>>>` 😅
+     * @return a `std::shared_ptr<creatures::LatestValueMailbox<creatures::MotionTimestamps>>`
      */
-    std::shared_ptr<creatures::MessageQueue<std::unordered_map<std::string, creatures::Input>>> getInputQueue();
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::MotionTimestamps>> getMappedTimestampsMailbox();
+
+    /**
+     * Send a motion latency report to the server with each summary. Call this
+     * before `start()`.
+     *
+     * @param queue the websocket's outgoing queue
+     */
+    void setServerQueue(std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> queue);
 
     u8 getNumberOfServosInUse();
 
@@ -126,12 +198,67 @@ class Controller : public creatures::StoppableThread {
     std::shared_ptr<creatures::io::MessageRouter> messageRouter;
 
     std::atomic<u64> number_of_frames = 0UL;
+    std::atomic<u64> ticksSkipped = 0UL;
+    std::atomic<double> framesPerSecond = 0.0;
+
+    /**
+     * One frame encoder per registered module, built the first time we're ready
+     * to send (modules register after we start) and rebuilt only if the set of
+     * modules changes
+     */
+    std::vector<creatures::commands::PositionFrameEncoder> frameEncoders;
+    size_t frameEncodersBuiltForHandlers = 0;
+    bool frameEncodersBuilt = false;
+
+    // Delta frames: off unless setDeltaPositionFrames() is called
+    bool deltaPositionFrames = false;
+    u32 positionDeadbandMicroseconds = 0;
+    u64 keyframeIntervalFrames = 1;
+
+    // The router's count of replaced position frames as of our last frame
+    u64 positionsReplacedSeen = 0;
+
+    // Loop timing: leave the scheduler alone and never spin unless
+    // setLoopTiming() says otherwise
+    int realtimePriority = 0;
+    int loopCpu = -1;
+    std::chrono::microseconds loopSpin{0};
+
+    // How late each tick woke up (in microseconds), reset with every summary
+    creatures::Histogram wakeupLateness;
 
     /**
-     * Our queue of inputs from the I/O handlers. A reference to this
-     * queue is made available to the creature.
+     * Put the calling thread on the scheduler and CPU we were asked for
      */
-    std::shared_ptr<creatures::MessageQueue<std::unordered_map<std::string, creatures::Input>>> inputQueue;
+    void applyLoopScheduling();
+
+    /**
+     * Log how long motion has been taking to get out, send it to the server,
+     * and start counting again
+     */
+    void reportMotionLatency();
+
+    /**
+     * Build a frame encoder for each module the message router knows about
+     */
+    void buildFrameEncoders();
+
+    /**
+     * The newest inputs from the I/O handlers. A reference to this mailbox is
+     * made available to the creature. If the creature falls behind, older
+     * frames are dropped instead of piling up.
+     */
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::InputFrame>> inputMailbox;
+
+    // Timestamps of the frames the creature has mapped, so the tick that sends
+    // their positions can pass them along
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::MotionTimestamps>> mappedTimestamps;
+
+    // Where motion latency reports go, if we're talking to a server
+    std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> serverQueue;
+
+    // How many inputs the creature has. No point passing frames along if it's none.
+    size_t numberOfInputs = 0;
 
     /**
      * Keeps track of if we are considered "online."
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "controller-config.h"
+#include "controller/MotionTimestamps.h"
+
+namespace creatures {
+
+/**
+ * One frame's worth of input values, straight off the wire
+ *
+ * This is what the input handlers hand the controller. It's just the values,
+ * indexed by each `Input`'s slot (the creature's channel offset has already
+ * been taken off), so it can be filled in and copied around without allocating
+ * anything. The names and such stay with the `Input`s the creature was built
+ * with.
+ */
+struct InputFrame {
+
+    /**
+     * A whole DMX universe, plus the start code at 0, the same as an e1.31
+     * packet carries
+     */
+    static constexpr size_t numberOfSlots = 513;
+
+    std::array<u8, numberOfSlots> slots{};
+
+    // When this frame came in, and where it's been since
+    MotionTimestamps timestamps{};
+};
+
+} // namespace creatures
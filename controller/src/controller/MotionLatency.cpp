@@ -0,0 +1,117 @@
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+
+#include "controller/MotionLatency.h"
+#include "util/Histogram.h"
+
+namespace creatures {
+
+MotionLatency::StageHistograms MotionLatency::histograms{};
+std::atomic<MotionLatency::StageHistograms *> MotionLatency::attached{nullptr};
+std::atomic<std::int64_t> MotionLatency::lastRecordedNs{0};
+
+namespace {
+
+// Time between two stamps, in microseconds. A stage that's missing a stamp,
+// or that appears to go backwards, is skipped.
+bool stageMicroseconds(std::int64_t from, std::int64_t to, std::uint64_t &microseconds) {
+    if (from == 0 || to == 0 || to < from) {
+        return false;
+    }
+    microseconds = static_cast<std::uint64_t>((to - from) / 1000);
+    return true;
+}
+
+} // namespace
+
+void MotionLatency::recordWritten(const MotionTimestamps &timestamps, std::int64_t writtenNs) {
+    if (!timestamps.isTraced()) {
+        return;
+    }
+
+    // Only the first module to get a frame out records it
+    std::int64_t last = lastRecordedNs.load(std::memory_order_relaxed);
+    do {
+        if (timestamps.receivedNs <= last) {
+            return;
+        }
+    } while (!lastRecordedNs.compare_exchange_weak(last, timestamps.receivedNs, std::memory_order_relaxed));
+
+    const std::array<std::int64_t, NumberOfStages> from = {timestamps.receivedNs, timestamps.handedOffNs,
+                                                           timestamps.mappedNs, timestamps.tickedNs,
+                                                           timestamps.receivedNs};
+    const std::array<std::int64_t, NumberOfStages> to = {timestamps.handedOffNs, timestamps.mappedNs,
+                                                         timestamps.tickedNs, writtenNs, writtenNs};
+
+    StageHistograms *extra = attached.load(std::memory_order_acquire);
+    std::uint64_t microseconds = 0;
+    for (size_t i = 0; i < NumberOfStages; i++) {
+        if (stageMicroseconds(from[i], to[i], microseconds)) {
+            histograms[i].record(microseconds);
+            if (extra != nullptr) {
+                (*extra)[i].record(microseconds);
+            }
+        }
+    }
+}
+
+void MotionLatency::attach(StageHistograms *extra) { attached.store(extra, std::memory_order_release); }
+
+const Histogram &MotionLatency::getHistogram(Stage stage) { return histograms[static_cast<size_t>(stage)]; }
+
+const char *MotionLatency::stageName(Stage stage) {
+    switch (stage) {
+    case Stage::network:
+        return "network";
+    case Stage::creature:
+        return "creature";
+    case Stage::tick:
+        return "tick";
+    case Stage::serial:
+        return "serial";
+    case Stage::total:
+    default:
+        return "total";
+    }
+}
+
+std::string MotionLatency::summary() {
+    std::string line = fmt::format("{} frames traced", histograms[static_cast<size_t>(Stage::total)].count());
+    for (size_t i = 0; i < NumberOfStages; i++) {
+        const auto &histogram = histograms[i];
+        line += fmt::format(", {} p50 {}us / p99 {}us / max {}us", stageName(static_cast<Stage>(i)),
+                            histogram.percentile(50), histogram.percentile(99), histogram.max());
+    }
+    return line;
+}
+
+nlohmann::json MotionLatency::toJson() {
+    nlohmann::json j;
+    j["frames"] = histograms[static_cast<size_t>(Stage::total)].count();
+    for (size_t i = 0; i < NumberOfStages; i++) {
+        const auto &histogram = histograms[i];
+        j["stages"][stageName(static_cast<Stage>(i))] = {
+            {"p50_us", histogram.percentile(50)},
+            {"p99_us", histogram.percentile(99)},
+            {"max_us", histogram.max()},
+            {"mean_us", histogram.mean()},
+        };
+    }
+    return j;
+}
+
+void MotionLatency::reset() {
+    for (auto &histogram : histograms) {
+        histogram.reset();
+    }
+    lastRecordedNs.store(0, std::memory_order_relaxed);
+}
+
+} // namespace creatures
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "controller/MotionTimestamps.h"
+#include "util/Histogram.h"
+
+namespace creatures {
+
+/**
+ * How long motion takes to get from the network to the wire, broken down by
+ * where the time goes
+ *
+ *   - network:  the packet sitting in the socket until the e1.31 client read it
+ *   - creature: waiting in the mailbox, plus the creature mapping it to servos
+ *   - tick:     waiting for the next control loop tick to pick it up
+ *   - serial:   waiting in the module's outgoing queue, plus the write() itself
+ *   - total:    all of the above, from the packet arriving to it being written
+ *
+ * Every frame is recorded when it's written to a module, so only frames that
+ * actually made it out count. A frame goes to every module, but it's only
+ * recorded once: by whichever module's writer gets it out first. Everything
+ * is in microseconds.
+ *
+ * Like `WatchdogGlobals`, this is shared by the whole process: the threads
+ * involved don't otherwise know anything about each other. The controller
+ * starts these over at every summary, so anyone who wants to watch a longer
+ * stretch (a replay, say) attaches histograms of their own.
+ */
+struct MotionLatency {
+
+    enum class Stage : size_t { network, creature, tick, serial, total };
+    static constexpr size_t NumberOfStages = 5;
+
+    using StageHistograms = std::array<Histogram, NumberOfStages>;
+
+    /**
+     * Right now, in the units the stamps use
+     */
+    static std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * Record a frame that was just written to a module
+     *
+     * Frames are told apart by when they were received. Once one's been
+     * recorded, writes of it (or anything older) to the other modules are
+     * skipped.
+     *
+     * @param timestamps the frame's stamps
+     * @param writtenNs when the write finished
+     */
+    static void recordWritten(const MotionTimestamps &timestamps, std::int64_t writtenNs);
+
+    static const Histogram &getHistogram(Stage stage);
+    static const char *stageName(Stage stage);
+
+    /**
+     * A one-line summary for the logs
+     */
+    static std::string summary();
+
+    /**
+     * The same thing, for the server
+     */
+    static nlohmann::json toJson();
+
+    /**
+     * Start counting over again
+     *
+     * Attached histograms aren't touched.
+     */
+    static void reset();
+
+    /**
+     * Record every frame into these as well, until they're detached
+     *
+     * There's room for one set at a time. A writer that was partway through
+     * recording might still add a frame just after they're detached, so they
+     * need to stick around until the writers are done.
+     *
+     * @param extra where else frames go, or nullptr to stop
+     */
+    static void attach(StageHistograms *extra);
+
+  private:
+    static StageHistograms histograms;
+
+    // Someone else's histograms, if they're watching (may be null)
+    static std::atomic<StageHistograms *> attached;
+
+    // When the newest frame we've recorded was received
+    static std::atomic<std::int64_t> lastRecordedNs;
+};
+
+} // namespace creatures
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace creatures {
+
+/**
+ * When a frame of input passed each point on its way from the network to a
+ * servo
+ *
+ * Every stamp is nanoseconds on the steady clock. Zero means that point
+ * hasn't been reached yet. A frame that was never stamped (it didn't come in
+ * over e1.31) isn't traced at all.
+ */
+struct MotionTimestamps {
+    std::int64_t receivedNs = 0;  // The packet arrived (the kernel's time, if it told us)
+    std::int64_t handedOffNs = 0; // The e1.31 client gave it to the controller
+    std::int64_t mappedNs = 0;    // The creature worker turned it into servo positions
+    std::int64_t tickedNs = 0;    // The control loop picked those positions up
+
+    [[nodiscard]] bool isTraced() const { return receivedNs != 0; }
+};
+
+} // namespace creatures
@@ -10,6 +10,7 @@
 #include "io/SerialHandler.h"
 #include "logging/Logger.h"
 #include "util/MessageQueue.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 #include "util/thread_name.h"
 
@@ -31,9 +32,15 @@ ServoModuleHandler::ServoModuleHandler(
     logger->info("creating a new ServoModuleHandler for module {} on node {}", UARTDevice::moduleNameToString(moduleId),
                  this->deviceNode);
 
-    // Make our queues
-    this->outgoingQueue = std::make_shared<MessageQueue<Message>>();
-    this->incomingQueue = std::make_shared<MessageQueue<Message>>();
+    // Make our queues. Both are single-producer / single-consumer rings: the
+    // SerialReader fills incomingQueue and our own thread drains it, while the
+    // MessageRouter (which serializes everyone who wants to talk to this
+    // module) fills outgoingQueue and the SerialWriter drains it.
+    this->outgoingQueue = std::make_shared<SpscQueue<Message>>(SERIAL_QUEUE_CAPACITY);
+    this->incomingQueue = std::make_shared<SpscQueue<Message>>(SERIAL_QUEUE_CAPACITY);
+
+    // Positions skip the line: the router keeps only the newest one here
+    this->pendingPosition = std::make_shared<io::PositionSlot>();
 
     this->messageRouter->setHandlerState(this->moduleId, creatures::io::MotorHandlerState::idle);
 
@@ -56,7 +63,7 @@ void ServoModuleHandler::init() {
 
     // Create the SerialHandler
     this->serialHandler = std::make_shared<SerialHandler>(logger, this->deviceNode, this->moduleId, this->outgoingQueue,
-                                                          this->incomingQueue);
+                                                          this->incomingQueue, this->pendingPosition);
 
     this->messageRouter->setHandlerState(this->moduleId, creatures::io::MotorHandlerState::awaitingConfiguration);
 }
@@ -72,14 +79,14 @@ void ServoModuleHandler::shutdown() {
     stop_requested.store(true);
 
     // Request shutdown on queues to wake up blocked threads
+    // (Anything still sitting in the rings is thrown away when they're destroyed;
+    // only their consumers are allowed to clear them.)
     if (this->incomingQueue) {
         this->incomingQueue->request_shutdown();
-        this->incomingQueue->clear();
     }
 
     if (this->outgoingQueue) {
         this->outgoingQueue->request_shutdown();
-        this->outgoingQueue->clear();
     }
 
     // Tell the message router we've stopped
@@ -91,12 +98,6 @@ void ServoModuleHandler::shutdown() {
         this->serialHandler->shutdown();
     }
 
-    // Shut down our message processor
-    if (this->messageProcessor) {
-        logger->debug("Shutting down MessageProcessor for module {}", UARTDevice::moduleNameToString(this->moduleId));
-        this->messageProcessor->shutdown();
-    }
-
     // Call parent shutdown to clean up our main thread
     logger->debug("Shutting down main thread for module {}", UARTDevice::moduleNameToString(this->moduleId));
     StoppableThread::shutdown();
@@ -111,10 +112,8 @@ void ServoModuleHandler::start() {
         return;
     }
 
-    if (this->messageProcessor) {
-        this->messageProcessor->start();
-    }
-
+    // Our own thread is the one and only consumer of the incoming ring, so the
+    // message processor doesn't get a thread of its own - we call into it.
     if (this->serialHandler) {
         this->serialHandler->start();
     }
@@ -122,9 +121,23 @@ void ServoModuleHandler::start() {
     creatures::StoppableThread::start();
 }
 
-std::shared_ptr<MessageQueue<Message>> ServoModuleHandler::getIncomingQueue() { return this->incomingQueue; }
+std::shared_ptr<SpscQueue<Message>> ServoModuleHandler::getIncomingQueue() { return this->incomingQueue; }
+
+std::shared_ptr<SpscQueue<Message>> ServoModuleHandler::getOutgoingQueue() { return this->outgoingQueue; }
+
+std::shared_ptr<io::PositionSlot> ServoModuleHandler::getPendingPosition() { return this->pendingPosition; }
+
+std::shared_ptr<io::SerialPortStats> ServoModuleHandler::getSerialStats() {
+    return this->serialHandler ? this->serialHandler->getStats() : nullptr;
+}
+
+const MessageProcessor *ServoModuleHandler::getMessageProcessor() const { return this->messageProcessor.get(); }
 
-std::shared_ptr<MessageQueue<Message>> ServoModuleHandler::getOutgoingQueue() { return this->outgoingQueue; }
+void ServoModuleHandler::setCapture(const std::shared_ptr<replay::CaptureWriter> &capture) {
+    if (this->serialHandler) {
+        this->serialHandler->setCapture(capture);
+    }
+}
 
 Result<bool> ServoModuleHandler::firmwareReadyForInitialization(u32 firmwareVer) {
     // Don't process if we're shutting down
@@ -147,6 +160,10 @@ Result<bool> ServoModuleHandler::firmwareReadyForInitialization(u32 firmwareVer)
     // Save the firmware version
     this->firmwareVersion = firmwareVer;
 
+    // Whatever we were speaking before, a freshly started firmware gets text
+    // until it tells us otherwise in its READY
+    this->messageRouter->negotiateFraming(this->moduleId, false);
+
     logger->info("firmware is ready for initialization on module {} (version {}, Dynamixel {})",
                  UARTDevice::moduleNameToString(getModuleName()), firmwareVer,
                  firmwareVer >= DYNAMIXEL_MIN_FIRMWARE_VERSION ? "supported" : "not supported");
@@ -181,7 +198,7 @@ Result<bool> ServoModuleHandler::firmwareReadyForInitialization(u32 firmwareVer)
     creatures::io::Message message =
         creatures::io::Message(getModuleName(), creatureConfigCommand.toMessageWithChecksum());
 
-    auto sendResult = this->messageRouter->sendMessageToCreature(message);
+    auto sendResult = this->messageRouter->sendMessageToCreature(std::move(message));
     if (!sendResult.isSuccess()) {
         logger->critical("Failed to send the creature configuration to the firmware: {}",
                          sendResult.getError()->getMessage());
@@ -190,7 +207,7 @@ Result<bool> ServoModuleHandler::firmwareReadyForInitialization(u32 firmwareVer)
     return Result<bool>{true};
 }
 
-void ServoModuleHandler::firmwareReadyToOperate() {
+void ServoModuleHandler::firmwareReadyToOperate(bool firmwareSupportsBinaryFraming) {
     // Don't process if we're shutting down
     if (is_shutting_down.load()) {
         logger->warn("Firmware ready signal received while shutting down");
@@ -200,6 +217,7 @@ void ServoModuleHandler::firmwareReadyToOperate() {
     logger->info("firmware is ready to operate");
     this->ready.store(true);
     this->configured.store(true);
+    this->messageRouter->negotiateFraming(this->moduleId, firmwareSupportsBinaryFraming);
     this->messageRouter->setHandlerState(this->moduleId, creatures::io::MotorHandlerState::ready);
 }
 
@@ -234,8 +252,10 @@ void ServoModuleHandler::run() {
         // timeout so we can hop out if we need to stop
         auto messageOpt = this->incomingQueue->pop_timeout(std::chrono::milliseconds(100));
 
+        // We're the only one who takes from this queue, so every line the
+        // firmware sends is processed exactly once, in order
         if (messageOpt.has_value()) {
-            auto incomingMessage = messageOpt.value();
+            const auto &incomingMessage = messageOpt.value();
             this->logger->trace("incoming message: {}", incomingMessage.payload);
 
             // Go process it!
@@ -6,10 +6,12 @@
 #include "controller/Controller.h"
 #include "io/Message.h"
 #include "io/MessageRouter.h"
+#include "io/PositionSlot.h"
 #include "io/SerialHandler.h"
 #include "logging/Logger.h"
 #include "server/ServerMessage.h"
 #include "util/MessageQueue.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 
 class Controller;
@@ -51,18 +53,46 @@ class ServoModuleHandler : public StoppableThread, public std::enable_shared_fro
     /**
      * Return a pointer to our incoming queue for the processor to use
      *
-     * @return a `MessageQueue<Message>` for incoming messages FROM the remote
+     * @return a `SpscQueue<Message>` for incoming messages FROM the remote
      * device
      */
-    std::shared_ptr<MessageQueue<Message>> getIncomingQueue();
+    std::shared_ptr<SpscQueue<Message>> getIncomingQueue();
 
     /**
      * Return a pointer to our incoming queue for the processor to use
      *
-     * @return a `MessageQueue<Message>` for incoming messages TO the remote
+     * @return a `SpscQueue<Message>` for incoming messages TO the remote
      * device
      */
-    std::shared_ptr<MessageQueue<Message>> getOutgoingQueue();
+    std::shared_ptr<SpscQueue<Message>> getOutgoingQueue();
+
+    /**
+     * Where the newest position frame for the remote device waits to go out
+     *
+     * @return the slot the message router should put positions in
+     */
+    std::shared_ptr<io::PositionSlot> getPendingPosition();
+
+    /**
+     * How much has gone in and out of our serial port
+     *
+     * @return the stats, or nullptr if `init()` hasn't been called yet
+     */
+    std::shared_ptr<io::SerialPortStats> getSerialStats();
+
+    /**
+     * The message processor our thread hands incoming lines to
+     *
+     * @return the processor, or nullptr if `init()` hasn't been called yet
+     */
+    [[nodiscard]] const MessageProcessor *getMessageProcessor() const;
+
+    /**
+     * Capture our serial traffic. Call it between `init()` and `start()`.
+     *
+     * @param capture where to capture it
+     */
+    void setCapture(const std::shared_ptr<replay::CaptureWriter> &capture);
 
     /**
      * Send a message back to the controller
@@ -85,8 +115,11 @@ class ServoModuleHandler : public StoppableThread, public std::enable_shared_fro
      * @brief Tells the controller that the firmware is ready to operate
      *
      * This is set by ReadyHandler.
+     *
+     * @param firmwareSupportsBinaryFraming true if the firmware said it can
+     * take binary frames in its READY message
      */
-    void firmwareReadyToOperate();
+    void firmwareReadyToOperate(bool firmwareSupportsBinaryFraming = false);
 
     /**
      * Get the module name of the module we're controlling
@@ -151,14 +184,20 @@ class ServoModuleHandler : public StoppableThread, public std::enable_shared_fro
     std::shared_ptr<SerialHandler> serialHandler;
 
     /**
-     * A `MessageQueue<Message>` for outgoing messages TO the remote device
+     * A `SpscQueue<Message>` for outgoing messages TO the remote device
+     */
+    std::shared_ptr<SpscQueue<Message>> outgoingQueue;
+
+    /**
+     * The newest position frame for the remote device. Only the latest one is
+     * worth sending, so they don't queue up in `outgoingQueue`.
      */
-    std::shared_ptr<MessageQueue<Message>> outgoingQueue;
+    std::shared_ptr<io::PositionSlot> pendingPosition;
 
     /**
-     * A `MessageQueue<Message>` for incoming messages FROM the remote device
+     * A `SpscQueue<Message>` for incoming messages FROM the remote device
      */
-    std::shared_ptr<MessageQueue<Message>> incomingQueue;
+    std::shared_ptr<SpscQueue<Message>> incomingQueue;
 
     /**
      * The message router we're using to route messages from our device to the
@@ -167,7 +206,7 @@ class ServoModuleHandler : public StoppableThread, public std::enable_shared_fro
     std::shared_ptr<creatures::io::MessageRouter> messageRouter;
 
     /*
-     * Our message processor
+     * Our message processor. It doesn't have a thread; ours calls into it.
      */
     std::unique_ptr<creatures::MessageProcessor> messageProcessor;
 
@@ -0,0 +1,177 @@
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "creature/MotorType.h"
+#include "io/BinaryFraming.h"
+
+#include "PositionFrameEncoder.h"
+
+namespace creatures::commands {
+
+namespace {
+
+/**
+ * Add up a run of characters the same way `ICommand::getChecksum()` does
+ */
+u16 sumOf(const char *start, const char *end) {
+    u16 checksum = 0;
+    for (const char *c = start; c < end; c++) {
+        checksum += *c;
+    }
+    return checksum;
+}
+
+} // namespace
+
+PositionFrameEncoder::PositionFrameEncoder(std::shared_ptr<Logger> _logger, // NOLINT(*-pass-by-value)
+                                           creatures::config::UARTDevice::module_name _module,
+                                           const creatures::device::ServoTable &_table)
+    : logger(_logger), module(_module), currentMicroseconds(_table.currentMicroseconds),
+      firstRow(_table.getModuleSpan(_module).first) {
+
+    const size_t count = _table.getModuleSpan(_module).count;
+    slots.reserve(count);
+    for (size_t row = firstRow; row < firstRow + count; row++) {
+        Slot slot{};
+        slot.pin = static_cast<u8>(_table.pin[row]);
+        slot.dynamixel = _table.type[row] == creatures::creature::motor_type::dynamixel;
+
+        char *cursor = slot.prefix;
+        *cursor++ = '\t';
+        if (slot.dynamixel) {
+            *cursor++ = 'D';
+        }
+        cursor = std::to_chars(cursor, slot.prefix + sizeof(slot.prefix) - 1, _table.pin[row]).ptr;
+        *cursor++ = ' ';
+
+        slot.prefixLength = static_cast<u8>(cursor - slot.prefix);
+        slot.prefixChecksum = sumOf(slot.prefix, cursor);
+        slot.selected = true;
+        slots.push_back(slot);
+    }
+
+    // Size the buffer for the worst case once, so encode() never has to grow it
+    buffer.resize(3 + slots.size() * MaxTokenLength + MaxChecksumLength);
+
+    // ...and the same for the binary frame: type, two counts, three bytes a
+    // servo, and the CRC. COBS adds a little, and then there's the delimiters.
+    binaryPayload.resize(1 + 1 + 1 + slots.size() * 3 + 2);
+    binaryBuffer.resize(1 + creatures::io::BinaryFraming::maxCobsLength(binaryPayload.size()) + 1);
+
+    logger->debug("built a position frame encoder for module {} with {} servos ({} byte buffer)",
+                  creatures::config::UARTDevice::moduleNameToString(module), slots.size(), buffer.size());
+}
+
+size_t PositionFrameEncoder::selectServos(u32 deadband, bool keyframe) {
+    size_t selected = 0;
+
+    const u32 *current = currentMicroseconds.data() + firstRow;
+    for (size_t i = 0; i < slots.size(); i++) {
+        auto &slot = slots[i];
+        const u32 position = current[i];
+        const u32 distance = position > slot.lastSentMicroseconds ? position - slot.lastSentMicroseconds
+                                                                  : slot.lastSentMicroseconds - position;
+
+        slot.selected = keyframe || !slot.sent || distance > deadband;
+        if (slot.selected) {
+            selected++;
+        }
+    }
+
+    return selected;
+}
+
+u32 PositionFrameEncoder::takePosition(size_t index) {
+    auto &slot = slots[index];
+    const u32 position = currentMicroseconds[firstRow + index];
+    slot.lastSentMicroseconds = position;
+    slot.sent = true;
+    return position;
+}
+
+std::string_view PositionFrameEncoder::encode() {
+
+    char *const start = buffer.data();
+    char *const end = start + buffer.size();
+    char *cursor = start;
+
+    // The 'POS' command prefix
+    std::memcpy(cursor, "POS", 3);
+    cursor += 3;
+    u16 checksum = 'P' + 'O' + 'S';
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        const auto &slot = slots[i];
+        if (!slot.selected) {
+            continue;
+        }
+
+        std::memcpy(cursor, slot.prefix, slot.prefixLength);
+        cursor += slot.prefixLength;
+        checksum += slot.prefixChecksum;
+
+        char *numberStart = cursor;
+        cursor = std::to_chars(cursor, end, takePosition(i)).ptr;
+        checksum += sumOf(numberStart, cursor);
+    }
+
+    // ...and the checksum of everything before it
+    std::memcpy(cursor, "\tCS ", 4);
+    cursor += 4;
+    cursor = std::to_chars(cursor, end, checksum).ptr;
+
+    return {start, static_cast<size_t>(cursor - start)};
+}
+
+std::string_view PositionFrameEncoder::encodeBinary() {
+    using namespace creatures::io;
+
+    u8 *cursor = binaryPayload.data();
+    *cursor++ = BinaryFraming::PositionFrameType;
+
+    // PWM servos first, then the Dynamixels, each group led by its count
+    auto writeGroup = [&cursor, this](bool dynamixels) {
+        u8 *count = cursor++;
+        *count = 0;
+        for (size_t i = 0; i < slots.size(); i++) {
+            const auto &slot = slots[i];
+            if (!slot.selected || slot.dynamixel != dynamixels) {
+                continue;
+            }
+
+            const u32 position = std::min<u32>(takePosition(i), UINT16_MAX);
+            *cursor++ = slot.pin;
+            *cursor++ = static_cast<u8>(position & 0xFF);
+            *cursor++ = static_cast<u8>(position >> 8);
+            (*count)++;
+        }
+    };
+    writeGroup(false);
+    writeGroup(true);
+
+    const u16 crc = BinaryFraming::crc16(binaryPayload.data(), static_cast<size_t>(cursor - binaryPayload.data()));
+    *cursor++ = static_cast<u8>(crc & 0xFF);
+    *cursor++ = static_cast<u8>(crc >> 8);
+
+    // Now stuff it and wrap it in delimiters
+    auto *out = reinterpret_cast<u8 *>(binaryBuffer.data());
+    out[0] = BinaryFraming::FrameDelimiter;
+    const size_t encodedLength = BinaryFraming::encodeCobs(
+        binaryPayload.data(), static_cast<size_t>(cursor - binaryPayload.data()), out + 1);
+    out[1 + encodedLength] = BinaryFraming::FrameDelimiter;
+
+    return {binaryBuffer.data(), encodedLength + 2};
+}
+
+creatures::config::UARTDevice::module_name PositionFrameEncoder::getModule() const { return module; }
+
+size_t PositionFrameEncoder::getNumberOfServos() const { return slots.size(); }
+
+} // namespace creatures::commands
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "controller-config.h"
+
+#include "config/UARTDevice.h"
+#include "device/ServoTable.h"
+#include "logging/Logger.h"
+
+namespace creatures::commands {
+
+/**
+ * Builds the `POS` frame for one module, every tick, without allocating
+ *
+ * This produces exactly the same bytes as a `SetServoPositions` command's
+ * `toMessageWithChecksum()`, but everything that doesn't change from frame to
+ * frame (which servos live on the module and what their tokens look like) is
+ * worked out once up front. Each call to `encode()` just writes the current
+ * positions into a buffer that was sized when we were built, adding up the
+ * checksum as it goes.
+ *
+ * Positions are read straight out of the creature's `ServoTable`. A module's
+ * servos are a run of rows next to each other, so each frame is one walk down
+ * the `currentMicroseconds` column, no `Servo` objects involved.
+ *
+ * The control loop calls this at the servo update rate, so it has to be as
+ * quick as a bunny and never stop to ask the allocator for anything.
+ *
+ * By default every frame has every servo in it. If `selectServos()` is used,
+ * only the servos it picked go into the frame, which lets the controller skip
+ * the ones that are sitting still. The firmware is happy with a partial list.
+ */
+class PositionFrameEncoder {
+
+  public:
+    /**
+     * @param _logger our logger
+     * @param _module the module this encoder builds frames for
+     * @param _table the table the module's servos live in. It has to outlive
+     *               us, and can't be rebuilt while we're around.
+     */
+    PositionFrameEncoder(std::shared_ptr<Logger> _logger, creatures::config::UARTDevice::module_name _module,
+                         const creatures::device::ServoTable &_table);
+
+    /**
+     * Pick which servos go into the next frame
+     *
+     * A servo is picked if it's never been sent, or if it's moved more than
+     * `deadband` microseconds from what we last sent it. A keyframe picks all
+     * of them no matter what, which keeps the firmware from going too long
+     * without hearing about a servo.
+     *
+     * @param deadband how far a servo has to move before it's worth sending
+     * @param keyframe if true, pick every servo
+     * @return how many servos were picked. If it's zero there's no point in
+     * sending a frame at all.
+     */
+    size_t selectServos(u32 deadband, bool keyframe);
+
+    /**
+     * Write the current position of every selected servo into our buffer
+     *
+     * @return a view of the finished `POS ... CS n` line. It stays valid until
+     * the next call to `encode()`.
+     */
+    std::string_view encode();
+
+    /**
+     * Write the current position of every selected servo into a binary frame
+     *
+     * This is the same information as `encode()` but laid out for firmware
+     * that has said it understands binary framing:
+     *
+     *     type (0x01) | pwmCount | (pin, us LE16) * pwmCount
+     *                 | dxlCount | (id, position LE16) * dxlCount | crc16 LE
+     *
+     * ...COBS-encoded and wrapped in zero bytes (see `io/BinaryFraming.h`).
+     * A full 16 servo frame is 56 bytes on the wire instead of ~130.
+     *
+     * @return a view of the finished frame, delimiters and all. It stays valid
+     * until the next call to `encodeBinary()`.
+     */
+    std::string_view encodeBinary();
+
+    [[nodiscard]] creatures::config::UARTDevice::module_name getModule() const;
+
+    [[nodiscard]] size_t getNumberOfServos() const;
+
+  private:
+    // The longest a servo token can be: a tab, an optional 'D', a u16 pin, a
+    // space, and a u32 position
+    static constexpr size_t MaxTokenLength = 1 + 1 + 5 + 1 + 10;
+
+    // The longest the checksum trailer can be: "\tCS " and a u16
+    static constexpr size_t MaxChecksumLength = 4 + 5;
+
+    struct Slot {
+        // Where this servo is in the binary frame
+        u8 pin;
+        bool dynamixel;
+
+        // "\t3 " or "\tD3 ", worked out once
+        char prefix[1 + 1 + 5 + 1];
+        u8 prefixLength;
+        u16 prefixChecksum;
+
+        // Does this servo go into the next frame?
+        bool selected;
+
+        // What we last told the firmware, so we know when it's changed
+        bool sent;
+        u32 lastSentMicroseconds;
+    };
+
+    std::shared_ptr<Logger> logger;
+    creatures::config::UARTDevice::module_name module;
+    std::vector<Slot> slots;
+    std::string buffer;
+
+    // Our servos' current positions: the table's column, starting at our
+    // module's first row. Slot i is row firstRow + i.
+    const std::vector<u32> &currentMicroseconds;
+    size_t firstRow = 0;
+
+    // The binary frame before COBS, and the finished frame on the wire
+    std::vector<u8> binaryPayload;
+    std::string binaryBuffer;
+
+    /**
+     * Get a servo's position for the frame and remember that we sent it
+     */
+    u32 takePosition(size_t index);
+};
+
+} // namespace creatures::commands
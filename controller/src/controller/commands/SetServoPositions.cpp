@@ -34,7 +34,9 @@ void SetServoPositions::addServoPosition(const creatures::ServoPosition &servoPo
     }
 
     this->servoPositions.push_back(servoPosition);
-    logger->trace("Added servo position: {}", servoPosition.toString());
+    if (logger->isTraceEnabled()) {
+        logger->trace("Added servo position: {}", servoPosition.toString());
+    }
 }
 
 std::string SetServoPositions::toMessage() {
@@ -1,7 +1,11 @@
 
+#include <algorithm>
+#include <chrono>
+
 #include "controller-config.h"
 
 #include "config/UARTDevice.h"
+#include "controller/MotionLatency.h"
 #include "creature/Creature.h"
 #include "creature/CreatureException.h"
 #include "logging/Logger.h"
@@ -24,8 +28,9 @@ Creature::Creature(const std::shared_ptr<creatures::Logger> &logger) : logger(lo
 void Creature::init(const std::shared_ptr<Controller> &c) {
     this->controller = c;
 
-    // Save a reference to the input queue for quick actions
-    this->inputQueue = c->getInputQueue();
+    // Save a reference to the input mailbox for quick actions
+    this->inputMailbox = c->getInputMailbox();
+    this->mappedTimestamps = c->getMappedTimestampsMailbox();
 
     logger->debug("init done, creature exists");
 }
@@ -40,6 +45,11 @@ void Creature::start() {
 void Creature::shutdown() {
     logger->info("asking the creature worker thread to stop");
     stop_requested.store(true);
+
+    // Don't leave the worker napping on the mailbox
+    if (inputMailbox != nullptr) {
+        inputMailbox->request_shutdown();
+    }
 }
 
 u16 Creature::convertInputValueToServoValue(u8 inputValue) {
@@ -57,11 +67,12 @@ Creature::getRequestedServoPositions(creatures::config::UARTDevice::module_name
     // Create a vector to hold the filtered positions into
     std::vector<creatures::ServoPosition> positions;
 
-    // Quickly walk the servos and return the number of ticks we want next
-    for (const auto &[key, servo] : servos) {
-        if (servo->getOutputModule() == module) {
-            positions.emplace_back(servo->getOutputLocation(), servo->getCurrentMicroseconds());
-        }
+    // This module's servos are all next to each other in the table
+    const auto span = servoTable.getModuleSpan(module);
+    positions.reserve(span.count);
+    for (size_t row = span.first; row < span.first + span.count; row++) {
+        positions.emplace_back(ServoSpecifier(servoTable.module[row], servoTable.pin[row], servoTable.type[row]),
+                               servoTable.currentMicroseconds[row]);
     }
 
     return positions;
@@ -69,18 +80,14 @@ Creature::getRequestedServoPositions(creatures::config::UARTDevice::module_name
 
 std::vector<creatures::ServoConfig> Creature::getServoConfigs(creatures::config::UARTDevice::module_name module) {
 
-    std::vector<creatures::ServoConfig> servoConfigs;
-    servoConfigs.reserve(servos.size());
+    const auto span = servoTable.getModuleSpan(module);
 
-    // Walk all of our servos and make a ServoConfig for each
-    for (const auto &[key, servo] : servos) {
-
-        // If it's not on the module we're looking for, skip it
-        if (servo->getOutputModule() != module) {
-            continue;
-        }
+    std::vector<creatures::ServoConfig> servoConfigs;
+    servoConfigs.reserve(span.count);
 
-        ServoConfig servoConfig = ServoConfig(logger, servo);
+    // Make a ServoConfig for each servo on this module
+    for (size_t row = span.first; row < span.first + span.count; row++) {
+        ServoConfig servoConfig = ServoConfig(logger, servoTable.getServo(row));
         servoConfigs.emplace_back(servoConfig);
     }
 
@@ -89,10 +96,8 @@ std::vector<creatures::ServoConfig> Creature::getServoConfigs(creatures::config:
 
 void Creature::calculateNextServoPositions() {
 
-    // Quickly walk the servos and return the number of ticks we want next
-    for (const auto &[key, servo] : servos) {
-        servo->calculateNextTick();
-    }
+    // One straight pass down the table
+    servoTable.calculateNextTick();
 }
 
 std::shared_ptr<Servo> Creature::getServo(const std::string &servoName) { return servos[servoName]; }
@@ -149,6 +154,15 @@ void Creature::addServo(std::string servoName, const std::shared_ptr<Servo> &ser
                  creatures::config::UARTDevice::moduleNameToString(servo->getOutputLocation().module),
                  servo->getOutputLocation().pin);
     servos[servoName] = servo;
+
+    // Servos only get added while we're being built, so keeping the table in
+    // step every time is cheap and means it's never stale
+    std::vector<std::shared_ptr<Servo>> allServos;
+    allServos.reserve(servos.size());
+    for (const auto &[key, value] : servos) {
+        allServos.push_back(value);
+    }
+    servoTable.rebuild(allServos);
 }
 
 const std::string &Creature::getName() const { return name; }
@@ -203,6 +217,54 @@ void Creature::addInput(const creatures::Input &input) { inputs.push_back(input)
 
 std::vector<creatures::Input> Creature::getInputs() const { return inputs; }
 
+Result<std::vector<Creature::InputHandle>> Creature::resolveInputs(const std::vector<std::string> &names) const {
+
+    std::vector<InputHandle> handles;
+    handles.reserve(names.size());
+
+    for (const auto &inputName : names) {
+        auto found = std::find_if(inputs.begin(), inputs.end(),
+                                  [&inputName](const creatures::Input &input) { return input.getName() == inputName; });
+        if (found == inputs.end()) {
+            auto errorMessage = fmt::format("missing required input: {}", inputName);
+            logger->critical(errorMessage);
+            return Result<std::vector<InputHandle>>{
+                ControllerError(ControllerError::InvalidConfiguration, errorMessage)};
+        }
+        if (found->getSlot() >= creatures::InputFrame::numberOfSlots) {
+            auto errorMessage = fmt::format("input {} is on slot {}, which is past the end of a frame", inputName,
+                                            found->getSlot());
+            logger->critical(errorMessage);
+            return Result<std::vector<InputHandle>>{
+                ControllerError(ControllerError::InvalidConfiguration, errorMessage)};
+        }
+        handles.push_back(found->getSlot());
+    }
+
+    return Result<std::vector<InputHandle>>{handles};
+}
+
+Result<std::vector<Creature::ServoHandle>> Creature::resolveServos(const std::vector<std::string> &ids) const {
+
+    std::vector<ServoHandle> handles;
+    handles.reserve(ids.size());
+
+    for (const auto &servoId : ids) {
+        auto found = servos.find(servoId);
+        if (found == servos.end() || found->second == nullptr) {
+            auto errorMessage = fmt::format("missing required servo: {}", servoId);
+            logger->critical(errorMessage);
+            return Result<std::vector<ServoHandle>>{
+                ControllerError(ControllerError::InvalidConfiguration, errorMessage)};
+        }
+        handles.push_back(servoTable.findRow(*found->second));
+    }
+
+    return Result<std::vector<ServoHandle>>{handles};
+}
+
+void Creature::moveServo(ServoHandle servo, u16 position) { servoTable.getServo(servo)->move(position); }
+
 void Creature::worker() {
 
     setThreadName("creature_worker");
@@ -210,21 +272,16 @@ void Creature::worker() {
 
     while (!stop_requested.load()) {
 
-        auto incoming = inputQueue->pop();
-
-        logger->trace("creature got {} inputs", incoming.size());
-
-        // Make sure we got the inputs we're expecting
-        for (const auto &requiredInput : requiredInputs) {
-            if (incoming.find(requiredInput) == incoming.end()) {
-                logger->warn("missing required input: {}", requiredInput);
-                continue;
-            }
+        // Only ever the newest frame. If we fell behind, the ones we missed
+        // are already gone.
+        const creatures::InputFrame *incoming = inputMailbox->take_timeout(std::chrono::milliseconds(100));
+        if (incoming == nullptr) {
+            continue;
         }
 
 #if DEBUG_CREATURE_WORKER_LOOP
-        for (auto &input : incoming) {
-            logger->debug("got input: {}", input.second.toString());
+        for (const auto &input : inputs) {
+            logger->debug("got input: {} = {}", input.getName(), incoming->slots[input.getSlot()]);
         }
 
         // Debug: Dump all of the servos
@@ -234,9 +291,20 @@ void Creature::worker() {
         }
 #endif
 
-        mapInputsToServos(incoming);
+        mapInputsToServos(*incoming);
+
+        // Let the control loop know when this frame's positions were ready
+        if (incoming->timestamps.isTraced()) {
+            creatures::MotionTimestamps timestamps = incoming->timestamps;
+            timestamps.mappedNs = creatures::MotionLatency::now();
+            mappedTimestamps->post(timestamps);
+        }
     }
 
+    if (inputMailbox->overwritten() > 0) {
+        logger->info("{} of {} input frames were replaced before the creature got to them",
+                     inputMailbox->overwritten(), inputMailbox->posted());
+    }
     logger->info("Creature worker thread stopped");
 }
 
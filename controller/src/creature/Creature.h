@@ -16,15 +16,17 @@
 #include "config/UARTDevice.h"
 #include "controller/Controller.h"
 #include "controller/Input.h"
+#include "controller/InputFrame.h"
 #include "controller/commands/tokens/ServoConfig.h"
 #include "controller/commands/tokens/ServoPosition.h"
 #include "creature/Creature.h"
 #include "creature/MotorType.h"
 #include "device/Servo.h"
 #include "device/ServoSpecifier.h"
+#include "device/ServoTable.h"
 #include "device/Stepper.h"
 #include "logging/Logger.h"
-#include "util/MessageQueue.h"
+#include "util/LatestValueMailbox.h"
 
 class Controller;
 
@@ -95,9 +97,9 @@ class Creature {
     /**
      * @brief Get the current requested positions of the servos
      *
-     * This walks the map of servos and returns a vector of the number of each ticks
-     * that the creature would like the servos set to. This is called from the controller's
-     * worker thread.
+     * This walks the module's rows in the servo table and returns a vector of the number
+     * of each ticks that the creature would like the servos set to. This is called from
+     * the controller's worker thread.
      *
      * @param module the module to get the positions for
      *
@@ -105,6 +107,17 @@ class Creature {
      */
     std::vector<creatures::ServoPosition> getRequestedServoPositions(creatures::config::UARTDevice::module_name module);
 
+    /**
+     * @brief Get the table every servo's positions live in
+     *
+     * The control loop's frame encoders read each module's run of rows
+     * straight out of this every tick. It's only rebuilt while the creature
+     * is being set up.
+     *
+     * @return the servo table
+     */
+    [[nodiscard]] const creatures::device::ServoTable &getServoTable() const { return servoTable; }
+
     /**
      * @brief Gets a ServoConfig for each servo on a module
      *
@@ -196,10 +209,12 @@ class Creature {
     std::string description;
     creature_type type;
 
-    u16 positionMin;
-    u16 positionMax;
-    u16 positionDefault;
-    u16 servoUpdateFrequencyHz;
+    // The config always sets these, but a creature that's built by hand
+    // shouldn't be reading garbage if something's missed
+    u16 positionMin = MIN_POSITION;
+    u16 positionMax = MAX_POSITION;
+    u16 positionDefault = DEFAULT_POSITION;
+    u16 servoUpdateFrequencyHz = 50;
 
     u16 channelOffset;
     u8 audioChannel;
@@ -212,9 +227,14 @@ class Creature {
     std::vector<std::string> requiredInputs = {}; // Make sure this is set in the child class
 
     /**
-     * Message queue to send inputs to the creature
+     * Where the newest inputs show up for the creature
+     */
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::InputFrame>> inputMailbox;
+
+    /**
+     * Where we say when each frame's servo positions were ready
      */
-    std::shared_ptr<creatures::MessageQueue<std::unordered_map<std::string, creatures::Input>>> inputQueue;
+    std::shared_ptr<creatures::LatestValueMailbox<creatures::MotionTimestamps>> mappedTimestamps;
 
     std::vector<creatures::ServoPosition> servoPositions;
     std::shared_ptr<Controller> controller;
@@ -227,6 +247,13 @@ class Creature {
      * that it's not a ServoSpecifier.
      */
     std::unordered_map<std::string, std::shared_ptr<Servo>> servos;
+
+    /**
+     * The same servos, laid out for the control loop. This is what gets walked
+     * every frame; the map above is for looking things up by name.
+     */
+    creatures::device::ServoTable servoTable;
+
     std::vector<std::string> requiredServos = {}; // Must populate this in the child class
 
     std::unordered_map<std::string, std::shared_ptr<Stepper>> steppers;
@@ -236,9 +263,47 @@ class Creature {
 
     /**
      * Map incoming inputs to servo positions. Called by the worker loop
-     * each time a new set of inputs arrives from the input queue.
+     * each time a new frame arrives in the input mailbox.
+     *
+     * This runs on every frame, so look up anything it needs by name ahead of
+     * time (in `performPreFlightCheck()`) with `resolveInputs()` and
+     * `resolveServos()`, and only use the handles in here.
+     */
+    virtual void mapInputsToServos(const creatures::InputFrame &frame) = 0;
+
+    using InputHandle = u16;    ///< Where an input lives in an `InputFrame`
+    using ServoHandle = size_t; ///< Which row a servo is in the servo table
+
+    /**
+     * Look up a set of inputs by name, once, so the per-frame code can just index
+     *
+     * @param names the inputs to find
+     * @return a handle for each name, in the same order, or an error naming the
+     * first one this creature doesn't have
+     */
+    Result<std::vector<InputHandle>> resolveInputs(const std::vector<std::string> &names) const;
+
+    /**
+     * Look up a set of servos by id, once, so the per-frame code can just index
+     *
+     * The handles are rows in the servo table, so only do this once all of the
+     * servos have been added.
+     *
+     * @param ids the servos to find
+     * @return a handle for each id, in the same order, or an error naming the
+     * first one this creature doesn't have
+     */
+    Result<std::vector<ServoHandle>> resolveServos(const std::vector<std::string> &ids) const;
+
+    /**
+     * Get an input's value out of a frame
+     */
+    static u8 inputValue(const creatures::InputFrame &frame, InputHandle input) { return frame.slots[input]; }
+
+    /**
+     * Move a servo by its handle
      */
-    virtual void mapInputsToServos(const std::unordered_map<std::string, creatures::Input> &inputs) = 0;
+    void moveServo(ServoHandle servo, u16 position);
 
     u8 numberOfJoints;
 
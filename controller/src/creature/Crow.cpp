@@ -11,6 +11,7 @@
 Crow::Crow(const std::shared_ptr<creatures::Logger> &logger) : Creature(logger) {
 
     // Start with Parrot's inputs/servos as a baseline -- adjust when real hardware is wired
+    // (The order of these two matters; it's what In and Out index into)
     requiredInputs = {"head_height", "head_tilt", "neck_rotate", "body_lean", "beak", "chest", "stand_rotate"};
     requiredServos = {"neck_left", "neck_right", "neck_rotate", "body_lean", "beak"};
 
@@ -30,14 +31,19 @@ creatures::Result<std::string> Crow::performPreFlightCheck() {
         logger->debug("servo: {}", id);
     }
 
-    for (const auto &requiredServo : requiredServos) {
-        if (servos.find(requiredServo) == servos.end()) {
-            auto errorMessage = fmt::format("missing required servo: {}", requiredServo);
-            logger->critical(errorMessage);
-            return creatures::Result<std::string>{
-                creatures::ControllerError(creatures::ControllerError::InvalidConfiguration, errorMessage)};
-        }
+    // Look up everything mapInputsToServos() touches once, here, so it never
+    // has to hash a string per frame (or insert a servo on a typo)
+    auto inputResult = resolveInputs(requiredInputs);
+    if (!inputResult.isSuccess()) {
+        return creatures::Result<std::string>{inputResult.getError().value()};
     }
+    inputHandles = inputResult.getValue().value();
+
+    auto servoResult = resolveServos(requiredServos);
+    if (!servoResult.isSuccess()) {
+        return creatures::Result<std::string>{servoResult.getError().value()};
+    }
+    servoHandles = servoResult.getValue().value();
 
     if (!head.has_value()) {
         auto errorMessage = "DifferentialHead not configured (missing head_offset_max in config?)";
@@ -50,19 +56,21 @@ creatures::Result<std::string> Crow::performPreFlightCheck() {
     return creatures::Result<std::string>{"Crow is ready to fly!"};
 }
 
-void Crow::mapInputsToServos(const std::unordered_map<std::string, creatures::Input> &inputs) {
+void Crow::mapInputsToServos(const creatures::InputFrame &frame) {
 
-    u8 height = inputs.at("head_height").getIncomingRequest();
-    u8 tilt = inputs.at("head_tilt").getIncomingRequest();
+    u8 height = inputValue(frame, inputHandles[In::headHeight]);
+    u8 tilt = inputValue(frame, inputHandles[In::headTilt]);
 
     u16 headHeight = head->convertToHeadHeight(convertInputValueToServoValue(height));
     int32_t headTilt = head->convertToHeadTilt(convertInputValueToServoValue(tilt));
 
     auto headPosition = head->calculateHeadPosition(headHeight, headTilt);
 
-    servos["neck_left"]->move(headPosition.left);
-    servos["neck_right"]->move(headPosition.right);
-    servos["neck_rotate"]->move(convertInputValueToServoValue(inputs.at("neck_rotate").getIncomingRequest()));
-    servos["body_lean"]->move(convertInputValueToServoValue(inputs.at("body_lean").getIncomingRequest()));
-    servos["beak"]->move(convertInputValueToServoValue(inputs.at("beak").getIncomingRequest()));
+    moveServo(servoHandles[Out::neckLeft], headPosition.left);
+    moveServo(servoHandles[Out::neckRight], headPosition.right);
+    moveServo(servoHandles[Out::neckRotate],
+              convertInputValueToServoValue(inputValue(frame, inputHandles[In::neckRotate])));
+    moveServo(servoHandles[Out::bodyLean],
+              convertInputValueToServoValue(inputValue(frame, inputHandles[In::bodyLean])));
+    moveServo(servoHandles[Out::beak], convertInputValueToServoValue(inputValue(frame, inputHandles[In::beak])));
 }
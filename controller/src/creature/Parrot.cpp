@@ -11,6 +11,7 @@
 Parrot::Parrot(const std::shared_ptr<creatures::Logger> &logger) : Creature(logger) {
 
     // Set up our expectations for configuration for clean error checking
+    // (The order of these two matters; it's what In and Out index into)
     requiredInputs = {"head_height", "head_tilt", "neck_rotate", "body_lean", "beak", "chest", "stand_rotate"};
     requiredServos = {"neck_left", "neck_right", "neck_rotate", "body_lean", "beak"};
 
@@ -32,15 +33,19 @@ creatures::Result<std::string> Parrot::performPreFlightCheck() {
         logger->debug("servo: {}", id);
     }
 
-    // Do some error checking to make sure we have our servos
-    for (const auto &requiredServo : requiredServos) {
-        if (servos.find(requiredServo) == servos.end()) {
-            auto errorMessage = fmt::format("missing required servo: {}", requiredServo);
-            logger->critical(errorMessage);
-            return creatures::Result<std::string>{
-                creatures::ControllerError(creatures::ControllerError::InvalidConfiguration, errorMessage)};
-        }
+    // Look up everything mapInputsToServos() touches once, here, so it never
+    // has to hash a string per frame (or insert a servo on a typo)
+    auto inputResult = resolveInputs(requiredInputs);
+    if (!inputResult.isSuccess()) {
+        return creatures::Result<std::string>{inputResult.getError().value()};
     }
+    inputHandles = inputResult.getValue().value();
+
+    auto servoResult = resolveServos(requiredServos);
+    if (!servoResult.isSuccess()) {
+        return creatures::Result<std::string>{servoResult.getError().value()};
+    }
+    servoHandles = servoResult.getValue().value();
 
     if (!head.has_value()) {
         auto errorMessage = "DifferentialHead not configured (missing head_offset_max in config?)";
@@ -53,10 +58,10 @@ creatures::Result<std::string> Parrot::performPreFlightCheck() {
     return creatures::Result<std::string>{"Parrot is ready to fly!"};
 }
 
-void Parrot::mapInputsToServos(const std::unordered_map<std::string, creatures::Input> &inputs) {
+void Parrot::mapInputsToServos(const creatures::InputFrame &frame) {
 
-    u8 height = inputs.at("head_height").getIncomingRequest();
-    u8 tilt = inputs.at("head_tilt").getIncomingRequest();
+    u8 height = inputValue(frame, inputHandles[In::headHeight]);
+    u8 tilt = inputValue(frame, inputHandles[In::headTilt]);
 
 #if DEBUG_CREATURE_WORKER_LOOP
     logger->debug("head height: {}, head tilt: {}", height, tilt);
@@ -72,11 +77,13 @@ void Parrot::mapInputsToServos(const std::unordered_map<std::string, creatures::
     auto headPosition = head->calculateHeadPosition(headHeight, headTilt);
 
     // Update our servos so that they'll get picked up on the next frame
-    servos["neck_left"]->move(headPosition.left);
-    servos["neck_right"]->move(headPosition.right);
-    servos["neck_rotate"]->move(convertInputValueToServoValue(inputs.at("neck_rotate").getIncomingRequest()));
-    servos["body_lean"]->move(convertInputValueToServoValue(inputs.at("body_lean").getIncomingRequest()));
-    servos["beak"]->move(convertInputValueToServoValue(inputs.at("beak").getIncomingRequest()));
+    moveServo(servoHandles[Out::neckLeft], headPosition.left);
+    moveServo(servoHandles[Out::neckRight], headPosition.right);
+    moveServo(servoHandles[Out::neckRotate],
+              convertInputValueToServoValue(inputValue(frame, inputHandles[In::neckRotate])));
+    moveServo(servoHandles[Out::bodyLean],
+              convertInputValueToServoValue(inputValue(frame, inputHandles[In::bodyLean])));
+    moveServo(servoHandles[Out::beak], convertInputValueToServoValue(inputValue(frame, inputHandles[In::beak])));
 
 #if DEBUG_CREATURE_WORKER_LOOP
     logger->debug("servos updated");
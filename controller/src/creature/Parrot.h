@@ -3,10 +3,12 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "controller-config.h"
 
 #include "Creature.h"
+#include "controller/InputFrame.h"
 #include "creature/DifferentialHead.h"
 
 #include "device/Servo.h"
@@ -23,8 +25,21 @@ class Parrot : public creatures::creature::Creature {
 
     void applyConfig(const nlohmann::json &config) override;
 
-    void mapInputsToServos(const std::unordered_map<std::string, creatures::Input> &inputs) override;
+    void mapInputsToServos(const creatures::InputFrame &frame) override;
 
   private:
     std::optional<creatures::creature::DifferentialHead> head;
+
+    // Where each of these lands in requiredInputs / requiredServos, and so in
+    // the handles resolved from them
+    struct In {
+        enum : size_t { headHeight, headTilt, neckRotate, bodyLean, beak, chest, standRotate };
+    };
+    struct Out {
+        enum : size_t { neckLeft, neckRight, neckRotate, bodyLean, beak };
+    };
+
+    // Resolved once in performPreFlightCheck()
+    std::vector<InputHandle> inputHandles;
+    std::vector<ServoHandle> servoHandles;
 };
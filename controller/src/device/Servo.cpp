@@ -7,6 +7,7 @@
 
 // This module
 #include "Servo.h"
+#include "ServoSmoothingKernel.h"
 #include "ServoSpecifier.h"
 
 // Our modules
@@ -146,20 +147,22 @@ creatures::Result<std::string> Servo::move(u16 position) {
         position = MAX_POSITION - position;
 
     // Covert this to a desired microsecond
-    desired_microseconds = positionToMicroseconds(position);
+    desiredMicroseconds() = positionToMicroseconds(position);
 
     // Save the position for debugging
     current_position = position;
 
-    std::string successMessage = fmt::format("requesting servo on output module {}, pin {} to be set to "
-                                             "position {} ({}us)",
-                                             creatures::config::UARTDevice::moduleNameToString(outputLocation.module),
-                                             outputLocation.pin, current_position, desired_microseconds);
-    logger->trace(successMessage);
+    // This happens for every servo on every frame, so don't build any strings
+    // unless someone's going to read them
+    if (logger->isTraceEnabled()) {
+        logger->trace("requesting servo on output module {}, pin {} to be set to position {} ({}us)",
+                      creatures::config::UARTDevice::moduleNameToString(outputLocation.module), outputLocation.pin,
+                      current_position, desiredMicroseconds());
+    }
 
     number_of_moves = number_of_moves + 1;
 
-    return creatures::Result<std::string>{successMessage};
+    return creatures::Result<std::string>{"moved"};
 }
 
 u32 Servo::positionToMicroseconds(u16 position) {
@@ -186,9 +189,9 @@ u16 Servo::getPosition() const {
 
 u16 Servo::getDefaultMicroseconds() const { return this->default_microseconds; }
 
-u32 Servo::getDesiredMicroseconds() const { return desired_microseconds; }
+u32 Servo::getDesiredMicroseconds() const { return desiredMicroseconds(); }
 
-u32 Servo::getCurrentMicroseconds() const { return current_microseconds; }
+u32 Servo::getCurrentMicroseconds() const { return currentMicroseconds(); }
 
 float Servo::getSmoothingValue() const { return smoothingValue; }
 
@@ -196,15 +199,29 @@ void Servo::calculateNextTick() {
     // Dynamixel servos handle smoothing internally via Profile Velocity at 4kHz,
     // so skip host-side EMA smoothing and pass through the raw target position
     if (outputLocation.type == creatures::creature::motor_type::dynamixel) {
-        current_microseconds = desired_microseconds;
+        currentMicroseconds() = desiredMicroseconds();
         return;
     }
 
-    u32 last_tick = current_microseconds;
+    currentMicroseconds() =
+        creatures::device::smoothedMicroseconds(desiredMicroseconds(), currentMicroseconds(), smoothingValue);
+}
+
+void Servo::bindToTable(creatures::device::ServoTable *servoTable, size_t row) {
+    this->table = servoTable;
+    this->tableRow = row;
+}
+
+void Servo::unbindFromTable() {
+    if (table == nullptr) {
+        return;
+    }
 
-    current_microseconds =
-        lround(((double)desired_microseconds * (1.0 - smoothingValue)) + ((double)last_tick * smoothingValue));
-    // debug("-- set current_microseconds to {}", current_microseconds);
+    // Take our positions with us
+    desired_microseconds = table->desiredMicroseconds[tableRow];
+    current_microseconds = table->currentMicroseconds[tableRow];
+    table = nullptr;
+    tableRow = 0;
 }
 
 bool Servo::isInverted() const { return inverted; };
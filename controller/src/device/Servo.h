@@ -7,6 +7,7 @@
 #include "config/UARTDevice.h"
 #include "creature/MotorType.h"
 #include "device/ServoSpecifier.h"
+#include "device/ServoTable.h"
 #include "logging/Logger.h"
 #include "util/Result.h"
 
@@ -21,6 +22,11 @@
  * The min and max pulse define the length of travel for this servo within
  * the creature. These values are highly specific to each individual creature's
  * physical construction and limitations.
+ *
+ * Once a servo is added to a creature, its desired and current positions live
+ * in the creature's `ServoTable` instead of in the servo itself. Nothing
+ * outside of the two classes needs to care; the getters and `move()` work the
+ * same either way.
  */
 class Servo {
 
@@ -177,6 +183,8 @@ class Servo {
     [[nodiscard]] creatures::creature::motor_type getMotorType() const;
 
   private:
+    friend class creatures::device::ServoTable;
+
     std::string id;                            ///< Unique identifier for this servo
     ServoSpecifier outputLocation;             ///< Hardware location (module and pin)
     u16 min_pulse_us;                          ///< Lower bound pulse size in microseconds
@@ -194,6 +202,37 @@ class Servo {
     float smoothingValue;                      ///< Movement smoothing factor (0.0-1.0)
     std::shared_ptr<creatures::Logger> logger; ///< Logger instance
 
+    creatures::device::ServoTable *table = nullptr; ///< The table holding our positions, if we're in one
+    size_t tableRow = 0;                            ///< Our row in that table
+
+    /**
+     * @brief Where our target position lives (the table, or our own copy)
+     */
+    u32 &desiredMicroseconds() { return table ? table->desiredMicroseconds[tableRow] : desired_microseconds; }
+    [[nodiscard]] const u32 &desiredMicroseconds() const {
+        return table ? table->desiredMicroseconds[tableRow] : desired_microseconds;
+    }
+
+    /**
+     * @brief Where our current position lives (the table, or our own copy)
+     */
+    u32 &currentMicroseconds() { return table ? table->currentMicroseconds[tableRow] : current_microseconds; }
+    [[nodiscard]] const u32 &currentMicroseconds() const {
+        return table ? table->currentMicroseconds[tableRow] : current_microseconds;
+    }
+
+    /**
+     * @brief Start keeping our positions in a table. Called by `ServoTable`.
+     *
+     * The table must already hold our current positions in this row.
+     */
+    void bindToTable(creatures::device::ServoTable *servoTable, size_t row);
+
+    /**
+     * @brief Copy our positions back out of the table and stop using it
+     */
+    void unbindFromTable();
+
     /**
      * @brief Converts position value to microseconds
      *
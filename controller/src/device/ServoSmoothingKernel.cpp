@@ -0,0 +1,159 @@
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "controller-config.h"
+
+#include "ServoSmoothingKernel.h"
+
+/*
+ * A note on rounding
+ *
+ * `lround()` rounds halves away from zero. Everything here is positive, so
+ * that's "truncate, then add one if what was chopped off is at least 0.5".
+ * Doing it that way (instead of floor(x + 0.5)) matters: adding 0.5 can round
+ * up on its own for values just under a half, and then we'd be off by one from
+ * the scalar path. Both the truncation and the subtraction are exact for
+ * numbers this small, so this gives the same answer as `lround()` every time.
+ *
+ * CMake builds this file with -ffp-contract=off so the compiler can't fuse the
+ * multiply and add in one path and not the other.
+ */
+
+namespace creatures::device {
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Two servos at a time with SSE2
+ */
+#if !defined(__SSE2__)
+__attribute__((target("sse2")))
+#endif
+size_t smoothSse2(const u32 *desired, u32 *current, const float *smoothing, size_t count) {
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d half = _mm_set1_pd(0.5);
+
+    // Positions are nowhere near 2^31, so loading them as signed is fine
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d d = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(desired + i)));
+        const __m128d c = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(current + i)));
+        const __m128d s =
+            _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(smoothing + i))));
+
+        const __m128d x = _mm_add_pd(_mm_mul_pd(d, _mm_sub_pd(one, s)), _mm_mul_pd(c, s));
+
+        const __m128d whole = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+        const __m128d roundUp = _mm_and_pd(_mm_cmpge_pd(_mm_sub_pd(x, whole), half), one);
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(current + i), _mm_cvttpd_epi32(_mm_add_pd(whole, roundUp)));
+    }
+    return i;
+}
+
+/**
+ * Four servos at a time with AVX2, when the CPU has it
+ */
+__attribute__((target("avx2"))) size_t smoothAvx2(const u32 *desired, u32 *current, const float *smoothing,
+                                                  size_t count) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d d = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(desired + i)));
+        const __m256d c = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(current + i)));
+        const __m256d s = _mm256_cvtps_pd(_mm_loadu_ps(smoothing + i));
+
+        const __m256d x = _mm256_add_pd(_mm256_mul_pd(d, _mm256_sub_pd(one, s)), _mm256_mul_pd(c, s));
+
+        const __m256d whole = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(x));
+        const __m256d roundUp = _mm256_and_pd(_mm256_cmp_pd(_mm256_sub_pd(x, whole), half, _CMP_GE_OQ), one);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(current + i), _mm256_cvttpd_epi32(_mm256_add_pd(whole, roundUp)));
+    }
+    return i;
+}
+
+bool haveAvx2() {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+#elif defined(__aarch64__)
+
+/**
+ * Two servos at a time with NEON
+ */
+size_t smoothNeon(const u32 *desired, u32 *current, const float *smoothing, size_t count) {
+    const float64x2_t one = vdupq_n_f64(1.0);
+    const float64x2_t half = vdupq_n_f64(0.5);
+    const float64x2_t zero = vdupq_n_f64(0.0);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const float64x2_t d = vcvtq_f64_u64(vmovl_u32(vld1_u32(desired + i)));
+        const float64x2_t c = vcvtq_f64_u64(vmovl_u32(vld1_u32(current + i)));
+        const float64x2_t s = vcvt_f64_f32(vld1_f32(smoothing + i));
+
+        const float64x2_t x = vaddq_f64(vmulq_f64(d, vsubq_f64(one, s)), vmulq_f64(c, s));
+
+        const float64x2_t whole = vrndq_f64(x);
+        const float64x2_t roundUp = vbslq_f64(vcgeq_f64(vsubq_f64(x, whole), half), one, zero);
+
+        vst1_u32(current + i, vmovn_u64(vcvtq_u64_f64(vaddq_f64(whole, roundUp))));
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+u32 smoothedMicroseconds(u32 desired, u32 current, float smoothing) {
+    return static_cast<u32>(
+        lround((static_cast<double>(desired) * (1.0 - smoothing)) + (static_cast<double>(current) * smoothing)));
+}
+
+void smoothServoPositionsScalar(const u32 *desired, u32 *current, const float *smoothing, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        current[i] = smoothedMicroseconds(desired[i], current[i], smoothing[i]);
+    }
+}
+
+void smoothServoPositions(const u32 *desired, u32 *current, const float *smoothing, size_t count) {
+    size_t done = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (haveAvx2()) {
+        done = smoothAvx2(desired, current, smoothing, count);
+    }
+    done += smoothSse2(desired + done, current + done, smoothing + done, count - done);
+#elif defined(__aarch64__)
+    done = smoothNeon(desired, current, smoothing, count);
+#endif
+
+    // Whatever didn't fill a whole vector
+    smoothServoPositionsScalar(desired + done, current + done, smoothing + done, count - done);
+}
+
+const char *smoothingKernelName() {
+#if defined(__x86_64__) || defined(__i386__)
+    return haveAvx2() ? "avx2" : "sse2";
+#elif defined(__aarch64__)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace creatures::device
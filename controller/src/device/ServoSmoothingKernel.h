@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include "controller-config.h"
+
+namespace creatures::device {
+
+/**
+ * The smoothing step for a whole column of servos at once
+ *
+ * Every servo does the same exponential moving average each tick:
+ *
+ *     current = lround(desired * (1 - smoothing) + current * smoothing)
+ *
+ * These work through a `ServoTable`'s columns doing exactly that, a few
+ * servos at a time with whatever vector unit the CPU has (AVX2 or SSE2 on
+ * x86, NEON on 64-bit ARM) and one at a time for whatever's left over. The
+ * math is done in doubles in the same order as the scalar version, and the
+ * rounding is done by hand to match `lround()`, so the answer is exactly the
+ * same whichever path runs.
+ *
+ * A smoothing value of 0 makes `current` jump straight to `desired`, which is
+ * how the Dynamixels (which smooth on their own) get passed through.
+ */
+
+/**
+ * Smooth one servo one tick. This is the reference everything else has to
+ * match, and it's what a `Servo` that isn't in a table uses.
+ *
+ * @param desired where the servo wants to be
+ * @param current where it is now
+ * @param smoothing how much of `current` to keep (0.0-1.0)
+ * @return where it is next tick
+ */
+u32 smoothedMicroseconds(u32 desired, u32 current, float smoothing);
+
+/**
+ * Smooth a column of servos one tick, using the best kernel this CPU has
+ *
+ * @param desired where each servo wants to be
+ * @param current where each servo is now, updated in place
+ * @param smoothing each servo's smoothing value
+ * @param count how many servos there are
+ */
+void smoothServoPositions(const u32 *desired, u32 *current, const float *smoothing, size_t count);
+
+/**
+ * The same thing one servo at a time, for comparing against
+ */
+void smoothServoPositionsScalar(const u32 *desired, u32 *current, const float *smoothing, size_t count);
+
+/**
+ * The name of the kernel `smoothServoPositions()` uses on this machine
+ */
+const char *smoothingKernelName();
+
+} // namespace creatures::device
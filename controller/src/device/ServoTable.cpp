@@ -0,0 +1,113 @@
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "controller-config.h"
+
+#include "device/Servo.h"
+#include "device/ServoSmoothingKernel.h"
+
+#include "ServoTable.h"
+
+namespace creatures::device {
+
+ServoTable::~ServoTable() { unbindAll(); }
+
+void ServoTable::rebuild(const std::vector<std::shared_ptr<Servo>> &newServos) {
+
+    // Give everyone their positions back first, so the getters below read the
+    // real values no matter which table (if any) the servo was in before
+    unbindAll();
+
+    std::vector<std::shared_ptr<Servo>> sorted = newServos;
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        const auto la = a->getOutputLocation();
+        const auto lb = b->getOutputLocation();
+        return std::tie(la.module, la.type, la.pin) < std::tie(lb.module, lb.type, lb.pin);
+    });
+
+    const size_t count = sorted.size();
+    desiredMicroseconds.clear();
+    desiredMicroseconds.reserve(count);
+    currentMicroseconds.clear();
+    currentMicroseconds.reserve(count);
+    smoothingValue.clear();
+    smoothingValue.reserve(count);
+    minPulseUs.clear();
+    minPulseUs.reserve(count);
+    maxPulseUs.clear();
+    maxPulseUs.reserve(count);
+    module.clear();
+    module.reserve(count);
+    pin.clear();
+    pin.reserve(count);
+    type.clear();
+    type.reserve(count);
+    tickSmoothing.clear();
+    tickSmoothing.reserve(count);
+    moduleSpans.fill(ModuleSpan{});
+
+    for (size_t row = 0; row < count; row++) {
+        const auto &servo = sorted[row];
+        const auto location = servo->getOutputLocation();
+
+        desiredMicroseconds.push_back(servo->getDesiredMicroseconds());
+        currentMicroseconds.push_back(servo->getCurrentMicroseconds());
+        smoothingValue.push_back(servo->getSmoothingValue());
+        minPulseUs.push_back(servo->getMinPulseUs());
+        maxPulseUs.push_back(servo->getMaxPulseUs());
+        module.push_back(location.module);
+        pin.push_back(location.pin);
+        type.push_back(location.type);
+
+        // Dynamixel servos handle smoothing internally via Profile Velocity,
+        // so they go straight to where they've been asked to be
+        const bool dynamixel = location.type == creatures::creature::motor_type::dynamixel;
+        tickSmoothing.push_back(dynamixel ? 0.0f : servo->getSmoothingValue());
+
+        // Sorting put each module's servos together, so its span is just
+        // where the first one landed and how many followed
+        if (location.module < creatures::config::UARTDevice::invalid_module) {
+            auto &span = moduleSpans[location.module];
+            if (span.count == 0) {
+                span.first = row;
+            }
+            span.count++;
+        }
+    }
+
+    // Now that the columns are in their final spots, point everyone at them
+    servos = std::move(sorted);
+    for (size_t row = 0; row < count; row++) {
+        servos[row]->bindToTable(this, row);
+    }
+}
+
+void ServoTable::calculateNextTick() {
+    smoothServoPositions(desiredMicroseconds.data(), currentMicroseconds.data(), tickSmoothing.data(),
+                         currentMicroseconds.size());
+}
+
+ServoTable::ModuleSpan ServoTable::getModuleSpan(creatures::config::UARTDevice::module_name moduleName) const {
+    if (moduleName >= creatures::config::UARTDevice::invalid_module) {
+        return ModuleSpan{};
+    }
+    return moduleSpans[moduleName];
+}
+
+const std::shared_ptr<Servo> &ServoTable::getServo(size_t row) const { return servos[row]; }
+
+size_t ServoTable::size() const { return servos.size(); }
+
+size_t ServoTable::findRow(const Servo &servo) const { return servo.table == this ? servo.tableRow : size(); }
+
+void ServoTable::unbindAll() {
+    for (auto &servo : servos) {
+        servo->unbindFromTable();
+    }
+    servos.clear();
+}
+
+} // namespace creatures::device
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "controller-config.h"
+
+#include "config/UARTDevice.h"
+#include "creature/MotorType.h"
+
+class Servo;
+
+namespace creatures::device {
+
+/**
+ * All of a creature's servos, laid out column by column
+ *
+ * Each `Servo` is still the thing the rest of the code talks to, but once it's
+ * been added to a table its desired and current positions actually live here,
+ * in plain contiguous arrays. The per-frame work (smoothing every servo and
+ * pulling out one module's positions) can then just walk straight down a few
+ * arrays instead of hopping through a hash map and a `shared_ptr` per servo.
+ *
+ * Rows are sorted by module, then motor type, then pin, so every module's
+ * servos sit next to each other. Where each module starts and how many servos
+ * it has is worked out once when the table is built.
+ *
+ * The table only changes at startup while the creature is being built, so
+ * nothing here is safe to rebuild while the control loop is running.
+ */
+class ServoTable {
+
+  public:
+    /**
+     * Where a module's servos live in the table
+     */
+    struct ModuleSpan {
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    ServoTable() = default;
+    ~ServoTable();
+
+    ServoTable(const ServoTable &) = delete;
+    ServoTable &operator=(const ServoTable &) = delete;
+
+    /**
+     * Rebuild the table from a set of servos and bind each one to its row
+     *
+     * Any servos that were in the table before keep their positions; they're
+     * read out before anything is moved around.
+     *
+     * @param servos every servo the creature has, in any order
+     */
+    void rebuild(const std::vector<std::shared_ptr<Servo>> &servos);
+
+    /**
+     * Smooth every servo one tick toward where it wants to be
+     *
+     * This does exactly what calling `Servo::calculateNextTick()` on each
+     * servo would do, just all in one pass.
+     */
+    void calculateNextTick();
+
+    /**
+     * Get where a module's servos are in the table
+     *
+     * @param module the module to look up
+     * @return the module's span. It's empty if there are no servos on it.
+     */
+    [[nodiscard]] ModuleSpan getModuleSpan(creatures::config::UARTDevice::module_name module) const;
+
+    /**
+     * Get the servo in a row, for the places that want the whole object
+     */
+    [[nodiscard]] const std::shared_ptr<Servo> &getServo(size_t row) const;
+
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * Find which row a servo is in
+     *
+     * @param servo the servo to look for
+     * @return its row, or `size()` if it isn't in this table
+     */
+    [[nodiscard]] size_t findRow(const Servo &servo) const;
+
+    // The columns. One entry per servo, all in the same (sorted) order.
+    std::vector<u32> desiredMicroseconds;
+    std::vector<u32> currentMicroseconds;
+    std::vector<float> smoothingValue;
+    std::vector<u16> minPulseUs;
+    std::vector<u16> maxPulseUs;
+    std::vector<creatures::config::UARTDevice::module_name> module;
+    std::vector<u16> pin;
+    std::vector<creatures::creature::motor_type> type;
+
+    // What the smoothing kernel actually uses: the servo's smoothing value, or
+    // 0 for the Dynamixels so they go straight to where they've been asked
+    std::vector<float> tickSmoothing;
+
+  private:
+    /**
+     * Hand every servo its positions back and let go of it
+     */
+    void unbindAll();
+
+    std::vector<std::shared_ptr<Servo>> servos;
+    std::array<ModuleSpan, creatures::config::UARTDevice::invalid_module> moduleSpans{};
+};
+
+} // namespace creatures::device
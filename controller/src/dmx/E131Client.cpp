@@ -2,21 +2,28 @@
 // E131Client.cpp
 //
 
+#include <algorithm>
 #include <arpa/inet.h>
+#include <array>
 #include <cerrno>       // For errno
+#include <cstddef>      // For offsetof
 #include <cstring>      // For strerror
+#include <ctime>        // For timespec
 #include <netinet/in.h> // For network structures
-#include <sys/socket.h> // For socket error constants
+#include <sys/socket.h> // For socket error constants and recvmmsg()
+#include <sys/uio.h>    // For iovec
 #include <thread>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "e131.h"
 
+#include "controller/MotionLatency.h"
 #include "creature/Creature.h"
 #include "dmx/E131Client.h"
 #include "dmx/E131Exception.h"
 #include "logging/Logger.h"
+#include "replay/CaptureWriter.h"
 #include "util/thread_name.h"
 
 #include "controller-config.h"
@@ -41,15 +48,22 @@ void E131Client::init(const std::shared_ptr<creature::Creature> &_creature,
     this->networkInterfaceIndex = _networkInterfaceIndex;
     this->networkInterfaceAddress = _networkInterfaceAddress;
 
-    // Create our input map
+    // Work out which slots we need to copy out of each packet
+    this->channelOffset = this->creature->getChannelOffset();
     for (const auto &input : this->creature->getInputs()) {
-        // Make a new Input and copy the data into it
-        auto newInput = Input(input);
-        this->inputMap.emplace(newInput.getSlot(), newInput);
+        if (input.getSlot() + channelOffset >= InputFrame::numberOfSlots) {
+            logger->warn("input {} is on slot {} (+{}), which is past the end of the universe. Ignoring it.",
+                         input.getName(), input.getSlot(), channelOffset);
+            continue;
+        }
+        this->inputSlots.push_back(input.getSlot());
+        this->capturedSlots = std::max<size_t>(this->capturedSlots, input.getSlot() + 1U);
     }
-    logger->debug("e1.31 client init'ed with {} inputs", this->inputMap.size());
+    logger->debug("e1.31 client init'ed with {} inputs", this->inputSlots.size());
 }
 
+void E131Client::setCapture(const std::shared_ptr<replay::CaptureWriter> &_capture) { this->capture = _capture; }
+
 void E131Client::start() {
     // Make sure we have our creature and controller
     if (this->creature == nullptr) {
@@ -59,7 +73,7 @@ void E131Client::start() {
         throw E131Exception("Unable to start e1.31 client without a controller");
     }
 
-    this->logger->info("e1.31 client started with {} inputs", this->inputMap.size());
+    this->logger->info("e1.31 client started with {} inputs", this->inputSlots.size());
 
     // Start the worker
     StoppableThread::start();
@@ -155,7 +169,7 @@ void E131Client::run() {
     memset(&groupAddr, 0, sizeof(groupAddr));
     groupAddr.sin_family = AF_INET;
     groupAddr.sin_port = htons(E131_DEFAULT_PORT);
-    groupAddr.sin_addr.s_addr = htonl(0xEFFF0000 | universe); // 239.255.x.x format
+    groupAddr.sin_addr.s_addr = htonl(multicastGroup(universe));
 
     if (bind(sockfd, reinterpret_cast<struct sockaddr *>(&groupAddr), sizeof(groupAddr)) < 0) {
         logger->warn("Unable to bind E1.31 socket to multicast group address: {}; falling back to INADDR_ANY",
@@ -172,6 +186,14 @@ void E131Client::run() {
 
     logger->debug("E1.31 socket bound to port {}", E131_DEFAULT_PORT);
 
+    // Ask the kernel to tell us when each packet actually arrived, so the time
+    // it spent waiting in the socket counts toward the motion latency
+    int timestamps = 1;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &timestamps, sizeof(timestamps)) < 0) {
+        logger->warn("Unable to set SO_TIMESTAMPNS on E1.31 socket, latency will be measured from when we read it: {}",
+                     getDetailedSocketError("setsockopt SO_TIMESTAMPNS"));
+    }
+
     logger->info("Joining multicast group for universe {} on interface '{}'", universe, networkInterfaceName);
     logger->info("  IP address: {}", networkInterfaceAddress);
     logger->info("  Interface index: {}", networkInterfaceIndex);
@@ -190,7 +212,7 @@ void E131Client::run() {
     /// Start of manual multicast join
     struct ip_mreqn mreq;
     memset(&mreq, 0, sizeof(mreq));
-    mreq.imr_multiaddr.s_addr = htonl(0xEFFF0000 | universe); // 239.255.x.x format
+    mreq.imr_multiaddr.s_addr = htonl(multicastGroup(universe));
     mreq.imr_address.s_addr = inet_addr(networkInterfaceAddress.c_str());
     mreq.imr_ifindex = networkInterfaceIndex;
 
@@ -204,71 +226,192 @@ void E131Client::run() {
     }
     /// End of manual multicast join
 
-    logger->info("Successfully joined multicast group 239.255.0.{} on {}", universe, networkInterfaceAddress);
+    logger->info("Successfully joined multicast group 239.255.{}.{} on {}", universe >> 8, universe & 0xff,
+                 networkInterfaceAddress);
     logger->info("Waiting for E1.31 packets on interface '{}'", networkInterfaceName);
 
-    // Receive loop
-    e131_packet_t packet;
-    e131_error_t error;
-    uint8_t last_seq = 0;
+    // Receive loop. Pull everything that's waiting off the socket in one go,
+    // then only use the newest of it.
+    std::vector<e131_packet_t> packets(E131_RECEIVE_BATCH_SIZE);
+    std::array<struct iovec, E131_RECEIVE_BATCH_SIZE> iovecs{};
+    std::array<struct mmsghdr, E131_RECEIVE_BATCH_SIZE> messages{};
+    std::array<u32, E131_RECEIVE_BATCH_SIZE> lengths{};
+    std::vector<ReceiveControl> controls(E131_RECEIVE_BATCH_SIZE);
+    for (size_t i = 0; i < E131_RECEIVE_BATCH_SIZE; i++) {
+        iovecs[i].iov_base = &packets[i];
+        iovecs[i].iov_len = sizeof(e131_packet_t);
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_control = controls[i].buffer;
+    }
+
+    u8 last_seq = 0;
 
     while (!stop_requested.load()) {
-        if (e131_recv(sockfd, &packet) < 0) {
-            logger->error("e131_recv() failed: {} (errno {})", getDetailedSocketError("e131_recv"), errno);
+
+        // The kernel shrinks these to what it actually filled in, so they need
+        // to be put back every time
+        for (size_t i = 0; i < E131_RECEIVE_BATCH_SIZE; i++) {
+            messages[i].msg_hdr.msg_controllen = sizeof(controls[i].buffer);
+        }
+
+        // Block until there's at least one packet, then take whatever else is
+        // already queued up behind it without waiting
+        const int received = recvmmsg(sockfd, messages.data(), E131_RECEIVE_BATCH_SIZE, MSG_WAITFORONE, nullptr);
+        if (received < 0) {
+            if (errno != EINTR) {
+                logger->error("recvmmsg() failed: {} (errno {})", getDetailedSocketError("recvmmsg"), errno);
+            }
+            continue;
+        }
+        packetsReceived.fetch_add(static_cast<u64>(received), std::memory_order_relaxed);
+
+        for (int i = 0; i < received; i++) {
+            lengths[i] = messages[i].msg_len;
+        }
+
+        u64 skipped = 0;
+        PacketRejections rejected;
+        const e131_packet_t *newest =
+            newestPacket(logger, packets.data(), lengths.data(), static_cast<size_t>(received), universe, last_seq,
+                         skipped, rejected);
+        if (rejected.invalid > 0) {
+            invalidPackets.fetch_add(rejected.invalid, std::memory_order_relaxed);
+        }
+        if (rejected.outOfOrder > 0) {
+            outOfOrderPackets.fetch_add(rejected.outOfOrder, std::memory_order_relaxed);
+        }
+        if (skipped > 0) {
+            framesSkipped.fetch_add(skipped, std::memory_order_relaxed);
+            logger->trace("skipped {} stale e1.31 frames", skipped);
+        }
+
+        if (newest != nullptr) {
+            const auto index = static_cast<size_t>(newest - packets.data());
+            handlePacket(*newest, arrivalTime(messages[index].msg_hdr));
+        }
+    }
+
+    logger->info("e1.31 client shutting down ({} packets received, {} stale frames skipped)", getPacketsReceived(),
+                 getFramesSkipped());
+    close(sockfd);
+}
+
+const e131_packet_t *E131Client::newestPacket(const std::shared_ptr<Logger> &logger, const e131_packet_t *packets,
+                                              const u32 *lengths, size_t count, u16 universe, u8 &lastSequence,
+                                              u64 &skipped) {
+    PacketRejections rejected;
+    return newestPacket(logger, packets, lengths, count, universe, lastSequence, skipped, rejected);
+}
+
+const e131_packet_t *E131Client::newestPacket(const std::shared_ptr<Logger> &logger, const e131_packet_t *packets,
+                                              const u32 *lengths, size_t count, u16 universe, u8 &lastSequence,
+                                              u64 &skipped, PacketRejections &rejected) {
+
+    // Anything shorter than this doesn't even have a start code
+    constexpr size_t minimumLength = offsetof(e131_packet_t, dmp.prop_val) + 1;
+
+    const e131_packet_t *newest = nullptr;
+    e131_error_t error;
+
+    for (size_t i = 0; i < count; i++) {
+        const e131_packet_t &packet = packets[i];
+
+        if (lengths[i] < minimumLength) {
+            logger->warn("Short E1.31 packet ({} bytes)", lengths[i]);
+            rejected.invalid++;
             continue;
         }
 
         if ((error = e131_pkt_validate(&packet)) != E131_ERR_NONE) {
             logger->warn("Invalid E1.31 packet: {}", e131_strerror(error));
+            rejected.invalid++;
             continue;
         }
 
         // Only process frames for our universe. On a shared host (travel mode) the
         // socket can still see other universes' traffic, and their sequence numbers
         // must not pollute our tracking, so this check stays ahead of the discard.
-        if (ntohs(packet.frame.universe) != this->universe) {
+        if (ntohs(packet.frame.universe) != universe) {
             logger->trace("ignoring packet for universe {}", ntohs(packet.frame.universe));
             continue;
         }
 
-        if (e131_pkt_discard(&packet, last_seq)) {
-            logger->warn("Out-of-order packet received (seq: {}, last: {})", packet.frame.seq_number, last_seq);
-            last_seq = packet.frame.seq_number;
+        if (e131_pkt_discard(&packet, lastSequence)) {
+            logger->warn("Out-of-order packet received (seq: {}, last: {})", packet.frame.seq_number, lastSequence);
+            lastSequence = packet.frame.seq_number;
+            rejected.outOfOrder++;
             continue;
         }
 
-        handlePacket(packet);
-        last_seq = packet.frame.seq_number;
+        // Good packet. It replaces whatever we had from earlier in the batch.
+        if (newest != nullptr) {
+            skipped++;
+        }
+        newest = &packet;
+        lastSequence = packet.frame.seq_number;
     }
 
-    logger->info("e1.31 client shutting down");
-    close(sockfd);
+    return newest;
 }
 
-void E131Client::handlePacket(const e131_packet_t &packet) {
-    std::string hexString;
+u64 E131Client::getPacketsReceived() const { return packetsReceived.load(std::memory_order_relaxed); }
+
+u64 E131Client::getFramesSkipped() const { return framesSkipped.load(std::memory_order_relaxed); }
 
-    // TODO: Don't do this unless verbose is on
-    for (u16 i = creature->getChannelOffset(); i < creature->getNumberOfServos() + creature->getChannelOffset(); i++) {
-        hexString += fmt::format("{:#04x} ", packet.dmp.prop_val[i]);
+u64 E131Client::getInvalidPackets() const { return invalidPackets.load(std::memory_order_relaxed); }
+
+u64 E131Client::getOutOfOrderPackets() const { return outOfOrderPackets.load(std::memory_order_relaxed); }
+
+std::int64_t E131Client::arrivalTime(const struct msghdr &header) {
+    const std::int64_t steadyNow = MotionLatency::now();
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<struct msghdr *>(&header), cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS) {
+            continue;
+        }
+
+        timespec arrived{};
+        memcpy(&arrived, CMSG_DATA(cmsg), sizeof(arrived));
+
+        // The kernel's stamp is on the wall clock, and ours are all on the
+        // steady one, so work out how long ago it was and go back that far
+        timespec wallNow{};
+        clock_gettime(CLOCK_REALTIME, &wallNow);
+        const std::int64_t ago = (static_cast<std::int64_t>(wallNow.tv_sec) - arrived.tv_sec) * 1'000'000'000 +
+                                 (wallNow.tv_nsec - arrived.tv_nsec);
+
+        // If the wall clock jumped, just use now
+        return ago >= 0 ? steadyNow - ago : steadyNow;
     }
-    logger->trace("Received e1.31 packet: {}", hexString);
 
-    std::vector<Input> inputs;
+    return steadyNow;
+}
 
-    // Walk the input map
-    for (auto &[fst, snd] : this->inputMap) {
-        const u16 slot = fst + creature->getChannelOffset();
-        const u8 value = packet.dmp.prop_val[slot];
+void E131Client::handlePacket(const e131_packet_t &packet, std::int64_t receivedNs) {
 
-        auto inputToSend = Input(snd);
-        inputToSend.setIncomingRequest(value);
+    // Building this is expensive, so only bother if someone's going to see it
+    if (logger->isTraceEnabled()) {
+        std::string hexString;
+        for (u16 i = channelOffset; i < creature->getNumberOfServos() + channelOffset; i++) {
+            hexString += fmt::format("{:#04x} ", packet.dmp.prop_val[i]);
+        }
+        logger->trace("Received e1.31 packet: {}", hexString);
+    }
 
-        inputs.push_back(inputToSend);
-        // logger->trace("Setting input slot {} ({}) to value {}", slot, inputToSend.getName(), value);
+    // Copy out just the slots we care about
+    for (const u16 slot : inputSlots) {
+        frame.slots[slot] = packet.dmp.prop_val[slot + channelOffset];
     }
 
-    this->controller->acceptInput(inputs);
+    frame.timestamps = MotionTimestamps{};
+    frame.timestamps.receivedNs = receivedNs;
+    frame.timestamps.handedOffNs = MotionLatency::now();
+    if (capture) {
+        capture->recordInputFrame(frame, capturedSlots);
+    }
+    this->controller->acceptInput(frame);
 }
 
 } // namespace creatures::dmx
@@ -1,20 +1,40 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <thread>
+#include <vector>
 
 #include "controller-config.h"
 #include "controller/Controller.h"
+#include "controller/InputFrame.h"
 #include "creature/Creature.h"
 #include "logging/Logger.h"
 #include "util/StoppableThread.h"
 
+#include <sys/socket.h>
+
 #include "e131.h"
 
+namespace creatures::replay {
+class CaptureWriter; // Forward declaration
+}
+
 namespace creatures::dmx {
 
 class E131Client : public StoppableThread {
 
   public:
+    /**
+     * Packets that were thrown out without ever being looked at
+     */
+    struct PacketRejections {
+        u64 invalid = 0;    // Too short, or not valid E1.31
+        u64 outOfOrder = 0; // Older than one we've already seen
+    };
+
     explicit E131Client(const std::shared_ptr<Logger> &logger);
     ~E131Client() override;
 
@@ -24,18 +44,103 @@ class E131Client : public StoppableThread {
     void start() override;
     void run() override;
 
+    /**
+     * Capture every frame we hand the controller. Set it before `start()`.
+     */
+    void setCapture(const std::shared_ptr<replay::CaptureWriter> &capture);
+
+    /**
+     * Pick the packet to use out of a batch off the socket
+     *
+     * Packets are checked in the order they arrived, the same way they'd be
+     * checked one at a time: bad ones, other universes, and out-of-order ones
+     * are skipped. Of what's left, only the newest matters, since it has the
+     * latest value for every slot. Everything it replaces is counted in
+     * `skipped`.
+     *
+     * @param logger where to complain about bad packets
+     * @param packets the batch
+     * @param lengths how many bytes actually arrived for each packet
+     * @param count how many packets are in the batch
+     * @param universe the universe we're listening to
+     * @param lastSequence the last sequence number we saw, updated as we go
+     * @param skipped bumped once for each good packet a newer one replaced
+     * @return the newest good packet, or nullptr if there weren't any
+     */
+    static const e131_packet_t *newestPacket(const std::shared_ptr<Logger> &logger, const e131_packet_t *packets,
+                                             const u32 *lengths, size_t count, u16 universe, u8 &lastSequence,
+                                             u64 &skipped);
+
+    /**
+     * Same as above, but also counts the packets that got thrown out
+     *
+     * @param rejected bumped for each packet that was bad or out of order
+     */
+    static const e131_packet_t *newestPacket(const std::shared_ptr<Logger> &logger, const e131_packet_t *packets,
+                                             const u32 *lengths, size_t count, u16 universe, u8 &lastSequence,
+                                             u64 &skipped, PacketRejections &rejected);
+
+    /**
+     * Copy our inputs out of a packet and hand them to the controller
+     *
+     * `run()` calls this with the packet `newestPacket()` picked. It's public
+     * so the benchmarks can hop on the same path without a socket.
+     *
+     * @param packet a valid packet for our universe
+     * @param receivedNs when it arrived, on the steady clock
+     */
+    void handlePacket(const e131_packet_t &packet, std::int64_t receivedNs);
+
+    /**
+     * The multicast group a universe is sent to: 239.255.x.x, with the
+     * universe in the last two octets. Host byte order.
+     */
+    static constexpr u32 multicastGroup(u16 universe) { return 0xEFFF0000U | universe; }
+
+    [[nodiscard]] u64 getPacketsReceived() const;
+    [[nodiscard]] u64 getFramesSkipped() const;
+    [[nodiscard]] u64 getInvalidPackets() const;
+    [[nodiscard]] u64 getOutOfOrderPackets() const;
+
   private:
     std::shared_ptr<Logger> logger;
     std::shared_ptr<creature::Creature> creature;
     std::shared_ptr<Controller> controller;
 
     /**
-     * A map of the inputs, with the slot number as the key. It's built in the
-     * init() function.
+     * The slots our inputs are on, relative to the creature's channel offset.
+     * It's built in the init() function.
      */
-    std::unordered_map<u16, Input> inputMap;
+    std::vector<u16> inputSlots;
+    u16 channelOffset = 0;
+
+    // How much of each frame is worth capturing (up to our last input's slot)
+    size_t capturedSlots = 0;
+    std::shared_ptr<replay::CaptureWriter> capture;
 
-    void handlePacket(const e131_packet_t &packet);
+    /**
+     * Filled in from each packet and handed to the controller. It's reused so
+     * nothing gets allocated per packet.
+     */
+    InputFrame frame;
+
+    std::atomic<u64> packetsReceived = 0UL;
+    std::atomic<u64> framesSkipped = 0UL;
+    std::atomic<u64> invalidPackets = 0UL;
+    std::atomic<u64> outOfOrderPackets = 0UL;
+
+    /**
+     * Room for the kernel to tell us when a packet arrived
+     */
+    struct ReceiveControl {
+        alignas(struct cmsghdr) char buffer[CMSG_SPACE(sizeof(timespec))];
+    };
+
+    /**
+     * When a packet arrived, on the steady clock. We use the kernel's stamp if
+     * it gave us one, or now if it didn't.
+     */
+    static std::int64_t arrivalTime(const struct msghdr &header);
 
     u16 universe;
     std::string networkInterfaceName = DEFAULT_NETWORK_INTERFACE_NAME;
@@ -0,0 +1,73 @@
+
+#include <cstddef>
+
+#include "controller-config.h"
+
+#include "BinaryFraming.h"
+
+namespace creatures::io::BinaryFraming {
+
+u16 crc16(const u8 *data, size_t length) {
+    u16 crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= static_cast<u16>(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<u16>((crc << 1) ^ 0x1021) : static_cast<u16>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t encodeCobs(const u8 *input, size_t length, u8 *output) {
+    size_t codeIndex = 0; // Where the current run's length byte goes
+    size_t outIndex = 1;
+    u8 code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (input[i] == 0) {
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+            continue;
+        }
+
+        output[outIndex++] = input[i];
+        if (++code == 0xFF) {
+            // A full run of 254 non-zero bytes, start a new one
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+
+    output[codeIndex] = code;
+    return outIndex;
+}
+
+size_t decodeCobs(const u8 *input, size_t length, u8 *output) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        const u8 code = input[inIndex++];
+        if (code == 0 || inIndex + code - 1 > length) {
+            return 0; // Zeros aren't allowed in a block, and runs can't go past the end
+        }
+
+        for (u8 i = 1; i < code; i++) {
+            if (input[inIndex] == 0) {
+                return 0;
+            }
+            output[outIndex++] = input[inIndex++];
+        }
+
+        // A short run means there was a zero here, unless we're at the very end
+        if (code != 0xFF && inIndex < length) {
+            output[outIndex++] = 0;
+        }
+    }
+
+    return outIndex;
+}
+
+} // namespace creatures::io::BinaryFraming
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+
+#include "controller-config.h"
+
+namespace creatures::io {
+
+/**
+ * How a message is laid out on the wire
+ *
+ * Text is the original newline terminated `CMD\ttoken\tCS n` protocol and is
+ * what every firmware speaks. Binary is only used for a module after its
+ * firmware says it understands it (by sending `READY\t1\tBIN`) and the
+ * controller has been told it's allowed to use it.
+ */
+enum class SerialFraming { text, binary };
+
+/**
+ * Helpers for the binary serial framing
+ *
+ * A binary frame on the wire looks like this:
+ *
+ *     0x00  COBS( type | body ... | crc16 (LE) )  0x00
+ *
+ * COBS guarantees there are no zero bytes inside the encoded block, so a zero
+ * always means "a frame starts or ends here." If the firmware ever loses its
+ * place (a byte gets dropped on the USB, say) it only has to wait for the next
+ * zero to be back in sync. The CRC is CRC-16/CCITT-FALSE over the type and
+ * body, which catches a lot more than the text protocol's simple sum.
+ *
+ * The firmware has a matching decoder in `messaging/binary_framing.c`. If you
+ * change anything here, change it there too! 🐇
+ */
+namespace BinaryFraming {
+
+/**
+ * The byte that starts and ends every binary frame
+ */
+constexpr u8 FrameDelimiter = 0x00;
+
+/**
+ * The first byte of every decoded frame, says what's in the rest of it
+ */
+constexpr u8 PositionFrameType = 0x01;
+
+/**
+ * The largest COBS block `encodeCobs()` can produce for `length` bytes in
+ */
+constexpr size_t maxCobsLength(size_t length) { return length + (length / 254) + 1; }
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no xor out)
+ *
+ * @param data the bytes to checksum
+ * @param length how many bytes there are
+ * @return the CRC
+ */
+u16 crc16(const u8 *data, size_t length);
+
+/**
+ * COBS-encode a block of bytes
+ *
+ * @param input the raw bytes
+ * @param length how many raw bytes there are
+ * @param output where to put the encoded block. Must have room for at least
+ * `maxCobsLength(length)` bytes. It may not overlap `input`.
+ * @return how many bytes were written to `output`
+ */
+size_t encodeCobs(const u8 *input, size_t length, u8 *output);
+
+/**
+ * Decode a COBS block (without its delimiters)
+ *
+ * @param input the encoded bytes
+ * @param length how many encoded bytes there are
+ * @param output where to put the decoded bytes. Must have room for `length`
+ * bytes.
+ * @return how many bytes were decoded, or 0 if the block isn't valid COBS
+ */
+size_t decodeCobs(const u8 *input, size_t length, u8 *output);
+
+} // namespace BinaryFraming
+
+} // namespace creatures::io
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "controller-config.h"
+
+namespace creatures::io {
+
+/**
+ * Turns the bytes coming off a serial port into lines
+ *
+ * Reads go straight into a fixed buffer (ask for `writable()`, read into it,
+ * then `commit()` what you got). Each byte is only looked at once when we
+ * scan for newlines, and the lines are handed out as views into the buffer,
+ * so a read that brings in a whole burst of telemetry costs about the same
+ * per line as one that brings in a single line.
+ *
+ * After a commit, whatever's left of a line that hasn't finished yet is slid
+ * back to the front of the buffer. That's never more than `maxLineLength`
+ * bytes, and it keeps every line in one piece so it can be a plain
+ * `std::string_view`.
+ *
+ * A `\r` before the `\n` is dropped, as are empty lines. A line longer than
+ * `maxLineLength` is thrown away (all of it, up to the next `\n`) and counted,
+ * so a firmware that's gone off the rails can't make us buffer forever.
+ *
+ * This isn't thread safe. It belongs to the reader's thread.
+ */
+class LineSplitter {
+  public:
+    /**
+     * @param _capacity how big the buffer is (at least twice `_maxLineLength`)
+     * @param _maxLineLength the longest line we'll keep
+     */
+    explicit LineSplitter(size_t _capacity = SERIAL_READ_BUFFER_SIZE,
+                          size_t _maxLineLength = SERIAL_MAX_LINE_LENGTH)
+        : capacity(std::max(_capacity, _maxLineLength * 2)), maxLineLength(_maxLineLength),
+          buffer(std::make_unique<char[]>(capacity)) {}
+
+    LineSplitter(const LineSplitter &) = delete;
+    LineSplitter &operator=(const LineSplitter &) = delete;
+
+    /**
+     * Where the next read should go. It's never empty.
+     */
+    std::span<char> writable() { return {buffer.get() + end, capacity - end}; }
+
+    /**
+     * Take in bytes that were just read into `writable()`
+     *
+     * @param bytes how many were read
+     * @param onLine called with each line that's now complete, in order. The
+     *               view is only good until it returns.
+     * @return how many lines there were
+     */
+    template <typename OnLine> size_t commit(size_t bytes, OnLine &&onLine) {
+        size_t lines = 0;
+        const size_t scanTo = end + std::min(bytes, capacity - end);
+
+        char *cursor = buffer.get() + end;
+        char *const last = buffer.get() + scanTo;
+        while (cursor < last) {
+            auto *newline = static_cast<char *>(std::memchr(cursor, '\n', static_cast<size_t>(last - cursor)));
+            if (newline == nullptr) {
+                break;
+            }
+
+            if (discarding) {
+                discarding = false; // That's the end of the long one
+            } else {
+                std::string_view line(buffer.get() + start, static_cast<size_t>(newline - (buffer.get() + start)));
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                if (line.size() > maxLineLength) {
+                    linesTooLong++; // Showed up all at once, but it's still too long
+                } else if (!line.empty()) {
+                    onLine(line);
+                    lines++;
+                }
+            }
+
+            start = static_cast<size_t>(newline - buffer.get()) + 1;
+            cursor = newline + 1;
+        }
+        end = scanTo;
+
+        // Too long to be anything we'd want. Toss it, and everything after it
+        // until the next newline.
+        if (!discarding && end - start > maxLineLength) {
+            discarding = true;
+            linesTooLong++;
+        }
+        if (discarding) {
+            start = end;
+        }
+
+        // Slide the start of the next line to the front so there's room to read
+        if (start == end) {
+            start = end = 0;
+        } else if (start > 0) {
+            std::memmove(buffer.get(), buffer.get() + start, end - start);
+            end -= start;
+            start = 0;
+        }
+
+        return lines;
+    }
+
+    /**
+     * Bytes of a line we're still waiting on the end of
+     */
+    [[nodiscard]] size_t pending() const { return end - start; }
+
+    /**
+     * How many lines were too long and got thrown away
+     */
+    [[nodiscard]] u64 getLinesTooLong() const { return linesTooLong; }
+
+  private:
+    size_t capacity;
+    size_t maxLineLength;
+    std::unique_ptr<char[]> buffer;
+
+    size_t start = 0; // The first byte of the line we're working on
+    size_t end = 0;   // One past the last byte we've read
+
+    bool discarding = false; // Partway through a line that was too long
+    u64 linesTooLong = 0;
+};
+
+} // namespace creatures::io
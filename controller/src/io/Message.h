@@ -1,7 +1,12 @@
 
 #pragma once
 
+#include <string>
+#include <utility>
+
 #include "config/UARTDevice.h"
+#include "controller/MotionTimestamps.h"
+#include "io/BinaryFraming.h"
 
 namespace creatures::io {
 
@@ -17,8 +22,21 @@ namespace creatures::io {
         // The payload of the message
         std::string payload;
 
-        Message(UARTDevice::module_name mod, std::string pay)
-                : module(mod), payload(std::move(pay)) {}
+        // How the payload is laid out. Text payloads get a newline added when
+        // they're written; binary ones already carry their own delimiters.
+        SerialFraming framing;
+
+        // If these are servo positions, where the input that moved them came
+        // from and when. Untraced for everything else.
+        MotionTimestamps timestamps{};
+
+        // Servo positions are only good until the next ones are ready, so a
+        // newer one can take the place of one that hasn't gone out yet. Never
+        // set this on anything else!
+        bool isPosition = false;
+
+        Message(UARTDevice::module_name mod, std::string pay, SerialFraming fram = SerialFraming::text)
+                : module(mod), payload(std::move(pay)), framing(fram) {}
     };
 
 } //creatures::io
@@ -1,6 +1,6 @@
-#include <sstream>
+#include <chrono>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -16,7 +16,6 @@
 #include "io/handlers/StatsHandler.h"
 #include "logging/Logger.h"
 #include "util/Result.h"
-#include "util/thread_name.h"
 
 #include "MessageProcessor.h"
 #include "io/MessageProcessingException.h"
@@ -38,23 +37,21 @@ MessageProcessor::MessageProcessor(
         throw MessageProcessingException("ServoModuleHandler is null");
     }
 
-    this->incomingQueue = this->servoModuleHandler->getIncomingQueue();
-    if (!this->incomingQueue) {
-        logger->critical("IncomingQueue is null in MessageProcessor constructor");
-        throw MessageProcessingException("IncomingQueue is null");
-    }
-
     createHandlers();
 
-    // Register handlers
-    registerHandler("LOG", this->logHandler);
+    // Register handlers. The table is searched in this order, so the chatty
+    // ones go first.
+    registerHandler("DSENSE", this->dynamixelSensorHandler);
+    registerHandler("BSENSE", this->boardSensorHandler);
+    registerHandler("MSENSE", this->motorSensorHandler);
     registerHandler("STATS", this->statsHandler);
+    registerHandler("LOG", this->logHandler);
     registerHandler("PONG", this->pongHandler);
     registerHandler("INIT", this->initHandler);
     registerHandler("READY", this->readyHandler);
-    registerHandler("BSENSE", this->boardSensorHandler);
-    registerHandler("MSENSE", this->motorSensorHandler);
-    registerHandler("DSENSE", this->dynamixelSensorHandler);
+
+    // The STATS line is the longest thing the firmware sends, by a lot
+    tokens.reserve(32);
 }
 
 void MessageProcessor::createHandlers() {
@@ -63,21 +60,62 @@ void MessageProcessor::createHandlers() {
     this->logHandler = std::make_shared<LogHandler>();
     this->initHandler = std::make_shared<InitHandler>(this->logger, this->servoModuleHandler);
     this->pongHandler = std::make_shared<PongHandler>(this->logger, this->servoModuleHandler);
-    this->statsHandler = std::make_shared<StatsHandler>();
+    this->statsHandler = std::make_shared<StatsHandler>(this->moduleId);
     this->readyHandler = std::make_shared<ReadyHandler>(this->logger, this->servoModuleHandler);
-    this->boardSensorHandler = std::make_shared<BoardSensorHandler>(this->logger, this->websocketOutgoingQueue);
-    this->motorSensorHandler = std::make_shared<MotorSensorHandler>(this->logger, this->websocketOutgoingQueue);
-    this->dynamixelSensorHandler = std::make_shared<DynamixelSensorHandler>(this->logger, this->websocketOutgoingQueue);
+    this->boardSensorHandler =
+        std::make_shared<BoardSensorHandler>(this->logger, this->moduleId, this->websocketOutgoingQueue);
+    this->motorSensorHandler =
+        std::make_shared<MotorSensorHandler>(this->logger, this->moduleId, this->websocketOutgoingQueue);
+    this->dynamixelSensorHandler =
+        std::make_shared<DynamixelSensorHandler>(this->logger, this->moduleId, this->websocketOutgoingQueue);
 }
 
 void MessageProcessor::registerHandler(std::string messageType, std::shared_ptr<IMessageHandler> handler) {
     logger->info("registering handler for {}", messageType);
-    handlers[messageType] = std::move(handler);
+
+    // Registering a type again replaces the handler that was there
+    for (size_t i = 0; i < handlerCount; i++) {
+        if (handlers[i].messageType == messageType) {
+            handlers[i].handler = std::move(handler);
+            return;
+        }
+    }
+
+    if (handlerCount == MaxHandlers) {
+        logger->critical("no room to register a handler for {}! (we only have room for {})", messageType,
+                         MaxHandlers);
+        return;
+    }
+
+    handlers[handlerCount].messageType = std::move(messageType);
+    handlers[handlerCount].handler = std::move(handler);
+    handlerCount++;
+}
+
+size_t MessageProcessor::findHandlerIndex(std::string_view messageType) const {
+    for (size_t i = 0; i < handlerCount; i++) {
+        if (handlers[i].messageType == messageType) {
+            return i;
+        }
+    }
+    return MaxHandlers;
 }
 
-void MessageProcessor::start() {
-    logger->info("Starting the message processor");
-    creatures::StoppableThread::start();
+void MessageProcessor::tokenize(std::string_view payload) {
+    tokens.clear();
+
+    // This matches what std::getline() used to give us: empty tokens between
+    // two tabs are kept, but a tab at the very end doesn't make one
+    size_t start = 0;
+    while (start < payload.size()) {
+        size_t tab = payload.find('\t', start);
+        if (tab == std::string_view::npos) {
+            tokens.push_back(payload.substr(start));
+            break;
+        }
+        tokens.push_back(payload.substr(start, tab - start));
+        start = tab + 1;
+    }
 }
 
 /**
@@ -92,7 +130,7 @@ Result<bool> MessageProcessor::processMessage(const Message &message) {
 #endif
 
     // Make sure we have handlers registered
-    if (handlers.empty()) {
+    if (handlerCount == 0) {
         auto errorMessage = "No handlers registered!";
         logger->critical(errorMessage);
         return Result<bool>{ControllerError(ControllerError::UnprocessableMessage, errorMessage)};
@@ -103,13 +141,10 @@ Result<bool> MessageProcessor::processMessage(const Message &message) {
         return Result<bool>{true};
     }
 
+    const auto startedAt = std::chrono::steady_clock::now();
+
     // Tokenize message by tabs
-    std::istringstream iss(message.payload);
-    std::vector<std::string> tokens;
-    std::string token;
-    while (std::getline(iss, token, '\t')) {
-        tokens.push_back(token);
-    }
+    tokenize(message.payload);
 
     // Need at least one token (the command)
     if (tokens.empty()) {
@@ -118,11 +153,13 @@ Result<bool> MessageProcessor::processMessage(const Message &message) {
     }
 
     // Find and invoke the handler
-    auto it = handlers.find(tokens[0]);
-    if (it != handlers.end()) {
+    const size_t index = findHandlerIndex(tokens[0]);
+    const auto parsedAt = std::chrono::steady_clock::now();
+
+    if (index < handlerCount) {
         try {
             // Handler found, invoke it
-            it->second->handle(logger, tokens);
+            handlers[index].handler->handle(logger, tokens);
         } catch (const std::exception &e) {
             auto errorMessage = fmt::format("Exception in message handler for {}: {}", tokens[0], e.what());
             logger->error(errorMessage);
@@ -133,34 +170,38 @@ Result<bool> MessageProcessor::processMessage(const Message &message) {
         logger->warn("Unknown message type: '{}'", tokens[0]);
     }
 
+    const auto dispatchedAt = std::chrono::steady_clock::now();
+    auto &timing = timings[index < handlerCount ? index : MaxHandlers];
+    timing.parseNs.record(
+        static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(parsedAt - startedAt).count()));
+    timing.dispatchNs.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(dispatchedAt - parsedAt).count()));
+
     return Result<bool>{true};
 }
 
-void MessageProcessor::run() {
-    this->threadName = fmt::format("MessageProcessor::{}", UARTDevice::moduleNameToString(this->moduleId));
-    setThreadName(this->threadName);
-
-    logger->debug("MessageProcessor thread started for module {}", UARTDevice::moduleNameToString(this->moduleId));
+std::vector<MessageProcessor::MessageTypeStats> MessageProcessor::getMessageTypeStats() const {
+    std::vector<MessageTypeStats> stats;
 
-    while (!this->stop_requested.load()) {
-        // Wait for a message with a short timeout so we can check stop_requested
-        auto messageOpt = this->incomingQueue->pop_timeout(std::chrono::milliseconds(100));
-
-        if (!messageOpt.has_value()) {
-            // Timeout - just continue to check stop_requested
-            continue;
-        }
-
-        // Process the message
-        auto processResult = processMessage(messageOpt.value());
-        if (!processResult.isSuccess()) {
-            // Log the error but continue processing
-            auto errorMessage = fmt::format("Error processing message: {}", processResult.getError()->getMessage());
-            logger->error(errorMessage);
+    auto addIfSeen = [&stats](const std::string &messageType, const Timing &timing) {
+        if (timing.dispatchNs.count() == 0) {
+            return;
         }
+        MessageTypeStats typeStats;
+        typeStats.messageType = messageType;
+        typeStats.messages = timing.dispatchNs.count();
+        typeStats.parseNs = timing.parseNs.sum();
+        typeStats.dispatchNs = timing.dispatchNs.sum();
+        typeStats.maxDispatchNs = timing.dispatchNs.max();
+        stats.push_back(std::move(typeStats));
+    };
+
+    for (size_t i = 0; i < handlerCount; i++) {
+        addIfSeen(handlers[i].messageType, timings[i]);
     }
+    addIfSeen("unknown", timings[MaxHandlers]);
 
-    logger->info("MessageProcessor thread for {} stopping gracefully", UARTDevice::moduleNameToString(this->moduleId));
+    return stats;
 }
 
-} // namespace creatures
\ No newline at end of file
+} // namespace creatures
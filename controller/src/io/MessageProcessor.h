@@ -1,9 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <thread>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include "controller-config.h"
 
@@ -20,9 +22,9 @@
 #include "io/handlers/StatsHandler.h"
 #include "logging/Logger.h"
 #include "server/ServerMessage.h"
+#include "util/Histogram.h"
 #include "util/MessageQueue.h"
 #include "util/Result.h"
-#include "util/StoppableThread.h"
 
 namespace creatures {
 
@@ -32,22 +34,44 @@ namespace creatures {
  * This class follows a simple philosophy: process messages as they come in, and if
  * anything goes wrong, log it and continue. No complex recovery attempts that can
  * introduce bugs. Keep it simple.
+ *
+ * It doesn't have a thread of its own. The ServoModuleHandler's thread is the
+ * one and only consumer of its module's incoming queue, and it calls
+ * `processMessage()` for every line, so each one is handled exactly once and
+ * in the order the firmware sent them.
  */
-class MessageProcessor : public StoppableThread {
+class MessageProcessor {
 
   public:
+    /**
+     * How long one type of message has been taking us
+     *
+     * "Parse" is splitting the line up and finding its handler, "dispatch" is
+     * the handler doing its thing. Times are in nanoseconds.
+     */
+    struct MessageTypeStats {
+        std::string messageType; // "unknown" for lines nobody handles
+        std::uint64_t messages = 0;
+        std::uint64_t parseNs = 0;
+        std::uint64_t dispatchNs = 0;
+        std::uint64_t maxDispatchNs = 0;
+    };
+
     MessageProcessor(std::shared_ptr<Logger> logger, UARTDevice::module_name moduleId,
                      std::shared_ptr<ServoModuleHandler> ServoModuleHandler,
                      std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue);
     ~MessageProcessor() = default;
 
     void registerHandler(std::string messageType, std::shared_ptr<IMessageHandler> handler);
-    void start() override;
-
-    void run() override;
 
     Result<bool> processMessage(const Message &message);
 
+    /**
+     * How each type of message has been taking, for the ones we've seen. Safe
+     * to call from any thread.
+     */
+    [[nodiscard]] std::vector<MessageTypeStats> getMessageTypeStats() const;
+
   private:
     /**
      * Create the handlers before we try to use them :)
@@ -55,8 +79,61 @@ class MessageProcessor : public StoppableThread {
     void createHandlers();
 
     std::shared_ptr<ServoModuleHandler> servoModuleHandler;
-    std::shared_ptr<MessageQueue<Message>> incomingQueue;
-    std::unordered_map<std::string, std::shared_ptr<IMessageHandler>> handlers;
+
+    /**
+     * Split a line from the firmware on tabs into `tokens`
+     *
+     * @param payload the line. The tokens point into it, so it has to stick
+     *                around for as long as they're being used.
+     */
+    void tokenize(std::string_view payload);
+
+    /**
+     * One row of the dispatch table
+     */
+    struct HandlerEntry {
+        std::string messageType;
+        std::shared_ptr<IMessageHandler> handler;
+    };
+
+    /**
+     * How many message types we can have handlers for. We ship with eight, so
+     * this leaves some room to grow.
+     */
+    static constexpr size_t MaxHandlers = 16;
+
+    /**
+     * Who handles what. It's a handful of short names, so walking a flat table
+     * is quicker than hashing the type (and, unlike a map keyed on a string, we
+     * don't have to make a string out of the token just to look it up).
+     */
+    std::array<HandlerEntry, MaxHandlers> handlers;
+    size_t handlerCount = 0;
+
+    /**
+     * Where the time goes, by message type. Each handler's timings are at
+     * the same index as it is in `handlers`, and the last pair is for
+     * messages nobody handles.
+     */
+    struct Timing {
+        Histogram parseNs;
+        Histogram dispatchNs;
+    };
+    std::array<Timing, MaxHandlers + 1> timings;
+
+    /**
+     * Which handler a message type belongs to
+     *
+     * @return its index in `handlers`, or `MaxHandlers` if nobody has claimed it
+     */
+    size_t findHandlerIndex(std::string_view messageType) const;
+
+    /**
+     * The tokens of the message we're working on. They're views into the
+     * message itself and this vector keeps its capacity between messages, so
+     * once it's warmed up nothing is allocated to split a line.
+     */
+    std::vector<std::string_view> tokens;
 
     std::shared_ptr<Logger> logger;
     UARTDevice::module_name moduleId;
@@ -74,4 +151,4 @@ class MessageProcessor : public StoppableThread {
     std::shared_ptr<creatures::DynamixelSensorHandler> dynamixelSensorHandler;
 };
 
-} // namespace creatures
\ No newline at end of file
+} // namespace creatures
@@ -1,8 +1,11 @@
 #include <string>
 
+#include "controller-config.h"
+
 #include "config/UARTDevice.h"
 #include "io/Message.h"
 #include "io/MessageRouter.h"
+#include "logging/LogRateLimiter.h"
 #include "logging/Logger.h"
 #include "util/thread_name.h"
 
@@ -25,8 +28,9 @@ MessageRouter::MessageRouter(const std::shared_ptr<Logger> &logger) : logger(log
 }
 
 Result<bool> MessageRouter::registerServoModuleHandler(creatures::config::UARTDevice::module_name moduleName,
-                                                       std::shared_ptr<MessageQueue<Message>> incomingMessages,
-                                                       std::shared_ptr<MessageQueue<Message>> outgoingMessages) {
+                                                       std::shared_ptr<SpscQueue<Message>> incomingMessages,
+                                                       std::shared_ptr<SpscQueue<Message>> outgoingMessages,
+                                                       std::shared_ptr<PositionSlot> pendingPosition) {
 
     // Make sure this module isn't already registered
     if (this->servoHandlers.find(moduleName) != this->servoHandlers.end()) {
@@ -36,43 +40,117 @@ Result<bool> MessageRouter::registerServoModuleHandler(creatures::config::UARTDe
         return Result<bool>{ControllerError(ControllerError::InvalidConfiguration, errorMessage)};
     }
 
-    this->servoHandlers[moduleName] = {incomingMessages, outgoingMessages};
+    this->servoHandlers[moduleName] = {incomingMessages, outgoingMessages, std::move(pendingPosition),
+                                      std::make_unique<std::mutex>(),
+                                      std::make_unique<std::atomic<SerialFraming>>(SerialFraming::text)};
     this->handlerStates[moduleName] = MotorHandlerState::unknown;
     this->logger->info("Registered module: {}", UARTDevice::moduleNameToString(moduleName));
     return Result<bool>{true};
 }
 
-Result<bool> MessageRouter::sendMessageToCreature(const Message &message) {
+Result<bool> MessageRouter::sendMessageToCreature(Message message) {
 
-    logger->trace("Sending message to creature on module {}: {}", UARTDevice::moduleNameToString(message.module),
-                  message.payload);
+    if (logger->isTraceEnabled()) {
+        logger->trace("Sending message to creature on module {}: {}", UARTDevice::moduleNameToString(message.module),
+                      message.payload);
+    }
 
     // Find the handler for this module
-    auto it = servoHandlers.find(message.module);
-    if (it != servoHandlers.end()) {
-        // Found the handler, send the message
-        it->second.outgoingQueue->push(message);
-        return Result<bool>{true};
+    const auto module = message.module;
+    auto it = servoHandlers.find(module);
+    if (it == servoHandlers.end()) {
+        return routingFailed(module, false);
+    }
+
+    // Found the handler, send the message
+    if (!pushToModule(it->second, std::move(message))) {
+        return routingFailed(module, true);
+    }
+    return Result<bool>{true};
+}
+
+Result<bool> MessageRouter::sendPositionToCreature(UARTDevice::module_name module, std::string_view frame,
+                                                   SerialFraming framing, const MotionTimestamps &timestamps) {
+
+    auto it = servoHandlers.find(module);
+    if (it == servoHandlers.end()) {
+        return routingFailed(module, false);
+    }
+
+    if (!offerPositionToModule(it->second, module, frame, framing, timestamps)) {
+        return routingFailed(module, true);
     }
+    return Result<bool>{true};
+}
+
+Result<bool> MessageRouter::routingFailed(UARTDevice::module_name module, bool moduleKnown) {
 
     // Module not found - this is an error
+    if (!moduleKnown) {
+        std::string errorMessage =
+            fmt::format("Unknown destination module: {}", UARTDevice::moduleNameToString(module));
+        this->logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::DestinationUnknown, errorMessage)};
+    }
+
     std::string errorMessage =
-        fmt::format("Unknown destination module: {}", UARTDevice::moduleNameToString(message.module));
-    this->logger->error(errorMessage);
-    return Result<bool>{ControllerError(ControllerError::DestinationUnknown, errorMessage)};
+        fmt::format("Outgoing queue for module {} is full or shutting down ({} dropped)",
+                    UARTDevice::moduleNameToString(module), servoHandlers.at(module).outgoingQueue->dropped());
+    this->logger->warn(errorMessage);
+    return Result<bool>{ControllerError(ControllerError::IOError, errorMessage)};
 }
 
 void MessageRouter::broadcastMessageToAllModules(const std::string &message) {
 
     logger->debug("📣 Broadcasting message to all modules: {}", message);
 
-    for (const auto &pair : servoHandlers) {
+    for (auto &pair : servoHandlers) {
         creatures::config::UARTDevice::module_name moduleName = pair.first;
-        auto handlerQueues = pair.second;
 
         // Create a message for this module and send it
-        handlerQueues.outgoingQueue->push(Message(moduleName, message));
+        if (!pushToModule(pair.second, Message(moduleName, message))) {
+            logger->warn("unable to broadcast to module {}, its outgoing queue is full or shutting down",
+                         UARTDevice::moduleNameToString(moduleName));
+        }
+    }
+}
+
+bool MessageRouter::pushToModule(HandlerQueues &queues, Message message) {
+    std::lock_guard<std::mutex> lock(*queues.producerMutex);
+    if (!message.isPosition || !queues.pendingPosition) {
+        return queues.outgoingQueue->push(std::move(message));
+    }
+    if (queues.outgoingQueue->is_shutdown_requested()) {
+        return false; // Nobody's going to come get it
+    }
+
+    // Latest wins. If there was already one waiting, the writer's been told
+    // about it and will pick this one up instead. If not, knock on its door.
+    const auto module = message.module;
+    if (queues.pendingPosition->offer(std::move(message))) {
+        queues.outgoingQueue->push(Message(module, std::string()));
+    }
+    return true;
+}
+
+bool MessageRouter::offerPositionToModule(HandlerQueues &queues, UARTDevice::module_name module,
+                                          std::string_view frame, SerialFraming framing,
+                                          const MotionTimestamps &timestamps) {
+    if (!queues.pendingPosition) {
+        auto message = Message(module, std::string(frame), framing);
+        message.timestamps = timestamps;
+        message.isPosition = true;
+        return pushToModule(queues, std::move(message));
     }
+
+    std::lock_guard<std::mutex> lock(*queues.producerMutex);
+    if (queues.outgoingQueue->is_shutdown_requested()) {
+        return false;
+    }
+    if (queues.pendingPosition->offer(module, frame, framing, timestamps)) {
+        queues.outgoingQueue->push(Message(module, std::string()));
+    }
+    return true;
 }
 
 Result<bool> MessageRouter::receivedMessageFromCreature(const Message &message) {
@@ -111,7 +189,8 @@ void MessageRouter::run() {
 
         if (messageOpt.has_value()) {
             auto incomingMessage = messageOpt.value();
-            this->logger->debug("incoming message from a creature: {}", incomingMessage.payload);
+            LOG_RATE_LIMITED(this->logger, debug, ROUTER_LOG_LINES_PER_SECOND, "incoming message from a creature: {}",
+                             incomingMessage.payload);
 
             // TODO: Something maybe should happen here other than logging it
         }
@@ -159,4 +238,50 @@ std::vector<creatures::config::UARTDevice::module_name> MessageRouter::getHandle
     return ids;
 }
 
+void MessageRouter::setBinaryFramingAllowed(bool allowed) {
+    this->binaryFramingAllowed.store(allowed);
+    this->logger->info("binary serial framing is {}", allowed ? "allowed" : "not allowed");
+}
+
+Result<SerialFraming> MessageRouter::negotiateFraming(creatures::config::UARTDevice::module_name moduleName,
+                                                      bool firmwareSupportsBinary) {
+
+    auto it = servoHandlers.find(moduleName);
+    if (it == servoHandlers.end()) {
+        std::string errorMessage =
+            fmt::format("Module {} is not registered", UARTDevice::moduleNameToString(moduleName));
+        this->logger->error(errorMessage);
+        return Result<SerialFraming>{ControllerError(ControllerError::InvalidConfiguration, errorMessage)};
+    }
+
+    const auto framing =
+        firmwareSupportsBinary && binaryFramingAllowed.load() ? SerialFraming::binary : SerialFraming::text;
+    it->second.framing->store(framing);
+
+    this->logger->info("module {} will use {} framing (firmware {} binary)", UARTDevice::moduleNameToString(moduleName),
+                       framing == SerialFraming::binary ? "binary" : "text",
+                       firmwareSupportsBinary ? "supports" : "does not support");
+    return Result<SerialFraming>{framing};
+}
+
+SerialFraming MessageRouter::getHandlerFraming(creatures::config::UARTDevice::module_name moduleName) const {
+    auto it = servoHandlers.find(moduleName);
+    if (it == servoHandlers.end()) {
+        return SerialFraming::text;
+    }
+    return it->second.framing->load(std::memory_order_relaxed);
+}
+
+size_t MessageRouter::getNumberOfHandlers() const { return servoHandlers.size(); }
+
+u64 MessageRouter::getPositionsReplaced() const {
+    u64 replaced = 0;
+    for (const auto &pair : servoHandlers) {
+        if (pair.second.pendingPosition) {
+            replaced += pair.second.pendingPosition->replaced();
+        }
+    }
+    return replaced;
+}
+
 } // namespace creatures::io
\ No newline at end of file
@@ -1,14 +1,21 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "config/UARTDevice.h"
+#include "io/BinaryFraming.h"
 #include "io/Message.h"
+#include "io/PositionSlot.h"
 #include "logging/Logger.h"
 #include "util/MessageQueue.h"
 #include "util/Result.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 
 namespace creatures ::io {
@@ -34,19 +41,47 @@ class MessageRouter : public StoppableThread {
      * @param moduleName the name of the module to register
      * @param incomingMessages the incoming message queue for the handler
      * @param outgoingMessages the outgoing message queue for the handler
+     * @param pendingPosition where the handler's next position frame waits. If
+     *                        this is null, positions go in the queue like
+     *                        everything else.
      * @return a `Result` indicating success or failure
      */
     Result<bool> registerServoModuleHandler(creatures::config::UARTDevice::module_name moduleName,
-                                            std::shared_ptr<MessageQueue<Message>> incomingMessages,
-                                            std::shared_ptr<MessageQueue<Message>> outgoingMessages);
+                                            std::shared_ptr<SpscQueue<Message>> incomingMessages,
+                                            std::shared_ptr<SpscQueue<Message>> outgoingMessages,
+                                            std::shared_ptr<PositionSlot> pendingPosition = nullptr);
 
     /**
      * Send a message to a specific creature module
      *
+     * A module's outgoing queue is a single-producer ring, and we're that
+     * producer. Callers on any thread are serialized here, so nobody else
+     * should ever push onto an outgoing queue directly.
+     *
+     * Positions (`Message::isPosition`) don't queue up behind each other. A
+     * newer one replaces one that hasn't gone out yet, and an empty message
+     * goes in the ring to wake the writer up when the slot was empty.
+     *
      * @param message the message to route
      * @return a `Result` indicating success or failure
      */
-    Result<bool> sendMessageToCreature(const Message &message);
+    Result<bool> sendMessageToCreature(Message message);
+
+    /**
+     * Send a position frame to a specific creature module
+     *
+     * This is what the control loop uses every tick. The frame is copied
+     * straight into a buffer the module's `PositionSlot` keeps around, so once
+     * things are warmed up, sending a frame doesn't allocate anything.
+     *
+     * @param module the module to send the frame to
+     * @param frame the encoded frame (only needs to live through this call)
+     * @param framing how the frame is laid out
+     * @param timestamps where the input that made it came from, and when
+     * @return a `Result` indicating success or failure
+     */
+    Result<bool> sendPositionToCreature(creatures::config::UARTDevice::module_name module, std::string_view frame,
+                                        SerialFraming framing, const MotionTimestamps &timestamps);
 
     /**
      * Broadcast a message to all registered modules
@@ -91,18 +126,95 @@ class MessageRouter : public StoppableThread {
      */
     std::vector<creatures::config::UARTDevice::module_name> getHandleIds();
 
+    /**
+     * Allow (or forbid) binary framing to modules whose firmware supports it
+     *
+     * This is off unless the configuration turns it on, so a controller that's
+     * upgraded before its firmware (or the other way around) keeps talking text.
+     *
+     * @param allowed true if we may use binary framing
+     */
+    void setBinaryFramingAllowed(bool allowed);
+
+    /**
+     * Work out which framing to use for a module now that we know what its
+     * firmware supports
+     *
+     * @param moduleName the module that just told us what it can do
+     * @param firmwareSupportsBinary true if the firmware advertised binary framing
+     * @return the framing we'll use for this module from now on
+     */
+    Result<SerialFraming> negotiateFraming(creatures::config::UARTDevice::module_name moduleName,
+                                           bool firmwareSupportsBinary);
+
+    /**
+     * Get the framing to use when sending to a module. Safe from any thread.
+     *
+     * @param moduleName the module to look up
+     * @return the module's framing, or text if we don't know about it
+     */
+    SerialFraming getHandlerFraming(creatures::config::UARTDevice::module_name moduleName) const;
+
+    /**
+     * Get the number of registered handlers without building a list of them
+     *
+     * @return how many modules are registered
+     */
+    size_t getNumberOfHandlers() const;
+
+    /**
+     * How many position frames, across every module, were replaced by a newer
+     * one before they went out. Safe from any thread.
+     */
+    u64 getPositionsReplaced() const;
+
   protected:
     void run() override;
 
   private:
     // Internal struct to hold the incoming and outgoing queues for a handler
     struct HandlerQueues {
-        std::shared_ptr<MessageQueue<Message>> incomingQueue;
-        std::shared_ptr<MessageQueue<Message>> outgoingQueue;
+        std::shared_ptr<SpscQueue<Message>> incomingQueue;
+        std::shared_ptr<SpscQueue<Message>> outgoingQueue;
+
+        // The newest position frame that hasn't gone out yet (may be null)
+        std::shared_ptr<PositionSlot> pendingPosition;
+
+        // Makes everyone who sends to this module take turns as the ring's one producer
+        std::unique_ptr<std::mutex> producerMutex;
+
+        // What the firmware on this module and we agreed to speak. Read by the
+        // control loop every frame, so it's an atomic rather than behind a lock.
+        std::unique_ptr<std::atomic<SerialFraming>> framing;
     };
 
+    /**
+     * Push onto a module's outgoing ring on behalf of whoever is calling
+     *
+     * @return false if the ring was full or is shutting down
+     */
+    static bool pushToModule(HandlerQueues &queues, Message message);
+
+    /**
+     * Copy a position frame into a module's slot (or its ring, if it doesn't
+     * have a slot) on behalf of whoever is calling
+     *
+     * @return false if the ring was full or is shutting down
+     */
+    static bool offerPositionToModule(HandlerQueues &queues, creatures::config::UARTDevice::module_name module,
+                                      std::string_view frame, SerialFraming framing,
+                                      const MotionTimestamps &timestamps);
+
+    /**
+     * Log (and build the error for) a message that didn't make it to a module
+     */
+    Result<bool> routingFailed(creatures::config::UARTDevice::module_name module, bool moduleKnown);
+
     std::shared_ptr<Logger> logger;
 
+    // Are we allowed to use binary framing at all?
+    std::atomic<bool> binaryFramingAllowed{false};
+
     // Messages in from creatures
     std::shared_ptr<MessageQueue<Message>> incomingQueue;
 
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "controller-config.h"
+#include "io/Message.h"
+
+namespace creatures::io {
+
+/**
+ * The one position frame waiting to go out to a module
+ *
+ * Control messages (INIT, CONFIG, PING, ESTOP...) go through a module's
+ * outgoing ring in order, and every one of them matters. Positions are
+ * different: once there's a newer frame, the old one is just a place the
+ * servos used to be headed. If the writer falls behind (a USB hiccup, a UART
+ * that's full), piling them up means the firmware plays back a burst of stale
+ * motion once it catches up.
+ *
+ * So positions go here instead, and a newer frame takes the place of one that
+ * hasn't gone out yet (and that's counted). The writer sends whatever control
+ * messages are waiting first, then takes the latest position.
+ *
+ * The router offers (one thread at a time, under its producer lock) and the
+ * writer takes. It's only ever held for a move, so a plain mutex is fine.
+ *
+ * A frame goes out every tick, so the slot keeps its buffers around rather
+ * than making a new string for each one. A frame copied in goes into the
+ * payload that's waiting (or the one the writer gave back), and once those
+ * have grown to the size of a frame nothing new gets allocated.
+ */
+class PositionSlot {
+  public:
+    PositionSlot() = default;
+
+    PositionSlot(const PositionSlot &) = delete;
+    PositionSlot &operator=(const PositionSlot &) = delete;
+
+    /**
+     * Put a position frame in the slot
+     *
+     * @param message the newest frame
+     * @return true if the slot was empty, false if this replaced one that
+     *         hadn't gone out yet
+     */
+    bool offer(Message message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const bool wasEmpty = !pending.has_value();
+        pending.emplace(std::move(message));
+
+        offeredCount.fetch_add(1, std::memory_order_relaxed);
+        if (!wasEmpty) {
+            replacedCount.fetch_add(1, std::memory_order_relaxed); // Hop over the old one
+        }
+        return wasEmpty;
+    }
+
+    /**
+     * Copy a position frame into the slot, reusing whatever buffer is on hand
+     *
+     * @param module the module the frame is for
+     * @param payload the newest frame
+     * @param framing how the frame is laid out
+     * @param timestamps where the input that made it came from, and when
+     * @return true if the slot was empty, false if this replaced one that
+     *         hadn't gone out yet
+     */
+    bool offer(UARTDevice::module_name module, std::string_view payload, SerialFraming framing,
+               const MotionTimestamps &timestamps) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const bool wasEmpty = !pending.has_value();
+        if (wasEmpty) {
+            pending.emplace(module, std::move(spare), framing);
+            spare = std::string();
+        }
+        pending->module = module;
+        pending->payload.assign(payload);
+        pending->framing = framing;
+        pending->timestamps = timestamps;
+        pending->isPosition = true;
+
+        offeredCount.fetch_add(1, std::memory_order_relaxed);
+        if (!wasEmpty) {
+            replacedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return wasEmpty;
+    }
+
+    /**
+     * Take the frame if there is one
+     *
+     * @return the newest frame, or nullopt if it's already gone out
+     */
+    std::optional<Message> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::optional<Message> message = std::move(pending);
+        pending.reset();
+        return message;
+    }
+
+    /**
+     * Hand a frame's buffer back once it's been written, so the next one
+     * can use it
+     *
+     * @param message a frame that came out of `take()`
+     */
+    void recycle(Message &&message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (message.payload.capacity() > spare.capacity()) {
+            spare = std::move(message.payload);
+        }
+    }
+
+    /**
+     * How many frames have been offered
+     */
+    [[nodiscard]] u64 offered() const { return offeredCount.load(std::memory_order_relaxed); }
+
+    /**
+     * How many frames were replaced by a newer one before they went out
+     */
+    [[nodiscard]] u64 replaced() const { return replacedCount.load(std::memory_order_relaxed); }
+
+  private:
+    std::mutex mutex;
+    std::optional<Message> pending;
+
+    // A buffer the writer gave back, for the next frame to go in
+    std::string spare;
+
+    std::atomic<u64> offeredCount{0};
+    std::atomic<u64> replacedCount{0};
+};
+
+} // namespace creatures::io
@@ -14,6 +14,7 @@
 #include "io/SerialHandler.h"
 #include "io/SerialReader.h"
 #include "io/SerialWriter.h"
+#include "replay/CaptureWriter.h"
 #include "util/Result.h"
 
 namespace creatures {
@@ -25,14 +26,16 @@ using creatures::io::Message;
  * Creates a new SerialHandler
  *
  * @param deviceNode the device node to open up
- * @param outgoingQueue A `MessageQueue<Message>` for outgoing messages TO the remote device
- * @param incomingQueue A `MessageQueue<Message>` for incoming messages FROM the remote device
+ * @param outgoingQueue A `SpscQueue<Message>` for outgoing messages TO the remote device
+ * @param incomingQueue A `SpscQueue<Message>` for incoming messages FROM the remote device
+ * @param pendingPosition Where the newest position frame waits for the writer (may be null)
  */
 SerialHandler::SerialHandler(const std::shared_ptr<Logger> &logger, std::string deviceNode,
                              UARTDevice::module_name moduleName,
-                             const std::shared_ptr<MessageQueue<Message>> &outgoingQueue,
-                             const std::shared_ptr<MessageQueue<Message>> &incomingQueue)
-    : deviceNode(deviceNode), moduleName(moduleName), logger(logger) {
+                             const std::shared_ptr<SpscQueue<Message>> &outgoingQueue,
+                             const std::shared_ptr<SpscQueue<Message>> &incomingQueue,
+                             const std::shared_ptr<io::PositionSlot> &pendingPosition)
+    : deviceNode(deviceNode), moduleName(moduleName), pendingPosition(pendingPosition), logger(logger) {
 
     this->logger->info("creating a new SerialHandler for device {} on node {} 🐰",
                        UARTDevice::moduleNameToString(moduleName), deviceNode);
@@ -74,9 +77,13 @@ SerialHandler::~SerialHandler() {
 UARTDevice::module_name SerialHandler::getModuleName() const { return this->moduleName; }
 
 // Access to our queues
-std::shared_ptr<MessageQueue<Message>> SerialHandler::getOutgoingQueue() { return this->outgoingQueue; }
+std::shared_ptr<SpscQueue<Message>> SerialHandler::getOutgoingQueue() { return this->outgoingQueue; }
 
-std::shared_ptr<MessageQueue<Message>> SerialHandler::getIncomingQueue() { return this->incomingQueue; }
+std::shared_ptr<SpscQueue<Message>> SerialHandler::getIncomingQueue() { return this->incomingQueue; }
+
+std::shared_ptr<io::SerialPortStats> SerialHandler::getStats() { return this->stats; }
+
+void SerialHandler::setCapture(const std::shared_ptr<replay::CaptureWriter> &_capture) { this->capture = _capture; }
 
 Result<bool> SerialHandler::setupSerialPort() {
     this->logger->info("attempting to open {}", this->deviceNode);
@@ -91,6 +98,13 @@ Result<bool> SerialHandler::setupSerialPort() {
         return Result<bool>{false};
     }
 
+    // Not a real port (/dev/null while replaying a capture, say), so there's
+    // nothing to set up. Writes go wherever it sends them.
+    if (!isatty(this->fileDescriptor)) {
+        this->logger->warn("{} isn't a serial port, so it's being used as-is", this->deviceNode);
+        return Result<bool>{true};
+    }
+
     struct termios tty{};
     if (tcgetattr(this->fileDescriptor, &tty) != 0) {
         // Can't configure the port - return error instead of exiting
@@ -169,10 +183,12 @@ Result<bool> SerialHandler::start() {
 
     // Create the reader and writer threads
     reader = std::make_shared<creatures::io::SerialReader>(this->logger, this->deviceNode, this->moduleName,
-                                                           this->fileDescriptor, this->incomingQueue);
+                                                           this->fileDescriptor, this->incomingQueue, this->stats,
+                                                           this->capture);
 
     writer = std::make_shared<creatures::io::SerialWriter>(this->logger, this->deviceNode, this->moduleName,
-                                                           this->fileDescriptor, this->outgoingQueue);
+                                                           this->fileDescriptor, this->outgoingQueue, this->stats,
+                                                           this->capture, this->pendingPosition);
 
     // Start both threads
     reader->start();
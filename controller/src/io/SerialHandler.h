@@ -12,8 +12,10 @@
 #include "config/UARTDevice.h"
 #include "logging/Logger.h"
 #include "io/Message.h"
-#include "util/MessageQueue.h"
+#include "io/PositionSlot.h"
+#include "io/SerialPortStats.h"
 #include "util/Result.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 
 namespace creatures {
@@ -26,6 +28,9 @@ namespace creatures {
         class SerialReader;
         class SerialWriter;
     }
+    namespace replay {
+        class CaptureWriter;
+    }
 
     /**
      * Manages a serial port connection with reader and writer threads
@@ -44,14 +49,16 @@ namespace creatures {
          * @param logger our logger
          * @param deviceNode the device node to open up
          * @param moduleName the name of the module we are communicating with
-         * @param outgoingQueue A `MessageQueue<Message>` for outgoing messages TO the remote device
-         * @param incomingQueue A `MessageQueue<Message>` for incoming messages FROM the remote device
+         * @param outgoingQueue A `SpscQueue<Message>` for outgoing messages TO the remote device (the writer is its only consumer)
+         * @param incomingQueue A `SpscQueue<Message>` for incoming messages FROM the remote device (the reader is its only producer)
+         * @param pendingPosition Where the newest position frame waits for the writer, if positions don't use the queue
          */
         SerialHandler(const std::shared_ptr<Logger>& logger,
                       std::string deviceNode,
                       UARTDevice::module_name moduleName,
-                      const std::shared_ptr<MessageQueue<Message>>& outgoingQueue,
-                      const std::shared_ptr<MessageQueue<Message>>& incomingQueue);
+                      const std::shared_ptr<SpscQueue<Message>>& outgoingQueue,
+                      const std::shared_ptr<SpscQueue<Message>>& incomingQueue,
+                      const std::shared_ptr<io::PositionSlot>& pendingPosition = nullptr);
 
         // Clean up the serial port
         ~SerialHandler();
@@ -59,8 +66,19 @@ namespace creatures {
         Result<bool> start();
         Result<bool> shutdown();
 
-        std::shared_ptr<MessageQueue<Message>> getOutgoingQueue();
-        std::shared_ptr<MessageQueue<Message>> getIncomingQueue();
+        std::shared_ptr<SpscQueue<Message>> getOutgoingQueue();
+        std::shared_ptr<SpscQueue<Message>> getIncomingQueue();
+
+        /**
+         * How much has gone in and out of this port
+         */
+        std::shared_ptr<io::SerialPortStats> getStats();
+
+        /**
+         * Capture everything that goes in and out of this port. Only takes
+         * effect if it's set before `start()`.
+         */
+        void setCapture(const std::shared_ptr<replay::CaptureWriter>& capture);
 
         /**
          * Get the module name for this serial handler
@@ -86,9 +104,18 @@ namespace creatures {
         UARTDevice::module_name moduleName;
         int fileDescriptor = -1;
 
-        // Our shared MessageQueues
-        std::shared_ptr<MessageQueue<Message>> outgoingQueue;
-        std::shared_ptr<MessageQueue<Message>> incomingQueue;
+        // Our shared rings
+        std::shared_ptr<SpscQueue<Message>> outgoingQueue;
+        std::shared_ptr<SpscQueue<Message>> incomingQueue;
+
+        // The newest position frame, if there's one waiting (may be null)
+        std::shared_ptr<io::PositionSlot> pendingPosition;
+
+        // Shared with the reader and writer, and outlives them both
+        std::shared_ptr<io::SerialPortStats> stats = std::make_shared<io::SerialPortStats>();
+
+        // Where to capture our traffic, if anywhere
+        std::shared_ptr<replay::CaptureWriter> capture;
 
         static bool isDeviceNodeAccessible(const std::shared_ptr<Logger>& logger, const std::string& deviceNode);
 
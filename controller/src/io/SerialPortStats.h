@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+
+#include "controller-config.h"
+
+namespace creatures::io {
+
+/**
+ * How much has gone in and out of one serial port
+ *
+ * The reader and writer threads each bump their own half, and anyone can
+ * look. Everything's relaxed since these are only ever for counting.
+ */
+struct SerialPortStats {
+    std::atomic<u64> bytesRead{0};
+    std::atomic<u64> messagesRead{0};
+    std::atomic<u64> linesTooLong{0};
+    std::atomic<u64> bytesWritten{0};
+    std::atomic<u64> messagesWritten{0};
+
+    // Writes the port only took part of (we pick up where it left off)
+    std::atomic<u64> shortWrites{0};
+
+    // Time spent in write calls, and waiting for the port to have room
+    std::atomic<u64> writeNs{0};
+    std::atomic<u64> writeWaitNs{0};
+
+    // Bytes written over the last SERIAL_WRITE_STATS_INTERVAL_MS
+    std::atomic<u64> bytesWrittenPerSecond{0};
+};
+
+} // namespace creatures::io
@@ -3,12 +3,16 @@
 //
 
 #include <iostream>
+#include <string>
+#include <string_view>
 #include <poll.h>
 #include <unistd.h>
 
 #include "config/UARTDevice.h"
+#include "io/LineSplitter.h"
 #include "io/Message.h"
 #include "io/SerialReader.h"
+#include "replay/CaptureWriter.h"
 #include "util/thread_name.h"
 
 namespace creatures ::io {
@@ -18,9 +22,11 @@ using creatures::io::Message;
 
 SerialReader::SerialReader(const std::shared_ptr<Logger> &logger, std::string deviceNode,
                            UARTDevice::module_name moduleName, int fileDescriptor,
-                           const std::shared_ptr<MessageQueue<Message>> &incomingQueue)
-    : logger(logger), incomingQueue(incomingQueue), deviceNode(deviceNode), moduleName(moduleName),
-      fileDescriptor(fileDescriptor) {
+                           const std::shared_ptr<SpscQueue<Message>> &incomingQueue,
+                           const std::shared_ptr<SerialPortStats> &stats,
+                           const std::shared_ptr<replay::CaptureWriter> &capture)
+    : logger(logger), incomingQueue(incomingQueue), stats(stats), capture(capture), deviceNode(deviceNode),
+      moduleName(moduleName), fileDescriptor(fileDescriptor) {
 
     this->logger->info("creating a new SerialReader for module {} on {} 🐰", UARTDevice::moduleNameToString(moduleName),
                        deviceNode);
@@ -43,7 +49,22 @@ void SerialReader::run() {
     fds[0].fd = this->fileDescriptor;
     fds[0].events = POLLIN;
 
-    std::string tempBuffer; // Temporary buffer to store incomplete messages
+    LineSplitter splitter;
+    u64 linesTooLongSoFar = 0;
+
+    // Every complete line the firmware sent goes on to be processed
+    auto onLine = [this](std::string_view line) {
+        stats->messagesRead.fetch_add(1, std::memory_order_relaxed);
+        if (capture) {
+            capture->recordSerial(replay::RecordKind::serialIn, this->moduleName, line);
+        }
+        Message incomingMessage = Message(this->moduleName, std::string(line));
+        this->logger->trace("adding message '{}' to the incoming queue", incomingMessage.payload);
+        if (!this->incomingQueue->push(std::move(incomingMessage)) && !this->incomingQueue->is_shutdown_requested()) {
+            this->logger->warn("incoming queue for {} is full, dropped a message ({} dropped so far)", this->deviceNode,
+                               this->incomingQueue->dropped());
+        }
+    };
 
     while (!stop_requested.load()) {
         int ret = poll(fds, 1, timeout_msecs);
@@ -72,10 +93,8 @@ void SerialReader::run() {
         }
 
         if (fds[0].revents & POLLIN) {
-            char readBuf[256];
-            memset(&readBuf, '\0', sizeof(readBuf));
-
-            ssize_t numBytes = read(this->fileDescriptor, &readBuf, sizeof(readBuf) - 1);
+            auto space = splitter.writable();
+            ssize_t numBytes = read(this->fileDescriptor, space.data(), space.size());
 
             if (numBytes < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
@@ -92,22 +111,15 @@ void SerialReader::run() {
                 break; // Exit thread gracefully instead of calling std::exit
             }
 
-            tempBuffer.append(readBuf, numBytes); // Append new data to tempBuffer
-
-            size_t newlinePos;
-            while ((newlinePos = tempBuffer.find('\n')) != std::string::npos) {
-                std::string line = tempBuffer.substr(0, newlinePos);
-                if (!line.empty() && line.back() == '\r') {
-                    line.pop_back();
-                }
-
-                if (!line.empty()) {
-                    Message incomingMessage = Message(this->moduleName, line);
-                    this->logger->trace("adding message '{}' to the incoming queue", incomingMessage.payload);
-                    this->incomingQueue->push(incomingMessage);
-                }
+            stats->bytesRead.fetch_add(static_cast<u64>(numBytes), std::memory_order_relaxed);
+            splitter.commit(static_cast<size_t>(numBytes), onLine);
 
-                tempBuffer.erase(0, newlinePos + 1);
+            if (splitter.getLinesTooLong() != linesTooLongSoFar) {
+                stats->linesTooLong.fetch_add(splitter.getLinesTooLong() - linesTooLongSoFar,
+                                              std::memory_order_relaxed);
+                linesTooLongSoFar = splitter.getLinesTooLong();
+                this->logger->warn("threw out a line from {} that was longer than {} bytes", this->deviceNode,
+                                   SERIAL_MAX_LINE_LENGTH);
             }
         }
     }
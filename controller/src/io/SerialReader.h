@@ -10,10 +10,15 @@
 #include "controller-config.h"
 #include "logging/Logger.h"
 #include "io/Message.h"
+#include "io/SerialPortStats.h"
 #include "config/UARTDevice.h"
-#include "util/MessageQueue.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 
+namespace creatures::replay {
+    class CaptureWriter; // Forward declaration
+}
+
 namespace creatures::io {
 
     using creatures::config::UARTDevice;
@@ -34,7 +39,9 @@ namespace creatures::io {
                      std::string deviceNode,
                      UARTDevice::module_name moduleName,
                      int fileDescriptor,
-                     const std::shared_ptr<MessageQueue<Message>>& incomingQueue);
+                     const std::shared_ptr<SpscQueue<Message>>& incomingQueue,
+                     const std::shared_ptr<SerialPortStats>& stats,
+                     const std::shared_ptr<replay::CaptureWriter>& capture = nullptr);
 
         ~SerialReader() override {
             this->logger->info("SerialReader destroyed");
@@ -47,7 +54,9 @@ namespace creatures::io {
 
     private:
         std::shared_ptr<Logger> logger;
-        std::shared_ptr<MessageQueue<Message>> incomingQueue;
+        std::shared_ptr<SpscQueue<Message>> incomingQueue;
+        std::shared_ptr<SerialPortStats> stats;
+        std::shared_ptr<replay::CaptureWriter> capture; // Only set if we're capturing serial traffic
         std::string deviceNode;
         UARTDevice::module_name moduleName;
         int fileDescriptor;
@@ -1,20 +1,39 @@
+#include <array>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <poll.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include "controller/MotionLatency.h"
 #include "io/Message.h"
 #include "io/SerialWriter.h"
 #include "logging/Logger.h"
+#include "replay/CaptureWriter.h"
 #include "util/thread_name.h"
 
 namespace creatures ::io {
 
 using creatures::io::Message;
 
+namespace {
+
+u64 nanosecondsSince(std::chrono::steady_clock::time_point startedAt) {
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startedAt).count());
+}
+
+} // namespace
+
 SerialWriter::SerialWriter(const std::shared_ptr<Logger> &logger, std::string deviceNode,
                            UARTDevice::module_name moduleName, int fileDescriptor,
-                           const std::shared_ptr<MessageQueue<Message>> &outgoingQueue)
-    : logger(logger), outgoingQueue(outgoingQueue), deviceNode(std::move(deviceNode)), moduleName(moduleName),
-      fileDescriptor(fileDescriptor) {
+                           const std::shared_ptr<SpscQueue<Message>> &outgoingQueue,
+                           const std::shared_ptr<SerialPortStats> &stats,
+                           const std::shared_ptr<replay::CaptureWriter> &capture,
+                           const std::shared_ptr<PositionSlot> &pendingPosition)
+    : logger(logger), outgoingQueue(outgoingQueue), pendingPosition(pendingPosition), stats(stats), capture(capture),
+      deviceNode(std::move(deviceNode)), moduleName(moduleName), fileDescriptor(fileDescriptor) {
 
     this->logger->info("creating a new SerialWriter for device {} 🐰", this->deviceNode);
 }
@@ -30,56 +49,220 @@ void SerialWriter::run() {
     this->threadName = fmt::format("SerialWriter::run for {}", this->deviceNode);
     setThreadName(threadName);
 
+    std::vector<Message> batch;
+    batch.reserve(SERIAL_WRITE_BATCH_MAX_MESSAGES);
+
     while (!stop_requested.load()) {
+        updateRateIfDue();
+
         // Use timeout-based pop to allow shutdown checking
         auto messageOpt = outgoingQueue->pop_timeout(std::chrono::milliseconds(100));
 
-        // Check if we got a message or if shutdown was requested
-        if (!messageOpt.has_value()) {
-            if (outgoingQueue->is_shutdown_requested() || stop_requested.load()) {
-                break; // Exit gracefully during shutdown
-            }
+        batch.clear();
+        if (messageOpt.has_value()) {
+            batch.push_back(std::move(messageOpt.value()));
+        } else if (outgoingQueue->is_shutdown_requested() || stop_requested.load()) {
+            break; // Exit gracefully during shutdown
+        }
+
+        // ...and anything else that's already waiting goes along with it. (If
+        // we timed out, this still catches a position we never got woken for.)
+        gatherBatch(batch);
+        if (batch.empty()) {
             continue; // Timeout, check again
         }
 
-        Message outgoingMessage = messageOpt.value();
+        if (!writeMessages(batch)) {
+            break; // Exit thread gracefully instead of calling std::exit
+        }
 
-        // Skip empty messages that might come from shutdown
-        if (outgoingMessage.payload.empty()) {
+        // The position's buffer can hold the next one
+        if (pendingPosition && batch.back().isPosition) {
+            pendingPosition->recycle(std::move(batch.back()));
+        }
+    }
+
+    this->logger->info("SerialWriter for {} shutting down normally", this->deviceNode);
+}
+
+void SerialWriter::gatherBatch(std::vector<Message> &batch) {
+
+    // Leave room at the end for a position
+    const size_t queueRoom = pendingPosition ? SERIAL_WRITE_BATCH_MAX_MESSAGES - 1 : SERIAL_WRITE_BATCH_MAX_MESSAGES;
+    while (batch.size() < queueRoom) {
+        auto next = outgoingQueue->try_pop();
+        if (!next.has_value()) {
+            break;
+        }
+        batch.push_back(std::move(next.value()));
+    }
+
+    if (pendingPosition && batch.size() < SERIAL_WRITE_BATCH_MAX_MESSAGES) {
+        if (auto position = pendingPosition->take()) {
+            batch.push_back(std::move(position.value()));
+        }
+    }
+}
+
+bool SerialWriter::writeMessages(const std::vector<Message> &batch) {
+    static char newline = '\n';
+
+    // Two pieces per message at most: the payload, and a newline for text
+    std::array<iovec, SERIAL_WRITE_BATCH_MAX_MESSAGES * 2> pieces{};
+    size_t pieceCount = 0;
+    size_t totalBytes = 0;
+    size_t messageCount = 0;
+
+    const bool tracing = this->logger->isTraceEnabled();
+    for (const auto &outgoingMessage : batch) {
+        // Skip empty messages that might come from shutdown, and anything
+        // past what we've got room for (run() never hands us that many)
+        if (outgoingMessage.payload.empty() || pieceCount + 2 > pieces.size()) {
             continue;
         }
-        this->logger->trace("message to write to module {} on {}: {}",
-                            UARTDevice::moduleNameToString(outgoingMessage.module), deviceNode,
-                            outgoingMessage.payload);
 
-        // Append a newline character to the message
-        outgoingMessage.payload += '\n';
+        if (tracing) {
+            if (outgoingMessage.framing == SerialFraming::binary) {
+                // Binary frames bring their own delimiters, and aren't much to look at
+                this->logger->trace("binary frame to write to module {} on {}: {} bytes",
+                                    UARTDevice::moduleNameToString(outgoingMessage.module), deviceNode,
+                                    outgoingMessage.payload.length());
+            } else {
+                this->logger->trace("message to write to module {} on {}: {}",
+                                    UARTDevice::moduleNameToString(outgoingMessage.module), deviceNode,
+                                    outgoingMessage.payload);
+            }
+        }
+
+        pieces[pieceCount++] = {const_cast<char *>(outgoingMessage.payload.data()), outgoingMessage.payload.size()};
+        totalBytes += outgoingMessage.payload.size();
+        if (outgoingMessage.framing != SerialFraming::binary) {
+            pieces[pieceCount++] = {&newline, 1};
+            totalBytes++;
+        }
+        messageCount++;
+    }
+
+    if (pieceCount == 0) {
+        return true;
+    }
 
-        ssize_t bytesWritten = -1;
-        do {
-            bytesWritten =
-                write(this->fileDescriptor, outgoingMessage.payload.c_str(), outgoingMessage.payload.length());
-        } while (bytesWritten < 0 && errno == EINTR && !stop_requested.load());
+    // Keep going until the port has taken every byte
+    size_t firstPiece = 0;
+    size_t bytesLeft = totalBytes;
+    while (bytesLeft > 0) {
+        const auto startedAt = std::chrono::steady_clock::now();
+        const ssize_t bytesWritten =
+            writev(this->fileDescriptor, pieces.data() + firstPiece, static_cast<int>(pieceCount - firstPiece));
+        stats->writeNs.fetch_add(nanosecondsSince(startedAt), std::memory_order_relaxed);
 
         if (bytesWritten < 0) {
+            if (errno == EINTR && !stop_requested.load()) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!waitUntilWritable()) {
+                    return false;
+                }
+                continue;
+            }
             if (stop_requested.load()) {
-                break;
+                return false;
             }
             std::string errorMessage = fmt::format("Serial port {} write error: {}", this->deviceNode, strerror(errno));
             this->logger->error(errorMessage);
-            break; // Exit thread gracefully instead of calling std::exit
-        } else if (bytesWritten != static_cast<ssize_t>(outgoingMessage.payload.length())) {
-            std::string errorMessage = fmt::format("Serial port {} partial write - expected {} bytes, wrote {} bytes",
-                                                   this->deviceNode, outgoingMessage.payload.length(), bytesWritten);
-            this->logger->warn(errorMessage);
-            break; // Exit thread gracefully instead of calling std::exit
+            return false;
+        }
+
+        auto written = static_cast<size_t>(bytesWritten);
+        stats->bytesWritten.fetch_add(written, std::memory_order_relaxed);
+        bytesLeft -= written;
+
+        if (bytesLeft == 0) {
+            break;
+        }
+
+        // The port only took some of it. Skip over what it did take, and
+        // trim the piece it stopped partway through.
+        stats->shortWrites.fetch_add(1, std::memory_order_relaxed);
+        while (written >= pieces[firstPiece].iov_len) {
+            written -= pieces[firstPiece].iov_len;
+            firstPiece++;
         }
+        pieces[firstPiece].iov_base = static_cast<char *>(pieces[firstPiece].iov_base) + written;
+        pieces[firstPiece].iov_len -= written;
 
-        this->logger->trace("Written {} bytes to module {} on {}", bytesWritten,
-                            UARTDevice::moduleNameToString(outgoingMessage.module), deviceNode);
+        if (!waitUntilWritable()) {
+            return false;
+        }
     }
 
-    this->logger->info("SerialWriter for {} shutting down normally", this->deviceNode);
+    stats->messagesWritten.fetch_add(messageCount, std::memory_order_relaxed);
+
+    const std::int64_t writtenAt = MotionLatency::now();
+    for (const auto &outgoingMessage : batch) {
+        if (outgoingMessage.payload.empty()) {
+            continue;
+        }
+
+        if (capture) {
+            capture->recordSerial(replay::RecordKind::serialOut, outgoingMessage.module, outgoingMessage.payload);
+        }
+
+        // Positions are on their way to the servos, so that's the end of the
+        // line for their latency trace
+        MotionLatency::recordWritten(outgoingMessage.timestamps, writtenAt);
+    }
+
+    if (tracing) {
+        this->logger->trace("Written {} bytes ({} messages) to {}", totalBytes, messageCount, deviceNode);
+    }
+    return true;
+}
+
+bool SerialWriter::waitUntilWritable() {
+    pollfd fds[1];
+    fds[0].fd = this->fileDescriptor;
+    fds[0].events = POLLOUT;
+
+    while (!stop_requested.load()) {
+        const auto startedAt = std::chrono::steady_clock::now();
+        const int ret = poll(fds, 1, 100);
+        stats->writeWaitNs.fetch_add(nanosecondsSince(startedAt), std::memory_order_relaxed);
+
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            this->logger->error("Serial port {} poll error: {}", this->deviceNode, strerror(errno));
+            return false;
+        }
+        if (ret == 0) {
+            continue; // Still full, check if we're stopping and wait some more
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            this->logger->error("Serial port {} error detected (revents: {:#x}) - communication lost!",
+                                this->deviceNode, fds[0].revents);
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+void SerialWriter::updateRateIfDue() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = now - lastRateUpdate;
+    if (elapsed < std::chrono::milliseconds(SERIAL_WRITE_STATS_INTERVAL_MS)) {
+        return;
+    }
+
+    const u64 bytes = stats->bytesWritten.load(std::memory_order_relaxed);
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    stats->bytesWrittenPerSecond.store(static_cast<u64>(static_cast<double>(bytes - bytesAtLastRateUpdate) / seconds),
+                                       std::memory_order_relaxed);
+    lastRateUpdate = now;
+    bytesAtLastRateUpdate = bytes;
 }
 
 } // namespace creatures::io
\ No newline at end of file
@@ -4,16 +4,24 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "controller-config.h"
 #include "config/UARTDevice.h"
 #include "logging/Logger.h"
 #include "io/Message.h"
-#include "util/MessageQueue.h"
+#include "io/PositionSlot.h"
+#include "io/SerialPortStats.h"
+#include "util/SpscQueue.h"
 #include "util/StoppableThread.h"
 
+namespace creatures::replay {
+    class CaptureWriter; // Forward declaration
+}
+
 namespace creatures::io {
 
     using creatures::config::UARTDevice;
@@ -22,6 +30,15 @@ namespace creatures::io {
     /**
      * A thread that writes messages to a serial port
      *
+     * The port is non-blocking. Everything that's waiting in the queue goes out
+     * together in one `writev()`, and if the port only takes part of it (a USB
+     * CDC device whose buffer is full, say), we wait for `POLLOUT` and pick up
+     * right where it left off. Nothing's dropped and nothing's sent twice.
+     *
+     * Position frames don't come through the queue. The router keeps only the
+     * newest one in a `PositionSlot`, and it goes out at the end of each batch,
+     * after whatever control messages were waiting ahead of it.
+     *
      * This class follows a fail-fast philosophy: if anything goes wrong with the
      * serial port, it cleanly shuts down rather than trying to recover. Sometimes
      * the best thing a rabbit can do is know when to hop away!
@@ -34,7 +51,10 @@ namespace creatures::io {
                      std::string deviceNode,
                      UARTDevice::module_name moduleName,
                      int fileDescriptor,
-                     const std::shared_ptr<MessageQueue<Message>>& outgoingQueue);
+                     const std::shared_ptr<SpscQueue<Message>>& outgoingQueue,
+                     const std::shared_ptr<SerialPortStats>& stats,
+                     const std::shared_ptr<replay::CaptureWriter>& capture = nullptr,
+                     const std::shared_ptr<PositionSlot>& pendingPosition = nullptr);
 
         ~SerialWriter() override {
             this->logger->info("SerialWriter destroyed");
@@ -42,15 +62,54 @@ namespace creatures::io {
 
         void start() override;
 
+        /**
+         * Add everything that's ready to go out to a batch, without waiting:
+         * whatever's in the queue (in order), and then the newest position
+         * frame if there is one. `run()` calls this after the queue wakes it.
+         *
+         * @param batch where to put them. Anything already in it stays first.
+         */
+        void gatherBatch(std::vector<Message>& batch);
+
+        /**
+         * Write a batch of messages to the port, right here on the calling
+         * thread. `run()` calls this with whatever it pulls off the queue.
+         *
+         * Text messages get their newline on the way out. Returns once every
+         * byte has been written, the port fails, or we're asked to stop.
+         *
+         * @param batch the messages, in order
+         * @return true if they were all written
+         */
+        bool writeMessages(const std::vector<Message>& batch);
+
     protected:
         void run() override;
 
     private:
+        /**
+         * Wait for the port to have room for more
+         *
+         * @return false if the port failed or we're stopping
+         */
+        bool waitUntilWritable();
+
+        /**
+         * Work out bytes/s, if it's been long enough since the last time
+         */
+        void updateRateIfDue();
+
         std::shared_ptr<Logger> logger;
-        std::shared_ptr<MessageQueue<Message>> outgoingQueue;
+        std::shared_ptr<SpscQueue<Message>> outgoingQueue;
+        std::shared_ptr<PositionSlot> pendingPosition; // Null if positions come through the queue
+        std::shared_ptr<SerialPortStats> stats;
+        std::shared_ptr<replay::CaptureWriter> capture; // Only set if we're capturing serial traffic
         std::string deviceNode;
         [[maybe_unused]] UARTDevice::module_name moduleName;
         int fileDescriptor;
+
+        std::chrono::steady_clock::time_point lastRateUpdate = std::chrono::steady_clock::now();
+        u64 bytesAtLastRateUpdate = 0;
     };
 
 } // creatures::io
\ No newline at end of file
@@ -1,7 +1,8 @@
 
 
-#include <string>
-#include <vector>
+#include <array>
+#include <string_view>
+#include <utility>
 
 #include "controller-config.h"
 
@@ -28,13 +29,13 @@
 namespace creatures {
 
 BoardSensorHandler::BoardSensorHandler(
-    std::shared_ptr<Logger> logger,
+    std::shared_ptr<Logger> logger, config::UARTDevice::module_name moduleId,
     std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue)
-    : websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
+    : moduleId(moduleId), websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
     logger->info("BoardSensorHandler created!");
 }
 
-void BoardSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std::vector<std::string> &tokens) {
+void BoardSensorHandler::handle(std::shared_ptr<Logger> handleLogger, std::span<const std::string_view> tokens) {
 
     handleLogger->debug("received board sensor report");
 
@@ -46,8 +47,8 @@ void BoardSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std:
     auto temperature = tokens[1];
     double boardTemperature = 0.0;
 
-    std::vector<std::string> split = splitString(temperature);
-    if (split.size() != 2) {
+    std::array<std::string_view, 4> split;
+    if (splitFields(temperature, split) != 2) {
         handleLogger->warn("expected two tokens in a temperature sensor report, got: {}", temperature);
         return;
     }
@@ -64,13 +65,12 @@ void BoardSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std:
     // This is fine
     for (int i = 2; i < 5; i++) {
         auto sensorReport = tokens[i];
-        split = splitString(sensorReport);
-        if (split.size() != 4) {
+        if (splitFields(sensorReport, split) != 4) {
             handleLogger->warn("expected five tokens in a motor report, got: {}", sensorReport);
             continue;
         }
 
-        std::string sensorName;
+        const char *sensorName;
 
         if (split[0] == "VBUS") {
             sensorName = "vbus";
@@ -100,14 +100,15 @@ void BoardSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std:
                             current, power);
 
         // Update watchdog global power draw for motor power sensor
-        if (sensorName == "motor_power_in") {
+        if (split[0] == "MP_IN") {
             creatures::watchdog::WatchdogGlobals::updatePowerDraw(power);
         }
     }
 
     // Send the message to the websocket
-    auto message = creatures::server::BoardSensorReportMessage(logger, payloadJson);
-    websocketOutgoingQueue->push(message);
+    auto message = creatures::server::BoardSensorReportMessage(logger, payloadJson,
+                                                             config::UARTDevice::moduleNameToString(moduleId));
+    websocketOutgoingQueue->push(std::move(message));
 }
 
 } // namespace creatures
\ No newline at end of file
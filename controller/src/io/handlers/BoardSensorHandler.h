@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "config/UARTDevice.h"
 #include "io/handlers/IMessageHandler.h"
 #include "logging/Logger.h"
 #include "server/ServerMessage.h"
@@ -10,11 +11,13 @@ namespace creatures {
 
 class BoardSensorHandler : public IMessageHandler {
   public:
-    BoardSensorHandler(std::shared_ptr<Logger> logger,
+    BoardSensorHandler(std::shared_ptr<Logger> logger, config::UARTDevice::module_name moduleId,
                        std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue);
-    void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) override;
+    void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) override;
 
   private:
+    // Which module's reports we're handling
+    config::UARTDevice::module_name moduleId;
     std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue;
     std::shared_ptr<Logger> logger;
 };
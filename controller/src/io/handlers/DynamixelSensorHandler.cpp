@@ -1,8 +1,9 @@
 
 
+#include <array>
 #include <cmath>
-#include <string>
-#include <vector>
+#include <string_view>
+#include <utility>
 
 #include "controller-config.h"
 
@@ -27,13 +28,13 @@
 namespace creatures {
 
 DynamixelSensorHandler::DynamixelSensorHandler(
-    std::shared_ptr<Logger> logger,
+    std::shared_ptr<Logger> logger, config::UARTDevice::module_name moduleId,
     std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue)
-    : websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
+    : moduleId(moduleId), websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
     logger->info("DynamixelSensorHandler created");
 }
 
-void DynamixelSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std::vector<std::string> &tokens) {
+void DynamixelSensorHandler::handle(std::shared_ptr<Logger> handleLogger, std::span<const std::string_view> tokens) {
 
     handleLogger->debug("received Dynamixel sensor report");
 
@@ -48,23 +49,24 @@ void DynamixelSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const
     int onlineCount = 0;
 
     // Process each motor token (skip token[0] which is "DSENSE")
+    std::array<std::string_view, 6> split;
     for (size_t i = 1; i < tokens.size(); i++) {
         auto motorReport = tokens[i];
-        auto split = splitString(motorReport);
+        const size_t fields = splitFields(motorReport, split);
 
         // 6 fields is current firmware, the last being the online flag; 5
         // predates that flag and 4 also predates present_position. Firmware
         // without the flag only reported servos it actually heard from, so
         // anything it sent counts as online.
-        const bool hasPosition = (split.size() >= 5);
-        const bool hasOnlineFlag = (split.size() == 6);
-        if (split.size() < 4 || split.size() > 6) {
-            handleLogger->warn("expected 4 to 6 fields in DSENSE motor token, got {}: {}", split.size(), motorReport);
+        const bool hasPosition = (fields >= 5);
+        const bool hasOnlineFlag = (fields == 6);
+        if (fields < 4 || fields > 6) {
+            handleLogger->warn("expected 4 to 6 fields in DSENSE motor token, got {}: {}", fields, motorReport);
             continue;
         }
 
         // Parse D<id> prefix
-        std::string idStr = split[0];
+        std::string_view idStr = split[0];
         if (idStr.empty() || idStr[0] != 'D') {
             handleLogger->warn("DSENSE motor token missing D prefix: {}", idStr);
             continue;
@@ -129,8 +131,9 @@ void DynamixelSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const
     }
 
     // Send to websocket
-    auto message = creatures::server::DynamixelSensorReportMessage(logger, payloadJson);
-    websocketOutgoingQueue->push(message);
+    auto message = creatures::server::DynamixelSensorReportMessage(logger, payloadJson,
+                                                                 config::UARTDevice::moduleNameToString(moduleId));
+    websocketOutgoingQueue->push(std::move(message));
 }
 
 } // namespace creatures
@@ -0,0 +1,24 @@
+
+#include <map>
+#include <mutex>
+
+#include "config/UARTDevice.h"
+#include "io/handlers/FirmwareStats.h"
+#include "io/handlers/StatsMessage.h"
+
+namespace creatures {
+
+std::map<config::UARTDevice::module_name, StatsMessage> FirmwareStats::latestStats;
+std::mutex FirmwareStats::statsMutex;
+
+void FirmwareStats::update(config::UARTDevice::module_name module, const StatsMessage &stats) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    latestStats.insert_or_assign(module, stats);
+}
+
+std::map<config::UARTDevice::module_name, StatsMessage> FirmwareStats::getLatest() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return latestStats;
+}
+
+} // namespace creatures
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+
+#include "config/UARTDevice.h"
+#include "io/handlers/StatsMessage.h"
+
+namespace creatures {
+
+/**
+ * The newest STATS report from each firmware board
+ *
+ * These are updated by each module's StatsHandler and read by whoever wants
+ * to know how the boards are doing (the metrics endpoint, mostly)
+ */
+struct FirmwareStats {
+    static std::map<config::UARTDevice::module_name, StatsMessage> latestStats;
+    static std::mutex statsMutex;
+
+    /**
+     * Remember the newest report from a module
+     *
+     * @param module the module that sent it
+     * @param stats what it said
+     */
+    static void update(config::UARTDevice::module_name module, const StatsMessage &stats);
+
+    /**
+     * Get a copy of the newest report from every module we've heard from
+     */
+    static std::map<config::UARTDevice::module_name, StatsMessage> getLatest();
+};
+
+} // namespace creatures
@@ -1,8 +1,7 @@
-
 #pragma once
 
-#include <string>
-#include <vector>
+#include <span>
+#include <string_view>
 
 #include "logging/Logger.h"
 
@@ -11,11 +10,15 @@ namespace creatures {
 class InitHandler;
 /**
  * Message Handler Interface
+ *
+ * Handlers get the tab separated tokens of one line from the firmware. They're
+ * views into the original message, so nothing gets copied on the way in, but
+ * they're only good until `handle()` returns. Copy anything you need to keep!
  */
 class IMessageHandler {
   public:
     virtual ~IMessageHandler() = default;
-    virtual void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) = 0;
+    virtual void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) = 0;
 };
 
-} // namespace creatures
\ No newline at end of file
+} // namespace creatures
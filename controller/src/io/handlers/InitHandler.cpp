@@ -1,6 +1,6 @@
 
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "io/handlers/InitHandler.h"
 
@@ -19,7 +19,7 @@ InitHandler::InitHandler(std::shared_ptr<Logger> logger, std::shared_ptr<ServoMo
     logger->info("InitHandler created!");
 }
 
-void InitHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) {
+void InitHandler::handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) {
 
     if (tokens.size() != 2) {
         std::string errorMessage =
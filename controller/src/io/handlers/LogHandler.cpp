@@ -1,9 +1,9 @@
 
 
-#include <string>
-#include <vector>
+#include <string_view>
 
 #include "controller-config.h"
+#include "logging/LogRateLimiter.h"
 #include "logging/Logger.h"
 
 #include "io/handlers/LogHandler.h"
@@ -18,14 +18,14 @@
 
 namespace creatures {
 
-void LogHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) {
+void LogHandler::handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) {
     // 0       1       2       3
     // LOG \t time \t level \t message
 
 #if DEBUG_MESSAGE_PROCESSING
     logger->trace("incoming log message");
-    for (std::string token : tokens) {
-        trace(" {}", token);
+    for (std::string_view token : tokens) {
+        logger->trace(" {}", token);
     }
 #endif
     if (tokens.size() < 4) {
@@ -41,16 +41,19 @@ void LogHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::s
     //
     // The firmware's text stays an argument rather than becoming part of the
     // format string; it is not ours and may legitimately contain braces.
+    //
+    // A chatty firmware can send a lot of the quieter levels, so those are
+    // capped. Warnings and worse always get through.
     auto uptime = tokens[1];
     auto level = tokens[2];
     auto message = tokens[3];
 
     if (level == FIRMWARE_LOGGING_VERBOSE)
-        logger->trace("📟 [{}ms] {}", uptime, message);
+        LOG_RATE_LIMITED(logger, trace, FIRMWARE_LOG_LINES_PER_SECOND, "📟 [{}ms] {}", uptime, message);
     else if (level == FIRMWARE_LOGGING_DEBUG)
-        logger->debug("📟 [{}ms] {}", uptime, message);
+        LOG_RATE_LIMITED(logger, debug, FIRMWARE_LOG_LINES_PER_SECOND, "📟 [{}ms] {}", uptime, message);
     else if (level == FIRMWARE_LOGGING_INFO)
-        logger->info("📟 [{}ms] {}", uptime, message);
+        LOG_RATE_LIMITED(logger, info, FIRMWARE_LOG_LINES_PER_SECOND, "📟 [{}ms] {}", uptime, message);
     else if (level == FIRMWARE_LOGGING_WARNING)
         logger->warn("📟 [{}ms] {}", uptime, message);
     else if (level == FIRMWARE_LOGGING_ERROR)
@@ -8,7 +8,7 @@ namespace creatures {
 
 class LogHandler : public IMessageHandler {
   public:
-    void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) override;
+    void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) override;
 };
 
 } // namespace creatures
@@ -1,7 +1,8 @@
 
 
-#include <string>
-#include <vector>
+#include <array>
+#include <string_view>
+#include <utility>
 
 #include "controller-config.h"
 
@@ -24,13 +25,13 @@
 namespace creatures {
 
 MotorSensorHandler::MotorSensorHandler(
-    std::shared_ptr<Logger> logger,
+    std::shared_ptr<Logger> logger, config::UARTDevice::module_name moduleId,
     std::shared_ptr<MessageQueue<creatures::server::ServerMessage>> websocketOutgoingQueue)
-    : websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
+    : moduleId(moduleId), websocketOutgoingQueue(websocketOutgoingQueue), logger(logger) {
     logger->info("MotorSensorHandler created!");
 }
 
-void MotorSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std::vector<std::string> &tokens) {
+void MotorSensorHandler::handle(std::shared_ptr<Logger> handleLogger, std::span<const std::string_view> tokens) {
 
     handleLogger->debug("received sensor report");
 
@@ -55,13 +56,12 @@ void MotorSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std:
     //        };
 
     json payloadJson;
-    std::vector<std::string> split;
+    std::array<std::string_view, 5> split;
 
     // Surely this will not bite me in the butt
     for (int i = 1; i < 9; i++) {
         auto motorReport = tokens[i];
-        split = splitString(motorReport);
-        if (split.size() != 5) {
+        if (splitFields(motorReport, split) != 5) {
             handleLogger->warn("expected five tokens in a motor report, got: {}", motorReport);
             continue;
         }
@@ -83,8 +83,9 @@ void MotorSensorHandler::handle(std::shared_ptr<Logger> handleLogger, const std:
     }
 
     // Send the message to the websocket
-    auto message = creatures::server::MotorSensorReportMessage(logger, payloadJson);
-    websocketOutgoingQueue->push(message);
+    auto message = creatures::server::MotorSensorReportMessage(logger, payloadJson,
+                                                             config::UARTDevice::moduleNameToString(moduleId));
+    websocketOutgoingQueue->push(std::move(message));
 }
 
 } // namespace creatures
\ No newline at end of file
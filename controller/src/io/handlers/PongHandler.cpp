@@ -1,7 +1,7 @@
 
 #include <chrono>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "controller/ServoModuleHandler.h"
 #include "io/handlers/PongHandler.h"
@@ -18,7 +18,7 @@ PongHandler::PongHandler(std::shared_ptr<Logger> logger, std::shared_ptr<ServoMo
                  UARTDevice::moduleNameToString(servoModuleHandler->getModuleName()));
 }
 
-void PongHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) {
+void PongHandler::handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) {
 
     (void)tokens; // Unused
 
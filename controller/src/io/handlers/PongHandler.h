@@ -10,7 +10,7 @@ namespace creatures {
 class PongHandler : public IMessageHandler {
   public:
     PongHandler(std::shared_ptr<Logger> logger, std::shared_ptr<ServoModuleHandler> servoModuleHandler);
-    void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) override;
+    void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) override;
 
   private:
     std::shared_ptr<ServoModuleHandler> servoModuleHandler;
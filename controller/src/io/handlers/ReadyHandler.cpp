@@ -1,6 +1,7 @@
 
+#include <algorithm>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "controller/ServoModuleHandler.h"
 #include "io/handlers/ReadyHandler.h"
@@ -15,14 +16,17 @@ ReadyHandler::ReadyHandler(std::shared_ptr<Logger> logger, std::shared_ptr<Servo
     logger->info("ReadyHandler created!");
 }
 
-void ReadyHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) {
+void ReadyHandler::handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) {
 
     // This is basically the most easy handler ever 😅
 
-    (void)tokens; // Unused
+    // Newer firmware tacks a "BIN" on the end if it can take binary frames.
+    // Older firmware just sends READY\t1, so not finding it is perfectly fine.
+    bool supportsBinary = std::find(tokens.begin(), tokens.end(), "BIN") != tokens.end();
 
-    logger->info("READY message received from the firmware!");
-    servoModuleHandler->firmwareReadyToOperate();
+    logger->info("READY message received from the firmware! (binary framing {})",
+                 supportsBinary ? "supported" : "not supported");
+    servoModuleHandler->firmwareReadyToOperate(supportsBinary);
 }
 
 } // namespace creatures
\ No newline at end of file
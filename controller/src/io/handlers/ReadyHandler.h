@@ -13,7 +13,7 @@ class ReadyHandler : public IMessageHandler {
 
   public:
     ReadyHandler(std::shared_ptr<Logger> logger, std::shared_ptr<ServoModuleHandler> servoModuleHandler);
-    void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) override;
+    void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) override;
 
   private:
     std::shared_ptr<ServoModuleHandler> servoModuleHandler;
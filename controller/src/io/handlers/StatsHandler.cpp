@@ -1,10 +1,11 @@
 
 
-#include <string>
-#include <vector>
+#include <array>
+#include <string_view>
 
 #include "controller-config.h"
 
+#include "io/handlers/FirmwareStats.h"
 #include "io/handlers/StatsHandler.h"
 #include "io/handlers/StatsMessage.h"
 #include "logging/Logger.h"
@@ -12,28 +13,31 @@
 
 namespace creatures {
 
-void StatsHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) {
+StatsHandler::StatsHandler(config::UARTDevice::module_name moduleId) : moduleId(moduleId) {}
+
+void StatsHandler::handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) {
 
     logger->debug("incoming stats!");
 
     auto statsMessage = StatsMessage();
 
-    for (std::string token : tokens) {
+    std::array<std::string_view, 2> split;
+    for (std::string_view token : tokens) {
 
-        std::vector<std::string> split = splitString(token);
+        size_t fields = splitFields(token, split);
 
         // Make sure we have the right number of tokens
-        if (split.empty() || split.size() > 2) {
+        if (fields == 0 || fields > 2) {
             logger->warn("invalid token in {} message: {}", SENSOR_MESSAGE, token);
             continue;
         }
 
         // Split the name and value
-        std::string name = split[0];
+        std::string_view name = split[0];
 
         // If this is a stats message, there won't be a second piece
-        std::string value;
-        if (split.size() == 2) {
+        std::string_view value;
+        if (fields == 2) {
             value = split[1];
         }
 
@@ -140,6 +144,10 @@ void StatsHandler::handle(std::shared_ptr<Logger> logger, const std::vector<std:
     lastIncomingMessagesDropped = statsMessage.incomingMessagesDropped;
     haveDropBaseline = true;
 
+    if (moduleId.has_value()) {
+        FirmwareStats::update(moduleId.value(), statsMessage);
+    }
+
     // Now log it!
     logger->debug(statsMessage.toString());
 }
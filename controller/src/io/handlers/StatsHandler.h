@@ -1,7 +1,10 @@
 
 #pragma once
 
+#include <optional>
+
 #include "controller-config.h"
+#include "config/UARTDevice.h"
 #include "io/handlers/IMessageHandler.h"
 #include "logging/Logger.h"
 
@@ -11,9 +14,19 @@ namespace creatures {
 
 class StatsHandler : public IMessageHandler {
   public:
-    void handle(std::shared_ptr<Logger> logger, const std::vector<std::string> &tokens) override;
+    StatsHandler() = default;
+
+    /**
+     * @param moduleId the module whose reports we handle. Its newest report is
+     *                 kept in `FirmwareStats` for anyone who wants it.
+     */
+    explicit StatsHandler(config::UARTDevice::module_name moduleId);
+
+    void handle(std::shared_ptr<Logger> logger, std::span<const std::string_view> tokens) override;
 
   private:
+    std::optional<config::UARTDevice::module_name> moduleId;
+
     // The firmware's drop counters are cumulative, so we remember the previous
     // report to detect new drops. One StatsHandler lives per module, so this
     // state is correctly scoped to a single firmware board.
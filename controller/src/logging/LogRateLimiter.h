@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "logging/Logger.h"
+
+namespace creatures {
+
+/**
+ * Lets a log line through at most so many times a second
+ *
+ * Some lines are fine to see now and then, but would happily fire a few
+ * thousand times a second if something got chatty (a firmware stuck in a loop
+ * logging, every message off the serial port at debug, that sort of thing).
+ * Put one of these in front of them and the first N in each second get
+ * through, the rest are counted, and the next one that makes it says how many
+ * we skipped.
+ *
+ * Checking is a couple of relaxed atomics, and it's fine to share one between
+ * threads. The window might get reset twice if two threads trip over the
+ * second boundary together, which lets a line or two extra through. Nobody
+ * will notice.
+ *
+ * Usually you want the `LOG_RATE_LIMITED()` macro below rather than one of
+ * these directly.
+ */
+class LogRateLimiter {
+  public:
+    /**
+     * @param _perSecond how many lines to let through each second
+     */
+    explicit LogRateLimiter(std::uint32_t _perSecond) : perSecond(_perSecond) {}
+
+    LogRateLimiter(const LogRateLimiter &) = delete;
+    LogRateLimiter &operator=(const LogRateLimiter &) = delete;
+
+    /**
+     * Should this line be logged?
+     *
+     * @param suppressed set to how many lines were dropped since the last one
+     *                   that got through, so the caller can mention it
+     * @return true if it should be logged
+     */
+    bool allow(std::uint64_t &suppressed) { return allow(suppressed, std::chrono::steady_clock::now()); }
+
+    /**
+     * Same as above, but you say what time it is (handy for tests)
+     */
+    bool allow(std::uint64_t &suppressed, std::chrono::steady_clock::time_point now) {
+        suppressed = 0;
+
+        const std::int64_t nowNs =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        std::int64_t started = windowStart.load(std::memory_order_relaxed);
+
+        // New second, new budget. Whoever starts the new window gets to report
+        // what the old one dropped.
+        if (nowNs - started >= WindowNs &&
+            windowStart.compare_exchange_strong(started, nowNs, std::memory_order_relaxed)) {
+            countInWindow.store(0, std::memory_order_relaxed);
+            suppressed = droppedCount.exchange(0, std::memory_order_relaxed);
+        }
+
+        if (countInWindow.fetch_add(1, std::memory_order_relaxed) < perSecond) {
+            return true;
+        }
+
+        // If we opened the window but lost the race for its budget, hang on to
+        // the old count so the next line that gets through can report it
+        droppedCount.fetch_add(suppressed + 1, std::memory_order_relaxed);
+        suppressed = 0;
+        return false;
+    }
+
+  private:
+    static constexpr std::int64_t WindowNs = 1'000'000'000;
+
+    const std::uint32_t perSecond;
+
+    // Starts far enough in the past that the very first line opens a window
+    std::atomic<std::int64_t> windowStart{INT64_MIN / 2};
+    std::atomic<std::uint32_t> countInWindow{0};
+    std::atomic<std::uint64_t> droppedCount{0};
+};
+
+} // namespace creatures
+
+/**
+ * Log at most `perSecond` lines a second from this spot, then say how many
+ * were skipped
+ *
+ * Each place this is used gets its own limit (it's a static in there), shared
+ * by every logger and thread that comes through. Nothing is counted if the
+ * level is turned off.
+ *
+ *     LOG_RATE_LIMITED(logger, debug, 20, "incoming message: {}", payload);
+ *
+ * @param logger a pointer to a `creatures::Logger`
+ * @param level trace, debug, info, warn, error, or critical
+ * @param perSecond how many a second to let through
+ */
+#define LOG_RATE_LIMITED(logger, level, perSecond, ...)                                                                \
+    do {                                                                                                               \
+        if ((logger)->template isEnabled<creatures::LogLevel::level>()) {                                              \
+            static creatures::LogRateLimiter logRateLimiter_(perSecond);                                               \
+            std::uint64_t logSuppressed_ = 0;                                                                          \
+            if (logRateLimiter_.allow(logSuppressed_)) {                                                               \
+                if (logSuppressed_ > 0) {                                                                              \
+                    (logger)->level("({} similar messages dropped in the last second)", logSuppressed_);               \
+                }                                                                                                      \
+                (logger)->level(__VA_ARGS__);                                                                          \
+            }                                                                                                          \
+        }                                                                                                              \
+    } while (0)
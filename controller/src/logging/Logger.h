@@ -1,13 +1,28 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
 #include <fmt/format.h>
 
+/*
+ * Anything below this level is compiled out entirely. 0 keeps everything
+ * (trace and up), 1 drops trace, 2 drops debug too, and so on. Set it from
+ * CMake with -DCREATURES_MIN_LOG_LEVEL=n.
+ */
+#ifndef CREATURES_MIN_LOG_LEVEL
+#define CREATURES_MIN_LOG_LEVEL 0
+#endif
+
 namespace creatures {
 
+/**
+ * How loud a message is. In the same order as spdlog's levels.
+ */
+enum class LogLevel : int { trace = 0, debug, info, warn, error, critical, off };
+
 /**
  * Abstract out the logger to an Interface
  *
@@ -29,43 +44,90 @@ class Logger {
     // shares the same level.
     virtual void setLevel(const std::string &levelName) = 0;
 
+    /**
+     * Would a message at this level actually go anywhere?
+     *
+     * This is one relaxed atomic load (or nothing at all, if the level was
+     * compiled out), so it's cheap enough to check before building anything
+     * expensive that's only ever logged, like a hex dump.
+     */
+    template <LogLevel level> [[nodiscard]] bool isEnabled() const {
+        if constexpr (static_cast<int>(level) < CREATURES_MIN_LOG_LEVEL) {
+            return false;
+        } else {
+            return static_cast<int>(level) >= levelGate->load(std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] bool isTraceEnabled() const { return isEnabled<LogLevel::trace>(); }
+    [[nodiscard]] bool isDebugEnabled() const { return isEnabled<LogLevel::debug>(); }
+
+    // These all check the level before formatting anything, so a message
+    // that's turned off costs next to nothing
+
     template <typename... Args> void trace(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logTrace(format, format_args);
+        if (isEnabled<LogLevel::trace>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logTrace(format, format_args);
+        }
     }
 
     template <typename... Args> void debug(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logDebug(format, format_args);
+        if (isEnabled<LogLevel::debug>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logDebug(format, format_args);
+        }
     }
 
     template <typename... Args> void info(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logInfo(format, format_args);
+        if (isEnabled<LogLevel::info>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logInfo(format, format_args);
+        }
     }
 
     template <typename... Args> void warn(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logWarning(format, format_args);
+        if (isEnabled<LogLevel::warn>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logWarning(format, format_args);
+        }
     }
 
     template <typename... Args> void error(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logError(format, format_args);
+        if (isEnabled<LogLevel::error>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logError(format, format_args);
+        }
     }
 
     template <typename... Args> void critical(const std::string &format, Args &&...args) {
-        auto format_args = fmt::make_format_args(args...);
-        logCritical(format, format_args);
+        if (isEnabled<LogLevel::critical>()) {
+            auto format_args = fmt::make_format_args(args...);
+            logCritical(format, format_args);
+        }
     }
 
   protected:
+    /**
+     * Point the front end at the level this implementation actually uses, so
+     * it can skip messages before they're formatted. Until this is called
+     * everything gets through, which is what the mocks want.
+     *
+     * @param gate the active level (as a `LogLevel`), shared by every logger
+     * that should turn up and down together
+     */
+    void useLevelGate(const std::atomic<int> &gate) { levelGate = &gate; }
+
     virtual void logTrace(const std::string &format, fmt::format_args args) = 0;
     virtual void logDebug(const std::string &format, fmt::format_args args) = 0;
     virtual void logInfo(const std::string &format, fmt::format_args args) = 0;
     virtual void logWarning(const std::string &format, fmt::format_args args) = 0;
     virtual void logError(const std::string &format, fmt::format_args args) = 0;
     virtual void logCritical(const std::string &format, fmt::format_args args) = 0;
+
+  private:
+    static inline const std::atomic<int> allLevels{static_cast<int>(LogLevel::trace)};
+    const std::atomic<int> *levelGate = &allLevels;
 };
 
 } // namespace creatures
\ No newline at end of file
@@ -1,10 +1,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <locale>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include <fmt/format.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
@@ -17,10 +23,67 @@ namespace creatures {
 
 /**
  * A spdlog-based implementation of the Logger interface
+ *
+ * Every logger writes to the same console sink. Until `startAsync()` is called
+ * they do it right there on the calling thread; after that, loggers hand their
+ * lines to one background thread that does the writing, so the threads that
+ * matter never wait on the terminal.
  */
 class SpdlogLogger : public Logger {
 
   public:
+    /**
+     * What to do with a line when the async queue is full
+     */
+    enum class OverflowPolicy {
+        block,     // Wait for room, so nothing's ever lost
+        dropOldest // Throw away the oldest waiting line to make room
+    };
+
+    SpdlogLogger() { useLevelGate(activeLevel()); }
+
+    /**
+     * Switch to writing log lines from a background thread
+     *
+     * Only loggers made after this are async, so call it early and remake any
+     * logger you made before (calling `init()` again with the same name is
+     * fine). Only the first call does anything.
+     *
+     * @param queueSize how many lines can be waiting to be written
+     * @param policy what to do when that many are already waiting
+     * @return true if async logging was started, false if it already was
+     */
+    static bool startAsync(size_t queueSize, OverflowPolicy policy) {
+        std::lock_guard lock(asyncMutex());
+        if (asyncPolicy().has_value()) {
+            return false;
+        }
+
+        // One thread, so lines come out in the order they went in
+        spdlog::init_thread_pool(queueSize, 1);
+        asyncPolicy() = policy == OverflowPolicy::block ? spdlog::async_overflow_policy::block
+                                                        : spdlog::async_overflow_policy::overrun_oldest;
+        return true;
+    }
+
+    /**
+     * How many lines have been thrown away because the async queue was full
+     */
+    static std::uint64_t droppedMessages() {
+        std::lock_guard lock(asyncMutex());
+        if (!asyncPolicy().has_value()) {
+            return 0;
+        }
+        return spdlog::thread_pool()->overrun_counter();
+    }
+
+    /**
+     * Write out anything still waiting in the queue and stop the background
+     * thread. Call this on the way out, or the last few lines may never make
+     * it to the screen!
+     */
+    static void shutdown() { spdlog::shutdown(); }
+
     void init(std::string loggerName) override {
         try {
             // Set up our locale. If this vomits, install `locales-all`
@@ -34,8 +97,22 @@ class SpdlogLogger : public Logger {
         // Save our name
         this->ourName = std::move(loggerName);
 
-        // Initialize and register the default logger
-        ourLogger = spdlog::stdout_color_mt(ourName);
+        // Making a logger again with the same name (like main does once the
+        // async backend is up) replaces the old one
+        spdlog::drop(ourName);
+
+        {
+            std::lock_guard lock(asyncMutex());
+            if (asyncPolicy().has_value()) {
+                ourLogger = std::make_shared<spdlog::async_logger>(ourName, consoleSink(), spdlog::thread_pool(),
+                                                                   asyncPolicy().value());
+            } else {
+                ourLogger = std::make_shared<spdlog::logger>(ourName, consoleSink());
+            }
+        }
+
+        // Register it so process-wide settings like the level reach it
+        spdlog::initialize_logger(ourLogger);
         ourLogger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] [%^%l%$] %v");
 
         // Intentionally leave the level alone so this logger inherits spdlog's
@@ -56,6 +133,7 @@ class SpdlogLogger : public Logger {
         // Apply to every registered logger and make it the default for any
         // loggers created afterward.
         spdlog::set_level(level);
+        activeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
         ourLogger->info("Log level set to '{}'", levelName);
     }
 
@@ -85,6 +163,37 @@ class SpdlogLogger : public Logger {
     }
 
   private:
+    /**
+     * The level every SpdlogLogger shares, kept in step with spdlog's own so
+     * the front end can check it without calling into spdlog. It starts where
+     * spdlog does.
+     */
+    static std::atomic<int> &activeLevel() {
+        static std::atomic<int> level{static_cast<int>(spdlog::get_level())};
+        return level;
+    }
+
+    /**
+     * The console, shared by every logger so they all take turns on it
+     */
+    static std::shared_ptr<spdlog::sinks::sink> consoleSink() {
+        static auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+        return sink;
+    }
+
+    /**
+     * The overflow policy for async loggers, or nothing if we're not async
+     */
+    static std::optional<spdlog::async_overflow_policy> &asyncPolicy() {
+        static std::optional<spdlog::async_overflow_policy> policy;
+        return policy;
+    }
+
+    static std::mutex &asyncMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
     std::shared_ptr<spdlog::logger> ourLogger;
     std::string ourName;
 };
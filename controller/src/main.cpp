@@ -41,8 +41,16 @@
 #include "io/MessageRouter.h"
 #include "logging/Logger.h"
 #include "logging/SpdlogLogger.h"
+#include "metrics/MetricsRegistry.h"
+#include "metrics/MetricsServer.h"
+#include "metrics/collectors.h"
+#include "replay/CaptureReader.h"
+#include "replay/CaptureWriter.h"
+#include "replay/Replayer.h"
+#include "server/MessageEncoding.h"
 #include "server/ServerConnection.h"
 #include "server/ServerMessage.h"
+#include "util/MessageQueue.h"
 #include "util/StoppableThread.h"
 #include "util/http_utils.h"
 #include "util/thread_name.h"
@@ -106,15 +114,25 @@ std::shared_ptr<creatures::audio::AudioSubsystem> audioSubsystem;
  * Errors are logged but non-fatal - the controller will continue running even if
  * registration fails (e.g., if the server is down).
  *
+ * This is also where we ask for a binary encoding for the websocket, if one is
+ * configured. We send the encodings we can do (best first) and the server
+ * answers with the ones it can take. Anything short of a clear yes is JSON.
+ *
  * @param logger Shared pointer to a logger instance
  * @param serverAddress The server's address
  * @param serverPort The server's port
  * @param creatureConfigFile Path to the creature's JSON config file
  * @param universe The universe this creature is assigned to
+ * @param preferredEncoding The encoding we'd like for websocket messages
+ * @param agreedEncoding Output set to the encoding the server agreed to
  * @return true if registration succeeded, false otherwise
  */
 bool registerCreatureWithServer(std::shared_ptr<creatures::Logger> logger, const std::string &serverAddress,
-                                u16 serverPort, const std::string &creatureConfigFile, u16 universe) {
+                                u16 serverPort, const std::string &creatureConfigFile, u16 universe,
+                                creatures::server::MessageEncoding preferredEncoding,
+                                creatures::server::MessageEncoding &agreedEncoding) {
+
+    agreedEncoding = creatures::server::MessageEncoding::json;
 
     logger->info("Registering creature with server at {}:{}...", serverAddress, serverPort);
 
@@ -136,6 +154,11 @@ bool registerCreatureWithServer(std::shared_ptr<creatures::Logger> logger, const
     nlohmann::json requestBody;
     requestBody["creature_config"] = creatureConfigContent; // String: raw JSON content
     requestBody["universe"] = universe;                     // UInt32: universe number
+    if (preferredEncoding != creatures::server::MessageEncoding::json) {
+        requestBody["message_encodings"] = {creatures::server::messageEncodingToString(preferredEncoding),
+                                            creatures::server::messageEncodingToString(
+                                                creatures::server::MessageEncoding::json)};
+    }
 
     std::string requestBodyStr = requestBody.dump();
 
@@ -162,6 +185,15 @@ bool registerCreatureWithServer(std::shared_ptr<creatures::Logger> logger, const
     // Check server response status
     if (httpCode == 200) {
         logger->info("Successfully registered creature with server");
+
+        if (preferredEncoding != creatures::server::MessageEncoding::json) {
+            auto response = nlohmann::json::parse(responseBody, nullptr, false);
+            agreedEncoding = creatures::server::negotiateMessageEncoding(preferredEncoding, response);
+            if (agreedEncoding != preferredEncoding) {
+                logger->info("server didn't agree to {}, sticking with JSON",
+                             creatures::server::messageEncodingToString(preferredEncoding));
+            }
+        }
         return true;
     } else {
         logger->warn("Server registration returned status {}: {}", httpCode, responseBody);
@@ -309,6 +341,15 @@ int main(int argc, char **argv) {
     // Yay, we have a valid config
     auto config = configResult.getValue().value();
 
+    // Now that we know how big to make the queue, hand log lines off to a
+    // background thread so a slow terminal can't stall motion. The main logger
+    // was made before this, so make it again to get it on board too.
+    creatures::SpdlogLogger::startAsync(config->getLogQueueSize(),
+                                        config->getLogOverflowPolicy() == "block"
+                                            ? creatures::SpdlogLogger::OverflowPolicy::block
+                                            : creatures::SpdlogLogger::OverflowPolicy::dropOldest);
+    logger = makeLogger("main");
+
     // Apply the configured log level now that we've parsed the config. This is
     // process-wide, so it affects every logger created from here on out too.
     logger->setLevel(config->getLogLevel());
@@ -361,11 +402,21 @@ int main(int argc, char **argv) {
     // Keep track of our threads - but keep it simple!
     std::vector<std::shared_ptr<creatures::StoppableThread>> workerThreads;
 
+    // Everyone who has numbers to share adds them here as they're set up.
+    // Nothing is gathered until someone scrapes us.
+    auto metricsRegistry = std::make_shared<creatures::metrics::MetricsRegistry>();
+    metricsRegistry->add(creatures::metrics::loggingCollector());
+    metricsRegistry->add(creatures::metrics::motionLatencyCollector());
+    metricsRegistry->add(creatures::metrics::firmwareCollector());
+
     // Start talking to the server if we're told to
-    auto websocketOutgoingQueue = std::make_shared<creatures::MessageQueue<creatures::server::ServerMessage>>();
+    auto websocketOutgoingQueue = std::make_shared<creatures::MessageQueue<creatures::server::ServerMessage>>(
+        WEBSOCKET_QUEUE_CAPACITY, creatures::QueueOverflowPolicy::replaceLatestByKey,
+        [](const creatures::server::ServerMessage &message) -> std::string_view { return message.getCoalesceKey(); });
     auto serverConnection =
         std::make_shared<ServerConnection>(makeLogger("server"), creature, config->isUsingServer(),
-                                           config->getServerAddress(), config->getServerPort(), websocketOutgoingQueue);
+                                           config->getServerAddress(), config->getServerPort(),
+                                           config->getBatchServerMessages(), websocketOutgoingQueue);
 
     if (config->getUseAudioSubsystem()) {
         logger->info("Setting up audio subsystem...");
@@ -403,14 +454,43 @@ int main(int argc, char **argv) {
         // it fails; the next reconnect will try again. Set before start() so the
         // first Open isn't missed. Capture by value - the lambda outlives this
         // scope (it lives on serverConnection).
+        //
+        // The connection is held weakly since it owns this callback.
+        const auto preferredEncoding = creatures::server::messageEncodingFromString(config->getServerMessageEncoding())
+                                           .value_or(creatures::server::MessageEncoding::json);
         serverConnection->setConnectionEstablishedCallback(
             [logger, serverAddress = config->getServerAddress(), serverPort = config->getServerPort(),
-             creatureConfigFile = config->getCreatureConfigFile(), universe = config->getUniverse()]() {
-                registerCreatureWithServer(logger, serverAddress, serverPort, creatureConfigFile, universe);
+             creatureConfigFile = config->getCreatureConfigFile(), universe = config->getUniverse(),
+             preferredEncoding, connection = std::weak_ptr<ServerConnection>(serverConnection)]() {
+                auto agreedEncoding = creatures::server::MessageEncoding::json;
+                registerCreatureWithServer(logger, serverAddress, serverPort, creatureConfigFile, universe,
+                                           preferredEncoding, agreedEncoding);
+
+                // A server that came back after a restart might not be the one
+                // that agreed last time, so this gets set every time
+                if (auto liveConnection = connection.lock()) {
+                    liveConnection->setMessageEncoding(agreedEncoding);
+                }
             });
 
         serverConnection->start();
         workerThreads.push_back(serverConnection);
+        metricsRegistry->add(creatures::metrics::serverCollector(serverConnection));
+    }
+
+    // If we've been asked to capture, get the file open before anything that
+    // records into it starts up. Asking and not getting it is a reason to stop.
+    std::shared_ptr<creatures::replay::CaptureWriter> captureWriter;
+    if (!config->getCaptureFile().empty()) {
+        captureWriter = std::make_shared<creatures::replay::CaptureWriter>(
+            makeLogger("capture"), config->getCaptureFile(), config->getUniverse(), config->getCaptureSerial());
+        auto openResult = captureWriter->open();
+        if (!openResult.isSuccess()) {
+            std::cerr << openResult.getError()->getMessage() << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        captureWriter->start();
+        workerThreads.push_back(captureWriter);
     }
 
     // Bring up the GPIO pins if enabled on the command line
@@ -420,15 +500,28 @@ int main(int argc, char **argv) {
 
     // Make the MessageRouter (it will be started later in the boot process)
     auto messageRouter = std::make_shared<creatures::io::MessageRouter>(makeLogger("message-router"));
+    messageRouter->setBinaryFramingAllowed(config->getBinarySerialFraming());
 
     // Fire up the controller
     auto controller = std::make_shared<Controller>(makeLogger("controller"), creature, messageRouter);
+    if (config->getDeltaPositionFrames()) {
+        controller->setDeltaPositionFrames(config->getPositionDeadbandMicroseconds(),
+                                           std::chrono::milliseconds(config->getPositionKeyframeIntervalMs()));
+    }
+    if (config->isUsingServer()) {
+        controller->setServerQueue(websocketOutgoingQueue);
+    }
+    controller->setLoopTiming(config->getControllerRealtimePriority(), config->getControllerCpu(),
+                              std::chrono::microseconds(config->getControllerSpinMicroseconds()));
     controller->start();
     workerThreads.push_back(controller);
+    metricsRegistry->add(creatures::metrics::controllerCollector(controller));
+    metricsRegistry->add(creatures::metrics::messageRouterCollector(messageRouter));
 
     /**
      * Create and start the ServoModuleHandler for the UART devices that were found in the config file
      */
+    std::vector<std::shared_ptr<ServoModuleHandler>> moduleHandlers;
     for (const auto &uart : config->getUARTDevices()) {
         logger->debug("creating a ServoModuleHandler for module {} on {}",
                       UARTDevice::moduleNameToString(uart.getModule()), uart.getDeviceNode());
@@ -440,35 +533,70 @@ int main(int argc, char **argv) {
 
         // Register the handler with the message router
         messageRouter->registerServoModuleHandler(uart.getModule(), handler->getIncomingQueue(),
-                                                  handler->getOutgoingQueue());
+                                                  handler->getOutgoingQueue(), handler->getPendingPosition());
 
         logger->debug("init'ing the ServoModuleHandler for module {}",
                       UARTDevice::moduleNameToString(uart.getModule()));
         handler->init();
+        if (captureWriter && captureWriter->isCapturingSerial()) {
+            handler->setCapture(captureWriter);
+        }
 
         logger->debug("starting the ServoModuleHandler for module {}",
                       UARTDevice::moduleNameToString(uart.getModule()));
         handler->start();
 
+        // A replay with nothing on the other end of the port would never hear
+        // from the firmware, so nothing would ever be sent. Say it's ready.
+        if (!config->getReplayFile().empty() && config->getReplayModulesReady()) {
+            logger->info("treating module {} as ready for the replay",
+                         UARTDevice::moduleNameToString(uart.getModule()));
+            handler->firmwareReadyToOperate();
+        }
+
+        moduleHandlers.push_back(handler);
         workerThreads.push_back(handler);
+        metricsRegistry->add(creatures::metrics::servoModuleCollector(handler));
     }
 
     // Now that the controller is running, we can start the creature
     creature->init(controller);
     creature->start();
 
-    // Create and start the e1.31 client
-    logger->debug("starting the e1.31 client");
-    auto e131Client = std::make_unique<creatures::dmx::E131Client>(makeLogger("e131-client"));
-    e131Client->init(creature, controller, config->getUniverse(), config->getNetworkDeviceName(),
-                     config->getNetworkDeviceIndex(), config->getNetworkDeviceIPAddress());
-    e131Client->start();
-    workerThreads.push_back(std::move(e131Client));
+    // Either play back a capture, or create and start the e1.31 client
+    std::shared_ptr<creatures::replay::Replayer> replayer;
+    if (!config->getReplayFile().empty()) {
+        auto captureReader = std::make_shared<creatures::replay::CaptureReader>(logger, config->getReplayFile());
+        auto openResult = captureReader->open();
+        if (!openResult.isSuccess()) {
+            std::cerr << openResult.getError()->getMessage() << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        replayer = std::make_shared<creatures::replay::Replayer>(makeLogger("replay"), captureReader, controller,
+                                                                 config->getReplayAsFastAsPossible());
+        for (const auto &handler : moduleHandlers) {
+            replayer->watchModule(handler);
+        }
+        replayer->start();
+        workerThreads.push_back(replayer);
+    } else {
+        logger->debug("starting the e1.31 client");
+        auto e131Client = std::make_shared<creatures::dmx::E131Client>(makeLogger("e131-client"));
+        e131Client->init(creature, controller, config->getUniverse(), config->getNetworkDeviceName(),
+                         config->getNetworkDeviceIndex(), config->getNetworkDeviceIPAddress());
+        if (captureWriter) {
+            e131Client->setCapture(captureWriter);
+        }
+        e131Client->start();
+        workerThreads.push_back(e131Client);
+        metricsRegistry->add(creatures::metrics::e131Collector(e131Client));
+    }
 
     // Start the audio subsystem if it was initialized
     if (audioSubsystem) {
         audioSubsystem->start();
         workerThreads.push_back(audioSubsystem);
+        metricsRegistry->add(creatures::metrics::audioCollector(audioSubsystem));
     }
 
     // Fire up the MessageRouter
@@ -494,15 +622,36 @@ int main(int argc, char **argv) {
     pingTask->start();
     workerThreads.push_back(std::move(pingTask));
 
+    // Let Prometheus in, if it's been invited. Not being able to listen isn't
+    // a reason to stop the show.
+    std::unique_ptr<creatures::metrics::MetricsServer> metricsServer;
+    if (config->getMetricsPort() != 0) {
+        metricsServer = std::make_unique<creatures::metrics::MetricsServer>(
+            makeLogger("metrics"), metricsRegistry, config->getMetricsAddress(), config->getMetricsPort());
+        if (!metricsServer->start().isSuccess()) {
+            metricsServer.reset();
+        }
+    }
+
     // Main loop - run until shutdown is requested
     logger->info("All systems running! Press Ctrl+C to shutdown gracefully.");
     while (!shutdown_requested.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+        // A replay is over once the capture runs out
+        if (replayer && replayer->isFinished()) {
+            logger->info("replay finished");
+            break;
+        }
     }
 
     // Graceful shutdown sequence
     logger->info("Shutdown requested, stopping all threads...");
 
+    if (metricsServer) {
+        metricsServer->shutdown();
+    }
+
     // Stop all threads in reverse order of creation
     for (auto it = workerThreads.rbegin(); it != workerThreads.rend(); ++it) {
         if (*it) {
@@ -512,6 +661,12 @@ int main(int argc, char **argv) {
         }
     }
 
+    // Everyone who records has stopped, so anything still waiting to be
+    // captured can go out now
+    if (captureWriter) {
+        captureWriter->close();
+    }
+
     // Stop the creature
     if (creature) {
         logger->debug("Stopping creature: {}", creature->getName());
@@ -525,6 +680,11 @@ int main(int argc, char **argv) {
         audioSubsystem.reset();
     }
 
+    if (auto dropped = creatures::SpdlogLogger::droppedMessages(); dropped > 0) {
+        logger->warn("{} log lines were dropped because the log queue was full", dropped);
+    }
+
     logger->info("Graceful shutdown complete.");
+    creatures::SpdlogLogger::shutdown();
     return EXIT_SUCCESS;
 }
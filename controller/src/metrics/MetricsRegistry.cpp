@@ -0,0 +1,26 @@
+
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "metrics/MetricsRegistry.h"
+#include "metrics/MetricsWriter.h"
+
+namespace creatures::metrics {
+
+void MetricsRegistry::add(Collector collector) {
+    std::lock_guard<std::mutex> lock(mutex);
+    collectors.push_back(std::move(collector));
+}
+
+std::string MetricsRegistry::render() const {
+    MetricsWriter writer;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &collector : collectors) {
+        collector(writer);
+    }
+    return writer.finish();
+}
+
+} // namespace creatures::metrics
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "metrics/MetricsWriter.h"
+
+namespace creatures::metrics {
+
+/**
+ * Everything that has metrics to share, in one place
+ *
+ * Each subsystem adds a collector when it's set up. A collector is handed a
+ * `MetricsWriter` and writes whatever it knows right then. Nothing is
+ * gathered until someone asks for the page, so this costs nothing between
+ * scrapes.
+ */
+class MetricsRegistry {
+  public:
+    using Collector = std::function<void(MetricsWriter &)>;
+
+    /**
+     * Add a collector. It'll be called from whatever thread asks for the
+     * page, so it needs to be safe to call from anywhere.
+     */
+    void add(Collector collector);
+
+    /**
+     * Run every collector and return the page
+     */
+    [[nodiscard]] std::string render() const;
+
+  private:
+    mutable std::mutex mutex;
+    std::vector<Collector> collectors;
+};
+
+} // namespace creatures::metrics
@@ -0,0 +1,71 @@
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+#include <ixwebsocket/IXHttpServer.h>
+
+#include "logging/Logger.h"
+#include "metrics/MetricsRegistry.h"
+#include "metrics/MetricsServer.h"
+#include "util/Result.h"
+
+namespace creatures::metrics {
+
+MetricsServer::MetricsServer(std::shared_ptr<Logger> _logger, std::shared_ptr<MetricsRegistry> _registry,
+                             std::string _address, int _port)
+    : logger(std::move(_logger)), registry(std::move(_registry)), address(std::move(_address)), port(_port) {}
+
+MetricsServer::~MetricsServer() { shutdown(); }
+
+Result<bool> MetricsServer::start() {
+    server = std::make_unique<ix::HttpServer>(port, address);
+    server->setOnConnectionCallback(
+        [this](const ix::HttpRequestPtr &request, const std::shared_ptr<ix::ConnectionState> & /*connectionState*/) {
+            return handleRequest(request);
+        });
+
+    auto [listening, reason] = server->listen();
+    if (!listening) {
+        server.reset();
+        auto errorMessage = fmt::format("unable to serve metrics on {}:{}: {}", address, port, reason);
+        logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::IOError, errorMessage)};
+    }
+
+    server->start();
+    logger->info("serving metrics at http://{}:{}/metrics 📈", address, port);
+    return Result<bool>{true};
+}
+
+void MetricsServer::shutdown() {
+    if (server) {
+        logger->debug("stopping the metrics server");
+        server->stop();
+        server.reset();
+    }
+}
+
+ix::HttpResponsePtr MetricsServer::handleRequest(const ix::HttpRequestPtr &request) const {
+    ix::WebSocketHttpHeaders headers;
+
+    // Prometheus sometimes adds a query string, which we don't care about
+    const std::string path = request->uri.substr(0, request->uri.find('?'));
+    if (path != "/metrics") {
+        headers["Content-Type"] = "text/plain";
+        return std::make_shared<ix::HttpResponse>(404, "Not Found", ix::HttpErrorCode::Ok, headers,
+                                                  "Nothing here but /metrics 🐰\n");
+    }
+
+    if (request->method != "GET" && request->method != "HEAD") {
+        headers["Content-Type"] = "text/plain";
+        return std::make_shared<ix::HttpResponse>(405, "Method Not Allowed", ix::HttpErrorCode::Ok, headers,
+                                                  "Only GET is allowed here\n");
+    }
+
+    headers["Content-Type"] = "text/plain; version=0.0.4; charset=utf-8";
+    return std::make_shared<ix::HttpResponse>(200, "OK", ix::HttpErrorCode::Ok, headers, registry->render());
+}
+
+} // namespace creatures::metrics
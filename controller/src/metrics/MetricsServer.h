@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <ixwebsocket/IXHttpServer.h>
+
+#include "logging/Logger.h"
+#include "metrics/MetricsRegistry.h"
+#include "util/Result.h"
+
+namespace creatures::metrics {
+
+/**
+ * A tiny web server that hands out our metrics at `/metrics` for Prometheus
+ * (or curl, or anyone else) to scrape
+ *
+ * Everything is gathered when the page is asked for, on the web server's
+ * thread, so nothing in the motion path ever waits on a scrape. It listens on
+ * loopback unless it's told otherwise, since there's nothing in here the rest
+ * of the network needs to see.
+ */
+class MetricsServer {
+  public:
+    MetricsServer(std::shared_ptr<Logger> logger, std::shared_ptr<MetricsRegistry> registry, std::string address,
+                  int port);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    /**
+     * Start listening
+     *
+     * @return true if it worked, or an error saying why we couldn't listen
+     */
+    Result<bool> start();
+
+    /**
+     * Stop listening. It's fine to call this more than once.
+     */
+    void shutdown();
+
+  private:
+    ix::HttpResponsePtr handleRequest(const ix::HttpRequestPtr &request) const;
+
+    std::shared_ptr<Logger> logger;
+    std::shared_ptr<MetricsRegistry> registry;
+    std::string address;
+    int port;
+
+    std::unique_ptr<ix::HttpServer> server;
+};
+
+} // namespace creatures::metrics
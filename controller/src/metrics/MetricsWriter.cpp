@@ -0,0 +1,101 @@
+
+#include <cmath>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "metrics/MetricsWriter.h"
+
+namespace creatures::metrics {
+
+namespace {
+
+// Label values are quoted, so quotes, backslashes, and newlines need escaping
+std::string escapeLabelValue(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c : value) {
+        switch (c) {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            escaped += c;
+            break;
+        }
+    }
+    return escaped;
+}
+
+std::string formatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+
+    // Whole numbers (which is most of them) shouldn't grow a decimal point
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        return fmt::format("{:.0f}", value);
+    }
+    return fmt::format("{}", value);
+}
+
+} // namespace
+
+void MetricsWriter::counter(std::string_view name, std::string_view help, double value, const Labels &labels) {
+    sample(name, help, "counter", value, labels);
+}
+
+void MetricsWriter::gauge(std::string_view name, std::string_view help, double value, const Labels &labels) {
+    sample(name, help, "gauge", value, labels);
+}
+
+void MetricsWriter::sample(std::string_view name, std::string_view help, std::string_view type, double value,
+                           const Labels &labels) {
+    auto &samples = family(name, help, type).samples;
+
+    samples += name;
+    if (!labels.empty()) {
+        samples += '{';
+        for (size_t i = 0; i < labels.size(); i++) {
+            if (i > 0) {
+                samples += ',';
+            }
+            samples += fmt::format("{}=\"{}\"", labels[i].first, escapeLabelValue(labels[i].second));
+        }
+        samples += '}';
+    }
+    samples += ' ';
+    samples += formatValue(value);
+    samples += '\n';
+}
+
+MetricsWriter::Family &MetricsWriter::family(std::string_view name, std::string_view help, std::string_view type) {
+    for (auto &existing : families) {
+        if (existing.name == name) {
+            return existing;
+        }
+    }
+    families.push_back(Family{std::string(name), std::string(help), std::string(type), {}});
+    return families.back();
+}
+
+std::string MetricsWriter::finish() const {
+    std::string page;
+    for (const auto &f : families) {
+        page += fmt::format("# HELP {} {}\n# TYPE {} {}\n", f.name, f.help, f.name, f.type);
+        page += f.samples;
+    }
+    return page;
+}
+
+} // namespace creatures::metrics
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace creatures::metrics {
+
+/**
+ * Builds a page of metrics in the Prometheus text format
+ *
+ *     # HELP creature_controller_frames_total Control loop ticks so far
+ *     # TYPE creature_controller_frames_total counter
+ *     creature_controller_frames_total 123456
+ *
+ * Samples can be added in any order. Ones with the same name are kept
+ * together under a single HELP and TYPE, in the order the names first showed
+ * up, which is what Prometheus wants.
+ */
+class MetricsWriter {
+  public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * Something that only ever goes up (until we restart)
+     */
+    void counter(std::string_view name, std::string_view help, double value, const Labels &labels = {});
+
+    /**
+     * Something that goes up and down
+     */
+    void gauge(std::string_view name, std::string_view help, double value, const Labels &labels = {});
+
+    /**
+     * The finished page
+     */
+    [[nodiscard]] std::string finish() const;
+
+  private:
+    struct Family {
+        std::string name;
+        std::string help;
+        std::string type;
+        std::string samples;
+    };
+
+    void sample(std::string_view name, std::string_view help, std::string_view type, double value,
+                const Labels &labels);
+
+    Family &family(std::string_view name, std::string_view help, std::string_view type);
+
+    std::vector<Family> families;
+};
+
+} // namespace creatures::metrics
@@ -0,0 +1,324 @@
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "audio/AudioSubsystem.h"
+#include "config/UARTDevice.h"
+#include "controller/Controller.h"
+#include "controller/MotionLatency.h"
+#include "controller/ServoModuleHandler.h"
+#include "dmx/E131Client.h"
+#include "io/MessageProcessor.h"
+#include "io/MessageRouter.h"
+#include "io/handlers/FirmwareStats.h"
+#include "io/handlers/StatsMessage.h"
+#include "logging/SpdlogLogger.h"
+#include "metrics/MetricsRegistry.h"
+#include "metrics/MetricsWriter.h"
+#include "metrics/collectors.h"
+#include "server/ServerConnection.h"
+#include "util/Histogram.h"
+
+namespace creatures::metrics {
+
+using creatures::config::UARTDevice;
+using Labels = MetricsWriter::Labels;
+
+namespace {
+
+/**
+ * A histogram as a handful of gauges, one per quantile. Our histograms are
+ * reset with each controller summary, so these only ever cover the last one.
+ */
+void writeQuantiles(MetricsWriter &writer, std::string_view name, std::string_view help, const Histogram &histogram,
+                    const Labels &labels = {}) {
+    constexpr std::array<std::pair<double, const char *>, 3> quantiles = {{{50, "0.5"}, {99, "0.99"}, {100, "1"}}};
+
+    for (const auto &[percentile, quantile] : quantiles) {
+        Labels withQuantile = labels;
+        withQuantile.emplace_back("quantile", quantile);
+        const auto value = percentile == 100 ? histogram.max() : histogram.percentile(percentile);
+        writer.gauge(name, help, static_cast<double>(value), withQuantile);
+    }
+}
+
+} // namespace
+
+MetricsRegistry::Collector controllerCollector(const std::shared_ptr<Controller> &controller) {
+    return [weakController = std::weak_ptr<Controller>(controller)](MetricsWriter &writer) {
+        auto liveController = weakController.lock();
+        if (!liveController) {
+            return;
+        }
+
+        writer.counter("creature_controller_frames_total", "Times the control loop has gone around",
+                       static_cast<double>(liveController->getNumberOfFrames()));
+        writer.gauge("creature_controller_frames_per_second", "Control loop frame rate as of the last summary",
+                     liveController->getFramesPerSecond());
+        writer.gauge("creature_controller_target_frames_per_second", "Control loop frame rate we're aiming for",
+                     liveController->getCreature()->getServoUpdateFrequencyHz());
+        writer.counter("creature_controller_ticks_skipped_total",
+                       "Control loop ticks skipped because the loop fell a whole period behind",
+                       static_cast<double>(liveController->getTicksSkipped()));
+        writeQuantiles(writer, "creature_controller_wakeup_lateness_microseconds",
+                       "How late the control loop woke up since the last summary", liveController->getWakeupLateness());
+    };
+}
+
+MetricsRegistry::Collector motionLatencyCollector() {
+    return [](MetricsWriter &writer) {
+        for (size_t i = 0; i < MotionLatency::NumberOfStages; i++) {
+            const auto stage = static_cast<MotionLatency::Stage>(i);
+            writeQuantiles(writer, "creature_controller_motion_latency_microseconds",
+                           "Time motion spent in each stage on its way to the servos since the last summary",
+                           MotionLatency::getHistogram(stage), {{"stage", MotionLatency::stageName(stage)}});
+        }
+    };
+}
+
+MetricsRegistry::Collector e131Collector(const std::shared_ptr<dmx::E131Client> &e131Client) {
+    return [weakClient = std::weak_ptr<dmx::E131Client>(e131Client)](MetricsWriter &writer) {
+        auto liveClient = weakClient.lock();
+        if (!liveClient) {
+            return;
+        }
+
+        writer.counter("creature_controller_e131_packets_received_total", "E1.31 packets off the socket",
+                       static_cast<double>(liveClient->getPacketsReceived()));
+        writer.counter("creature_controller_e131_frames_skipped_total",
+                       "Good E1.31 packets replaced by a newer one in the same batch",
+                       static_cast<double>(liveClient->getFramesSkipped()));
+        writer.counter("creature_controller_e131_packets_invalid_total", "E1.31 packets that were short or invalid",
+                       static_cast<double>(liveClient->getInvalidPackets()));
+        writer.counter("creature_controller_e131_packets_out_of_order_total", "E1.31 packets that arrived too late",
+                       static_cast<double>(liveClient->getOutOfOrderPackets()));
+    };
+}
+
+MetricsRegistry::Collector servoModuleCollector(const std::shared_ptr<ServoModuleHandler> &handler) {
+    return [weakHandler = std::weak_ptr<ServoModuleHandler>(handler)](MetricsWriter &writer) {
+        auto liveHandler = weakHandler.lock();
+        if (!liveHandler) {
+            return;
+        }
+
+        const std::string module = UARTDevice::moduleNameToString(liveHandler->getModuleName());
+
+        writer.gauge("creature_controller_module_ready", "Is this module's firmware ready to go?",
+                     liveHandler->isReady() ? 1 : 0, {{"module", module}});
+
+        const std::array<std::pair<const char *, std::shared_ptr<SpscQueue<Message>>>, 2> queues = {
+            {{"incoming", liveHandler->getIncomingQueue()}, {"outgoing", liveHandler->getOutgoingQueue()}}};
+        for (const auto &[direction, queue] : queues) {
+            if (!queue) {
+                continue;
+            }
+            const Labels labels = {{"module", module}, {"direction", direction}};
+            writer.gauge("creature_controller_module_queue_depth", "Messages waiting in a module's queue",
+                         static_cast<double>(queue->size()), labels);
+            writer.gauge("creature_controller_module_queue_capacity", "How many messages a module's queue can hold",
+                         static_cast<double>(queue->capacity()), labels);
+            writer.counter("creature_controller_module_queue_dropped_total",
+                           "Messages dropped because a module's queue was full", static_cast<double>(queue->dropped()),
+                           labels);
+        }
+
+        if (const auto *processor = liveHandler->getMessageProcessor()) {
+            for (const auto &typeStats : processor->getMessageTypeStats()) {
+                const Labels labels = {{"module", module}, {"type", typeStats.messageType}};
+                writer.counter("creature_controller_module_messages_processed_total",
+                               "Messages from a module's firmware, by type", static_cast<double>(typeStats.messages),
+                               labels);
+                writer.counter("creature_controller_module_message_seconds_total",
+                               "Time spent on messages from a module's firmware, by type and stage",
+                               static_cast<double>(typeStats.parseNs) / 1e9,
+                               {labels[0], labels[1], {"stage", "parse"}});
+                writer.counter("creature_controller_module_message_seconds_total",
+                               "Time spent on messages from a module's firmware, by type and stage",
+                               static_cast<double>(typeStats.dispatchNs) / 1e9,
+                               {labels[0], labels[1], {"stage", "dispatch"}});
+                writer.gauge("creature_controller_module_message_dispatch_max_seconds",
+                             "The longest a handler has taken with one message, by type",
+                             static_cast<double>(typeStats.maxDispatchNs) / 1e9, labels);
+            }
+        }
+
+        if (auto pendingPosition = liveHandler->getPendingPosition()) {
+            writer.counter("creature_controller_serial_positions_replaced_total",
+                           "Position frames replaced by a newer one before they went out to a module",
+                           static_cast<double>(pendingPosition->replaced()), {{"module", module}});
+        }
+
+        if (auto stats = liveHandler->getSerialStats()) {
+            const Labels read = {{"module", module}, {"direction", "read"}};
+            const Labels written = {{"module", module}, {"direction", "written"}};
+            writer.counter("creature_controller_serial_bytes_total", "Bytes through a module's serial port",
+                           static_cast<double>(stats->bytesRead.load(std::memory_order_relaxed)), read);
+            writer.counter("creature_controller_serial_bytes_total", "Bytes through a module's serial port",
+                           static_cast<double>(stats->bytesWritten.load(std::memory_order_relaxed)), written);
+            writer.counter("creature_controller_serial_messages_total", "Messages through a module's serial port",
+                           static_cast<double>(stats->messagesRead.load(std::memory_order_relaxed)), read);
+            writer.counter("creature_controller_serial_messages_total", "Messages through a module's serial port",
+                           static_cast<double>(stats->messagesWritten.load(std::memory_order_relaxed)), written);
+            writer.gauge("creature_controller_serial_write_bytes_per_second",
+                         "How fast we've been writing to a module's serial port lately",
+                         static_cast<double>(stats->bytesWrittenPerSecond.load(std::memory_order_relaxed)),
+                         {{"module", module}});
+            writer.counter("creature_controller_serial_short_writes_total",
+                           "Writes a module's serial port only took part of",
+                           static_cast<double>(stats->shortWrites.load(std::memory_order_relaxed)),
+                           {{"module", module}});
+            writer.counter("creature_controller_serial_write_seconds_total",
+                           "Time spent writing to a module's serial port, and waiting for it to have room",
+                           static_cast<double>(stats->writeNs.load(std::memory_order_relaxed)) / 1e9,
+                           {{"module", module}, {"stage", "write"}});
+            writer.counter("creature_controller_serial_write_seconds_total",
+                           "Time spent writing to a module's serial port, and waiting for it to have room",
+                           static_cast<double>(stats->writeWaitNs.load(std::memory_order_relaxed)) / 1e9,
+                           {{"module", module}, {"stage", "wait"}});
+            writer.counter("creature_controller_serial_lines_too_long_total",
+                           "Lines from a module's firmware thrown out for being too long",
+                           static_cast<double>(stats->linesTooLong.load(std::memory_order_relaxed)),
+                           {{"module", module}});
+        }
+    };
+}
+
+MetricsRegistry::Collector messageRouterCollector(const std::shared_ptr<io::MessageRouter> &messageRouter) {
+    return [weakRouter = std::weak_ptr<io::MessageRouter>(messageRouter)](MetricsWriter &writer) {
+        auto liveRouter = weakRouter.lock();
+        if (!liveRouter) {
+            return;
+        }
+
+        if (auto queue = liveRouter->getIncomingQueue()) {
+            writer.gauge("creature_controller_router_queue_depth", "Messages waiting for the message router",
+                         static_cast<double>(queue->size()));
+            writer.gauge("creature_controller_router_queue_high_water",
+                         "The most messages ever waiting for the message router",
+                         static_cast<double>(queue->high_water_mark()));
+        }
+    };
+}
+
+MetricsRegistry::Collector firmwareCollector() {
+    return [](MetricsWriter &writer) {
+        for (const auto &[moduleName, stats] : FirmwareStats::getLatest()) {
+            const Labels labels = {{"module", UARTDevice::moduleNameToString(moduleName)}};
+
+            writer.gauge("creature_controller_firmware_heap_free_bytes", "Free heap on the firmware",
+                         static_cast<double>(stats.freeHeap), labels);
+            writer.gauge("creature_controller_firmware_temperature_degrees", "Board temperature the firmware reported",
+                         stats.boardTemperature, labels);
+            writer.counter("creature_controller_firmware_uart_messages_received_total",
+                           "Messages the firmware has received from us",
+                           static_cast<double>(stats.uARTMessagesReceived), labels);
+            writer.counter("creature_controller_firmware_uart_messages_sent_total", "Messages the firmware has sent us",
+                           static_cast<double>(stats.uARTMessagesSent), labels);
+            writer.counter("creature_controller_firmware_parse_failures_total",
+                           "Messages the firmware couldn't parse", static_cast<double>(stats.parseFailures), labels);
+            writer.counter("creature_controller_firmware_checksum_failures_total",
+                           "Messages the firmware threw out for a bad checksum",
+                           static_cast<double>(stats.checksumFailures), labels);
+            writer.counter("creature_controller_firmware_messages_dropped_total",
+                           "Messages the firmware dropped because a queue was full",
+                           static_cast<double>(stats.incomingMessagesDropped), {labels[0], {"direction", "incoming"}});
+            writer.counter("creature_controller_firmware_messages_dropped_total",
+                           "Messages the firmware dropped because a queue was full",
+                           static_cast<double>(stats.outgoingMessagesDropped), {labels[0], {"direction", "outgoing"}});
+            writer.counter("creature_controller_firmware_positions_processed_total",
+                           "Position messages the firmware has acted on",
+                           static_cast<double>(stats.positionMessagesProcessed), labels);
+            writer.counter("creature_controller_firmware_pwm_wraps_total", "PWM wraps on the firmware",
+                           static_cast<double>(stats.pwmWraps), labels);
+            writer.counter("creature_controller_firmware_dynamixel_errors_total", "Dynamixel bus errors",
+                           static_cast<double>(stats.dxlErrors), labels);
+            writer.counter("creature_controller_firmware_dynamixel_crc_errors_total", "Dynamixel bus CRC errors",
+                           static_cast<double>(stats.dxlCrcErrors), labels);
+            writer.counter("creature_controller_firmware_dynamixel_timeouts_total", "Dynamixel bus timeouts",
+                           static_cast<double>(stats.dxlTimeouts), labels);
+        }
+    };
+}
+
+MetricsRegistry::Collector serverCollector(const std::shared_ptr<server::ServerConnection> &serverConnection) {
+    return [weakConnection = std::weak_ptr<server::ServerConnection>(serverConnection)](MetricsWriter &writer) {
+        auto liveConnection = weakConnection.lock();
+        if (!liveConnection) {
+            return;
+        }
+
+        const auto stats = liveConnection->getWriterStats();
+        writer.gauge("creature_controller_server_queue_depth", "Messages waiting to go to the server",
+                     static_cast<double>(stats.queueDepth));
+        writer.gauge("creature_controller_server_queue_high_water",
+                     "The most messages ever waiting to go to the server", static_cast<double>(stats.queueHighWater));
+        writer.counter("creature_controller_server_queue_overflowed_total",
+                       "Messages thrown out because the server queue was full",
+                       static_cast<double>(stats.queueOverflowed));
+        writer.counter("creature_controller_server_messages_sent_total", "Messages sent to the server",
+                       static_cast<double>(stats.messagesSent));
+        writer.counter("creature_controller_server_frames_sent_total", "Websocket frames sent to the server",
+                       static_cast<double>(stats.framesSent));
+        writer.counter("creature_controller_server_bytes_sent_total", "Bytes sent to the server",
+                       static_cast<double>(stats.bytesSent));
+        writer.counter("creature_controller_server_messages_coalesced_total",
+                       "Messages replaced by a newer one before they were sent",
+                       static_cast<double>(stats.messagesCoalesced));
+        writer.counter("creature_controller_server_messages_dropped_total", "Messages that were never sent",
+                       static_cast<double>(stats.messagesDropped));
+        writer.counter("creature_controller_server_send_failures_total", "Websocket frames that failed to send",
+                       static_cast<double>(stats.sendFailures));
+    };
+}
+
+MetricsRegistry::Collector audioCollector(const std::shared_ptr<audio::AudioSubsystem> &audioSubsystem) {
+    return [weakAudio = std::weak_ptr<audio::AudioSubsystem>(audioSubsystem)](MetricsWriter &writer) {
+        auto liveAudio = weakAudio.lock();
+        if (!liveAudio) {
+            return;
+        }
+        auto client = liveAudio->getRtpClient();
+        if (!client) {
+            return;
+        }
+
+        writer.gauge("creature_controller_audio_receiving", "Is audio arriving?", client->isReceiving() ? 1 : 0);
+        writer.gauge("creature_controller_audio_buffer_level", "How full the audio output buffer is (0 to 1)",
+                     client->getBufferLevel());
+        writer.gauge("creature_controller_audio_output_queued_frames", "Audio frames queued for the output device",
+                     static_cast<double>(client->getOutputQueuedFrames()));
+        writer.gauge("creature_controller_audio_buffered_frames", "Audio frames waiting in a stream's jitter buffer",
+                     static_cast<double>(client->getDialogBufferedFrames()), {{"stream", "dialog"}});
+        writer.gauge("creature_controller_audio_buffered_frames", "Audio frames waiting in a stream's jitter buffer",
+                     static_cast<double>(client->getBgmBufferedFrames()), {{"stream", "bgm"}});
+        writer.counter("creature_controller_audio_packets_received_total", "RTP audio packets received",
+                       static_cast<double>(client->getPacketsReceived()));
+        writer.counter("creature_controller_audio_concealed_frames_total", "Audio frames we had to make up",
+                       static_cast<double>(client->getConcealedFrames()));
+        writer.counter("creature_controller_audio_decode_errors_total", "Audio frames that wouldn't decode",
+                       static_cast<double>(client->getDecodeErrors()));
+        writer.counter("creature_controller_audio_buffer_overruns_total", "Audio packets with no room in the buffer",
+                       static_cast<double>(client->getBufferOverruns()));
+        writer.counter("creature_controller_audio_playout_deadline_misses_total",
+                       "Times audio wasn't ready when the output needed it",
+                       static_cast<double>(client->getPlayoutDeadlineMisses()));
+        writer.counter("creature_controller_audio_rtcp_fallbacks_total",
+                       "Times we fell back to timing audio by when it arrived",
+                       static_cast<double>(client->getRtcpFallbacks()));
+        writer.counter("creature_controller_audio_rtcp_late_frames_dropped_total",
+                       "Audio frames dropped for missing their RTCP playout deadline",
+                       static_cast<double>(client->getRtcpLateFramesDropped()));
+    };
+}
+
+MetricsRegistry::Collector loggingCollector() {
+    return [](MetricsWriter &writer) {
+        writer.counter("creature_controller_log_lines_dropped_total", "Log lines dropped because the queue was full",
+                       static_cast<double>(SpdlogLogger::droppedMessages()));
+    };
+}
+
+} // namespace creatures::metrics
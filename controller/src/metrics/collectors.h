@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+
+#include "metrics/MetricsRegistry.h"
+
+class Controller;
+
+namespace creatures {
+class ServoModuleHandler;
+}
+
+namespace creatures::audio {
+class AudioSubsystem;
+}
+
+namespace creatures::dmx {
+class E131Client;
+}
+
+namespace creatures::io {
+class MessageRouter;
+}
+
+namespace creatures::server {
+class ServerConnection;
+}
+
+/*
+ * Collectors for each of our subsystems, ready to add to a `MetricsRegistry`
+ *
+ * They only hold on to what they look at weakly, so a scrape that shows up
+ * while we're shutting down just gets a shorter page.
+ */
+namespace creatures::metrics {
+
+/**
+ * Control loop ticks, frame rate, and how on time it's been waking up
+ */
+MetricsRegistry::Collector controllerCollector(const std::shared_ptr<Controller> &controller);
+
+/**
+ * How long motion has been taking to get from the network to the servos
+ */
+MetricsRegistry::Collector motionLatencyCollector();
+
+/**
+ * E1.31 packets we've seen, and the ones we didn't use
+ */
+MetricsRegistry::Collector e131Collector(const std::shared_ptr<dmx::E131Client> &e131Client);
+
+/**
+ * One servo module's queues and serial port
+ */
+MetricsRegistry::Collector servoModuleCollector(const std::shared_ptr<ServoModuleHandler> &handler);
+
+/**
+ * What the message router has waiting for it
+ */
+MetricsRegistry::Collector messageRouterCollector(const std::shared_ptr<io::MessageRouter> &messageRouter);
+
+/**
+ * The newest STATS report from each firmware board
+ */
+MetricsRegistry::Collector firmwareCollector();
+
+/**
+ * How the websocket to the server has been getting on
+ */
+MetricsRegistry::Collector serverCollector(const std::shared_ptr<server::ServerConnection> &serverConnection);
+
+/**
+ * Audio buffer levels, and everything that went wrong getting it out on time
+ */
+MetricsRegistry::Collector audioCollector(const std::shared_ptr<audio::AudioSubsystem> &audioSubsystem);
+
+/**
+ * Log lines that didn't make it
+ */
+MetricsRegistry::Collector loggingCollector();
+
+} // namespace creatures::metrics
@@ -0,0 +1,95 @@
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "replay/CaptureReader.h"
+
+namespace creatures::replay {
+
+CaptureReader::CaptureReader(const std::shared_ptr<Logger> &_logger, std::string _path)
+    : logger(_logger), path(std::move(_path)) {}
+
+CaptureReader::~CaptureReader() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+Result<bool> CaptureReader::open() {
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        auto errorMessage = fmt::format("Unable to open capture file {}: {}", path, std::strerror(errno));
+        logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::IOError, errorMessage)};
+    }
+
+    std::array<char, CAPTURE_HEADER_SIZE> header{};
+    if (std::fread(header.data(), 1, header.size(), file) != header.size() ||
+        std::memcmp(header.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+        auto errorMessage = fmt::format("{} isn't a capture file", path);
+        logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::InvalidData, errorMessage)};
+    }
+
+    const auto version = static_cast<u16>(getLittleEndian(header.data() + 4, 2));
+    if (version != CAPTURE_FORMAT_VERSION) {
+        auto errorMessage = fmt::format("{} is a version {} capture, and we only know how to read version {}", path,
+                                        version, CAPTURE_FORMAT_VERSION);
+        logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::InvalidData, errorMessage)};
+    }
+
+    universe = static_cast<u16>(getLittleEndian(header.data() + 6, 2));
+    startedAtNs = static_cast<std::int64_t>(getLittleEndian(header.data() + 8, 8));
+
+    logger->debug("opened capture file {} (universe {})", path, universe);
+    return Result<bool>{true};
+}
+
+Result<bool> CaptureReader::next(CaptureRecord &record) {
+    if (file == nullptr) {
+        return Result<bool>{ControllerError(ControllerError::InternalError, "the capture file isn't open")};
+    }
+
+    std::array<char, CAPTURE_RECORD_HEADER_SIZE> header{};
+    const size_t headerRead = std::fread(header.data(), 1, header.size(), file);
+    if (headerRead == 0 && std::feof(file)) {
+        return Result<bool>{false};
+    }
+    if (headerRead != header.size()) {
+        return Result<bool>{ControllerError(ControllerError::InvalidData,
+                                            fmt::format("capture file {} ends partway through a record", path))};
+    }
+
+    const auto kind = static_cast<u8>(header[0]);
+    if (kind < static_cast<u8>(RecordKind::inputFrame) || kind > static_cast<u8>(RecordKind::serialOut)) {
+        return Result<bool>{ControllerError(
+            ControllerError::InvalidData, fmt::format("capture file {} has a record of unknown kind {}", path, kind))};
+    }
+
+    const auto module = static_cast<u8>(header[1]);
+    if (module > UARTDevice::invalid_module) {
+        return Result<bool>{ControllerError(ControllerError::InvalidData,
+                                            fmt::format("capture file {} has a record for module {}", path, module))};
+    }
+
+    record.kind = static_cast<RecordKind>(kind);
+    record.module = static_cast<UARTDevice::module_name>(module);
+    record.offsetNs = static_cast<std::int64_t>(getLittleEndian(header.data() + 4, 8));
+
+    const auto length = static_cast<size_t>(getLittleEndian(header.data() + 2, 2));
+    record.payload.resize(length);
+    if (length > 0 && std::fread(record.payload.data(), 1, length, file) != length) {
+        return Result<bool>{ControllerError(ControllerError::InvalidData,
+                                            fmt::format("capture file {} ends partway through a record", path))};
+    }
+
+    return Result<bool>{true};
+}
+
+} // namespace creatures::replay
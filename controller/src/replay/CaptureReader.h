@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "controller-config.h"
+#include "logging/Logger.h"
+#include "replay/CaptureRecord.h"
+#include "util/Result.h"
+
+namespace creatures::replay {
+
+/**
+ * Reads back a file the `CaptureWriter` wrote, one record at a time
+ *
+ * Records come out in the order they were written, which is close to the
+ * order they happened in, but not exactly: the e1.31 client and the serial
+ * threads all record on their own. Anyone who cares about the order should
+ * look at `offsetNs`.
+ */
+class CaptureReader {
+  public:
+    CaptureReader(const std::shared_ptr<Logger> &logger, std::string path);
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+    /**
+     * Open the file and make sure it's a capture we know how to read
+     */
+    Result<bool> open();
+
+    /**
+     * Read the next record
+     *
+     * @param record where to put it
+     * @return true if there was one, false at the end of the file, or an error
+     *         if the file is cut off or doesn't make sense
+     */
+    Result<bool> next(CaptureRecord &record);
+
+    [[nodiscard]] u16 getUniverse() const { return universe; }
+
+    /**
+     * When the capture started, in nanoseconds since the Unix epoch
+     */
+    [[nodiscard]] std::int64_t getStartedAtNs() const { return startedAtNs; }
+
+  private:
+    std::shared_ptr<Logger> logger;
+    std::string path;
+    std::FILE *file = nullptr;
+
+    u16 universe = 0;
+    std::int64_t startedAtNs = 0;
+};
+
+} // namespace creatures::replay
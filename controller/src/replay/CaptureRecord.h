@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "config/UARTDevice.h"
+#include "controller-config.h"
+
+namespace creatures::replay {
+
+using creatures::config::UARTDevice;
+
+/**
+ * What's in a capture file, and how it's laid out
+ *
+ * A capture starts with a small header:
+ *
+ *     "CCAP"   magic
+ *     u16      format version (CAPTURE_FORMAT_VERSION)
+ *     u16      the e1.31 universe we were listening to
+ *     i64      when the capture started, in nanoseconds since the Unix epoch
+ *
+ * and then it's records, one after another, until the end of the file:
+ *
+ *     u8       kind (a `RecordKind`)
+ *     u8       module (a `UARTDevice::module_name`, or invalid_module for
+ *              input frames)
+ *     u16      payload length
+ *     i64      nanoseconds since the capture started
+ *     ...      the payload
+ *
+ * Everything is little-endian. An input frame's payload is the frame's slots,
+ * starting from slot 0, up to the last slot the creature has an input on. A
+ * serial record's payload is the line, without its newline.
+ */
+
+inline constexpr char CAPTURE_MAGIC[4] = {'C', 'C', 'A', 'P'};
+inline constexpr u16 CAPTURE_FORMAT_VERSION = 1;
+inline constexpr size_t CAPTURE_HEADER_SIZE = 16;
+inline constexpr size_t CAPTURE_RECORD_HEADER_SIZE = 12;
+
+enum class RecordKind : u8 {
+    inputFrame = 1, // An e1.31 frame that made it to the controller
+    serialIn = 2,   // A line a module sent us
+    serialOut = 3,  // A line we sent a module
+};
+
+struct CaptureRecord {
+    RecordKind kind = RecordKind::inputFrame;
+    UARTDevice::module_name module = UARTDevice::invalid_module;
+
+    // When it happened, relative to the start of the capture
+    std::int64_t offsetNs = 0;
+
+    std::string payload;
+};
+
+/**
+ * Put the low `bytes` bytes of a value into `out`, little-endian
+ */
+inline void putLittleEndian(char *out, std::uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * Read `bytes` bytes back out of `in`, little-endian
+ */
+inline std::uint64_t getLittleEndian(const char *in, size_t bytes) {
+    std::uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace creatures::replay
@@ -0,0 +1,180 @@
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "controller/MotionLatency.h"
+#include "replay/CaptureWriter.h"
+#include "util/thread_name.h"
+
+namespace creatures::replay {
+
+CaptureWriter::CaptureWriter(const std::shared_ptr<Logger> &_logger, std::string _path, u16 _universe,
+                             bool _includeSerial)
+    : logger(_logger), path(std::move(_path)), universe(_universe), includeSerial(_includeSerial) {}
+
+CaptureWriter::~CaptureWriter() { close(); }
+
+Result<bool> CaptureWriter::open() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        auto errorMessage = fmt::format("Unable to open capture file {}: {}", path, std::strerror(errno));
+        logger->error(errorMessage);
+        return Result<bool>{ControllerError(ControllerError::IOError, errorMessage)};
+    }
+
+    const auto wallClockNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+
+    std::array<char, CAPTURE_HEADER_SIZE> header{};
+    std::memcpy(header.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    putLittleEndian(header.data() + 4, CAPTURE_FORMAT_VERSION, 2);
+    putLittleEndian(header.data() + 6, universe, 2);
+    putLittleEndian(header.data() + 8, static_cast<std::uint64_t>(wallClockNs), 8);
+
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        auto errorMessage = fmt::format("Unable to write the header to capture file {}: {}", path,
+                                        std::strerror(errno));
+        logger->error(errorMessage);
+        std::fclose(file);
+        file = nullptr;
+        return Result<bool>{ControllerError(ControllerError::IOError, errorMessage)};
+    }
+    bytesWritten.fetch_add(header.size(), std::memory_order_relaxed);
+
+    startedNs = MotionLatency::now();
+    opened.store(true);
+
+    logger->info("capturing {} to {}", includeSerial ? "e1.31 frames and serial traffic" : "e1.31 frames", path);
+    return Result<bool>{true};
+}
+
+void CaptureWriter::start() {
+    logger->info("starting the capture writer");
+    StoppableThread::start();
+}
+
+void CaptureWriter::recordInputFrame(const InputFrame &frame, size_t slotsUsed) {
+    const std::int64_t atNs = frame.timestamps.receivedNs != 0 ? frame.timestamps.receivedNs : MotionLatency::now();
+    const size_t length = std::min(slotsUsed, frame.slots.size());
+    enqueue(RecordKind::inputFrame, UARTDevice::invalid_module, atNs,
+            std::string_view(reinterpret_cast<const char *>(frame.slots.data()), length));
+}
+
+void CaptureWriter::recordSerial(RecordKind kind, UARTDevice::module_name module, std::string_view line) {
+    if (!includeSerial) {
+        return;
+    }
+    enqueue(kind, module, MotionLatency::now(), line);
+}
+
+void CaptureWriter::enqueue(RecordKind kind, UARTDevice::module_name module, std::int64_t atNs,
+                            std::string_view payload) {
+    if (!opened.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if (payload.size() > std::numeric_limits<u16>::max()) {
+        recordsDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CaptureRecord record;
+    record.kind = kind;
+    record.module = module;
+    record.offsetNs = atNs - startedNs;
+    record.payload.assign(payload);
+
+    // Better to lose a few records than to let a stuck disk eat all our RAM
+    if (!pending.push(std::move(record))) {
+        recordsDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CaptureWriter::run() {
+    threadName = "CaptureWriter::run";
+    setThreadName(threadName);
+
+    std::vector<CaptureRecord> batch;
+    batch.reserve(CAPTURE_WRITE_BATCH_SIZE);
+
+    while (!stop_requested.load()) {
+        auto first = pending.pop_timeout(std::chrono::milliseconds(100));
+        if (!first.has_value()) {
+            continue;
+        }
+
+        batch.clear();
+        batch.push_back(std::move(first.value()));
+        pending.drain_into(batch, CAPTURE_WRITE_BATCH_SIZE - 1);
+
+        std::lock_guard<std::mutex> lock(fileMutex);
+        writeRecords(batch);
+    }
+
+    logger->debug("capture writer thread stopping");
+}
+
+void CaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file == nullptr) {
+        return;
+    }
+
+    opened.store(false);
+    pending.request_shutdown();
+
+    // Whatever the writer thread hadn't gotten to yet
+    std::vector<CaptureRecord> remaining;
+    pending.drain_into(remaining);
+    writeRecords(remaining);
+
+    std::fclose(file);
+    file = nullptr;
+
+    logger->info("capture file {} closed ({} records, {} bytes, {} dropped)", path, getRecordsWritten(),
+                 getBytesWritten(), getRecordsDropped());
+}
+
+void CaptureWriter::writeRecords(const std::vector<CaptureRecord> &records) {
+    if (file == nullptr) {
+        return;
+    }
+
+    std::array<char, CAPTURE_RECORD_HEADER_SIZE> header{};
+    for (const auto &record : records) {
+        header[0] = static_cast<char>(record.kind);
+        header[1] = static_cast<char>(record.module);
+        putLittleEndian(header.data() + 2, record.payload.size(), 2);
+        putLittleEndian(header.data() + 4, static_cast<std::uint64_t>(record.offsetNs), 8);
+
+        if (std::fwrite(header.data(), 1, header.size(), file) != header.size() ||
+            std::fwrite(record.payload.data(), 1, record.payload.size(), file) != record.payload.size()) {
+            logger->error("unable to write to capture file {}: {}", path, std::strerror(errno));
+            recordsDropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        recordsWritten.fetch_add(1, std::memory_order_relaxed);
+        bytesWritten.fetch_add(header.size() + record.payload.size(), std::memory_order_relaxed);
+    }
+}
+
+u64 CaptureWriter::getRecordsWritten() const { return recordsWritten.load(std::memory_order_relaxed); }
+
+u64 CaptureWriter::getRecordsDropped() const { return recordsDropped.load(std::memory_order_relaxed); }
+
+u64 CaptureWriter::getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+
+} // namespace creatures::replay
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config/UARTDevice.h"
+#include "controller-config.h"
+#include "controller/InputFrame.h"
+#include "logging/Logger.h"
+#include "replay/CaptureRecord.h"
+#include "util/MessageQueue.h"
+#include "util/Result.h"
+#include "util/StoppableThread.h"
+
+namespace creatures::replay {
+
+/**
+ * Writes what the controller saw to a capture file, so a show that went
+ * sideways can be played back later on a laptop
+ *
+ * Recording is cheap on purpose: the e1.31 client and the serial threads only
+ * copy the bytes into a queue, and this thread does the actual writing. If it
+ * can't keep up and CAPTURE_MAX_PENDING_RECORDS are waiting, new records are
+ * dropped and counted rather than holding anyone up.
+ *
+ * `close()` writes out whatever's still waiting and closes the file. Call it
+ * after everyone who records has been stopped, or the tail of the show will
+ * be missing.
+ */
+class CaptureWriter : public StoppableThread {
+  public:
+    /**
+     * @param logger our logger
+     * @param path the file to write (it's replaced if it's already there)
+     * @param universe the universe we're listening to, for the header
+     * @param includeSerial should serial lines be captured too?
+     */
+    CaptureWriter(const std::shared_ptr<Logger> &logger, std::string path, u16 universe, bool includeSerial);
+    ~CaptureWriter() override;
+
+    /**
+     * Create the file and write its header. Nothing is recorded until this
+     * works.
+     */
+    Result<bool> open();
+
+    void start() override;
+
+    /**
+     * Record an input frame on its way to the controller
+     *
+     * @param frame the frame. If it was stamped when it arrived, that's when
+     *              it's recorded as happening.
+     * @param slotsUsed how many slots to keep, starting from slot 0
+     */
+    void recordInputFrame(const InputFrame &frame, size_t slotsUsed);
+
+    /**
+     * Record a line to or from a module. Does nothing unless serial capture
+     * was asked for.
+     *
+     * @param kind `RecordKind::serialIn` or `RecordKind::serialOut`
+     * @param module the module it went to or came from
+     * @param line the line, without its newline
+     */
+    void recordSerial(RecordKind kind, UARTDevice::module_name module, std::string_view line);
+
+    [[nodiscard]] bool isCapturingSerial() const { return includeSerial; }
+
+    /**
+     * Write out everything that's waiting and close the file
+     */
+    void close();
+
+    [[nodiscard]] u64 getRecordsWritten() const;
+    [[nodiscard]] u64 getRecordsDropped() const;
+    [[nodiscard]] u64 getBytesWritten() const;
+
+  protected:
+    void run() override;
+
+  private:
+    void enqueue(RecordKind kind, UARTDevice::module_name module, std::int64_t atNs, std::string_view payload);
+
+    /**
+     * Write a batch of records. Caller holds `fileMutex`.
+     */
+    void writeRecords(const std::vector<CaptureRecord> &records);
+
+    std::shared_ptr<Logger> logger;
+    std::string path;
+    u16 universe;
+    bool includeSerial;
+
+    // Steady clock time the capture started, which record offsets count from
+    std::int64_t startedNs = 0;
+
+    MessageQueue<CaptureRecord> pending{CAPTURE_MAX_PENDING_RECORDS, QueueOverflowPolicy::dropNewest};
+
+    std::mutex fileMutex;
+    std::FILE *file = nullptr;
+
+    std::atomic<bool> opened{false};
+    std::atomic<u64> recordsWritten{0};
+    std::atomic<u64> recordsDropped{0};
+    std::atomic<u64> bytesWritten{0};
+};
+
+} // namespace creatures::replay
@@ -0,0 +1,214 @@
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "controller/InputFrame.h"
+#include "controller/MotionLatency.h"
+#include "controller/ServoModuleHandler.h"
+#include "replay/Replayer.h"
+#include "util/Histogram.h"
+#include "util/thread_name.h"
+
+namespace creatures::replay {
+
+Replayer::Replayer(const std::shared_ptr<Logger> &_logger, const std::shared_ptr<CaptureReader> &_reader,
+                   const std::shared_ptr<Controller> &_controller, bool _asFastAsPossible)
+    : logger(_logger), reader(_reader), controller(_controller), asFastAsPossible(_asFastAsPossible) {}
+
+void Replayer::start() {
+    logger->info("starting the replay ({})", asFastAsPossible ? "as fast as possible" : "in real time");
+    StoppableThread::start();
+}
+
+void Replayer::watchModule(const std::shared_ptr<ServoModuleHandler> &handler) {
+    watchedModules.push_back({handler->getSerialStats(), handler->getPendingPosition(), handler->getOutgoingQueue()});
+}
+
+void Replayer::run() {
+    threadName = "Replayer::run";
+    setThreadName(threadName);
+
+    auto result = replay();
+    if (result.isSuccess()) {
+        auto report = result.getValue().value();
+        logReport(report);
+
+        std::lock_guard<std::mutex> lock(reportMutex);
+        lastReport = report;
+    } else {
+        logger->error("replay stopped: {}", result.getError()->getMessage());
+    }
+
+    finished.store(true);
+}
+
+Result<ReplayReport> Replayer::replay() {
+    ReplayReport report;
+    Histogram lateness;
+    Histogram gaps;
+
+    const auto mailbox = controller->getInputMailbox();
+    const u64 overwrittenBefore = mailbox->overwritten();
+    const u64 ticksSkippedBefore = controller->getTicksSkipped();
+    const ReplayReport writersBefore = writerTotals();
+
+    for (auto &histogram : latency) {
+        histogram.reset();
+    }
+    MotionLatency::attach(&latency);
+
+    InputFrame frame;
+    CaptureRecord record;
+
+    bool first = true;
+    std::int64_t firstOffsetNs = 0;
+    std::int64_t lastOffsetNs = 0;
+    const std::int64_t startedNs = MotionLatency::now();
+
+    while (!stop_requested.load()) {
+        auto nextResult = reader->next(record);
+        if (!nextResult.isSuccess()) {
+            MotionLatency::attach(nullptr);
+            return Result<ReplayReport>{nextResult.getError().value()};
+        }
+        if (!nextResult.getValue().value()) {
+            break; // That's the whole show
+        }
+
+        if (record.kind == RecordKind::serialIn) {
+            report.serialLinesIn++;
+            continue;
+        }
+        if (record.kind == RecordKind::serialOut) {
+            report.serialLinesOut++;
+            continue;
+        }
+
+        if (first) {
+            firstOffsetNs = record.offsetNs;
+            lastOffsetNs = record.offsetNs;
+            first = false;
+        }
+        gaps.record(static_cast<u64>(std::max<std::int64_t>(record.offsetNs - lastOffsetNs, 0)) / 1000);
+        lastOffsetNs = std::max(lastOffsetNs, record.offsetNs);
+
+        // Wait until it's time for this one, a little at a time so we can still
+        // be stopped partway through a long pause in the show
+        if (!asFastAsPossible) {
+            const std::int64_t dueNs = startedNs + (record.offsetNs - firstOffsetNs);
+            std::int64_t nowNs = MotionLatency::now();
+            while (nowNs < dueNs && !stop_requested.load()) {
+                const std::int64_t napNs = std::min<std::int64_t>(dueNs - nowNs, 100'000'000);
+                std::this_thread::sleep_for(std::chrono::nanoseconds(napNs));
+                nowNs = MotionLatency::now();
+            }
+            lateness.record(static_cast<u64>(std::max<std::int64_t>(nowNs - dueNs, 0)) / 1000);
+        }
+
+        // Slots we didn't capture stay zero, same as they would have been
+        frame.slots.fill(0);
+        std::memcpy(frame.slots.data(), record.payload.data(), std::min(record.payload.size(), frame.slots.size()));
+
+        frame.timestamps = MotionTimestamps{};
+        frame.timestamps.receivedNs = MotionLatency::now();
+        frame.timestamps.handedOffNs = frame.timestamps.receivedNs;
+
+        if (controller->acceptInput(frame)) {
+            report.framesReplayed++;
+        } else {
+            report.framesRejected++;
+        }
+    }
+
+    report.capturedDurationUs = (lastOffsetNs - firstOffsetNs) / 1000;
+    report.replayDurationUs = (MotionLatency::now() - startedNs) / 1000;
+
+    // Give the last frames a moment to make it out to the modules
+    if (!watchedModules.empty() && !stop_requested.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(REPLAY_SETTLE_MS));
+    }
+    MotionLatency::attach(nullptr);
+
+    report.latenessP50Us = lateness.percentile(50);
+    report.latenessP99Us = lateness.percentile(99);
+    report.latenessMaxUs = lateness.max();
+    report.gapP50Us = gaps.percentile(50);
+    report.gapP99Us = gaps.percentile(99);
+    report.gapMaxUs = gaps.max();
+
+    report.framesNeverSeen = mailbox->overwritten() - overwrittenBefore;
+    report.ticksSkipped = controller->getTicksSkipped() - ticksSkippedBefore;
+
+    const ReplayReport writersAfter = writerTotals();
+    report.serialMessagesWritten = writersAfter.serialMessagesWritten - writersBefore.serialMessagesWritten;
+    report.serialBytesWritten = writersAfter.serialBytesWritten - writersBefore.serialBytesWritten;
+    report.positionsReplaced = writersAfter.positionsReplaced - writersBefore.positionsReplaced;
+    report.outgoingDropped = writersAfter.outgoingDropped - writersBefore.outgoingDropped;
+
+    const auto &serial = latency[static_cast<size_t>(MotionLatency::Stage::serial)];
+    const auto &total = latency[static_cast<size_t>(MotionLatency::Stage::total)];
+    report.motionFramesTraced = total.count();
+    report.motionSerialP50Us = serial.percentile(50);
+    report.motionSerialP99Us = serial.percentile(99);
+    report.motionSerialMaxUs = serial.max();
+    report.motionTotalP50Us = total.percentile(50);
+    report.motionTotalP99Us = total.percentile(99);
+    report.motionTotalMaxUs = total.max();
+
+    return Result<ReplayReport>{report};
+}
+
+ReplayReport Replayer::writerTotals() const {
+    ReplayReport totals;
+    for (const auto &module : watchedModules) {
+        if (module.stats) {
+            totals.serialMessagesWritten += module.stats->messagesWritten.load(std::memory_order_relaxed);
+            totals.serialBytesWritten += module.stats->bytesWritten.load(std::memory_order_relaxed);
+        }
+        if (module.pendingPosition) {
+            totals.positionsReplaced += module.pendingPosition->replaced();
+        }
+        if (module.outgoingQueue) {
+            totals.outgoingDropped += module.outgoingQueue->dropped();
+        }
+    }
+    return totals;
+}
+
+ReplayReport Replayer::getReport() const {
+    std::lock_guard<std::mutex> lock(reportMutex);
+    return lastReport;
+}
+
+void Replayer::logReport(const ReplayReport &report) const {
+    logger->info("replayed {} frames ({} rejected) and skipped over {} serial lines in, {} out",
+                 report.framesReplayed, report.framesRejected, report.serialLinesIn, report.serialLinesOut);
+    logger->info("the capture ran {:.3f}s, the replay took {:.3f}s",
+                 static_cast<double>(report.capturedDurationUs) / 1'000'000.0,
+                 static_cast<double>(report.replayDurationUs) / 1'000'000.0);
+    logger->info("gaps between frames as captured: p50 {}us, p99 {}us, max {}us", report.gapP50Us, report.gapP99Us,
+                 report.gapMaxUs);
+    if (!asFastAsPossible) {
+        logger->info("frames were handed off late by: p50 {}us, p99 {}us, max {}us", report.latenessP50Us,
+                     report.latenessP99Us, report.latenessMaxUs);
+    }
+    logger->info("{} frames were replaced before the creature saw them, {} control loop ticks were skipped",
+                 report.framesNeverSeen, report.ticksSkipped);
+    if (!watchedModules.empty()) {
+        logger->info("the modules' writers sent {} messages ({} bytes), {} positions were replaced before they went "
+                     "out, and {} messages didn't fit in an outgoing queue",
+                     report.serialMessagesWritten, report.serialBytesWritten, report.positionsReplaced,
+                     report.outgoingDropped);
+    }
+    if (report.motionFramesTraced > 0) {
+        logger->info("{} frames made it to the wire: serial p50 {}us, p99 {}us, max {}us; total p50 {}us, p99 {}us, "
+                     "max {}us",
+                     report.motionFramesTraced, report.motionSerialP50Us, report.motionSerialP99Us,
+                     report.motionSerialMaxUs, report.motionTotalP50Us, report.motionTotalP99Us,
+                     report.motionTotalMaxUs);
+    }
+}
+
+} // namespace creatures::replay
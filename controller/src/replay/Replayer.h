@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "controller-config.h"
+#include "controller/Controller.h"
+#include "controller/MotionLatency.h"
+#include "io/Message.h"
+#include "io/PositionSlot.h"
+#include "io/SerialPortStats.h"
+#include "logging/Logger.h"
+#include "replay/CaptureReader.h"
+#include "util/Result.h"
+#include "util/SpscQueue.h"
+#include "util/StoppableThread.h"
+
+namespace creatures {
+class ServoModuleHandler;
+}
+
+namespace creatures::replay {
+
+/**
+ * How a replay went
+ *
+ * Times are in microseconds. "Lateness" is how far behind schedule a frame
+ * was handed to the controller (it's only kept when replaying in real time).
+ * "Gaps" are the spaces between frames as they were captured, which is what
+ * the show server actually sent us.
+ *
+ * The writer numbers only cover modules the replayer was told to watch, and
+ * they only move if positions actually went out to them. With nothing on the
+ * other end of a module's port, that means replaying with the modules marked
+ * ready (`--replay-modules-ready`).
+ */
+struct ReplayReport {
+    u64 framesReplayed = 0;
+    u64 framesRejected = 0; // The controller wouldn't take them
+    u64 serialLinesIn = 0;
+    u64 serialLinesOut = 0;
+
+    std::int64_t capturedDurationUs = 0;
+    std::int64_t replayDurationUs = 0;
+
+    u64 latenessP50Us = 0;
+    u64 latenessP99Us = 0;
+    u64 latenessMaxUs = 0;
+
+    u64 gapP50Us = 0;
+    u64 gapP99Us = 0;
+    u64 gapMaxUs = 0;
+
+    // Frames that were replaced in the controller's mailbox before the
+    // creature ever looked at them, and control loop ticks that were skipped
+    // because we were running behind
+    u64 framesNeverSeen = 0;
+    u64 ticksSkipped = 0;
+
+    // What the modules' writers did while we were replaying
+    u64 serialMessagesWritten = 0;
+    u64 serialBytesWritten = 0;
+    u64 positionsReplaced = 0; // A newer one came along before the writer got to it
+    u64 outgoingDropped = 0;   // A module's outgoing ring was full
+
+    // How long the replayed frames took to get from us to the wire
+    u64 motionFramesTraced = 0;
+    u64 motionSerialP50Us = 0;
+    u64 motionSerialP99Us = 0;
+    u64 motionSerialMaxUs = 0;
+    u64 motionTotalP50Us = 0;
+    u64 motionTotalP99Us = 0;
+    u64 motionTotalMaxUs = 0;
+};
+
+/**
+ * Plays a capture back into the controller, as if the e1.31 client were
+ * getting those frames off the network
+ *
+ * In real time, each frame goes in as far after the first one as it came in
+ * when it was captured. As fast as possible, they go in back to back, which is
+ * handy for seeing how the rest of the pipeline holds up when it's flooded.
+ * Serial records are counted, but not sent anywhere: the modules' ports are
+ * whatever the config points them at (a pty, or /dev/null).
+ *
+ * The report's motion latency numbers come from histograms of the replayer's
+ * own, which it attaches to `MotionLatency` while it plays. They cover every
+ * frame that went out during the replay, no matter how many times the
+ * controller's summary starts its numbers over in the meantime.
+ */
+class Replayer : public StoppableThread {
+  public:
+    /**
+     * @param logger our logger
+     * @param reader an opened capture
+     * @param controller where the frames go
+     * @param asFastAsPossible ignore the captured timing?
+     */
+    Replayer(const std::shared_ptr<Logger> &logger, const std::shared_ptr<CaptureReader> &reader,
+             const std::shared_ptr<Controller> &controller, bool asFastAsPossible);
+
+    void start() override;
+
+    /**
+     * Keep track of what a module's writer does during the replay. Call this
+     * before starting.
+     *
+     * @param handler the module's handler, after it's been init'ed
+     */
+    void watchModule(const std::shared_ptr<ServoModuleHandler> &handler);
+
+    /**
+     * Play the whole capture, right here on the calling thread
+     *
+     * `run()` calls this. It stops early if the thread is asked to.
+     *
+     * @return how it went, or an error if the capture couldn't be read
+     */
+    Result<ReplayReport> replay();
+
+    /**
+     * Has the replay thread gotten to the end (or given up)?
+     */
+    [[nodiscard]] bool isFinished() const { return finished.load(); }
+
+    /**
+     * How it went, once it's finished
+     */
+    [[nodiscard]] ReplayReport getReport() const;
+
+  protected:
+    void run() override;
+
+  private:
+    void logReport(const ReplayReport &report) const;
+
+    // Where we look for a module writer's numbers
+    struct WatchedModule {
+        std::shared_ptr<io::SerialPortStats> stats;
+        std::shared_ptr<io::PositionSlot> pendingPosition;
+        std::shared_ptr<SpscQueue<io::Message>> outgoingQueue;
+    };
+
+    /**
+     * Add up the writer numbers across every module we're watching
+     */
+    ReplayReport writerTotals() const;
+
+    std::shared_ptr<Logger> logger;
+    std::shared_ptr<CaptureReader> reader;
+    std::shared_ptr<Controller> controller;
+    bool asFastAsPossible;
+    std::vector<WatchedModule> watchedModules;
+
+    // How long this replay's frames took to get to the wire
+    MotionLatency::StageHistograms latency{};
+
+    std::atomic<bool> finished{false};
+
+    mutable std::mutex reportMutex;
+    ReplayReport lastReport;
+};
+
+} // namespace creatures::replay
@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include <fmt/format.h>
+
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
@@ -13,11 +15,15 @@ namespace creatures ::server {
 
 class BoardSensorReportMessage : public ServerMessage {
   public:
-    BoardSensorReportMessage(std::shared_ptr<Logger> logger,
-                             const json &message) {
+    /**
+     * @param source where the report came from (the module), so a newer
+     *               report from the same place can replace this one
+     */
+    BoardSensorReportMessage(std::shared_ptr<Logger> logger, const json &message, const std::string &source) {
         this->logger = logger;
         this->commandType = "board-sensor-report";
         this->message = message;
+        this->coalesceKey = fmt::format("{}@{}", this->commandType, source);
     }
 };
 
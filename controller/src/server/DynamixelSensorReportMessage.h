@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include <fmt/format.h>
+
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
@@ -13,10 +15,15 @@ namespace creatures::server {
 
 class DynamixelSensorReportMessage : public ServerMessage {
   public:
-    DynamixelSensorReportMessage(std::shared_ptr<Logger> logger, const json &message) {
+    /**
+     * @param source where the report came from (the module), so a newer
+     *               report from the same place can replace this one
+     */
+    DynamixelSensorReportMessage(std::shared_ptr<Logger> logger, const json &message, const std::string &source) {
         this->logger = logger;
         this->commandType = "dynamixel-sensor-report";
         this->message = message;
+        this->coalesceKey = fmt::format("{}@{}", this->commandType, source);
     }
 };
 
@@ -0,0 +1,142 @@
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "server/MessageBatcher.h"
+#include "server/ServerMessage.h"
+
+#include "controller-config.h"
+
+namespace creatures::server {
+
+MessageBatcher::MessageBatcher(size_t _maxFrameBytes) : maxFrameBytes(_maxFrameBytes) {}
+
+bool MessageBatcher::add(ServerMessage message) {
+
+    // There's only ever a handful waiting, so a walk through them is plenty
+    const std::string &key = message.getCoalesceKey();
+    if (!key.empty()) {
+        for (auto &waiting : pending) {
+            if (waiting.getCoalesceKey() == key) {
+                waiting = std::move(message);
+                return true;
+            }
+        }
+    }
+
+    pending.push_back(std::move(message));
+    return false;
+}
+
+size_t MessageBatcher::takeFrames(const std::string &creatureId, bool batched, MessageEncoding encoding,
+                                  std::vector<std::string> &frames) {
+    frames.clear();
+    serialized.clear();
+
+    if (encoding != MessageEncoding::json) {
+        return takeBinaryFrames(creatureId, batched, encoding, frames);
+    }
+
+    size_t failed = 0;
+    for (auto &message : pending) {
+        auto result = message.toWebSocketMessage(creatureId);
+        if (!result.isSuccess()) {
+            failed++;
+            continue;
+        }
+        serialized.push_back(std::move(result.getValue().value()));
+    }
+    pending.clear();
+
+    if (!batched) {
+        frames.swap(serialized);
+        return failed;
+    }
+
+    // Everything in here has already been turned into JSON, so the batch is
+    // put together as a string rather than parsing it all over again
+    const std::string prefix =
+        fmt::format(R"({{"command":"batch","payload":{{"creature_id":{},"messages":[)", json(creatureId).dump());
+    const std::string suffix = "]}}";
+
+    size_t i = 0;
+    while (i < serialized.size()) {
+
+        // See how many fit in this frame. There's always at least one.
+        size_t frameBytes = prefix.size() + serialized[i].size() + suffix.size();
+        size_t end = i + 1;
+        while (end < serialized.size() && frameBytes + 1 + serialized[end].size() <= maxFrameBytes) {
+            frameBytes += 1 + serialized[end].size();
+            end++;
+        }
+
+        // No sense wrapping up just one
+        if (end - i == 1) {
+            frames.push_back(std::move(serialized[i]));
+            i = end;
+            continue;
+        }
+
+        std::string frame;
+        frame.reserve(frameBytes);
+        frame += prefix;
+        for (size_t j = i; j < end; j++) {
+            if (j != i) {
+                frame += ',';
+            }
+            frame += serialized[j];
+        }
+        frame += suffix;
+        frames.push_back(std::move(frame));
+        i = end;
+    }
+
+    return failed;
+}
+
+size_t MessageBatcher::takeBinaryFrames(const std::string &creatureId, bool batched, MessageEncoding encoding,
+                                        std::vector<std::string> &frames) {
+
+    // CBOR and MessagePack can't be glued together as strings like the JSON
+    // is, so a batch gets built as one document and encoded once. There's
+    // never more than WEBSOCKET_BATCH_MAX_MESSAGES in here, so it doesn't need
+    // splitting up by size.
+    if (batched && pending.size() > 1) {
+        json batch;
+        batch["command"] = "batch";
+        batch["payload"]["creature_id"] = creatureId;
+        json &messages = batch["payload"]["messages"] = json::array();
+        for (const auto &message : pending) {
+            messages.push_back(message.toJson(creatureId));
+        }
+        pending.clear();
+
+        auto result = encodeMessage(batch, encoding);
+        if (!result.isSuccess()) {
+            return messages.size();
+        }
+        frames.push_back(std::move(result.getValue().value()));
+        return 0;
+    }
+
+    size_t failed = 0;
+    for (const auto &message : pending) {
+        auto result = message.toWebSocketMessage(creatureId, encoding);
+        if (!result.isSuccess()) {
+            failed++;
+            continue;
+        }
+        frames.push_back(std::move(result.getValue().value()));
+    }
+    pending.clear();
+
+    return failed;
+}
+
+} // namespace creatures::server
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "server/MessageEncoding.h"
+#include "server/ServerMessage.h"
+
+#include "controller-config.h"
+
+namespace creatures::server {
+
+/**
+ * Gathers up messages headed for the server and turns them into as few
+ * websocket frames as it can
+ *
+ * Two things make that work:
+ *
+ *   - Coalescing. A sensor report is only interesting until the next one from
+ *     the same place shows up, so if a newer one arrives while an older one is
+ *     still waiting, the newer one takes its spot. Messages without a coalesce
+ *     key (e-stops, watchdog warnings) are never replaced.
+ *
+ *   - Batching. When it's turned on, everything that's waiting goes out in
+ *     one frame, wrapped up like this:
+ *
+ *         {"command":"batch","payload":{"creature_id":"...","messages":[...]}}
+ *
+ *     The server has to know how to unwrap that, so it's optional. A frame
+ *     that would only hold one message is sent on its own, same as always.
+ *
+ * If the server asked for CBOR or MessagePack, frames come out in that
+ * encoding instead, and they need to go out as binary frames.
+ *
+ * This isn't thread safe. It belongs to the websocket writer's thread.
+ */
+class MessageBatcher {
+  public:
+    /**
+     * @param maxFrameBytes the biggest batch frame to build. A single message
+     *                      that's bigger than this still goes, just on its own.
+     */
+    explicit MessageBatcher(size_t maxFrameBytes = WEBSOCKET_BATCH_MAX_BYTES);
+
+    /**
+     * Add a message to the pile
+     *
+     * @param message the message
+     * @return true if it replaced an older one that hadn't been sent yet
+     */
+    bool add(ServerMessage message);
+
+    /**
+     * Turn everything that's waiting into frames, and start over empty
+     *
+     * @param creatureId the creature these messages are from
+     * @param batched should messages be batched into one frame, or sent one
+     *                per frame the old way?
+     * @param encoding how to encode the frames
+     * @param frames where to put the frames (it's cleared first)
+     * @return how many messages couldn't be encoded and were dropped
+     */
+    size_t takeFrames(const std::string &creatureId, bool batched, MessageEncoding encoding,
+                      std::vector<std::string> &frames);
+
+    [[nodiscard]] size_t size() const { return pending.size(); }
+    [[nodiscard]] bool empty() const { return pending.empty(); }
+
+  private:
+    size_t takeBinaryFrames(const std::string &creatureId, bool batched, MessageEncoding encoding,
+                            std::vector<std::string> &frames);
+
+    size_t maxFrameBytes;
+    std::vector<ServerMessage> pending;
+
+    // Reused between calls so we're not allocating these every time
+    std::vector<std::string> serialized;
+};
+
+} // namespace creatures::server
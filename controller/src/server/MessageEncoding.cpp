@@ -0,0 +1,81 @@
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "server/MessageEncoding.h"
+#include "util/Result.h"
+
+namespace creatures::server {
+
+const char *messageEncodingToString(MessageEncoding encoding) {
+    switch (encoding) {
+    case MessageEncoding::cbor:
+        return "cbor";
+    case MessageEncoding::msgpack:
+        return "msgpack";
+    case MessageEncoding::json:
+    default:
+        return "json";
+    }
+}
+
+std::optional<MessageEncoding> messageEncodingFromString(std::string_view name) {
+    if (name == "json") {
+        return MessageEncoding::json;
+    }
+    if (name == "cbor") {
+        return MessageEncoding::cbor;
+    }
+    if (name == "msgpack") {
+        return MessageEncoding::msgpack;
+    }
+    return std::nullopt;
+}
+
+MessageEncoding negotiateMessageEncoding(MessageEncoding preferred, const json &registrationResponse) {
+    if (preferred == MessageEncoding::json || !registrationResponse.is_object()) {
+        return MessageEncoding::json;
+    }
+
+    auto offered = registrationResponse.find("message_encodings");
+    if (offered == registrationResponse.end() || !offered->is_array()) {
+        return MessageEncoding::json;
+    }
+
+    for (const auto &name : *offered) {
+        if (name.is_string() && name.get<std::string>() == messageEncodingToString(preferred)) {
+            return preferred;
+        }
+    }
+    return MessageEncoding::json;
+}
+
+Result<std::string> encodeMessage(const json &document, MessageEncoding encoding) {
+    try {
+        std::string encoded;
+        switch (encoding) {
+        case MessageEncoding::cbor:
+            json::to_cbor(document, encoded);
+            break;
+        case MessageEncoding::msgpack:
+            json::to_msgpack(document, encoded);
+            break;
+        case MessageEncoding::json:
+        default:
+            encoded = document.dump();
+            break;
+        }
+        return Result<std::string>{encoded};
+    } catch (std::exception &e) {
+        auto errorMessage = fmt::format("Error encoding {} message: {}", messageEncodingToString(encoding), e.what());
+        return Result<std::string>{ControllerError(ControllerError::UnprocessableMessage, errorMessage)};
+    }
+}
+
+} // namespace creatures::server
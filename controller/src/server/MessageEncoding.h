@@ -0,0 +1,60 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "util/Result.h"
+
+namespace creatures::server {
+
+/**
+ * How messages to the server are put on the wire
+ *
+ * JSON text is what every server understands. The binary ones carry the same
+ * document, just packed up with nlohmann's CBOR or MessagePack writers and
+ * sent as binary frames, which is a lot less work for both ends when a report
+ * is mostly numbers.
+ */
+enum class MessageEncoding { json, cbor, msgpack };
+
+/**
+ * The name we use for an encoding, in config files and when talking to the
+ * server ("json", "cbor", or "msgpack")
+ */
+const char *messageEncodingToString(MessageEncoding encoding);
+
+/**
+ * Look up an encoding by name
+ *
+ * @return the encoding, or nothing if we don't know that one
+ */
+std::optional<MessageEncoding> messageEncodingFromString(std::string_view name);
+
+/**
+ * Work out which encoding to use with this server
+ *
+ * A server that can take binary frames lists what it takes in its reply to
+ * our registration, as `"message_encodings": ["json", "cbor", ...]`. We only
+ * use the one we'd like if it's on that list. Anything else (an older server,
+ * a failed registration, a reply we couldn't parse) means JSON text.
+ *
+ * @param preferred the encoding we'd like to use
+ * @param registrationResponse the server's reply to our registration
+ * @return the encoding to use
+ */
+MessageEncoding negotiateMessageEncoding(MessageEncoding preferred, const json &registrationResponse);
+
+/**
+ * Put a document on the wire in the given encoding
+ *
+ * @param document the document
+ * @param encoding how to encode it
+ * @return the bytes to send, or an error if it couldn't be encoded
+ */
+Result<std::string> encodeMessage(const json &document, MessageEncoding encoding);
+
+} // namespace creatures::server
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "logging/Logger.h"
+#include "server/ServerMessage.h"
+
+namespace creatures::server {
+
+/**
+ * How long motion has been taking to get from the network to the servos. See
+ * `MotionLatency` for what's in it.
+ */
+class MotionLatencyReportMessage : public ServerMessage {
+  public:
+    MotionLatencyReportMessage(std::shared_ptr<Logger> logger, const json &message) {
+        this->logger = logger;
+        this->commandType = "motion-latency-report";
+        this->message = message;
+        this->coalesceKey = this->commandType;
+    }
+};
+
+} // namespace creatures::server
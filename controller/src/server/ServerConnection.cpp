@@ -20,8 +20,8 @@ void ServerConnection::start() {
     // We always need to make the writer, even if we're not enabled so that
     // messages that get sent don't just sit in the queue forever and leak
     // memory.
-    websocketWriter =
-        std::make_unique<WebsocketWriter>(logger, webSocket, outgoingMessagesQueue, creature->getId(), enabled);
+    websocketWriter = std::make_unique<WebsocketWriter>(logger, webSocket, outgoingMessagesQueue, creature->getId(),
+                                                        enabled, batchMessages);
     websocketWriter->start();
 
     if (!enabled) {
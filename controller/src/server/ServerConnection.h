@@ -31,15 +31,16 @@ class ServerConnection : public StoppableThread {
 
   public:
     ServerConnection(std::shared_ptr<Logger> _logger, std::shared_ptr<creatures::creature::Creature> _creature,
-                     bool _enabled, std::string _address, u16 _port,
+                     bool _enabled, std::string _address, u16 _port, bool _batchMessages,
                      std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> _outgoingMessagesQueue)
         : logger(std::move(_logger)), enabled(_enabled), address(std::move(_address)), port(_port),
-          outgoingMessagesQueue(std::move(_outgoingMessagesQueue)), creature(std::move(_creature)) {
+          batchMessages(_batchMessages), outgoingMessagesQueue(std::move(_outgoingMessagesQueue)),
+          creature(std::move(_creature)) {
 
         webSocket = std::make_shared<ix::WebSocket>();
 
-        websocketWriter =
-            std::make_unique<WebsocketWriter>(logger, webSocket, outgoingMessagesQueue, creature->getId(), enabled);
+        websocketWriter = std::make_unique<WebsocketWriter>(logger, webSocket, outgoingMessagesQueue, creature->getId(),
+                                                            enabled, batchMessages);
     }
     ~ServerConnection();
 
@@ -63,6 +64,18 @@ class ServerConnection : public StoppableThread {
         connectionEstablishedCallback = std::move(callback);
     }
 
+    /**
+     * How the websocket writer is getting on (queue depth, bytes sent, etc)
+     */
+    [[nodiscard]] WebsocketWriterStats getWriterStats() const { return websocketWriter->getStats(); }
+
+    /**
+     * Change how messages are encoded on their way to the server. Call this
+     * once the server has said what it understands, which is part of
+     * registration. Until then it's JSON.
+     */
+    void setMessageEncoding(MessageEncoding encoding) { websocketWriter->setEncoding(encoding); }
+
   protected:
     void run() override;
 
@@ -73,6 +86,9 @@ class ServerConnection : public StoppableThread {
     std::string address;
     u16 port;
 
+    // Can the server take batch frames?
+    bool batchMessages = false;
+
     std::string serverUrl;
 
     std::shared_ptr<creatures::MessageQueue<creatures::server::ServerMessage>> outgoingMessagesQueue;
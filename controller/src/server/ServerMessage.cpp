@@ -1,19 +1,31 @@
-
 #include <fmt/format.h>
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
 #include "logging/Logger.h"
+#include "server/MessageEncoding.h"
 #include "server/ServerMessage.h"
 #include "util/Result.h"
 
 namespace creatures ::server {
 
 Result<std::string> ServerMessage::toWebSocketMessage(std::string creatureId) {
+    return toWebSocketMessage(creatureId, MessageEncoding::json);
+}
 
-    logger->debug("creating JSON message to send down the websocket");
+Result<std::string> ServerMessage::toWebSocketMessage(const std::string &creatureId, MessageEncoding encoding) const {
 
+    logger->debug("creating {} message to send down the websocket", messageEncodingToString(encoding));
+
+    auto result = encodeMessage(toJson(creatureId), encoding);
+    if (!result.isSuccess()) {
+        logger->error(result.getError()->getMessage());
+    }
+    return result;
+}
+
+json ServerMessage::toJson(const std::string &creatureId) const {
     json j;
     j["command"] = commandType;
     j["payload"] = message;
@@ -21,15 +33,7 @@ Result<std::string> ServerMessage::toWebSocketMessage(std::string creatureId) {
     // Ensure that the creature Id is set, always.
     j["payload"]["creature_id"] = creatureId;
 
-    try {
-        return Result<std::string>{j.dump()};
-    } catch (std::exception &e) {
-        auto errorMessage =
-            fmt::format("Error creating JSON message: {}", e.what());
-        logger->error(errorMessage);
-        return Result<std::string>{ControllerError(
-            ControllerError::UnprocessableMessage, errorMessage)};
-    }
+    return j;
 }
 
 } // namespace creatures::server
@@ -1,10 +1,10 @@
-
 #pragma once
 
 #include <nlohmann/json.hpp>
 using json = nlohmann::json;
 
 #include "logging/Logger.h"
+#include "server/MessageEncoding.h"
 #include "util/Result.h"
 
 namespace creatures ::server {
@@ -16,10 +16,29 @@ class ServerMessage {
     // Turn this message into a string that can be sent over the web socket
     Result<std::string> toWebSocketMessage(std::string creatureId);
 
+    /**
+     * Turn this message into bytes for the web socket in the given encoding.
+     * Anything but JSON has to go out as a binary frame.
+     */
+    Result<std::string> toWebSocketMessage(const std::string &creatureId, MessageEncoding encoding) const;
+
+    /**
+     * The whole message as a document, ready to be encoded
+     */
+    [[nodiscard]] json toJson(const std::string &creatureId) const;
+
+    /**
+     * A newer message with the same key makes this one pointless, so if both
+     * are waiting to be sent, only the newer one goes. Empty means every one
+     * of these matters (an e-stop, say) and none of them get replaced.
+     */
+    [[nodiscard]] const std::string &getCoalesceKey() const { return coalesceKey; }
+
   protected:
     std::string commandType;
+    std::string coalesceKey;
     json message;
     std::shared_ptr<Logger> logger;
 };
 
-} // namespace creatures::server
\ No newline at end of file
+} // namespace creatures::server
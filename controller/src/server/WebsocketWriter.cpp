@@ -1,8 +1,11 @@
-
+#include <chrono>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "logging/Logger.h"
+#include "server/MessageBatcher.h"
 #include "server/ServerMessage.h"
 #include "server/WebsocketWriter.h"
 #include "util/MessageQueue.h"
@@ -15,14 +18,15 @@ namespace creatures::server {
 
 WebsocketWriter::WebsocketWriter(const std::shared_ptr<Logger> &logger, std::shared_ptr<ix::WebSocket> webSocket,
                                  const std::shared_ptr<MessageQueue<ServerMessage>> &outgoingQueue,
-                                 std::string creatureId, bool enabled) {
+                                 std::string creatureId, bool enabled, bool batchMessages) {
     this->logger = logger;
     this->webSocket = webSocket;
     this->outgoingQueue = outgoingQueue;
     this->creatureId = creatureId;
     this->enabled = enabled;
+    this->batchMessages = batchMessages;
 
-    this->logger->info("WebsocketWriter created");
+    this->logger->info("WebsocketWriter created (batching {})", batchMessages ? "on" : "off");
 }
 
 void WebsocketWriter::start() {
@@ -30,6 +34,21 @@ void WebsocketWriter::start() {
     creatures::StoppableThread::start();
 }
 
+WebsocketWriterStats WebsocketWriter::getStats() const {
+    WebsocketWriterStats stats;
+    stats.queueDepth = outgoingQueue->size();
+    stats.queueHighWater = outgoingQueue->high_water_mark();
+    stats.queueOverflowed = outgoingQueue->dropped();
+    stats.messagesSent = messagesSent.load(std::memory_order_relaxed);
+    stats.framesSent = framesSent.load(std::memory_order_relaxed);
+    stats.bytesSent = bytesSent.load(std::memory_order_relaxed);
+    stats.bytesPerSecond = bytesPerSecond.load(std::memory_order_relaxed);
+    stats.messagesCoalesced = messagesCoalesced.load(std::memory_order_relaxed) + outgoingQueue->replaced();
+    stats.messagesDropped = messagesDropped.load(std::memory_order_relaxed);
+    stats.sendFailures = sendFailures.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void WebsocketWriter::run() {
 
     this->threadName = fmt::format("WebsocketWriter::run");
@@ -37,7 +56,16 @@ void WebsocketWriter::run() {
 
     this->logger->info("hello from the WebsocketWriter thread!");
 
+    MessageBatcher batcher;
+    std::vector<ServerMessage> incoming;
+    std::vector<std::string> frames;
+    incoming.reserve(WEBSOCKET_BATCH_MAX_MESSAGES);
+
+    lastStatsReport = std::chrono::steady_clock::now();
+
     while (!stop_requested.load()) {
+        reportStatsIfDue();
+
         auto outgoingMessage = outgoingQueue->pop_timeout(std::chrono::milliseconds(100));
 
         if (!outgoingMessage.has_value()) {
@@ -47,23 +75,97 @@ void WebsocketWriter::run() {
         // If we're not enabled, just continue and don't send the message. We
         // need to chew things off the queue so that we don't leak memory 😅
         if (!this->enabled) {
-            logger->debug("skipping message because we're not enabled");
+            messagesDropped.fetch_add(1, std::memory_order_relaxed);
             continue;
         }
 
-        auto messageResult = outgoingMessage.value().toWebSocketMessage(creatureId);
-        if (!messageResult.isSuccess()) {
-            this->logger->error("failed to convert message to websocket message");
-            continue;
+        if (batcher.add(std::move(outgoingMessage.value()))) {
+            messagesCoalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Give everyone else a moment to chime in before we send
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WEBSOCKET_BATCH_WINDOW_MS);
+        while (batcher.size() < WEBSOCKET_BATCH_MAX_MESSAGES) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+
+            incoming.clear();
+            if (outgoingQueue->drain_into(incoming,
+                                          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now),
+                                          WEBSOCKET_BATCH_MAX_MESSAGES - batcher.size()) == 0) {
+                break;
+            }
+
+            for (auto &message : incoming) {
+                if (batcher.add(std::move(message))) {
+                    messagesCoalesced.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const size_t messageCount = batcher.size();
+        const MessageEncoding frameEncoding = encoding.load(std::memory_order_relaxed);
+        const size_t failed = batcher.takeFrames(creatureId, batchMessages, frameEncoding, frames);
+        if (failed > 0) {
+            this->logger->error("failed to convert {} message(s) to websocket messages", failed);
+            messagesDropped.fetch_add(failed, std::memory_order_relaxed);
+        }
+
+        size_t bytes = 0;
+        for (const auto &frame : frames) {
+            ix::WebSocketSendInfo sendInfo;
+            if (frameEncoding == MessageEncoding::json) {
+                if (logger->isTraceEnabled()) {
+                    this->logger->trace("frame to write to websocket: {}", frame);
+                }
+                sendInfo = webSocket->sendUtf8Text(frame);
+            } else {
+                sendInfo = webSocket->sendBinary(frame);
+            }
+            if (!sendInfo.success) {
+                sendFailures.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            bytes += frame.size();
+            framesSent.fetch_add(1, std::memory_order_relaxed);
         }
-        auto message = messageResult.getValue().value();
+        messagesSent.fetch_add(messageCount - failed, std::memory_order_relaxed);
+        bytesSent.fetch_add(bytes, std::memory_order_relaxed);
 
-        this->logger->debug("message to write to websocket: {}", message);
-        webSocket->sendUtf8Text(message);
-        logger->debug("sent message to websocket");
+        logger->debug("sent {} message(s) to the websocket in {} frame(s), {} bytes", messageCount - failed,
+                      frames.size(), bytes);
     }
 
     logger->info("WebsocketWriter thread stopping");
 }
 
-} // namespace creatures::server
\ No newline at end of file
+void WebsocketWriter::setEncoding(MessageEncoding newEncoding) {
+    if (encoding.exchange(newEncoding, std::memory_order_relaxed) != newEncoding) {
+        logger->info("websocket messages will be sent as {}", messageEncodingToString(newEncoding));
+    }
+}
+
+void WebsocketWriter::reportStatsIfDue() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = now - lastStatsReport;
+    if (elapsed < std::chrono::milliseconds(WEBSOCKET_STATS_INTERVAL_MS)) {
+        return;
+    }
+
+    const u64 bytes = bytesSent.load(std::memory_order_relaxed);
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    bytesPerSecond.store(static_cast<u64>(static_cast<double>(bytes - bytesAtLastStatsReport) / seconds),
+                         std::memory_order_relaxed);
+    lastStatsReport = now;
+    bytesAtLastStatsReport = bytes;
+
+    auto stats = getStats();
+    logger->debug("websocket: {} waiting (at most {}), {} sent in {} frames, {} bytes/s, {} coalesced, {} dropped, "
+                  "{} overflowed, {} send failures",
+                  stats.queueDepth, stats.queueHighWater, stats.messagesSent, stats.framesSent, stats.bytesPerSecond,
+                  stats.messagesCoalesced, stats.messagesDropped, stats.queueOverflowed, stats.sendFailures);
+}
+
+} // namespace creatures::server
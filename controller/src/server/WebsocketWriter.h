@@ -1,12 +1,14 @@
-
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <thread>
 
 #include <ixwebsocket/IXWebSocket.h>
 
 #include "logging/Logger.h"
+#include "server/MessageEncoding.h"
 #include "server/ServerMessage.h"
 #include "util/MessageQueue.h"
 #include "util/StoppableThread.h"
@@ -15,12 +17,33 @@
 
 namespace creatures::server {
 
+/**
+ * How the websocket writer has been getting on
+ */
+struct WebsocketWriterStats {
+    u64 queueDepth = 0;        // Messages waiting right now
+    u64 queueHighWater = 0;    // The most that have ever been waiting at once
+    u64 queueOverflowed = 0;   // Thrown out because the queue was full
+    u64 messagesSent = 0;      // Messages that made it into a frame we sent
+    u64 framesSent = 0;        // Websocket frames sent
+    u64 bytesSent = 0;         // Bytes in those frames
+    u64 bytesPerSecond = 0;    // Over the last stats interval
+    u64 messagesCoalesced = 0; // Replaced by a newer one before they were sent
+    u64 messagesDropped = 0;   // Never sent (we're disabled, or they wouldn't serialize)
+    u64 sendFailures = 0;      // Frames the websocket wouldn't take
+};
+
 /**
  * @brief A thread that writes messages to the websocket
  *
  * Inspired by the SerialWriter class in the io module, this class
  * writes messages out to the WebSocket. It's a lot easier since
  * we don't have hardware we're juggling.
+ *
+ * Rather than one frame per message, it waits a moment after the first
+ * message shows up to see what else comes along, and sends the lot together.
+ * Sensor reports that got superseded in the meantime are skipped. See
+ * `MessageBatcher` for the details.
  */
 class WebsocketWriter : public StoppableThread {
 
@@ -29,7 +52,7 @@ class WebsocketWriter : public StoppableThread {
         const std::shared_ptr<Logger> &logger,
         std::shared_ptr<ix::WebSocket> webSocket,
         const std::shared_ptr<MessageQueue<ServerMessage>> &outgoingQueue,
-        std::string creatureId, bool enabled);
+        std::string creatureId, bool enabled, bool batchMessages);
 
     ~WebsocketWriter() override {
         this->logger->info("WebsocketWriter destroyed");
@@ -37,15 +60,52 @@ class WebsocketWriter : public StoppableThread {
 
     void start() override;
 
+    /**
+     * Get a snapshot of how we're doing. Safe to call from any thread.
+     */
+    [[nodiscard]] WebsocketWriterStats getStats() const;
+
+    /**
+     * Switch how frames are encoded. This is usually whatever the server
+     * agreed to when we registered. Safe to call from any thread, and it
+     * takes effect on the next frame.
+     */
+    void setEncoding(MessageEncoding newEncoding);
+
+    [[nodiscard]] MessageEncoding getEncoding() const { return encoding.load(std::memory_order_relaxed); }
+
   protected:
     void run() override;
 
   private:
+    /**
+     * Log a summary of the stats and work out the byte rate, if it's been long
+     * enough since the last one
+     */
+    void reportStatsIfDue();
+
     bool enabled;
+    bool batchMessages;
     std::string creatureId;
     std::shared_ptr<ix::WebSocket> webSocket;
     std::shared_ptr<Logger> logger;
     std::shared_ptr<MessageQueue<ServerMessage>> outgoingQueue;
+
+    // Plain JSON until the server tells us it can handle something else
+    std::atomic<MessageEncoding> encoding{MessageEncoding::json};
+
+    std::atomic<u64> messagesSent{0};
+    std::atomic<u64> framesSent{0};
+    std::atomic<u64> bytesSent{0};
+    std::atomic<u64> bytesPerSecond{0};
+    std::atomic<u64> messagesCoalesced{0};
+    std::atomic<u64> messagesDropped{0};
+    std::atomic<u64> sendFailures{0};
+
+    // Where the byte rate was last worked out from. Only the writer thread
+    // touches these.
+    std::chrono::steady_clock::time_point lastStatsReport;
+    u64 bytesAtLastStatsReport = 0;
 };
 
-} // namespace creatures::server
\ No newline at end of file
+} // namespace creatures::server
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace creatures {
+
+/**
+ * A cheap histogram for things like "how late did we wake up"
+ *
+ * Values land in power-of-two buckets: 0 gets its own, then 1, 2-3, 4-7,
+ * 8-15, and so on. That's coarse, but it's the shape we care about (is it a
+ * few microseconds, or a few milliseconds?) and recording is a handful of
+ * relaxed atomics with no locks and no allocation, so it's fine to do on
+ * every tick of the control loop.
+ *
+ * Any thread can record or read. The numbers might be a value or two out of
+ * step with each other while it's busy, which is fine for a summary.
+ */
+class Histogram {
+  public:
+    static constexpr size_t NumberOfBuckets = 64;
+
+    Histogram() = default;
+
+    Histogram(const Histogram &) = delete;
+    Histogram &operator=(const Histogram &) = delete;
+
+    /**
+     * Add a value
+     */
+    void record(std::uint64_t value) {
+        buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t seen = largest.load(std::memory_order_relaxed);
+        while (value > seen && !largest.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Forget everything and start over
+     */
+    void reset() {
+        for (auto &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        samples.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        largest.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::uint64_t count() const { return samples.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t sum() const { return total.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t max() const { return largest.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] double mean() const {
+        const std::uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(n);
+    }
+
+    /**
+     * Roughly where a percentile falls
+     *
+     * @param percentile 0 to 100
+     * @return the top of the bucket it's in (never more than the biggest value
+     *         we've actually seen), or 0 if nothing's been recorded
+     */
+    [[nodiscard]] std::uint64_t percentile(double percentile) const {
+        const std::uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+
+        // The rank we're after, rounded up so p100 is the last sample
+        auto rank = static_cast<std::uint64_t>(static_cast<double>(n) * percentile / 100.0);
+        if (static_cast<double>(rank) < static_cast<double>(n) * percentile / 100.0) {
+            rank++;
+        }
+        rank = rank == 0 ? 1 : rank;
+
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < NumberOfBuckets; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                const std::uint64_t top = bucketUpperBound(i);
+                return top < max() ? top : max();
+            }
+        }
+        return max();
+    }
+
+    /**
+     * How many values are in a bucket
+     */
+    [[nodiscard]] std::uint64_t bucketCount(size_t bucket) const {
+        return bucket < NumberOfBuckets ? buckets[bucket].load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * The biggest value that lands in a bucket
+     */
+    static constexpr std::uint64_t bucketUpperBound(size_t bucket) {
+        return bucket == 0 ? 0 : bucket >= NumberOfBuckets - 1 ? UINT64_MAX : (std::uint64_t{1} << bucket) - 1;
+    }
+
+    /**
+     * Which bucket a value lands in
+     */
+    static constexpr size_t bucketFor(std::uint64_t value) {
+        const auto bucket = static_cast<size_t>(std::bit_width(value));
+        return bucket < NumberOfBuckets ? bucket : NumberOfBuckets - 1;
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, NumberOfBuckets> buckets{};
+    std::atomic<std::uint64_t> samples{0};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> largest{0};
+};
+
+} // namespace creatures
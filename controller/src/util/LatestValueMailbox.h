@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/ThreadParker.h"
+
+namespace creatures {
+
+/**
+ * A single-producer / single-consumer mailbox that only ever holds the newest
+ * value
+ *
+ * Unlike a queue, nothing ever backs up in here. If the producer posts twice
+ * before the consumer looks, the older value is simply gone (and counted), so
+ * the consumer is never more than one value behind no matter how bursty the
+ * producer gets. That's exactly what we want for input frames: a stale
+ * position is no use to anyone.
+ *
+ * It's a classic triple buffer. The producer always has a slot of its own to
+ * write into, the consumer always has a slot of its own to read from, and the
+ * third one sits in the middle. Posting and taking are each a single atomic
+ * exchange of the middle slot's index, so neither side ever waits on the
+ * other and nothing is allocated after construction.
+ *
+ * The rules of the warren:
+ *   - Only one thread may ever call `post()` at a time
+ *   - Only one thread may ever call `take()` / `take_timeout()`
+ *   - A value returned by `take()` stays put until the consumer takes again
+ *
+ * @tparam T the value to pass along. It's copied in, so keep it flat.
+ */
+template <typename T> class LatestValueMailbox {
+  public:
+    LatestValueMailbox() = default;
+
+    LatestValueMailbox(const LatestValueMailbox &) = delete;
+    LatestValueMailbox &operator=(const LatestValueMailbox &) = delete;
+
+    /**
+     * Post a new value, replacing whatever the consumer hasn't picked up yet.
+     * Producer side only.
+     *
+     * @param value the newest value
+     */
+    void post(const T &value) {
+        slots[writeIndex].value = value;
+        publish();
+    }
+
+    /**
+     * Take the newest value if there's one we haven't seen yet, without ever
+     * sleeping. Consumer side only.
+     *
+     * @return the value, or nullptr if nothing new has been posted
+     */
+    const T *take() {
+        if ((middle.load(std::memory_order_relaxed) & FreshBit) == 0) {
+            return nullptr;
+        }
+
+        const uint32_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & IndexMask;
+        return &slots[readIndex].value;
+    }
+
+    /**
+     * Wait for a new value. Consumer side only.
+     *
+     * @param timeout how long to wait
+     * @return the value, or nullptr if we timed out or are shutting down
+     */
+    const T *take_timeout(const std::chrono::milliseconds &timeout) {
+        if (const T *value = take()) {
+            return value;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!shutdown_requested.load(std::memory_order_relaxed)) {
+
+            // Tell the producer we're about to nap, then look one more time so
+            // we can't miss a value that landed in between
+            parker.prepareToPark();
+            if (const T *value = take()) {
+                parker.cancelPark();
+                return value;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline || shutdown_requested.load(std::memory_order_relaxed)) {
+                parker.cancelPark();
+                break;
+            }
+            parker.park(deadline - now);
+
+            if (const T *value = take()) {
+                return value;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Request shutdown - wakes up the consumer if it's waiting
+     */
+    void request_shutdown() {
+        shutdown_requested.store(true);
+        parker.wake();
+    }
+
+    /**
+     * Check if shutdown has been requested
+     */
+    bool is_shutdown_requested() const { return shutdown_requested.load(); }
+
+    /**
+     * How many values have been posted
+     */
+    std::uint64_t posted() const { return postedCount.load(std::memory_order_relaxed); }
+
+    /**
+     * How many values were replaced before the consumer ever saw them
+     */
+    std::uint64_t overwritten() const { return overwrittenCount.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr size_t CacheLineSize = 64;
+
+    // The middle slot's index lives in the low bits, and this bit says the
+    // producer put something there the consumer hasn't taken yet
+    static constexpr uint32_t IndexMask = 0x3;
+    static constexpr uint32_t FreshBit = 0x4;
+
+    struct alignas(CacheLineSize) Slot {
+        T value{};
+    };
+
+    /**
+     * Swap our freshly written slot into the middle and take whatever was
+     * there to write into next time
+     */
+    void publish() {
+        const uint32_t previous = middle.exchange(writeIndex | FreshBit, std::memory_order_acq_rel);
+        writeIndex = previous & IndexMask;
+
+        postedCount.fetch_add(1, std::memory_order_relaxed);
+        if ((previous & FreshBit) != 0) {
+            overwrittenCount.fetch_add(1, std::memory_order_relaxed); // Nobody ate that carrot
+        }
+
+        parker.unpark();
+    }
+
+    std::array<Slot, 3> slots{};
+
+    // Which slot each side owns. Only ever touched by that side.
+    alignas(CacheLineSize) uint32_t writeIndex = 0;
+    alignas(CacheLineSize) uint32_t readIndex = 1;
+
+    alignas(CacheLineSize) std::atomic<uint32_t> middle{2};
+
+    alignas(CacheLineSize) ThreadParker parker;
+    std::atomic<bool> shutdown_requested{false};
+    std::atomic<std::uint64_t> postedCount{0};
+    std::atomic<std::uint64_t> overwrittenCount{0};
+};
+
+} // namespace creatures
@@ -0,0 +1,68 @@
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <ctime>
+#endif
+
+#include "util/LoopTimer.h"
+
+namespace creatures {
+
+LoopTimer::LoopTimer(std::chrono::nanoseconds _period, std::chrono::nanoseconds _spin)
+    : period(_period), spin(_spin < _period ? _spin : _period) {}
+
+void LoopTimer::start() {
+    deadline = std::chrono::steady_clock::now() + period;
+    overruns = 0;
+}
+
+std::chrono::nanoseconds LoopTimer::waitForNextTick() {
+    using namespace std::chrono;
+
+    auto now = steady_clock::now();
+
+    // Already behind? Drop the ticks we missed entirely and just take this one.
+    if (now >= deadline + period) {
+        const auto missed = static_cast<std::uint64_t>((now - deadline) / period);
+        overruns += missed;
+        deadline += period * missed;
+    }
+
+    if (now < deadline) {
+        if (deadline - now > spin) {
+            sleepUntil(deadline - spin);
+        }
+
+        // Spin the last little bit
+        now = steady_clock::now();
+        while (now < deadline) {
+            now = steady_clock::now();
+        }
+    }
+
+    const auto lateness = duration_cast<nanoseconds>(now - deadline);
+    deadline += period;
+    return lateness;
+}
+
+void LoopTimer::sleepUntil(std::chrono::steady_clock::time_point when) {
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC on Linux, so its time points can be
+    // handed straight to the kernel
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+    timespec target{};
+    target.tv_sec = static_cast<time_t>(sinceEpoch / 1'000'000'000);
+    target.tv_nsec = static_cast<long>(sinceEpoch % 1'000'000'000);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+        // A signal woke us up early, go back to bed
+    }
+#else
+    std::this_thread::sleep_until(when);
+#endif
+}
+
+} // namespace creatures
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace creatures {
+
+/**
+ * Keeps a loop running on a fixed period, as close to on time as we can
+ * manage
+ *
+ * Sleeping for "whatever's left" is at the mercy of how long the work took to
+ * measure and how long the kernel takes to wake us, and the error adds up tick
+ * after tick. Instead this keeps an absolute deadline for every tick and
+ * sleeps until that exact time (`clock_nanosleep()` with `TIMER_ABSTIME` on
+ * Linux), so a late wakeup doesn't push the next one back.
+ *
+ * Even that can wake up a bit late on a busy Pi. If a spin is set, we sleep
+ * until that much before the deadline and then spin the rest of the way. It
+ * burns a little CPU for a lot less jitter, which is a good trade when jitter
+ * means servos buzzing.
+ *
+ * If we fall more than a whole period behind (something stalled), the ticks
+ * we missed are skipped rather than run back to back to catch up. A burst of
+ * frames would be worse for the servos than a missing one.
+ *
+ * Not thread safe. It belongs to the loop that's using it.
+ */
+class LoopTimer {
+  public:
+    /**
+     * @param period how long between ticks
+     * @param spin how long before each deadline to stop sleeping and spin
+     *             instead (zero to never spin)
+     */
+    explicit LoopTimer(std::chrono::nanoseconds period, std::chrono::nanoseconds spin = std::chrono::nanoseconds(0));
+
+    /**
+     * Start counting. The first tick is one period from now.
+     */
+    void start();
+
+    /**
+     * Wait for the next tick
+     *
+     * @return how late we woke up (zero if we were right on time)
+     */
+    std::chrono::nanoseconds waitForNextTick();
+
+    /**
+     * How many ticks were skipped because we'd fallen behind
+     */
+    [[nodiscard]] std::uint64_t getOverruns() const { return overruns; }
+
+    [[nodiscard]] std::chrono::nanoseconds getPeriod() const { return period; }
+
+  private:
+    /**
+     * Sleep until the given time, without giving up early if a signal shows up
+     */
+    static void sleepUntil(std::chrono::steady_clock::time_point when);
+
+    std::chrono::nanoseconds period;
+    std::chrono::nanoseconds spin;
+    std::chrono::steady_clock::time_point deadline;
+    std::uint64_t overruns = 0;
+};
+
+} // namespace creatures
@@ -1,32 +1,128 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <functional>
+#include <limits>
 #include <mutex>
 #include <optional>
+#include <string_view>
+#include <vector>
 
 namespace creatures {
 
+/**
+ * What a bounded queue does when someone pushes onto it while it's full
+ */
+enum class QueueOverflowPolicy {
+    block,              // Wait for a consumer to make room
+    dropOldest,         // Throw out the oldest message to make room
+    dropNewest,         // Throw out the message being pushed
+    replaceLatestByKey, // A newer message takes the spot of a waiting one with the same key (else drop the
+                        // oldest keyed one, since messages without a key are the ones that all matter)
+};
+
 /**
  * A simple thread-safe message queue
  *
  * Used for passing messages around between threads in order
  *
+ * By default it'll hold as many messages as it's given. Give it a capacity and
+ * it'll hold at most that many, and do what its overflow policy says once it's
+ * full, so a consumer that falls behind can't eat all of our memory (or leave
+ * everything that's waiting hopelessly stale).
+ *
  * @tparam T
  */
 template <typename T> class MessageQueue {
   public:
+    /**
+     * How a message's key is found, for `QueueOverflowPolicy::replaceLatestByKey`.
+     * Messages with an empty key are never replaced.
+     *
+     * It's called on every waiting message under the lock, so it points into
+     * the message rather than making a copy. (Make sure a lambda says it
+     * returns a `std::string_view`, or it'll hand back a view of a temporary!)
+     */
+    using KeyFunction = std::function<std::string_view(const T &)>;
+
     MessageQueue() : shutdown_requested(false) {}
 
-    void push(T message) {
-        std::lock_guard<std::mutex> lock(mtx);
+    /**
+     * A bounded queue
+     *
+     * @param _capacity the most messages to hold at once
+     * @param _policy what to do when it's full
+     * @param _keyOf how to find a message's key (only for replaceLatestByKey)
+     */
+    explicit MessageQueue(size_t _capacity, QueueOverflowPolicy _policy = QueueOverflowPolicy::block,
+                          KeyFunction _keyOf = nullptr)
+        : shutdown_requested(false), capacity_(_capacity == 0 ? 1 : _capacity), policy(_policy),
+          keyOf(std::move(_keyOf)) {}
+
+    /**
+     * Add a message to the back of the queue
+     *
+     * @return true if it's in the queue (it might have taken an older message's
+     *         spot), false if it was thrown out because the queue was full or
+     *         we're shutting down
+     */
+    bool push(T message) {
+        std::unique_lock<std::mutex> lock(mtx);
         if (shutdown_requested.load()) {
-            return; // Don't accept new messages during shutdown
+            return false; // Don't accept new messages during shutdown
+        }
+
+        std::string_view key;
+        if (policy == QueueOverflowPolicy::replaceLatestByKey && keyOf) {
+            key = keyOf(message);
+            if (!key.empty()) {
+                // Newest first, since that's where a match most likely is
+                for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+                    if (keyOf(*it) == key) {
+                        *it = std::move(message);
+                        replacedCount.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
         }
+
+        if (queue.size() >= capacity_) {
+            switch (policy) {
+            case QueueOverflowPolicy::block:
+                notFull.wait(lock, [this] { return queue.size() < capacity_ || shutdown_requested.load(); });
+                if (shutdown_requested.load()) {
+                    return false;
+                }
+                break;
+            case QueueOverflowPolicy::dropNewest:
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case QueueOverflowPolicy::dropOldest:
+                queue.pop_front();
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case QueueOverflowPolicy::replaceLatestByKey:
+                if (!dropOldestKeyed(key)) {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                break;
+            }
+        }
+
         queue.push_back(std::move(message));
+        if (queue.size() > highWaterMark.load(std::memory_order_relaxed)) {
+            highWaterMark.store(queue.size(), std::memory_order_relaxed);
+        }
         cond.notify_one(); // Hop, hop! A new message is here!
+        return true;
     }
 
     T pop() {
@@ -42,6 +138,7 @@ template <typename T> class MessageQueue {
 
         T msg = std::move(queue.front());
         queue.pop_front();
+        notFull.notify_one();
         return msg;
     }
 
@@ -58,17 +155,49 @@ template <typename T> class MessageQueue {
         if (cond.wait_for(lock, timeout, [this] { return !queue.empty(); })) {
             T msg = std::move(queue.front());
             queue.pop_front();
+            notFull.notify_one();
             return msg;
         }
         return std::nullopt; // Timeout - no carrots today!
     }
 
+    /**
+     * Move everything that's waiting (up to a limit) out of the queue, all
+     * under one lock, without ever waiting for more
+     *
+     * @param into where to put them. They're added to the end.
+     * @param max the most to take
+     * @return how many we took
+     */
+    size_t drain_into(std::vector<T> &into, size_t max = std::numeric_limits<size_t>::max()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        return drainLocked(into, max);
+    }
+
+    /**
+     * Wait (up to a point) for something to show up, then take everything
+     * that's waiting (up to a limit). Handy for a writer that wants to work
+     * in batches.
+     *
+     * @param into where to put them. They're added to the end.
+     * @param timeout how long to wait if the queue is empty
+     * @param max the most to take
+     * @return how many we took (zero if we timed out or are shutting down)
+     */
+    size_t drain_into(std::vector<T> &into, const std::chrono::milliseconds &timeout,
+                      size_t max = std::numeric_limits<size_t>::max()) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait_for(lock, timeout, [this] { return !queue.empty() || shutdown_requested.load(); });
+        return drainLocked(into, max);
+    }
+
     /**
      * Clear all messages from the queue - like cleaning out a rabbit hutch!
      */
     void clear() {
         std::lock_guard<std::mutex> lock(mtx);
         queue.clear();
+        notFull.notify_all();
     }
 
     /**
@@ -78,6 +207,7 @@ template <typename T> class MessageQueue {
         std::lock_guard<std::mutex> lock(mtx);
         shutdown_requested.store(true);
         cond.notify_all(); // Wake up all waiting threads
+        notFull.notify_all();
     }
 
     /**
@@ -101,10 +231,83 @@ template <typename T> class MessageQueue {
         return queue.size();
     }
 
+    /**
+     * The most messages this queue will hold (the max size_t if it's unbounded)
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * The most messages that have ever been waiting at once
+     */
+    size_t high_water_mark() const { return highWaterMark.load(std::memory_order_relaxed); }
+
+    /**
+     * How many messages were thrown out because the queue was full
+     */
+    std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    /**
+     * How many messages were replaced by a newer one with the same key
+     */
+    std::uint64_t replaced() const { return replacedCount.load(std::memory_order_relaxed); }
+
   private:
+    /**
+     * Make room in a full replaceLatestByKey queue. Call with the lock held.
+     *
+     * A message without a key is never thrown out while there's one with a
+     * key that could go instead. The oldest keyed one goes if there is one.
+     * If everything waiting is unkeyed, a keyed newcomer is the one that
+     * loses out. Only when the newcomer has no key either does the oldest
+     * unkeyed one go, since something has to.
+     *
+     * @param incomingKey the key of the message that wants in
+     * @return true if there's room now, false if the newcomer should be dropped
+     */
+    bool dropOldestKeyed(std::string_view incomingKey) {
+        if (keyOf) {
+            for (auto it = queue.begin(); it != queue.end(); ++it) {
+                if (!keyOf(*it).empty()) {
+                    queue.erase(it);
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        if (!incomingKey.empty()) {
+            return false;
+        }
+        queue.pop_front();
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Call with the lock held
+    size_t drainLocked(std::vector<T> &into, size_t max) {
+        const size_t taken = std::min(queue.size(), max);
+        into.reserve(into.size() + taken);
+        for (size_t i = 0; i < taken; i++) {
+            into.push_back(std::move(queue[i]));
+        }
+        queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(taken));
+        if (taken > 0) {
+            notFull.notify_all();
+        }
+        return taken;
+    }
+
     mutable std::mutex mtx; // Made mutable so const methods can use it
     std::condition_variable cond;
+    std::condition_variable notFull; // For producers waiting on a full queue
     std::deque<T> queue;
     std::atomic<bool> shutdown_requested;
+
+    size_t capacity_ = std::numeric_limits<size_t>::max();
+    QueueOverflowPolicy policy = QueueOverflowPolicy::block;
+    KeyFunction keyOf;
+
+    std::atomic<size_t> highWaterMark{0};
+    std::atomic<std::uint64_t> droppedCount{0};
+    std::atomic<std::uint64_t> replacedCount{0};
 };
 } // namespace creatures
\ No newline at end of file
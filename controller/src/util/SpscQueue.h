@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "util/ThreadParker.h"
+
+namespace creatures {
+
+/**
+ * A bounded, lock-free, single-producer / single-consumer ring buffer
+ *
+ * This has the same shape as `MessageQueue` (push, pop_timeout,
+ * request_shutdown, and friends) but is meant for the hot paths where there is
+ * exactly one thread on each end, like a serial port's reader and writer. The
+ * head and tail live on their own cache lines so the two sides don't fight
+ * over them, and the consumer only goes to sleep (and the producer only makes
+ * a syscall) when the ring is actually empty.
+ *
+ * The rules of the warren:
+ *   - Only one thread may ever call `push()` at a time
+ *   - Only one thread may ever call `pop_timeout()`, `try_pop()`, or `clear()`
+ *   - `size()` and `empty()` are safe from anywhere, but are only a snapshot
+ *
+ * The ring never grows. If the consumer falls behind and it fills up, `push()`
+ * refuses the new message and counts the drop rather than blocking the
+ * producer.
+ *
+ * @tparam T the type of thing we're hopping between threads
+ */
+template <typename T> class SpscQueue {
+  public:
+    /**
+     * @param requestedCapacity how many messages the ring can hold. This is
+     * rounded up to the next power of two.
+     */
+    explicit SpscQueue(size_t requestedCapacity = 1024)
+        : capacity_(roundUpToPowerOfTwo(requestedCapacity)), mask(capacity_ - 1),
+          slots(std::make_unique<std::optional<T>[]>(capacity_)) {}
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * Add a message to the ring. Producer side only.
+     *
+     * @param message the message to add
+     * @return false if the ring is full or we're shutting down
+     */
+    bool push(T message) {
+        if (shutdown_requested.load(std::memory_order_relaxed)) {
+            return false; // Don't accept new messages during shutdown
+        }
+
+        const size_t currentTail = producer.tail.load(std::memory_order_relaxed);
+        if (currentTail - producer.cachedHead >= capacity_) {
+            // Only go look at the consumer's cache line when we think we're full
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            if (currentTail - producer.cachedHead >= capacity_) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        slots[currentTail & mask].emplace(std::move(message));
+        producer.tail.store(currentTail + 1, std::memory_order_release);
+
+        parker.unpark(); // Hop, hop! A new message is here (but only knock if someone's asleep)
+        return true;
+    }
+
+    /**
+     * Take a message if there's one waiting, without ever sleeping. Consumer
+     * side only.
+     *
+     * @return the message, or nullopt if the ring is empty
+     */
+    std::optional<T> try_pop() {
+        const size_t currentHead = consumer.head.load(std::memory_order_relaxed);
+        if (currentHead == consumer.cachedTail) {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            if (currentHead == consumer.cachedTail) {
+                return std::nullopt;
+            }
+        }
+
+        auto &slot = slots[currentHead & mask];
+        std::optional<T> msg = std::move(slot);
+        slot.reset();
+        consumer.head.store(currentHead + 1, std::memory_order_release);
+        return msg;
+    }
+
+    /**
+     * Pop a message with a timeout. Consumer side only.
+     *
+     * @param timeout how long to wait for a message
+     * @return optional containing the message if one arrived in time, nullopt
+     * if we timed out or are shutting down
+     */
+    std::optional<T> pop_timeout(const std::chrono::milliseconds &timeout) {
+        if (auto msg = try_pop()) {
+            return msg;
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!shutdown_requested.load(std::memory_order_relaxed)) {
+
+            // Tell producers we're about to nap, then look one more time so we
+            // can't miss a message that landed in between
+            parker.prepareToPark();
+            if (auto msg = try_pop()) {
+                parker.cancelPark();
+                return msg;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline || shutdown_requested.load(std::memory_order_relaxed)) {
+                parker.cancelPark();
+                break;
+            }
+            parker.park(deadline - now);
+
+            if (auto msg = try_pop()) {
+                return msg;
+            }
+        }
+        return std::nullopt; // Timeout - no carrots today!
+    }
+
+    /**
+     * Throw away everything in the ring. Consumer side only.
+     */
+    void clear() {
+        while (try_pop().has_value()) {
+        }
+    }
+
+    /**
+     * Request shutdown - wakes up the consumer if it's waiting
+     */
+    void request_shutdown() {
+        shutdown_requested.store(true);
+        parker.wake();
+    }
+
+    /**
+     * Check if shutdown has been requested
+     */
+    bool is_shutdown_requested() const { return shutdown_requested.load(); }
+
+    /**
+     * Check if the ring is empty (a snapshot, safe from any thread)
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * How many messages are waiting (a snapshot, safe from any thread)
+     */
+    size_t size() const {
+        const size_t head = consumer.head.load(std::memory_order_acquire);
+        const size_t tail = producer.tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    /**
+     * How many messages the ring can hold
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * How many messages were turned away because the ring was full
+     */
+    std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr size_t CacheLineSize = 64;
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Written by the producer, read by the consumer
+    struct alignas(CacheLineSize) ProducerSide {
+        std::atomic<size_t> tail{0};
+        size_t cachedHead{0};
+    };
+
+    // Written by the consumer, read by the producer
+    struct alignas(CacheLineSize) ConsumerSide {
+        std::atomic<size_t> head{0};
+        size_t cachedTail{0};
+    };
+
+    const size_t capacity_;
+    const size_t mask;
+    std::unique_ptr<std::optional<T>[]> slots;
+
+    ProducerSide producer;
+    ConsumerSide consumer;
+
+    alignas(CacheLineSize) ThreadParker parker;
+    std::atomic<bool> shutdown_requested{false};
+    std::atomic<std::uint64_t> droppedCount{0};
+};
+
+} // namespace creatures
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace creatures {
+
+/**
+ * Lets exactly one consumer thread go to sleep until a producer has something
+ * for it, without either side taking a lock in the common case.
+ *
+ * The consumer announces that it's about to park, re-checks whatever it was
+ * waiting on, and only then sleeps. Producers publish their data first and
+ * then call `unpark()`, which costs a single atomic load unless someone is
+ * actually asleep. On Linux the sleep is a futex; everywhere else we fall back
+ * to a condition variable that only gets touched when parking.
+ *
+ * Like a rabbit that only gets out of the burrow when someone knocks!
+ */
+class ThreadParker {
+  public:
+    ThreadParker() = default;
+    ThreadParker(const ThreadParker &) = delete;
+    ThreadParker &operator=(const ThreadParker &) = delete;
+
+    /**
+     * Called by the consumer right before it re-checks its condition. After
+     * this any producer that publishes will wake us up.
+     */
+    void prepareToPark() {
+        state.store(Parked, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /**
+     * Called by the consumer if the re-check found work and it doesn't need
+     * to sleep after all
+     */
+    void cancelPark() { state.store(Awake, std::memory_order_relaxed); }
+
+    /**
+     * Sleep until a producer calls `unpark()` or the timeout expires. Spurious
+     * wakeups are possible, so callers must re-check their condition.
+     *
+     * @param timeout the longest we're willing to nap
+     */
+    void park(const std::chrono::nanoseconds &timeout) {
+#if defined(__linux__)
+        const auto nanos = timeout.count() > 0 ? timeout.count() : 0;
+        struct timespec ts {};
+        ts.tv_sec = static_cast<time_t>(nanos / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(nanos % 1'000'000'000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state), FUTEX_WAIT_PRIVATE, Parked, &ts, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait_for(lock, timeout, [this] { return state.load(std::memory_order_relaxed) != Parked; });
+#endif
+        state.store(Awake, std::memory_order_relaxed);
+    }
+
+    /**
+     * Called by a producer after publishing. Only makes a syscall if the
+     * consumer is actually asleep.
+     */
+    void unpark() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (state.load(std::memory_order_relaxed) != Parked) {
+            return;
+        }
+        wake();
+    }
+
+    /**
+     * Wake the consumer no matter what - used when shutting down
+     */
+    void wake() {
+#if defined(__linux__)
+        state.store(Awake, std::memory_order_relaxed);
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            state.store(Awake, std::memory_order_relaxed);
+        }
+        cond.notify_all();
+#endif
+    }
+
+  private:
+    static constexpr uint32_t Awake = 0;
+    static constexpr uint32_t Parked = 1;
+
+    // The futex word. It has to be exactly 32 bits for the kernel.
+    std::atomic<uint32_t> state{Awake};
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+#if !defined(__linux__)
+    std::mutex mtx;
+    std::condition_variable cond;
+#endif
+};
+
+} // namespace creatures
@@ -1,9 +1,14 @@
 
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
 #include <charconv>
 #include <cmath> // for std::isspace
+#include <cstdlib>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "string_utils.h"
@@ -14,7 +19,7 @@
  * @param str the string to parse
  * @return a u32 of the string, if possible
  */
-u32 stringToU32(const std::string &str) {
+u32 stringToU32(std::string_view str) {
 
     // Skip leading whitespace
     const char *start = str.data();
@@ -48,7 +53,7 @@ u32 stringToU32(const std::string &str) {
  * @param str the string to parse
  * @return a u64 of the string, if possible
  */
-u64 stringToU64(const std::string &str) {
+u64 stringToU64(std::string_view str) {
 
     // Skip leading whitespace
     const char *start = str.data();
@@ -82,7 +87,7 @@ u64 stringToU64(const std::string &str) {
  * @param str the string to parse
  * @return a double of the string, if possible, otherwise NaN
  */
-double stringToDouble(const std::string &str) {
+double stringToDouble(std::string_view str) {
 
     // Skip leading whitespace
     const char *start = str.data();
@@ -96,17 +101,36 @@ double stringToDouble(const std::string &str) {
         return std::numeric_limits<double>::quiet_NaN();
     }
 
+    double value = 0.0;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::from_chars(start, end, value);
+
+    if (result.ec == std::errc::invalid_argument || result.ec == std::errc::result_out_of_range) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+#else
+    // Older standard libraries (looking at you, libc++) can't do from_chars()
+    // on a double yet. strtod() needs a terminated string and our view might
+    // not be one, so copy it somewhere that is first. Nothing we parse is
+    // anywhere near this long.
+    char buffer[64];
+    const size_t length = std::min(static_cast<size_t>(end - start), sizeof(buffer) - 1);
+    std::copy(start, start + length, buffer);
+    buffer[length] = '\0';
+
     // Reset errno before calling strtod
     errno = 0;
 
     // Convert string to double
     char *endPtr;
-    double value = std::strtod(start, &endPtr);
+    value = std::strtod(buffer, &endPtr);
 
     // Check for conversion errors
-    if (errno == ERANGE || start == endPtr) {
+    if (errno == ERANGE || buffer == endPtr) {
         return std::numeric_limits<double>::quiet_NaN();
     }
+#endif
 
     return value;
 }
@@ -117,8 +141,8 @@ double stringToDouble(const std::string &str) {
  * @param str the string to split
  * @return a vector containing the pieces
  */
-std::vector<std::string> splitString(const std::string &str) {
-    std::istringstream iss(str);
+std::vector<std::string> splitString(std::string_view str) {
+    std::istringstream iss{std::string(str)};
     std::vector<std::string> tokens;
 
     for (const std::movable auto &part :
@@ -128,3 +152,38 @@ std::vector<std::string> splitString(const std::string &str) {
 
     return tokens;
 }
+
+/**
+ * Split a string on whitespace without copying anything
+ *
+ * @param str the string to split
+ * @param fields where to put the pieces
+ * @return how many fields `str` had
+ */
+size_t splitFields(std::string_view str, std::span<std::string_view> fields) {
+    size_t count = 0;
+    size_t position = 0;
+
+    while (position < str.size()) {
+
+        // Hop over the whitespace in front of the next field
+        while (position < str.size() && std::isspace(static_cast<unsigned char>(str[position]))) {
+            ++position;
+        }
+        if (position == str.size()) {
+            break;
+        }
+
+        const size_t fieldStart = position;
+        while (position < str.size() && !std::isspace(static_cast<unsigned char>(str[position]))) {
+            ++position;
+        }
+
+        if (count < fields.size()) {
+            fields[count] = str.substr(fieldStart, position - fieldStart);
+        }
+        count++;
+    }
+
+    return count;
+}
@@ -1,11 +1,12 @@
-
 #pragma once
 
 #include <charconv>
 #include <cstdint>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "controller-config.h"
@@ -16,7 +17,7 @@
  * @param str the string to parse
  * @return a u32 of the string, if possible
  */
-u32 stringToU32(const std::string &str);
+u32 stringToU32(std::string_view str);
 
 /**
  * Convert a string into a u64 safely
@@ -24,7 +25,7 @@ u32 stringToU32(const std::string &str);
  * @param str the string to parse
  * @return a u64 of the string, if possible
  */
-u64 stringToU64(const std::string &str);
+u64 stringToU64(std::string_view str);
 
 /**
  * Convert a string into a double safely
@@ -32,7 +33,7 @@ u64 stringToU64(const std::string &str);
  * @param str the string to parse
  * @return a double of the string, if possible, otherwise NaN
  */
-double stringToDouble(const std::string &str);
+double stringToDouble(std::string_view str);
 
 /**
  * Split a string into pieces in a safe way
@@ -40,4 +41,18 @@ double stringToDouble(const std::string &str);
  * @param str the string to split
  * @return a vector containing the pieces
  */
-std::vector<std::string> splitString(const std::string &str);
+std::vector<std::string> splitString(std::string_view str);
+
+/**
+ * Split a string on whitespace without copying anything
+ *
+ * The fields are views into `str`, so they're only good for as long as it is.
+ * If there are more fields than `fields` can hold, the extras aren't stored but
+ * are still counted, so callers can tell a line with too many fields from one
+ * that fits.
+ *
+ * @param str the string to split
+ * @param fields where to put the pieces
+ * @return how many fields `str` had
+ */
+size_t splitFields(std::string_view str, std::span<std::string_view> fields);
@@ -0,0 +1,64 @@
+
+#include <cerrno>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/Result.h"
+#include "util/thread_priority.h"
+
+namespace creatures {
+
+Result<bool> setRealtimePriority(int priority) {
+#if defined(__linux__)
+    if (priority < sched_get_priority_min(SCHED_FIFO) || priority > sched_get_priority_max(SCHED_FIFO)) {
+        return Result<bool>{ControllerError(ControllerError::InvalidConfiguration,
+                                            fmt::format("SCHED_FIFO priority {} is out of range ({} to {})", priority,
+                                                        sched_get_priority_min(SCHED_FIFO),
+                                                        sched_get_priority_max(SCHED_FIFO)))};
+    }
+
+    sched_param param{};
+    param.sched_priority = priority;
+    const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        return Result<bool>{ControllerError(
+            ControllerError::InternalError,
+            fmt::format("unable to switch to SCHED_FIFO priority {}: {}", priority, std::strerror(result)))};
+    }
+    return Result<bool>{true};
+#else
+    return Result<bool>{ControllerError(ControllerError::InternalError,
+                                        fmt::format("SCHED_FIFO priority {} isn't supported on this platform",
+                                                    priority))};
+#endif
+}
+
+Result<bool> pinThreadToCpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return Result<bool>{
+            ControllerError(ControllerError::InvalidConfiguration, fmt::format("CPU {} is out of range", cpu))};
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+        return Result<bool>{ControllerError(ControllerError::InternalError,
+                                            fmt::format("unable to pin to CPU {}: {}", cpu, std::strerror(result)))};
+    }
+    return Result<bool>{true};
+#else
+    return Result<bool>{ControllerError(ControllerError::InternalError,
+                                        fmt::format("pinning to CPU {} isn't supported on this platform", cpu))};
+#endif
+}
+
+} // namespace creatures
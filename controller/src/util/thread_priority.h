@@ -0,0 +1,28 @@
+#pragma once
+
+#include "util/Result.h"
+
+namespace creatures {
+
+/**
+ * Run the calling thread under `SCHED_FIFO` at the given priority
+ *
+ * This needs root or `CAP_SYS_NICE` (or an rtprio limit that allows it), and
+ * only works on Linux.
+ *
+ * @param priority 1 (lowest) to 99 (highest)
+ * @return true if it worked, or an error saying why not
+ */
+Result<bool> setRealtimePriority(int priority);
+
+/**
+ * Keep the calling thread on one CPU
+ *
+ * Only works on Linux.
+ *
+ * @param cpu the CPU to stay on, starting at 0
+ * @return true if it worked, or an error saying why not
+ */
+Result<bool> pinThreadToCpu(int cpu);
+
+} // namespace creatures
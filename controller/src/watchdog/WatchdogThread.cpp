@@ -7,6 +7,7 @@
 #include <chrono>
 #include <nlohmann/json.hpp>
 #include <thread>
+#include <utility>
 
 using json = nlohmann::json;
 
@@ -263,7 +264,7 @@ void WatchdogThread::triggerEmergencyStop(const std::string &reason) {
 
         for (const auto &moduleId : moduleIds) {
             creatures::io::Message estopMessage(moduleId, estopCommand->toMessageWithChecksum());
-            auto result = messageRouter->sendMessageToCreature(estopMessage);
+            auto result = messageRouter->sendMessageToCreature(std::move(estopMessage));
             if (!result.isSuccess()) {
                 auto error = result.getError();
                 if (error.has_value()) {
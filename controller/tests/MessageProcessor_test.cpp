@@ -1,5 +1,10 @@
 
+#include <map>
 #include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -70,6 +75,47 @@ TEST_F(MessageProcessorTest, ProcessMessage_CustomHandler) {
     EXPECT_TRUE(result.isSuccess());
 }
 
+namespace {
+
+/**
+ * Hangs on to copies of whatever it was handed
+ */
+class RecordingMessageHandler : public creatures::IMessageHandler {
+  public:
+    void handle(std::shared_ptr<creatures::Logger> /*logger*/, std::span<const std::string_view> tokens) override {
+        received.assign(tokens.begin(), tokens.end());
+        calls++;
+    }
+
+    std::vector<std::string> received;
+    int calls = 0;
+};
+
+} // namespace
+
+TEST_F(MessageProcessorTest, ProcessMessage_TokenizesOnTabs) {
+    auto handler = std::make_shared<RecordingMessageHandler>();
+    messageProcessor->registerHandler("MOCK", handler);
+
+    // Empty tokens in the middle stay, a trailing tab doesn't add one
+    Message msg(moduleId, "MOCK\tone two\t\tthree\t");
+    ASSERT_TRUE(messageProcessor->processMessage(msg).isSuccess());
+
+    ASSERT_EQ(handler->calls, 1);
+    EXPECT_EQ(handler->received, (std::vector<std::string>{"MOCK", "one two", "", "three"}));
+}
+
+TEST_F(MessageProcessorTest, ProcessMessage_RegisteringAgainReplacesTheHandler) {
+    auto first = std::make_shared<RecordingMessageHandler>();
+    auto second = std::make_shared<RecordingMessageHandler>();
+    messageProcessor->registerHandler("MOCK", first);
+    messageProcessor->registerHandler("MOCK", second);
+
+    ASSERT_TRUE(messageProcessor->processMessage(Message(moduleId, "MOCK\thi")).isSuccess());
+    EXPECT_EQ(first->calls, 0);
+    EXPECT_EQ(second->calls, 1);
+}
+
 TEST_F(MessageProcessorTest, ProcessMessage_UnknownHandler) {
     // Unknown handlers no longer throw - they log a warning and return success
     Message msg(moduleId, "AAACCCKKKKK\tthe printer is on fire");
@@ -77,6 +123,26 @@ TEST_F(MessageProcessorTest, ProcessMessage_UnknownHandler) {
     EXPECT_TRUE(result.isSuccess());
 }
 
+TEST_F(MessageProcessorTest, CountsEachMessageTypeOnce) {
+    auto handler = std::make_shared<RecordingMessageHandler>();
+    messageProcessor->registerHandler("MOCK", handler);
+
+    ASSERT_TRUE(messageProcessor->processMessage(Message(moduleId, "MOCK\tone")).isSuccess());
+    ASSERT_TRUE(messageProcessor->processMessage(Message(moduleId, "MOCK\ttwo")).isSuccess());
+    ASSERT_TRUE(messageProcessor->processMessage(Message(moduleId, "LOG\thi")).isSuccess());
+    ASSERT_TRUE(messageProcessor->processMessage(Message(moduleId, "CARROT\tcrunch")).isSuccess());
+
+    std::map<std::string, u64> seen;
+    for (const auto &typeStats : messageProcessor->getMessageTypeStats()) {
+        seen[typeStats.messageType] = typeStats.messages;
+        EXPECT_GE(typeStats.maxDispatchNs * typeStats.messages, typeStats.dispatchNs);
+    }
+
+    // Types we haven't seen yet aren't reported at all
+    EXPECT_EQ(seen, (std::map<std::string, u64>{{"MOCK", 2}, {"LOG", 1}, {"unknown", 1}}));
+    EXPECT_EQ(handler->calls, 2);
+}
+
 TEST_F(MessageProcessorTest, ProcessMessage_EmptyPayload) {
     Message msg(moduleId, "");
     auto result = messageProcessor->processMessage(msg);
@@ -1,5 +1,11 @@
 
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -21,6 +27,12 @@ void pushMessages(creatures::MessageQueue<int>& queue, int start, int end) {
     }
 }
 
+std::vector<int> drainAll(creatures::MessageQueue<int>& queue) {
+    std::vector<int> all;
+    queue.drain_into(all);
+    return all;
+}
+
 void popMessages(creatures::MessageQueue<int>& queue, int count, std::vector<int>& out) {
     for (int i = 0; i < count; ++i) {
         out.push_back(queue.pop());
@@ -42,3 +54,137 @@ TEST(MessageQueue, MultiThreadedPushPop) {
     }
 }
 
+TEST(MessageQueue, DrainIntoTakesWhatsThereUpToTheLimit) {
+    creatures::MessageQueue<int> queue;
+    pushMessages(queue, 1, 5);
+
+    std::vector<int> taken;
+    EXPECT_EQ(queue.drain_into(taken, 3), 3u);
+    EXPECT_EQ(taken, (std::vector<int>{1, 2, 3}));
+
+    EXPECT_EQ(queue.drain_into(taken, 10), 2u);
+    EXPECT_EQ(taken, (std::vector<int>{1, 2, 3, 4, 5}));
+
+    EXPECT_EQ(queue.drain_into(taken, 10), 0u);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MessageQueue, DropNewestTurnsAwayMessagesWhenFull) {
+    creatures::MessageQueue<int> queue(3, creatures::QueueOverflowPolicy::dropNewest);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_FALSE(queue.push(4));
+
+    EXPECT_EQ(drainAll(queue), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(queue.dropped(), 1u);
+    EXPECT_EQ(queue.high_water_mark(), 3u);
+    EXPECT_EQ(queue.capacity(), 3u);
+}
+
+TEST(MessageQueue, DropOldestMakesRoomForTheNewOne) {
+    creatures::MessageQueue<int> queue(3, creatures::QueueOverflowPolicy::dropOldest);
+    pushMessages(queue, 1, 5);
+
+    EXPECT_EQ(drainAll(queue), (std::vector<int>{3, 4, 5}));
+    EXPECT_EQ(queue.dropped(), 2u);
+}
+
+TEST(MessageQueue, ReplaceLatestByKeyKeepsTheSpotInLine) {
+    using Keyed = std::pair<std::string, int>;
+    creatures::MessageQueue<Keyed> queue(3, creatures::QueueOverflowPolicy::replaceLatestByKey,
+                                         [](const Keyed &message) -> std::string_view { return message.first; });
+
+    queue.push({"motor", 1});
+    queue.push({"board", 1});
+    queue.push({"motor", 2});
+    queue.push({"", 1}); // No key, never replaced
+    queue.push({"", 2}); // ...and the queue's full, so the oldest goes
+
+    std::vector<Keyed> taken;
+    EXPECT_EQ(queue.drain_into(taken), 3u);
+    EXPECT_EQ(taken, (std::vector<Keyed>{{"board", 1}, {"", 1}, {"", 2}}));
+    EXPECT_EQ(queue.replaced(), 1u);
+    EXPECT_EQ(queue.dropped(), 1u);
+}
+
+TEST(MessageQueue, ReplaceLatestByKeyNeverThrowsOutAnUnkeyedMessageForAKeyedOne) {
+    using Keyed = std::pair<std::string, int>;
+    creatures::MessageQueue<Keyed> queue(3, creatures::QueueOverflowPolicy::replaceLatestByKey,
+                                         [](const Keyed &message) -> std::string_view { return message.first; });
+
+    // An e-stop, and then a flood of sensor readings that all have keys of their own
+    EXPECT_TRUE(queue.push({"", 1}));
+    EXPECT_TRUE(queue.push({"motor", 1}));
+    EXPECT_TRUE(queue.push({"board", 1}));
+    EXPECT_TRUE(queue.push({"power", 1}));
+
+    // Another one that matters makes room by pushing out a reading, too
+    EXPECT_TRUE(queue.push({"", 2}));
+
+    // Once there's nothing with a key left to throw out, a new reading is
+    // the one that doesn't make it
+    EXPECT_TRUE(queue.push({"", 3}));
+    EXPECT_FALSE(queue.push({"sensor", 1}));
+
+    std::vector<Keyed> taken;
+    EXPECT_EQ(queue.drain_into(taken), 3u);
+    EXPECT_EQ(taken, (std::vector<Keyed>{{"", 1}, {"", 2}, {"", 3}}));
+    EXPECT_EQ(queue.dropped(), 4u);
+}
+
+TEST(MessageQueue, BlockWaitsForRoom) {
+    creatures::MessageQueue<int> queue(1, creatures::QueueOverflowPolicy::block);
+    queue.push(1);
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] {
+        queue.push(2);
+        pushed.store(true);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed.load());
+
+    EXPECT_EQ(queue.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.dropped(), 0u);
+}
+
+TEST(MessageQueue, ShutdownLetsBlockedProducersGo) {
+    creatures::MessageQueue<int> queue(1, creatures::QueueOverflowPolicy::block);
+    queue.push(1);
+
+    std::thread producer([&] { EXPECT_FALSE(queue.push(2)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.request_shutdown();
+    producer.join();
+}
+
+TEST(MessageQueue, DrainWithTimeoutWaitsForSomethingThenTakesEverything) {
+    creatures::MessageQueue<int> queue;
+    std::vector<int> taken;
+
+    EXPECT_EQ(queue.drain_into(taken, std::chrono::milliseconds(5)), 0u);
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        pushMessages(queue, 1, 3);
+    });
+    while (taken.size() < 3) {
+        queue.drain_into(taken, std::chrono::milliseconds(1000));
+    }
+    producer.join();
+
+    EXPECT_EQ(taken, (std::vector<int>{1, 2, 3}));
+    EXPECT_TRUE(queue.empty());
+
+    // ...but no more than it's told to
+    pushMessages(queue, 4, 6);
+    EXPECT_EQ(queue.drain_into(taken, std::chrono::milliseconds(5), 2), 2u);
+    EXPECT_EQ(taken, (std::vector<int>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(queue.size(), 1u);
+}
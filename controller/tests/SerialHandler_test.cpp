@@ -6,7 +6,7 @@
 #include "io/Message.h"
 #include "io/SerialHandler.h"
 #include "mocks/logging/MockLogger.h"
-#include "util/MessageQueue.h"
+#include "util/SpscQueue.h"
 
 extern std::atomic<bool> shutdown_requested;
 
@@ -15,8 +15,8 @@ namespace creatures {
 // There isn't a clean way to mock a serial device in a unit test
 //    TEST(SerialOutput, CreateSerialOutput_ValidDevice) {
 //        auto logger = std::make_shared<NiceMockLogger>();
-//        auto outputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
-//        auto inputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
+//        auto outputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
+//        auto inputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
 //
 //        EXPECT_NO_THROW({
 //                            auto serialOutput = SerialHandler(logger, "/dev/null", UARTDevice::A, outputQueue,
@@ -29,16 +29,16 @@ namespace creatures {
 // Result. These tests pin that contract.
 TEST(SerialOutput, CreateSerialOutput_DeviceDoesNotExist_IsNonFatal) {
     auto logger = std::make_shared<NiceMockLogger>();
-    auto outputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
-    auto inputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
+    auto outputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
+    auto inputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
 
     EXPECT_NO_THROW({ auto serialOutput = SerialHandler(logger, "", UARTDevice::A, outputQueue, inputQueue); });
 }
 
 TEST(SerialOutput, CreateSerialOutput_DeviceNotCharacterDevice_IsNonFatal) {
     auto logger = std::make_shared<NiceMockLogger>();
-    auto outputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
-    auto inputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
+    auto outputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
+    auto inputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
 
     EXPECT_NO_THROW({ auto serialOutput = SerialHandler(logger, "/", UARTDevice::A, outputQueue, inputQueue); });
 }
@@ -46,7 +46,7 @@ TEST(SerialOutput, CreateSerialOutput_DeviceNotCharacterDevice_IsNonFatal) {
 // Null queues are still a programming error and surface as std::invalid_argument.
 TEST(SerialOutput, CreateSerialOutput_InvalidOutputQueue) {
     auto logger = std::make_shared<NiceMockLogger>();
-    auto inputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
+    auto inputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
 
     EXPECT_THROW(
         { auto serialOutput = SerialHandler(logger, "/dev/null", UARTDevice::A, nullptr, inputQueue); },
@@ -55,7 +55,7 @@ TEST(SerialOutput, CreateSerialOutput_InvalidOutputQueue) {
 
 TEST(SerialOutput, CreateSerialOutput_InvalidInputQueue) {
     auto logger = std::make_shared<NiceMockLogger>();
-    auto outputQueue = std::make_shared<MessageQueue<creatures::io::Message>>();
+    auto outputQueue = std::make_shared<SpscQueue<creatures::io::Message>>();
 
     EXPECT_THROW(
         { auto serialOutput = SerialHandler(logger, "/dev/null", UARTDevice::A, outputQueue, nullptr); },
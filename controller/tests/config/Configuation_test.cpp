@@ -130,3 +130,18 @@ TEST_F(ConfigurationTest, SetAndGetDynamixelLoadLimitSeconds) {
     config->setDynamixelLoadLimitSeconds(5.0);
     ASSERT_DOUBLE_EQ(config->getDynamixelLoadLimitSeconds(), 5.0);
 }
+
+TEST_F(ConfigurationTest, DeltaPositionFramesDefaultOff) {
+    ASSERT_FALSE(config->getDeltaPositionFrames());
+    ASSERT_EQ(config->getPositionDeadbandMicroseconds(), 0);
+    ASSERT_EQ(config->getPositionKeyframeIntervalMs(), DEFAULT_POSITION_KEYFRAME_INTERVAL_MS);
+}
+
+TEST_F(ConfigurationTest, SetAndGetDeltaPositionFrames) {
+    config->setDeltaPositionFrames(true);
+    config->setPositionDeadbandMicroseconds(4);
+    config->setPositionKeyframeIntervalMs(250);
+    ASSERT_TRUE(config->getDeltaPositionFrames());
+    ASSERT_EQ(config->getPositionDeadbandMicroseconds(), 4);
+    ASSERT_EQ(config->getPositionKeyframeIntervalMs(), 250);
+}
@@ -0,0 +1,78 @@
+
+#include <gtest/gtest.h>
+
+#include "controller/MotionLatency.h"
+
+using creatures::MotionLatency;
+using creatures::MotionTimestamps;
+
+TEST(MotionLatency, EachStageGetsItsShareOfTheTime) {
+    MotionLatency::reset();
+
+    MotionTimestamps timestamps;
+    timestamps.receivedNs = 1'000'000;
+    timestamps.handedOffNs = 1'050'000; //  50us in the socket
+    timestamps.mappedNs = 1'250'000;    // 200us through the creature
+    timestamps.tickedNs = 9'250'000;    //   8ms waiting for a tick
+    MotionLatency::recordWritten(timestamps, 9'500'000);
+
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::network).max(), 50u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::creature).max(), 200u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::tick).max(), 8000u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::serial).max(), 250u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::total).max(), 8500u);
+
+    auto report = MotionLatency::toJson();
+    EXPECT_EQ(report["frames"], 1u);
+    EXPECT_EQ(report["stages"]["tick"]["max_us"], 8000u);
+
+    MotionLatency::reset();
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::total).count(), 0u);
+}
+
+TEST(MotionLatency, UntracedMessagesAreIgnored) {
+    MotionLatency::reset();
+
+    MotionLatency::recordWritten(MotionTimestamps{}, MotionLatency::now());
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::total).count(), 0u);
+
+    // A stage with a missing stamp is skipped, but the rest still count
+    MotionTimestamps timestamps;
+    timestamps.receivedNs = 1'000'000;
+    timestamps.handedOffNs = 1'010'000;
+    MotionLatency::recordWritten(timestamps, 2'000'000);
+
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::network).count(), 1u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::tick).count(), 0u);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::total).count(), 1u);
+
+    MotionLatency::reset();
+}
+
+TEST(MotionLatency, AFrameIsOnlyRecordedOnceNoMatterHowManyModulesGetIt) {
+    MotionLatency::reset();
+
+    MotionTimestamps first;
+    first.receivedNs = 1'000'000;
+    MotionTimestamps second;
+    second.receivedNs = 2'000'000;
+
+    // Three modules write the first frame, and one of them is still behind
+    // when another has already moved on to the second
+    MotionLatency::recordWritten(first, 1'500'000);
+    MotionLatency::recordWritten(first, 1'600'000);
+    MotionLatency::recordWritten(second, 2'500'000);
+    MotionLatency::recordWritten(first, 2'600'000);
+    MotionLatency::recordWritten(second, 2'700'000);
+
+    const auto &total = MotionLatency::getHistogram(MotionLatency::Stage::total);
+    EXPECT_EQ(total.count(), 2u);
+    EXPECT_EQ(total.max(), 500u);
+
+    // Starting over forgets which frames we've seen
+    MotionLatency::reset();
+    MotionLatency::recordWritten(first, 1'500'000);
+    EXPECT_EQ(MotionLatency::getHistogram(MotionLatency::Stage::total).count(), 1u);
+
+    MotionLatency::reset();
+}
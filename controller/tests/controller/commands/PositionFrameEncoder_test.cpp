@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mocks/logging/MockLogger.h"
+
+#include "controller/commands/PositionFrameEncoder.h"
+#include "controller/commands/SetServoPositions.h"
+#include "controller/commands/tokens/ServoPosition.h"
+#include "creature/MotorType.h"
+#include "device/Servo.h"
+#include "device/ServoSpecifier.h"
+#include "device/ServoTable.h"
+#include "io/BinaryFraming.h"
+
+namespace {
+
+std::shared_ptr<Servo> makeServo(const std::shared_ptr<creatures::Logger> &logger, u16 pin,
+                                 creatures::creature::motor_type type, u16 defaultMicroseconds,
+                                 creatures::config::UARTDevice::module_name module = creatures::config::UARTDevice::A) {
+    auto location = ServoSpecifier(module, pin, type);
+    return std::make_shared<Servo>(logger, "servo" + std::to_string(pin), "Test Servo", location, 1000, 3000, 0.0,
+                                   false, 50, defaultMicroseconds);
+}
+
+std::string expectedFrame(const std::shared_ptr<creatures::Logger> &logger,
+                          const std::vector<std::shared_ptr<Servo>> &servos) {
+    auto command = creatures::commands::SetServoPositions(logger);
+    for (const auto &servo : servos) {
+        command.addServoPosition(creatures::ServoPosition(servo->getOutputLocation(), servo->getCurrentMicroseconds()));
+    }
+    return command.toMessageWithChecksum();
+}
+
+} // namespace
+
+TEST(PositionFrameEncoder, MatchesSetServoPositions) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1500),
+        makeServo(logger, 1, creatures::creature::motor_type::servo, 1000),
+        makeServo(logger, 7, creatures::creature::motor_type::servo, 2999),
+        makeServo(logger, 3, creatures::creature::motor_type::dynamixel, 2048),
+        makeServo(logger, 12, creatures::creature::motor_type::dynamixel, 1024),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+
+    EXPECT_EQ(encoder.getNumberOfServos(), 5);
+    EXPECT_EQ(std::string(encoder.encode()), expectedFrame(logger, servos));
+}
+
+TEST(PositionFrameEncoder, PicksUpNewPositionsEachFrame) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1500),
+        makeServo(logger, 1, creatures::creature::motor_type::servo, 1500),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+    auto first = std::string(encoder.encode());
+
+    // With no smoothing, one tick lands us right on the requested position
+    ASSERT_TRUE(servos[1]->move(MAX_POSITION).isSuccess());
+    servos[1]->calculateNextTick();
+
+    auto second = std::string(encoder.encode());
+    EXPECT_NE(first, second);
+    EXPECT_EQ(second, expectedFrame(logger, servos));
+    EXPECT_EQ(second.rfind("POS\t0 1500\t1 3000\tCS ", 0), 0);
+}
+
+TEST(PositionFrameEncoder, FrameLayout) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 2, creatures::creature::motor_type::servo, 1234),
+        makeServo(logger, 3, creatures::creature::motor_type::dynamixel, 2048),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+
+    u16 checksum = 0;
+    for (const char c : std::string("POS\t2 1234\tD3 2048")) {
+        checksum += c;
+    }
+    EXPECT_EQ(std::string(encoder.encode()), "POS\t2 1234\tD3 2048\tCS " + std::to_string(checksum));
+}
+
+TEST(PositionFrameEncoder, BinaryFrameLayout) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 2, creatures::creature::motor_type::servo, 1234),
+        makeServo(logger, 5, creatures::creature::motor_type::servo, 2000),
+        makeServo(logger, 3, creatures::creature::motor_type::dynamixel, 2048),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+    auto frame = std::string(encoder.encodeBinary());
+
+    // Wrapped in delimiters, with nothing but non-zero bytes in between
+    ASSERT_GE(frame.size(), 2);
+    EXPECT_EQ(frame.front(), '\0');
+    EXPECT_EQ(frame.back(), '\0');
+    EXPECT_EQ(frame.find('\0', 1), frame.size() - 1);
+
+    std::vector<u8> decoded(frame.size());
+    const size_t decodedLength = creatures::io::BinaryFraming::decodeCobs(
+        reinterpret_cast<const u8 *>(frame.data()) + 1, frame.size() - 2, decoded.data());
+    decoded.resize(decodedLength);
+
+    const std::vector<u8> body = {
+        creatures::io::BinaryFraming::PositionFrameType,
+        2, 2, 0xD2, 0x04, 5, 0xD0, 0x07, // Two PWM servos: 1234us and 2000us
+        1, 3, 0x00, 0x08,                // One Dynamixel: 2048
+    };
+    ASSERT_EQ(decoded.size(), body.size() + 2);
+    EXPECT_TRUE(std::equal(body.begin(), body.end(), decoded.begin()));
+
+    const u16 crc = creatures::io::BinaryFraming::crc16(body.data(), body.size());
+    EXPECT_EQ(decoded[body.size()], crc & 0xFF);
+    EXPECT_EQ(decoded[body.size() + 1], crc >> 8);
+}
+
+TEST(PositionFrameEncoder, DeltaFramesOnlyCarryWhatMoved) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1500),
+        makeServo(logger, 1, creatures::creature::motor_type::servo, 1500),
+        makeServo(logger, 3, creatures::creature::motor_type::dynamixel, 2048),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+
+    // Nothing's been sent yet, so everything goes
+    EXPECT_EQ(encoder.selectServos(0, false), 3);
+    EXPECT_EQ(std::string(encoder.encode()), expectedFrame(logger, servos));
+
+    // Nobody moved, so there's nothing to send...
+    EXPECT_EQ(encoder.selectServos(0, false), 0);
+
+    // ...unless it's time for a keyframe
+    EXPECT_EQ(encoder.selectServos(0, true), 3);
+    encoder.encode();
+
+    // Move one servo and only it goes out
+    ASSERT_TRUE(servos[1]->move(MAX_POSITION).isSuccess());
+    servos[1]->calculateNextTick();
+    EXPECT_EQ(encoder.selectServos(0, false), 1);
+    EXPECT_EQ(std::string(encoder.encode()), expectedFrame(logger, {servos[1]}));
+
+    // The binary frame picks the same servos
+    ASSERT_TRUE(servos[1]->move(MIN_POSITION).isSuccess());
+    servos[1]->calculateNextTick();
+    EXPECT_EQ(encoder.selectServos(0, false), 1);
+    auto frame = std::string(encoder.encodeBinary());
+    std::vector<u8> decoded(frame.size());
+    decoded.resize(creatures::io::BinaryFraming::decodeCobs(reinterpret_cast<const u8 *>(frame.data()) + 1,
+                                                            frame.size() - 2, decoded.data()));
+    ASSERT_EQ(decoded.size(), 1 + 1 + 3 + 1 + 2);
+    EXPECT_EQ(decoded[1], 1); // One PWM servo...
+    EXPECT_EQ(decoded[2], 1); // ...on pin 1
+    EXPECT_EQ(decoded[5], 0); // ...and no Dynamixels
+}
+
+TEST(PositionFrameEncoder, DeadbandIgnoresSmallMoves) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1500),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto encoder = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+    EXPECT_EQ(encoder.selectServos(100, false), 1);
+    encoder.encode();
+
+    // A full swing is well past any deadband
+    ASSERT_TRUE(servos[0]->move(MAX_POSITION).isSuccess());
+    servos[0]->calculateNextTick();
+    EXPECT_EQ(encoder.selectServos(100, false), 1);
+    EXPECT_EQ(encoder.selectServos(UINT16_MAX * 2, false), 0);
+}
+
+TEST(PositionFrameEncoder, OnlyReadsItsOwnModulesRows) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    std::vector<std::shared_ptr<Servo>> servos = {
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1100, creatures::config::UARTDevice::B),
+        makeServo(logger, 0, creatures::creature::motor_type::servo, 1500),
+        makeServo(logger, 4, creatures::creature::motor_type::dynamixel, 2048),
+        makeServo(logger, 1, creatures::creature::motor_type::servo, 1900, creatures::config::UARTDevice::B),
+    };
+
+    creatures::device::ServoTable table;
+    table.rebuild(servos);
+    auto moduleA = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::A, table);
+    auto moduleB = creatures::commands::PositionFrameEncoder(logger, creatures::config::UARTDevice::B, table);
+
+    EXPECT_EQ(moduleA.getNumberOfServos(), 2);
+    EXPECT_EQ(moduleB.getNumberOfServos(), 2);
+    EXPECT_EQ(std::string(moduleA.encode()), expectedFrame(logger, {servos[1], servos[2]}));
+    EXPECT_EQ(std::string(moduleB.encode()), expectedFrame(logger, {servos[0], servos[3]}));
+
+    // Positions are read from the table every frame
+    ASSERT_TRUE(servos[3]->move(MAX_POSITION).isSuccess());
+    servos[3]->calculateNextTick();
+    EXPECT_EQ(moduleA.selectServos(0, false), 0);
+    EXPECT_EQ(moduleB.selectServos(0, false), 1);
+    EXPECT_EQ(std::string(moduleB.encode()), expectedFrame(logger, {servos[3]}));
+}
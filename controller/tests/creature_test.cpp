@@ -1,6 +1,10 @@
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "controller/InputFrame.h"
 #include "creature/Creature.h"
 #include "creature/Parrot.h"
 #include "creature/CreatureException.h"
@@ -56,4 +60,67 @@ TEST(Creature, ServoMap_DuplicateId) {
     EXPECT_THROW({parrot->addServo("a", std::make_shared<Servo>(logger, "a", "Servo B (but a)", location2, 1000, 3000, 0.90, false, 50, 2000));
                  }, creatures::CreatureException);
 
-}
\ No newline at end of file
+}
+
+namespace {
+
+std::shared_ptr<Parrot> makeFlyableParrot(const std::shared_ptr<creatures::Logger> &logger) {
+    auto parrot = std::make_shared<Parrot>(logger);
+    parrot->setName("doug");
+    parrot->setPositionMin(MIN_POSITION);
+    parrot->setPositionMax(MAX_POSITION);
+    parrot->setPositionDefault(DEFAULT_POSITION);
+    parrot->setServoUpdateFrequencyHz(50);
+
+    const std::vector<std::string> inputNames = {"head_height", "head_tilt", "neck_rotate", "body_lean",
+                                                 "beak",        "chest",     "stand_rotate"};
+    for (size_t i = 0; i < inputNames.size(); i++) {
+        parrot->addInput(creatures::Input(inputNames[i], static_cast<u16>(i + 1), 1, 0));
+    }
+
+    const std::vector<std::string> servoIds = {"neck_left", "neck_right", "neck_rotate", "body_lean", "beak"};
+    for (size_t i = 0; i < servoIds.size(); i++) {
+        auto location = ServoSpecifier(creatures::config::UARTDevice::A, static_cast<u16>(i));
+        parrot->addServo(servoIds[i], std::make_shared<Servo>(logger, servoIds[i], servoIds[i], location, 1000, 3000,
+                                                              0.90, false, 50, 2000));
+    }
+
+    parrot->applyConfig(nlohmann::json{{"head_offset_max", 0.4}});
+    return parrot;
+}
+
+} // namespace
+
+TEST(Creature, PreFlightResolvesHandlesAndMapsFrames) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto parrot = makeFlyableParrot(logger);
+
+    ASSERT_TRUE(parrot->performPreFlightCheck().isSuccess());
+
+    // Inputs were added on slots 1-7 in required order, so beak is slot 5 and
+    // body_lean is slot 4
+    creatures::InputFrame frame;
+    frame.slots[5] = 255;
+    frame.slots[4] = 0;
+    parrot->mapInputsToServos(frame);
+
+    EXPECT_EQ(3000, parrot->getServo("beak")->getDesiredMicroseconds());
+    EXPECT_EQ(1000, parrot->getServo("body_lean")->getDesiredMicroseconds());
+
+    frame.slots[5] = 0;
+    parrot->mapInputsToServos(frame);
+    EXPECT_EQ(1000, parrot->getServo("beak")->getDesiredMicroseconds());
+}
+
+TEST(Creature, PreFlightFailsOnAMissingInput) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto parrot = std::make_shared<Parrot>(logger);
+    parrot->applyConfig(nlohmann::json{{"head_offset_max", 0.4}});
+    parrot->addInput(creatures::Input("head_height", 1, 1, 0));
+
+    auto result = parrot->performPreFlightCheck();
+    ASSERT_FALSE(result.isSuccess());
+    EXPECT_NE(std::string::npos, result.getError()->getMessage().find("head_tilt"));
+}
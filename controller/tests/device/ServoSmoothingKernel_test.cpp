@@ -0,0 +1,73 @@
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "controller-config.h"
+
+#include "device/ServoSmoothingKernel.h"
+
+using creatures::device::smoothedMicroseconds;
+using creatures::device::smoothServoPositions;
+using creatures::device::smoothServoPositionsScalar;
+
+TEST(ServoSmoothingKernel, MatchesTheScalarPathOnRandomServos) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<u32> position(0, 4095);
+    std::uniform_real_distribution<float> smoothing(0.0f, 1.0f);
+
+    // Odd sizes too, so the leftovers after the last full vector get checked
+    for (size_t count : {0, 1, 2, 3, 4, 5, 7, 8, 9, 31, 64, 257}) {
+        std::vector<u32> desired(count);
+        std::vector<u32> current(count);
+        std::vector<float> smoothingValues(count);
+        for (size_t i = 0; i < count; i++) {
+            desired[i] = position(rng);
+            current[i] = position(rng);
+            smoothingValues[i] = smoothing(rng);
+        }
+
+        // Run a bunch of ticks so the positions actually walk around
+        std::vector<u32> expected = current;
+        for (int tick = 0; tick < 50; tick++) {
+            smoothServoPositionsScalar(desired.data(), expected.data(), smoothingValues.data(), count);
+            smoothServoPositions(desired.data(), current.data(), smoothingValues.data(), count);
+            ASSERT_EQ(expected, current) << "count " << count << ", tick " << tick << " ("
+                                         << creatures::device::smoothingKernelName() << ")";
+        }
+    }
+}
+
+TEST(ServoSmoothingKernel, RoundsHalvesLikeLround) {
+    // Each of these lands right on a half (or just shy of one)
+    const std::vector<u32> desired = {1, 2, 1001, 2000, 0, 3, 1500, 7};
+    std::vector<u32> current = {2, 3, 1000, 2001, 1, 4, 1501, 8};
+    const std::vector<float> smoothingValues = {0.5f, 0.5f, 0.5f, 0.5f, 0.49999997f, 0.49999997f, 0.5f, 0.5f};
+
+    std::vector<u32> expected;
+    for (size_t i = 0; i < desired.size(); i++) {
+        expected.push_back(static_cast<u32>(lround((static_cast<double>(desired[i]) * (1.0 - smoothingValues[i])) +
+                                                   (static_cast<double>(current[i]) * smoothingValues[i]))));
+    }
+
+    smoothServoPositions(desired.data(), current.data(), smoothingValues.data(), desired.size());
+    EXPECT_EQ(expected, current);
+}
+
+TEST(ServoSmoothingKernel, ZeroSmoothingPassesStraightThrough) {
+    // This is how the Dynamixels skip the smoothing
+    const std::vector<u32> desired = {0, 1, 1500, 2048, 4095, 3000, 17, 900, 2500};
+    std::vector<u32> current = {4095, 3000, 10, 0, 1, 2, 3, 4, 5};
+    const std::vector<float> smoothingValues(desired.size(), 0.0f);
+
+    smoothServoPositions(desired.data(), current.data(), smoothingValues.data(), desired.size());
+    EXPECT_EQ(desired, current);
+}
+
+TEST(ServoSmoothingKernel, SingleStepMatchesTheColumn) {
+    EXPECT_EQ(1750u, smoothedMicroseconds(2000, 1500, 0.5f));
+    EXPECT_EQ(2000u, smoothedMicroseconds(2000, 1500, 0.0f));
+    EXPECT_EQ(1500u, smoothedMicroseconds(2000, 1500, 1.0f));
+}
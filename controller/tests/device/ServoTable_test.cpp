@@ -0,0 +1,116 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "mocks/logging/MockLogger.h"
+
+#include "config/UARTDevice.h"
+#include "creature/MotorType.h"
+#include "device/Servo.h"
+#include "device/ServoSpecifier.h"
+#include "device/ServoTable.h"
+
+using creatures::config::UARTDevice;
+using creatures::creature::motor_type;
+using creatures::device::ServoTable;
+
+namespace {
+
+std::shared_ptr<Servo> makeServo(const std::shared_ptr<creatures::Logger> &logger, UARTDevice::module_name module,
+                                 u16 pin, motor_type type, float smoothing) {
+    auto location = ServoSpecifier(module, pin, type);
+    return std::make_shared<Servo>(logger, "servo" + std::to_string(pin), "Test Servo", location, 1000, 3000,
+                                   smoothing, false, 50, 1500);
+}
+
+} // namespace
+
+TEST(ServoTable, SortsByModuleAndWorksOutSpans) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto b3 = makeServo(logger, UARTDevice::B, 3, motor_type::servo, 0.9f);
+    auto a7 = makeServo(logger, UARTDevice::A, 7, motor_type::servo, 0.9f);
+    auto aD1 = makeServo(logger, UARTDevice::A, 1, motor_type::dynamixel, 0.0f);
+    auto a2 = makeServo(logger, UARTDevice::A, 2, motor_type::servo, 0.9f);
+
+    ServoTable table;
+    table.rebuild({b3, a7, aD1, a2});
+
+    ASSERT_EQ(table.size(), 4);
+    EXPECT_EQ(table.getServo(0), a2);
+    EXPECT_EQ(table.getServo(1), a7);
+    EXPECT_EQ(table.getServo(2), aD1);
+    EXPECT_EQ(table.getServo(3), b3);
+
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::A).first, 0);
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::A).count, 3);
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::B).first, 3);
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::B).count, 1);
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::C).count, 0);
+    EXPECT_EQ(table.getModuleSpan(UARTDevice::invalid_module).count, 0);
+}
+
+TEST(ServoTable, MovesLandInTheTable) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto servo = makeServo(logger, UARTDevice::A, 0, motor_type::servo, 0.0f);
+
+    ServoTable table;
+    table.rebuild({servo});
+
+    ASSERT_TRUE(servo->move(MAX_POSITION).isSuccess());
+    EXPECT_EQ(table.desiredMicroseconds[0], 3000);
+    EXPECT_EQ(servo->getDesiredMicroseconds(), 3000);
+
+    table.calculateNextTick();
+    EXPECT_EQ(table.currentMicroseconds[0], 3000);
+    EXPECT_EQ(servo->getCurrentMicroseconds(), 3000);
+}
+
+TEST(ServoTable, SmoothsExactlyLikeTheServoDoes) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    // Two identical sets of servos, one in a table and one on its own
+    std::vector<std::shared_ptr<Servo>> bound;
+    std::vector<std::shared_ptr<Servo>> loose;
+    const std::vector<float> smoothing = {0.0f, 0.5f, 0.9f, 0.95f, 0.99f};
+    for (u16 i = 0; i < smoothing.size(); i++) {
+        bound.push_back(makeServo(logger, UARTDevice::A, i, motor_type::servo, smoothing[i]));
+        loose.push_back(makeServo(logger, UARTDevice::A, i, motor_type::servo, smoothing[i]));
+    }
+    bound.push_back(makeServo(logger, UARTDevice::A, 9, motor_type::dynamixel, 0.9f));
+    loose.push_back(makeServo(logger, UARTDevice::A, 9, motor_type::dynamixel, 0.9f));
+
+    ServoTable table;
+    table.rebuild(bound);
+
+    for (int tick = 0; tick < 200; tick++) {
+        const u16 target = (tick / 40) % 2 == 0 ? MAX_POSITION : static_cast<u16>(tick % MAX_POSITION);
+        for (size_t i = 0; i < bound.size(); i++) {
+            ASSERT_TRUE(bound[i]->move(target).isSuccess());
+            ASSERT_TRUE(loose[i]->move(target).isSuccess());
+            loose[i]->calculateNextTick();
+        }
+        table.calculateNextTick();
+
+        for (size_t i = 0; i < bound.size(); i++) {
+            ASSERT_EQ(bound[i]->getCurrentMicroseconds(), loose[i]->getCurrentMicroseconds())
+                << "servo " << i << " on tick " << tick;
+        }
+    }
+}
+
+TEST(ServoTable, ServosKeepTheirPositionsWhenTheTableGoesAway) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto servo = makeServo(logger, UARTDevice::A, 0, motor_type::servo, 0.0f);
+
+    {
+        ServoTable table;
+        table.rebuild({servo});
+        ASSERT_TRUE(servo->move(MIN_POSITION).isSuccess());
+        table.calculateNextTick();
+    }
+
+    EXPECT_EQ(servo->getDesiredMicroseconds(), 1000);
+    EXPECT_EQ(servo->getCurrentMicroseconds(), 1000);
+}
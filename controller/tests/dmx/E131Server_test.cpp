@@ -26,4 +26,88 @@ TEST(E131Server, StartFailsWithoutController) {
 
     EXPECT_THROW(server.start(), creatures::dmx::E131Exception);
 
-}
\ No newline at end of file
+}
+namespace {
+
+e131_packet_t makePacket(u16 universe, u8 sequence, u8 value) {
+    e131_packet_t packet;
+    e131_pkt_init(&packet, universe, 16);
+    packet.frame.seq_number = sequence;
+    packet.dmp.prop_val[1] = value;
+    return packet;
+}
+
+} // namespace
+
+TEST(E131Server, NewestPacketInABatchWins) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    std::vector<e131_packet_t> packets = {makePacket(42, 10, 1), makePacket(42, 11, 2), makePacket(42, 12, 3)};
+    std::vector<u32> lengths(packets.size(), sizeof(e131_packet_t));
+
+    u8 lastSequence = 9;
+    u64 skipped = 0;
+    const auto *newest = creatures::dmx::E131Client::newestPacket(logger, packets.data(), lengths.data(),
+                                                                   packets.size(), 42, lastSequence, skipped);
+
+    ASSERT_NE(nullptr, newest);
+    EXPECT_EQ(3, newest->dmp.prop_val[1]);
+    EXPECT_EQ(12, lastSequence);
+    EXPECT_EQ(2u, skipped);
+}
+
+TEST(E131Server, StaleAndForeignPacketsAreIgnored) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    // A good one, then one for someone else's universe, a late one, and a runt
+    std::vector<e131_packet_t> packets = {makePacket(42, 20, 1), makePacket(43, 21, 2), makePacket(42, 15, 3),
+                                          makePacket(42, 22, 4)};
+    std::vector<u32> lengths(packets.size(), sizeof(e131_packet_t));
+    lengths[3] = 10;
+
+    u8 lastSequence = 19;
+    u64 skipped = 0;
+    const auto *newest = creatures::dmx::E131Client::newestPacket(logger, packets.data(), lengths.data(),
+                                                                   packets.size(), 42, lastSequence, skipped);
+
+    ASSERT_NE(nullptr, newest);
+    EXPECT_EQ(1, newest->dmp.prop_val[1]);
+    EXPECT_EQ(0u, skipped);
+}
+
+TEST(E131Server, NothingUsableMeansNoPacket) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    std::vector<e131_packet_t> packets = {makePacket(43, 1, 1)};
+    std::vector<u32> lengths(packets.size(), sizeof(e131_packet_t));
+
+    u8 lastSequence = 0;
+    u64 skipped = 0;
+    EXPECT_EQ(nullptr, creatures::dmx::E131Client::newestPacket(logger, packets.data(), lengths.data(),
+                                                                 packets.size(), 42, lastSequence, skipped));
+}
+
+TEST(E131Server, RejectedPacketsAreCounted) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    // Same batch as above: one from another universe (not a rejection), one
+    // late, and one runt
+    std::vector<e131_packet_t> packets = {makePacket(42, 20, 1), makePacket(43, 21, 2), makePacket(42, 15, 3),
+                                          makePacket(42, 22, 4)};
+    std::vector<u32> lengths(packets.size(), sizeof(e131_packet_t));
+    lengths[3] = 10;
+
+    u8 lastSequence = 19;
+    u64 skipped = 0;
+    creatures::dmx::E131Client::PacketRejections rejected;
+    const auto *newest = creatures::dmx::E131Client::newestPacket(logger, packets.data(), lengths.data(),
+                                                                   packets.size(), 42, lastSequence, skipped, rejected);
+
+    ASSERT_NE(nullptr, newest);
+    EXPECT_EQ(1u, rejected.invalid);
+    EXPECT_EQ(1u, rejected.outOfOrder);
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "io/BinaryFraming.h"
+
+using namespace creatures::io;
+
+namespace {
+
+std::vector<u8> encode(const std::vector<u8> &raw) {
+    std::vector<u8> out(BinaryFraming::maxCobsLength(raw.size()));
+    out.resize(BinaryFraming::encodeCobs(raw.data(), raw.size(), out.data()));
+    return out;
+}
+
+std::vector<u8> decode(const std::vector<u8> &encoded) {
+    std::vector<u8> out(encoded.size());
+    out.resize(BinaryFraming::decodeCobs(encoded.data(), encoded.size(), out.data()));
+    return out;
+}
+
+} // namespace
+
+TEST(BinaryFraming, Crc16KnownAnswer) {
+    // The standard check value for CRC-16/CCITT-FALSE
+    const std::string check = "123456789";
+    EXPECT_EQ(BinaryFraming::crc16(reinterpret_cast<const u8 *>(check.data()), check.size()), 0x29B1);
+}
+
+TEST(BinaryFraming, CobsKnownVectors) {
+    EXPECT_EQ(encode({0x00}), (std::vector<u8>{0x01, 0x01}));
+    EXPECT_EQ(encode({0x00, 0x00}), (std::vector<u8>{0x01, 0x01, 0x01}));
+    EXPECT_EQ(encode({0x11, 0x22, 0x00, 0x33}), (std::vector<u8>{0x03, 0x11, 0x22, 0x02, 0x33}));
+    EXPECT_EQ(encode({0x11, 0x00, 0x00, 0x00}), (std::vector<u8>{0x02, 0x11, 0x01, 0x01, 0x01}));
+}
+
+TEST(BinaryFraming, CobsRoundTripsLongRuns) {
+    // Long enough to need more than one 254 byte run
+    std::vector<u8> raw;
+    for (int i = 0; i < 600; i++) {
+        raw.push_back(static_cast<u8>(i % 7 == 0 ? 0 : i));
+    }
+    std::vector<u8> allNonZero(300, 0x42);
+
+    for (const auto &input : {raw, allNonZero}) {
+        auto encoded = encode(input);
+        EXPECT_LE(encoded.size(), BinaryFraming::maxCobsLength(input.size()));
+        EXPECT_EQ(std::count(encoded.begin(), encoded.end(), 0), 0);
+        EXPECT_EQ(decode(encoded), input);
+    }
+}
+
+TEST(BinaryFraming, CobsRejectsGarbage) {
+    // A zero can't show up inside a block, and a run can't go past the end
+    EXPECT_EQ(decode({0x02, 0x00}).size(), 0);
+    EXPECT_EQ(decode({0x05, 0x11, 0x22}).size(), 0);
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "io/LineSplitter.h"
+
+using creatures::io::LineSplitter;
+
+namespace {
+
+/**
+ * Feed the splitter some bytes the way the serial reader does, and gather up
+ * whatever lines come out
+ */
+std::vector<std::string> feed(LineSplitter &splitter, std::string_view bytes) {
+    std::vector<std::string> lines;
+    while (!bytes.empty()) {
+        auto space = splitter.writable();
+        const size_t chunk = std::min(space.size(), bytes.size());
+        std::memcpy(space.data(), bytes.data(), chunk);
+        splitter.commit(chunk, [&lines](std::string_view line) { lines.emplace_back(line); });
+        bytes.remove_prefix(chunk);
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(LineSplitter, SplitsAWholeBurstInOneGo) {
+    LineSplitter splitter;
+    EXPECT_EQ(feed(splitter, "LOG\thi\nPONG\t1\nSTATS\t2\n"),
+              (std::vector<std::string>{"LOG\thi", "PONG\t1", "STATS\t2"}));
+    EXPECT_EQ(splitter.pending(), 0u);
+}
+
+TEST(LineSplitter, HoldsOnToHalfALineUntilTheRestShowsUp) {
+    LineSplitter splitter;
+    EXPECT_TRUE(feed(splitter, "BSEN").empty());
+    EXPECT_EQ(splitter.pending(), 4u);
+    EXPECT_EQ(feed(splitter, "SE\t1\nLOG"), (std::vector<std::string>{"BSENSE\t1"}));
+    EXPECT_EQ(feed(splitter, "\tbye\n"), (std::vector<std::string>{"LOG\tbye"}));
+}
+
+TEST(LineSplitter, DropsCarriageReturnsAndEmptyLines) {
+    LineSplitter splitter;
+    EXPECT_EQ(feed(splitter, "READY\t1\r\n\r\n\nPONG\r"), (std::vector<std::string>{"READY\t1"}));
+
+    // The \r ended up split from its \n
+    EXPECT_EQ(feed(splitter, "\n"), (std::vector<std::string>{"PONG"}));
+}
+
+TEST(LineSplitter, ThrowsOutLinesThatAreTooLong) {
+    LineSplitter splitter(64, 16);
+
+    // Long enough to overflow across a few reads before its newline shows up
+    const std::string tooLong(100, 'x');
+    EXPECT_EQ(feed(splitter, "LOG\tshort\n" + tooLong + "\nLOG\tafter\n"),
+              (std::vector<std::string>{"LOG\tshort", "LOG\tafter"}));
+    EXPECT_EQ(splitter.getLinesTooLong(), 1u);
+
+    // A line right at the limit is fine
+    EXPECT_EQ(feed(splitter, std::string(16, 'y') + "\n"), (std::vector<std::string>{std::string(16, 'y')}));
+    EXPECT_EQ(splitter.getLinesTooLong(), 1u);
+}
+
+TEST(LineSplitter, ThrowsOutLinesThatAreTooLongEvenInOneRead) {
+    LineSplitter splitter(64, 16);
+
+    // The whole thing fits in the buffer, newline and all
+    const std::string tooLong(40, 'x');
+    EXPECT_EQ(feed(splitter, tooLong + "\nLOG\tafter\n"), (std::vector<std::string>{"LOG\tafter"}));
+    EXPECT_EQ(splitter.getLinesTooLong(), 1u);
+
+    // The \r doesn't count against it
+    EXPECT_EQ(feed(splitter, std::string(16, 'y') + "\r\n"), (std::vector<std::string>{std::string(16, 'y')}));
+    EXPECT_EQ(splitter.getLinesTooLong(), 1u);
+}
+
+TEST(LineSplitter, AlwaysHasRoomToRead) {
+    LineSplitter splitter(64, 16);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_FALSE(splitter.writable().empty());
+        feed(splitter, "ab\ncdefg");
+    }
+}
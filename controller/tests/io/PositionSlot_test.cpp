@@ -0,0 +1,63 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "config/UARTDevice.h"
+#include "io/Message.h"
+#include "io/PositionSlot.h"
+
+using creatures::config::UARTDevice;
+using creatures::io::Message;
+using creatures::io::PositionSlot;
+
+TEST(PositionSlot, StartsEmpty) {
+    PositionSlot slot;
+    EXPECT_FALSE(slot.take().has_value());
+    EXPECT_EQ(slot.offered(), 0u);
+    EXPECT_EQ(slot.replaced(), 0u);
+}
+
+TEST(PositionSlot, NewestFrameWins) {
+    PositionSlot slot;
+
+    EXPECT_TRUE(slot.offer(Message(UARTDevice::A, "POS\t1")));
+    EXPECT_FALSE(slot.offer(Message(UARTDevice::A, "POS\t2")));
+    EXPECT_FALSE(slot.offer(Message(UARTDevice::A, "POS\t3")));
+
+    auto taken = slot.take();
+    ASSERT_TRUE(taken.has_value());
+    EXPECT_EQ(taken->payload, "POS\t3");
+    EXPECT_FALSE(slot.take().has_value());
+
+    // Once it's gone out, the next one isn't replacing anything
+    EXPECT_TRUE(slot.offer(Message(UARTDevice::A, "POS\t4")));
+    EXPECT_EQ(slot.offered(), 4u);
+    EXPECT_EQ(slot.replaced(), 2u);
+}
+
+TEST(PositionSlot, CopiedFramesReuseTheBufferTheWriterGaveBack) {
+    PositionSlot slot;
+    const std::string frame(200, 'x');
+    const creatures::MotionTimestamps timestamps{1, 2, 3, 4};
+
+    EXPECT_TRUE(slot.offer(UARTDevice::B, frame, creatures::io::SerialFraming::binary, timestamps));
+    auto taken = slot.take();
+    ASSERT_TRUE(taken.has_value());
+    EXPECT_EQ(taken->module, UARTDevice::B);
+    EXPECT_EQ(taken->payload, frame);
+    EXPECT_EQ(taken->framing, creatures::io::SerialFraming::binary);
+    EXPECT_EQ(taken->timestamps.mappedNs, 3);
+    EXPECT_TRUE(taken->isPosition);
+
+    // Once it's been written, the next frame goes right back into the same buffer
+    const char *buffer = taken->payload.data();
+    slot.recycle(std::move(*taken));
+    EXPECT_TRUE(slot.offer(UARTDevice::B, std::string(150, 'y'), creatures::io::SerialFraming::binary, timestamps));
+    EXPECT_FALSE(slot.offer(UARTDevice::B, std::string(180, 'z'), creatures::io::SerialFraming::binary, timestamps));
+
+    taken = slot.take();
+    ASSERT_TRUE(taken.has_value());
+    EXPECT_EQ(taken->payload, std::string(180, 'z'));
+    EXPECT_EQ(taken->payload.data(), buffer);
+    EXPECT_EQ(slot.replaced(), 1u);
+}
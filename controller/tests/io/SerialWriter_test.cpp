@@ -0,0 +1,209 @@
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "config/UARTDevice.h"
+#include "io/Message.h"
+#include "io/MessageRouter.h"
+#include "io/PositionSlot.h"
+#include "io/SerialPortStats.h"
+#include "io/SerialWriter.h"
+#include "util/SpscQueue.h"
+
+#include "mocks/logging/MockLogger.h"
+
+using creatures::config::UARTDevice;
+using creatures::io::Message;
+using creatures::io::MessageRouter;
+using creatures::io::PositionSlot;
+using creatures::io::SerialFraming;
+using creatures::io::SerialPortStats;
+using creatures::io::SerialWriter;
+
+namespace {
+
+/**
+ * A non-blocking pipe standing in for a serial port that's slower than we are
+ */
+class SlowPort {
+  public:
+    SlowPort() {
+        EXPECT_EQ(pipe(fds), 0);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(fds[1], F_SETFL, O_NONBLOCK);
+#ifdef F_SETPIPE_SZ
+        fcntl(fds[1], F_SETPIPE_SZ, 4096); // As small as it goes
+#endif
+    }
+
+    ~SlowPort() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    int writeEnd() const { return fds[1]; }
+
+    /**
+     * Read a little at a time until we've got `bytes`
+     */
+    std::string drain(size_t bytes) {
+        std::string received;
+        char chunk[512];
+        while (received.size() < bytes) {
+            const ssize_t got = read(fds[0], chunk, sizeof(chunk));
+            if (got > 0) {
+                received.append(chunk, static_cast<size_t>(got));
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return received;
+    }
+
+  private:
+    int fds[2] = {-1, -1};
+};
+
+} // namespace
+
+TEST(SerialWriter, BatchesGoOutInOrderWithNewlinesOnlyOnText) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto stats = std::make_shared<SerialPortStats>();
+    auto queue = std::make_shared<creatures::SpscQueue<Message>>(16);
+    SlowPort port;
+
+    SerialWriter writer(logger, "pipe", UARTDevice::A, port.writeEnd(), queue, stats);
+
+    std::vector<Message> batch = {Message(UARTDevice::A, "PING\t1"),
+                                  Message(UARTDevice::A, std::string("\0\x03\x01\x02\0", 5), SerialFraming::binary),
+                                  Message(UARTDevice::A, ""), Message(UARTDevice::A, "POS\t1 2")};
+    ASSERT_TRUE(writer.writeMessages(batch));
+
+    const std::string expected = std::string("PING\t1\n") + std::string("\0\x03\x01\x02\0", 5) + "POS\t1 2\n";
+    EXPECT_EQ(port.drain(expected.size()), expected);
+    EXPECT_EQ(stats->messagesWritten.load(), 3u);
+    EXPECT_EQ(stats->bytesWritten.load(), expected.size());
+    EXPECT_EQ(stats->shortWrites.load(), 0u);
+}
+
+TEST(SerialWriter, PicksUpWhereAShortWriteLeftOff) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto stats = std::make_shared<SerialPortStats>();
+    auto queue = std::make_shared<creatures::SpscQueue<Message>>(16);
+    SlowPort port;
+
+    SerialWriter writer(logger, "pipe", UARTDevice::A, port.writeEnd(), queue, stats);
+
+    // Way more than the pipe can hold at once
+    std::vector<Message> batch;
+    std::string expected;
+    for (int i = 0; i < 8; i++) {
+        std::string line = "LOG\t" + std::string(20000, static_cast<char>('a' + i));
+        expected += line + "\n";
+        batch.emplace_back(UARTDevice::A, line);
+    }
+
+    std::string received;
+    std::thread reader([&] { received = port.drain(expected.size()); });
+    const bool written = writer.writeMessages(batch);
+    reader.join();
+
+    ASSERT_TRUE(written);
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(stats->messagesWritten.load(), 8u);
+    EXPECT_EQ(stats->bytesWritten.load(), expected.size());
+    EXPECT_GT(stats->shortWrites.load(), 0u);
+}
+
+TEST(SerialWriter, GivesUpWhenThePortIsGone) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto stats = std::make_shared<SerialPortStats>();
+    auto queue = std::make_shared<creatures::SpscQueue<Message>>(16);
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    close(fds[0]); // Nobody's listening
+    signal(SIGPIPE, SIG_IGN);
+
+    SerialWriter writer(logger, "pipe", UARTDevice::A, fds[1], queue, stats);
+    EXPECT_FALSE(writer.writeMessages({Message(UARTDevice::A, "PING\t1")}));
+    EXPECT_EQ(stats->messagesWritten.load(), 0u);
+
+    close(fds[1]);
+}
+
+TEST(SerialWriter, ControlMessagesGoFirstAndOnlyTheNewestPositionGoesOut) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto stats = std::make_shared<SerialPortStats>();
+    auto queue = std::make_shared<creatures::SpscQueue<Message>>(16);
+    auto incoming = std::make_shared<creatures::SpscQueue<Message>>(16);
+    auto pendingPosition = std::make_shared<PositionSlot>();
+    SlowPort port;
+
+    MessageRouter router(logger);
+    ASSERT_TRUE(router.registerServoModuleHandler(UARTDevice::A, incoming, queue, pendingPosition).isSuccess());
+    SerialWriter writer(logger, "pipe", UARTDevice::A, port.writeEnd(), queue, stats, nullptr, pendingPosition);
+
+    // A stalled writer, and the controller keeps going
+    auto position = [](const std::string &payload) {
+        Message message(UARTDevice::A, payload);
+        message.isPosition = true;
+        return message;
+    };
+    router.sendMessageToCreature(Message(UARTDevice::A, "INIT\t1"));
+    router.sendMessageToCreature(position("POS\t1"));
+    router.sendMessageToCreature(Message(UARTDevice::A, "PING\t1"));
+    router.sendMessageToCreature(position("POS\t2"));
+    router.sendMessageToCreature(position("POS\t3"));
+
+    std::vector<Message> batch;
+    writer.gatherBatch(batch);
+    ASSERT_TRUE(writer.writeMessages(batch));
+
+    const std::string expected = "INIT\t1\nPING\t1\nPOS\t3\n";
+    EXPECT_EQ(port.drain(expected.size()), expected);
+    EXPECT_EQ(stats->messagesWritten.load(), 3u);
+    EXPECT_EQ(pendingPosition->replaced(), 2u);
+    EXPECT_EQ(router.getPositionsReplaced(), 2u);
+
+    // Nothing's left over for next time
+    batch.clear();
+    writer.gatherBatch(batch);
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST(SerialWriter, TheNewestCopiedInPositionGoesOut) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    auto stats = std::make_shared<SerialPortStats>();
+    auto queue = std::make_shared<creatures::SpscQueue<Message>>(16);
+    auto incoming = std::make_shared<creatures::SpscQueue<Message>>(16);
+    auto pendingPosition = std::make_shared<PositionSlot>();
+    SlowPort port;
+
+    MessageRouter router(logger);
+    ASSERT_TRUE(router.registerServoModuleHandler(UARTDevice::A, incoming, queue, pendingPosition).isSuccess());
+    SerialWriter writer(logger, "pipe", UARTDevice::A, port.writeEnd(), queue, stats, nullptr, pendingPosition);
+
+    ASSERT_TRUE(router.sendPositionToCreature(UARTDevice::A, "POS\t1", creatures::io::SerialFraming::text, {})
+                    .isSuccess());
+    ASSERT_TRUE(router.sendPositionToCreature(UARTDevice::A, "POS\t2", creatures::io::SerialFraming::text, {})
+                    .isSuccess());
+    EXPECT_FALSE(router.sendPositionToCreature(UARTDevice::B, "POS\t3", creatures::io::SerialFraming::text, {})
+                     .isSuccess());
+
+    // Only one knock on the writer's door for the both of them
+    EXPECT_EQ(queue->size(), 1u);
+
+    std::vector<Message> batch;
+    writer.gatherBatch(batch);
+    ASSERT_TRUE(writer.writeMessages(batch));
+    EXPECT_EQ(port.drain(6), "POS\t2\n");
+    EXPECT_EQ(router.getPositionsReplaced(), 1u);
+}
@@ -1,8 +1,9 @@
 
-#include <string>
+#include <string_view>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "io/handlers/FirmwareStats.h"
 #include "io/handlers/StatsMessage.h"
 #include "io/handlers/StatsHandler.h"
 #include "mocks/logging/MockLogger.h"
@@ -23,7 +24,7 @@ TEST(StatsHandler, HandleValid) {
 
     auto logger = std::make_shared<creatures::NiceMockLogger>();
 
-    auto tokens = std::vector<std::string>();
+    auto tokens = std::vector<std::string_view>();
     tokens.emplace_back("STATS");
     tokens.emplace_back("FREE_HEAP 20394");
 
@@ -32,3 +33,21 @@ TEST(StatsHandler, HandleValid) {
     EXPECT_NO_FATAL_FAILURE(statsHandler.handle(logger, tokens));
 
 }
+
+TEST(StatsHandler, KeepsTheNewestReportForItsModule) {
+
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+
+    auto tokens = std::vector<std::string_view>();
+    tokens.emplace_back("STATS");
+    tokens.emplace_back("HEAP_FREE 20394");
+    tokens.emplace_back("POS_PROC 42");
+
+    auto statsHandler = creatures::StatsHandler(creatures::config::UARTDevice::C);
+    statsHandler.handle(logger, tokens);
+
+    auto latest = creatures::FirmwareStats::getLatest();
+    ASSERT_EQ(1u, latest.count(creatures::config::UARTDevice::C));
+    EXPECT_EQ(20394u, latest.at(creatures::config::UARTDevice::C).freeHeap);
+    EXPECT_EQ(42u, latest.at(creatures::config::UARTDevice::C).positionMessagesProcessed);
+}
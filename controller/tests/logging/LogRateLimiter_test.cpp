@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "logging/LogRateLimiter.h"
+#include "mocks/logging/MockLogger.h"
+
+using ::testing::_;
+using ::testing::HasSubstr;
+using namespace std::chrono_literals;
+
+TEST(LogRateLimiter, LetsTheFirstFewThroughEachSecond) {
+    creatures::LogRateLimiter limiter(3);
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t suppressed = 0;
+
+    int allowed = 0;
+    for (int i = 0; i < 10; i++) {
+        if (limiter.allow(suppressed, start + std::chrono::milliseconds(i))) {
+            allowed++;
+        }
+        EXPECT_EQ(suppressed, 0u);
+    }
+    EXPECT_EQ(allowed, 3);
+
+    // A second later we get a fresh budget, and hear about the seven we missed
+    EXPECT_TRUE(limiter.allow(suppressed, start + 1100ms));
+    EXPECT_EQ(suppressed, 7u);
+
+    EXPECT_TRUE(limiter.allow(suppressed, start + 1200ms));
+    EXPECT_EQ(suppressed, 0u);
+}
+
+TEST(LogRateLimiter, QuietSecondsHaveNothingToReport) {
+    creatures::LogRateLimiter limiter(1);
+    const auto start = std::chrono::steady_clock::now();
+    std::uint64_t suppressed = 0;
+
+    EXPECT_TRUE(limiter.allow(suppressed, start));
+    EXPECT_TRUE(limiter.allow(suppressed, start + 5s));
+    EXPECT_EQ(suppressed, 0u);
+}
+
+TEST(LogRateLimiter, MacroOnlyFormatsWhatGetsThrough) {
+    auto logger = std::make_shared<creatures::MockLogger>();
+
+    // Everything's enabled on a mock, so only the first two get formatted
+    EXPECT_CALL(*logger, logDebug(HasSubstr("hop"), _)).Times(2);
+    for (int i = 0; i < 5; i++) {
+        LOG_RATE_LIMITED(logger, debug, 2, "hop {}", i);
+    }
+}
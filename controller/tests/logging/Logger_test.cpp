@@ -0,0 +1,65 @@
+
+#include <atomic>
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "logging/Logger.h"
+#include "mocks/logging/MockLogger.h"
+
+using ::testing::_;
+
+namespace {
+
+/**
+ * A mock logger with a level of its own, the way a real implementation wires
+ * up its gate
+ */
+class GatedMockLogger : public creatures::MockLogger {
+  public:
+    GatedMockLogger() { useLevelGate(level); }
+
+    std::atomic<int> level{static_cast<int>(creatures::LogLevel::trace)};
+};
+
+} // namespace
+
+TEST(Logger, EverythingGetsThroughWithoutAGate) {
+    auto logger = std::make_shared<creatures::MockLogger>();
+
+    EXPECT_TRUE(logger->isTraceEnabled());
+    EXPECT_CALL(*logger, logTrace(_, _)).Times(1);
+    logger->trace("hop {}", 1);
+}
+
+TEST(Logger, MessagesBelowTheLevelAreSkipped) {
+    auto logger = std::make_shared<GatedMockLogger>();
+    logger->level.store(static_cast<int>(creatures::LogLevel::info));
+
+    EXPECT_FALSE(logger->isTraceEnabled());
+    EXPECT_FALSE(logger->isDebugEnabled());
+
+    EXPECT_CALL(*logger, logTrace(_, _)).Times(0);
+    EXPECT_CALL(*logger, logDebug(_, _)).Times(0);
+    EXPECT_CALL(*logger, logInfo(_, _)).Times(1);
+    EXPECT_CALL(*logger, logError(_, _)).Times(1);
+
+    logger->trace("hop {}", 1);
+    logger->debug("hop {}", 2);
+    logger->info("hop {}", 3);
+    logger->error("hop {}", 4);
+}
+
+TEST(Logger, TurningTheLevelDownLetsTraceBackIn) {
+    auto logger = std::make_shared<GatedMockLogger>();
+    logger->level.store(static_cast<int>(creatures::LogLevel::off));
+
+    EXPECT_CALL(*logger, logCritical(_, _)).Times(0);
+    logger->critical("nobody hears this");
+
+    logger->level.store(static_cast<int>(creatures::LogLevel::trace));
+    EXPECT_TRUE(logger->isTraceEnabled());
+    EXPECT_CALL(*logger, logTrace(_, _)).Times(1);
+    logger->trace("but everybody hears this");
+}
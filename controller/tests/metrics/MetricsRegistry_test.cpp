@@ -0,0 +1,31 @@
+#include <atomic>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "metrics/MetricsRegistry.h"
+#include "metrics/MetricsWriter.h"
+
+using creatures::metrics::MetricsRegistry;
+using creatures::metrics::MetricsWriter;
+
+TEST(MetricsRegistry, EmptyRegistryRendersAnEmptyPage) {
+    MetricsRegistry registry;
+    EXPECT_EQ("", registry.render());
+}
+
+TEST(MetricsRegistry, CollectorsRunEachTimeThePageIsRendered) {
+    MetricsRegistry registry;
+    std::atomic<int> scrapes{0};
+
+    registry.add([&scrapes](MetricsWriter &writer) {
+        writer.counter("scrapes_total", "Times we've been asked", ++scrapes);
+    });
+    registry.add([](MetricsWriter &writer) { writer.gauge("carrots", "Carrots on hand", 7); });
+
+    EXPECT_NE(std::string::npos, registry.render().find("scrapes_total 1\n"));
+
+    const std::string page = registry.render();
+    EXPECT_NE(std::string::npos, page.find("scrapes_total 2\n"));
+    EXPECT_NE(std::string::npos, page.find("carrots 7\n"));
+}
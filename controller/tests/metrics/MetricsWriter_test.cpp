@@ -0,0 +1,46 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "metrics/MetricsWriter.h"
+
+using creatures::metrics::MetricsWriter;
+
+TEST(MetricsWriter, WritesHelpAndTypeOncePerFamily) {
+    MetricsWriter writer;
+    writer.counter("bunny_hops_total", "Hops so far", 42);
+    writer.gauge("bunny_carrots", "Carrots on hand", 3, {{"garden", "north"}});
+    writer.gauge("bunny_carrots", "Carrots on hand", 5, {{"garden", "south"}});
+
+    EXPECT_EQ("# HELP bunny_hops_total Hops so far\n"
+              "# TYPE bunny_hops_total counter\n"
+              "bunny_hops_total 42\n"
+              "# HELP bunny_carrots Carrots on hand\n"
+              "# TYPE bunny_carrots gauge\n"
+              "bunny_carrots{garden=\"north\"} 3\n"
+              "bunny_carrots{garden=\"south\"} 5\n",
+              writer.finish());
+}
+
+TEST(MetricsWriter, KeepsFamiliesTogetherWhenSamplesAreInterleaved) {
+    MetricsWriter writer;
+    writer.gauge("queue_depth", "Depth", 1, {{"module", "A"}});
+    writer.counter("queue_dropped_total", "Dropped", 0, {{"module", "A"}});
+    writer.gauge("queue_depth", "Depth", 2, {{"module", "B"}});
+
+    EXPECT_EQ("# HELP queue_depth Depth\n"
+              "# TYPE queue_depth gauge\n"
+              "queue_depth{module=\"A\"} 1\n"
+              "queue_depth{module=\"B\"} 2\n"
+              "# HELP queue_dropped_total Dropped\n"
+              "# TYPE queue_dropped_total counter\n"
+              "queue_dropped_total{module=\"A\"} 0\n",
+              writer.finish());
+}
+
+TEST(MetricsWriter, EscapesLabelValuesAndFormatsNumbers) {
+    MetricsWriter writer;
+    writer.gauge("odd", "Odd values", 0.25, {{"name", "say \"hi\"\\bye\n"}, {"other", "ok"}});
+
+    EXPECT_NE(std::string::npos, writer.finish().find("odd{name=\"say \\\"hi\\\"\\\\bye\\n\",other=\"ok\"} 0.25\n"));
+}
@@ -7,7 +7,7 @@
 
 namespace creatures {
 
-void MockMessageHandler::handle(std::shared_ptr<Logger> /*logger*/, const std::vector<std::string> & /*tokens*/) {
+void MockMessageHandler::handle(std::shared_ptr<Logger> /*logger*/, std::span<const std::string_view> /*tokens*/) {
     // Do nothing
 }
 
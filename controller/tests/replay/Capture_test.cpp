@@ -0,0 +1,124 @@
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "controller/InputFrame.h"
+#include "replay/CaptureReader.h"
+#include "replay/CaptureRecord.h"
+#include "replay/CaptureWriter.h"
+
+#include "mocks/logging/MockLogger.h"
+
+using creatures::InputFrame;
+using creatures::config::UARTDevice;
+using creatures::replay::CaptureReader;
+using creatures::replay::CaptureRecord;
+using creatures::replay::CaptureWriter;
+using creatures::replay::RecordKind;
+
+namespace {
+
+std::string capturePath(const std::string &name) {
+    return (std::filesystem::temp_directory_path() / fmt::format("{}-{}.ccap", name, getpid())).string();
+}
+
+} // namespace
+
+TEST(Capture, FramesAndSerialLinesMakeTheRoundTrip) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path = capturePath("round-trip");
+
+    {
+        CaptureWriter writer(logger, path, 3000, true);
+        ASSERT_TRUE(writer.open().isSuccess());
+
+        InputFrame frame;
+        frame.slots[1] = 42;
+        frame.slots[3] = 255;
+        frame.slots[7] = 9; // Past what we asked to keep
+        writer.recordInputFrame(frame, 4);
+        writer.recordSerial(RecordKind::serialIn, UARTDevice::B, "STATS\tHEAP_FREE 1234");
+        writer.recordSerial(RecordKind::serialOut, UARTDevice::B, "POS\tB0 1500\tCS 1234");
+        writer.close();
+
+        EXPECT_EQ(3u, writer.getRecordsWritten());
+        EXPECT_EQ(0u, writer.getRecordsDropped());
+    }
+
+    CaptureReader reader(logger, path);
+    ASSERT_TRUE(reader.open().isSuccess());
+    EXPECT_EQ(3000, reader.getUniverse());
+    EXPECT_GT(reader.getStartedAtNs(), 0);
+
+    CaptureRecord record;
+    ASSERT_TRUE(reader.next(record).getValue().value());
+    EXPECT_EQ(RecordKind::inputFrame, record.kind);
+    EXPECT_EQ(std::string("\0\x2a\0\xff", 4), record.payload);
+
+    ASSERT_TRUE(reader.next(record).getValue().value());
+    EXPECT_EQ(RecordKind::serialIn, record.kind);
+    EXPECT_EQ(UARTDevice::B, record.module);
+    EXPECT_EQ("STATS\tHEAP_FREE 1234", record.payload);
+
+    ASSERT_TRUE(reader.next(record).getValue().value());
+    EXPECT_EQ(RecordKind::serialOut, record.kind);
+    EXPECT_EQ("POS\tB0 1500\tCS 1234", record.payload);
+
+    auto end = reader.next(record);
+    ASSERT_TRUE(end.isSuccess());
+    EXPECT_FALSE(end.getValue().value());
+
+    std::filesystem::remove(path);
+}
+
+TEST(Capture, SerialIsLeftOutUnlessAskedFor) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path = capturePath("no-serial");
+
+    CaptureWriter writer(logger, path, 1, false);
+    ASSERT_TRUE(writer.open().isSuccess());
+    writer.recordSerial(RecordKind::serialIn, UARTDevice::A, "PONG");
+    writer.recordInputFrame(InputFrame{}, 8);
+    writer.close();
+
+    EXPECT_EQ(1u, writer.getRecordsWritten());
+    std::filesystem::remove(path);
+}
+
+TEST(Capture, ReaderTurnsAwayFilesThatArentCaptures) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path = capturePath("not-a-capture");
+    std::ofstream(path) << "this is a grocery list: carrots, more carrots";
+
+    CaptureReader reader(logger, path);
+    auto result = reader.open();
+    ASSERT_FALSE(result.isSuccess());
+    EXPECT_EQ(creatures::ControllerError::InvalidData, result.getError()->getErrorType());
+
+    std::filesystem::remove(path);
+}
+
+TEST(Capture, ACutOffRecordIsAnError) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path = capturePath("cut-off");
+
+    CaptureWriter writer(logger, path, 1, true);
+    ASSERT_TRUE(writer.open().isSuccess());
+    writer.recordSerial(RecordKind::serialIn, UARTDevice::A, "LOG\tI\tthis line gets cut off");
+    writer.close();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+
+    CaptureReader reader(logger, path);
+    ASSERT_TRUE(reader.open().isSuccess());
+
+    CaptureRecord record;
+    EXPECT_FALSE(reader.next(record).isSuccess());
+
+    std::filesystem::remove(path);
+}
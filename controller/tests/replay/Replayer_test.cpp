@@ -0,0 +1,211 @@
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "controller/Controller.h"
+#include "controller/InputFrame.h"
+#include "controller/MotionLatency.h"
+#include "controller/ServoModuleHandler.h"
+#include "creature/Parrot.h"
+#include "io/MessageProcessor.h"
+#include "io/MessageRouter.h"
+#include "io/PositionSlot.h"
+#include "replay/CaptureReader.h"
+#include "replay/CaptureWriter.h"
+#include "replay/Replayer.h"
+#include "server/ServerMessage.h"
+#include "util/MessageQueue.h"
+
+#include "mocks/logging/MockLogger.h"
+
+using creatures::InputFrame;
+using creatures::config::UARTDevice;
+using creatures::replay::CaptureReader;
+using creatures::replay::CaptureWriter;
+using creatures::replay::RecordKind;
+using creatures::replay::Replayer;
+
+namespace {
+
+std::shared_ptr<Controller> makeController(const std::shared_ptr<creatures::Logger> &logger) {
+    auto parrot = std::make_shared<Parrot>(logger);
+    parrot->addInput(creatures::Input("head_height", 1, 1, 0));
+    parrot->addInput(creatures::Input("beak", 2, 1, 0));
+    return std::make_shared<Controller>(logger, parrot, std::make_shared<creatures::io::MessageRouter>(logger));
+}
+
+} // namespace
+
+TEST(Replayer, EveryCapturedFrameGoesToTheController) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path =
+        (std::filesystem::temp_directory_path() / fmt::format("replay-{}.ccap", getpid())).string();
+
+    {
+        CaptureWriter writer(logger, path, 3000, true);
+        ASSERT_TRUE(writer.open().isSuccess());
+
+        InputFrame frame;
+        for (u8 i = 1; i <= 5; i++) {
+            frame.slots[1] = i;
+            frame.slots[2] = static_cast<u8>(i * 10);
+            writer.recordInputFrame(frame, 3);
+            writer.recordSerial(RecordKind::serialOut, UARTDevice::A, "POS\tA0 1500\tCS 1500");
+        }
+        writer.recordSerial(RecordKind::serialIn, UARTDevice::A, "PONG");
+        writer.close();
+    }
+
+    auto reader = std::make_shared<CaptureReader>(logger, path);
+    ASSERT_TRUE(reader->open().isSuccess());
+
+    // The controller isn't running, so nobody takes frames out of its mailbox
+    auto controller = makeController(logger);
+    Replayer replayer(logger, reader, controller, true);
+
+    auto result = replayer.replay();
+    ASSERT_TRUE(result.isSuccess());
+
+    const auto report = result.getValue().value();
+    EXPECT_EQ(5u, report.framesReplayed);
+    EXPECT_EQ(0u, report.framesRejected);
+    EXPECT_EQ(1u, report.serialLinesIn);
+    EXPECT_EQ(5u, report.serialLinesOut);
+    EXPECT_EQ(4u, report.framesNeverSeen);
+
+    const InputFrame *last = controller->getInputMailbox()->take();
+    ASSERT_NE(nullptr, last);
+    EXPECT_EQ(5, last->slots[1]);
+    EXPECT_EQ(50, last->slots[2]);
+
+    std::filesystem::remove(path);
+}
+
+TEST(Replayer, WatchedWritersOnlyCountWhatHappensDuringTheReplay) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path =
+        (std::filesystem::temp_directory_path() / fmt::format("replay-writers-{}.ccap", getpid())).string();
+
+    {
+        CaptureWriter writer(logger, path, 3000, false);
+        ASSERT_TRUE(writer.open().isSuccess());
+
+        InputFrame frame;
+        for (u8 i = 1; i <= 3; i++) {
+            frame.slots[1] = i;
+            writer.recordInputFrame(frame, 3);
+        }
+        writer.close();
+    }
+
+    auto reader = std::make_shared<CaptureReader>(logger, path);
+    ASSERT_TRUE(reader->open().isSuccess());
+
+    auto messageRouter = std::make_shared<creatures::io::MessageRouter>(logger);
+    auto parrot = std::make_shared<Parrot>(logger);
+    parrot->addInput(creatures::Input("head_height", 1, 1, 0));
+    auto controller = std::make_shared<Controller>(logger, parrot, messageRouter);
+    auto handler = std::make_shared<creatures::ServoModuleHandler>(
+        logger, controller, UARTDevice::A, "/dev/null", messageRouter,
+        std::make_shared<creatures::MessageQueue<creatures::server::ServerMessage>>());
+    handler->init();
+    ASSERT_TRUE(messageRouter
+                    ->registerServoModuleHandler(UARTDevice::A, handler->getIncomingQueue(),
+                                                 handler->getOutgoingQueue(), handler->getPendingPosition())
+                    .isSuccess());
+
+    // This is what --replay-modules-ready does, since there's no firmware here to say so
+    handler->firmwareReadyToOperate();
+    EXPECT_TRUE(messageRouter->allHandlersReady());
+
+    // Whatever went on before the replay isn't part of it
+    ASSERT_NE(nullptr, handler->getSerialStats());
+    handler->getSerialStats()->messagesWritten.store(7);
+    handler->getPendingPosition()->offer(creatures::io::Message(UARTDevice::A, "POS\t1"));
+    handler->getPendingPosition()->offer(creatures::io::Message(UARTDevice::A, "POS\t2"));
+    creatures::MotionTimestamps before;
+    before.receivedNs = 1'000'000;
+    creatures::MotionLatency::recordWritten(before, 2'000'000);
+
+    Replayer replayer(logger, reader, controller, true);
+    replayer.watchModule(handler);
+
+    auto result = replayer.replay();
+    ASSERT_TRUE(result.isSuccess());
+
+    // The controller isn't running, so nothing new went out
+    const auto report = result.getValue().value();
+    EXPECT_EQ(3u, report.framesReplayed);
+    EXPECT_EQ(0u, report.serialMessagesWritten);
+    EXPECT_EQ(0u, report.positionsReplaced);
+    EXPECT_EQ(0u, report.outgoingDropped);
+    EXPECT_EQ(0u, report.motionFramesTraced);
+
+    creatures::MotionLatency::reset();
+    std::filesystem::remove(path);
+}
+
+TEST(Replayer, MotionLatencyCoversTheWholeReplayAcrossSummaries) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    const auto path =
+        (std::filesystem::temp_directory_path() / fmt::format("replay-latency-{}.ccap", getpid())).string();
+
+    // A fifth of a second of show, played back in real time
+    {
+        CaptureWriter writer(logger, path, 3000, false);
+        ASSERT_TRUE(writer.open().isSuccess());
+
+        InputFrame frame;
+        for (u8 i = 1; i <= 5; i++) {
+            frame.slots[1] = i;
+            frame.timestamps.receivedNs = static_cast<std::int64_t>(i) * 50'000'000;
+            writer.recordInputFrame(frame, 3);
+        }
+        writer.close();
+    }
+
+    auto reader = std::make_shared<CaptureReader>(logger, path);
+    ASSERT_TRUE(reader->open().isSuccess());
+    Replayer replayer(logger, reader, makeController(logger), false);
+
+    // Stand in for the writers, and for the controller starting its numbers
+    // over at every summary while the replay goes on
+    std::atomic<bool> done{false};
+    std::thread writers([&done] {
+        std::int64_t receivedNs = 1'000'000;
+        for (int i = 1; !done.load(); i++) {
+            creatures::MotionTimestamps timestamps;
+            timestamps.receivedNs = receivedNs;
+            creatures::MotionLatency::recordWritten(timestamps, receivedNs + 500'000);
+            receivedNs += 1'000'000;
+            if (i % 10 == 0) {
+                creatures::MotionLatency::reset();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    auto result = replayer.replay();
+    done.store(true);
+    writers.join();
+    ASSERT_TRUE(result.isSuccess());
+
+    const auto report = result.getValue().value();
+    EXPECT_EQ(5u, report.framesReplayed);
+    EXPECT_GT(report.motionFramesTraced, 10u);
+    EXPECT_GT(report.motionFramesTraced,
+              creatures::MotionLatency::getHistogram(creatures::MotionLatency::Stage::total).count());
+    EXPECT_EQ(500u, report.motionTotalMaxUs);
+
+    creatures::MotionLatency::reset();
+    std::filesystem::remove(path);
+}
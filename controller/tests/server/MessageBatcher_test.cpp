@@ -0,0 +1,96 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "mocks/logging/MockLogger.h"
+#include "server/BoardSensorReportMessage.h"
+#include "server/EstopMessage.h"
+#include "server/MessageBatcher.h"
+
+using creatures::server::BoardSensorReportMessage;
+using creatures::server::EstopMessage;
+using creatures::server::MessageBatcher;
+using creatures::server::MessageEncoding;
+using json = nlohmann::json;
+
+TEST(MessageBatcher, NewerReportsFromTheSameModuleReplaceOlderOnes) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+
+    EXPECT_FALSE(batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 70.0}}, "A")));
+    EXPECT_FALSE(batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 71.0}}, "B")));
+    EXPECT_TRUE(batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 72.0}}, "A")));
+    EXPECT_EQ(batcher.size(), 2u);
+
+    std::vector<std::string> frames;
+    EXPECT_EQ(batcher.takeFrames("creature", false, MessageEncoding::json, frames), 0u);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(json::parse(frames[0])["payload"]["board_temperature"], 72.0);
+    EXPECT_EQ(json::parse(frames[1])["payload"]["board_temperature"], 71.0);
+    EXPECT_TRUE(batcher.empty());
+}
+
+TEST(MessageBatcher, MessagesWithoutAKeyAreNeverReplaced) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+
+    EXPECT_FALSE(batcher.add(EstopMessage(logger, json{{"reason", "one"}})));
+    EXPECT_FALSE(batcher.add(EstopMessage(logger, json{{"reason", "two"}})));
+    EXPECT_EQ(batcher.size(), 2u);
+}
+
+TEST(MessageBatcher, BatchesEverythingIntoOneFrame) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+
+    batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 70.0}}, "A"));
+    batcher.add(EstopMessage(logger, json{{"reason", "bunnies"}}));
+
+    std::vector<std::string> frames;
+    batcher.takeFrames("creature \"1\"", true, MessageEncoding::json, frames);
+    ASSERT_EQ(frames.size(), 1u);
+
+    auto frame = json::parse(frames[0]);
+    EXPECT_EQ(frame["command"], "batch");
+    EXPECT_EQ(frame["payload"]["creature_id"], "creature \"1\"");
+    ASSERT_EQ(frame["payload"]["messages"].size(), 2u);
+    EXPECT_EQ(frame["payload"]["messages"][0]["command"], "board-sensor-report");
+    EXPECT_EQ(frame["payload"]["messages"][1]["command"], "emergency-stop");
+    EXPECT_EQ(frame["payload"]["messages"][1]["payload"]["creature_id"], "creature \"1\"");
+}
+
+TEST(MessageBatcher, LoneMessagesAreNotWrapped) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+
+    batcher.add(EstopMessage(logger, json{{"reason", "bunnies"}}));
+
+    std::vector<std::string> frames;
+    batcher.takeFrames("creature", true, MessageEncoding::json, frames);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(json::parse(frames[0])["command"], "emergency-stop");
+}
+
+TEST(MessageBatcher, SplitsFramesThatWouldBeTooBig) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher(300);
+
+    for (int i = 0; i < 6; i++) {
+        batcher.add(EstopMessage(logger, json{{"reason", std::string(60, 'x')}}));
+    }
+
+    std::vector<std::string> frames;
+    batcher.takeFrames("creature", true, MessageEncoding::json, frames);
+    ASSERT_GT(frames.size(), 1u);
+
+    size_t messages = 0;
+    for (const auto &frameText : frames) {
+        EXPECT_LE(frameText.size(), 300u);
+        auto frame = json::parse(frameText);
+        messages += frame["command"] == "batch" ? frame["payload"]["messages"].size() : 1;
+    }
+    EXPECT_EQ(messages, 6u);
+}
@@ -0,0 +1,86 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "mocks/logging/MockLogger.h"
+#include "server/BoardSensorReportMessage.h"
+#include "server/EstopMessage.h"
+#include "server/MessageBatcher.h"
+#include "server/MessageEncoding.h"
+
+using creatures::server::BoardSensorReportMessage;
+using creatures::server::EstopMessage;
+using creatures::server::MessageBatcher;
+using creatures::server::MessageEncoding;
+using creatures::server::negotiateMessageEncoding;
+using json = nlohmann::json;
+
+TEST(MessageEncoding, NamesRoundTrip) {
+    for (auto encoding : {MessageEncoding::json, MessageEncoding::cbor, MessageEncoding::msgpack}) {
+        auto name = creatures::server::messageEncodingToString(encoding);
+        EXPECT_EQ(creatures::server::messageEncodingFromString(name), encoding);
+    }
+    EXPECT_FALSE(creatures::server::messageEncodingFromString("carrots").has_value());
+}
+
+TEST(MessageEncoding, OnlyUsesWhatTheServerAgreedTo) {
+    EXPECT_EQ(negotiateMessageEncoding(MessageEncoding::cbor, json{{"message_encodings", {"json", "cbor"}}}),
+              MessageEncoding::cbor);
+    EXPECT_EQ(negotiateMessageEncoding(MessageEncoding::msgpack, json{{"message_encodings", {"json", "cbor"}}}),
+              MessageEncoding::json);
+
+    // Older servers don't say anything at all, and some replies aren't even objects
+    EXPECT_EQ(negotiateMessageEncoding(MessageEncoding::cbor, json{{"status", "ok"}}), MessageEncoding::json);
+    EXPECT_EQ(negotiateMessageEncoding(MessageEncoding::cbor, json::parse("nope", nullptr, false)),
+              MessageEncoding::json);
+    EXPECT_EQ(negotiateMessageEncoding(MessageEncoding::cbor, json{{"message_encodings", "cbor"}}),
+              MessageEncoding::json);
+}
+
+TEST(MessageEncoding, BinaryMessagesCarryTheSameDocument) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    BoardSensorReportMessage message(logger, json{{"board_temperature", 70.5}}, "A");
+
+    auto cbor = message.toWebSocketMessage("creature", MessageEncoding::cbor);
+    ASSERT_TRUE(cbor.isSuccess());
+    auto msgpack = message.toWebSocketMessage("creature", MessageEncoding::msgpack);
+    ASSERT_TRUE(msgpack.isSuccess());
+
+    const json expected = message.toJson("creature");
+    EXPECT_EQ(json::from_cbor(cbor.getValue().value()), expected);
+    EXPECT_EQ(json::from_msgpack(msgpack.getValue().value()), expected);
+    EXPECT_EQ(expected["payload"]["creature_id"], "creature");
+}
+
+TEST(MessageEncoding, BatchesAreEncodedAsOneDocument) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+    batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 70.0}}, "A"));
+    batcher.add(EstopMessage(logger, json{{"reason", "bunnies"}}));
+
+    std::vector<std::string> frames;
+    EXPECT_EQ(batcher.takeFrames("creature", true, MessageEncoding::cbor, frames), 0u);
+    ASSERT_EQ(frames.size(), 1u);
+
+    auto frame = json::from_cbor(frames[0]);
+    EXPECT_EQ(frame["command"], "batch");
+    EXPECT_EQ(frame["payload"]["creature_id"], "creature");
+    ASSERT_EQ(frame["payload"]["messages"].size(), 2u);
+    EXPECT_EQ(frame["payload"]["messages"][1]["payload"]["reason"], "bunnies");
+    EXPECT_TRUE(batcher.empty());
+}
+
+TEST(MessageEncoding, UnbatchedBinaryIsOneFramePerMessage) {
+    auto logger = std::make_shared<creatures::NiceMockLogger>();
+    MessageBatcher batcher;
+    batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 70.0}}, "A"));
+    batcher.add(BoardSensorReportMessage(logger, json{{"board_temperature", 71.0}}, "B"));
+
+    std::vector<std::string> frames;
+    batcher.takeFrames("creature", false, MessageEncoding::msgpack, frames);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(json::from_msgpack(frames[1])["payload"]["board_temperature"], 71.0);
+}
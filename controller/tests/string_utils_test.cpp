@@ -1,5 +1,8 @@
 
+#include <array>
+#include <cmath>
 #include <limits>
+#include <string_view>
 
 #include <gtest/gtest.h>
 
@@ -147,3 +150,44 @@ TEST(StringUtils, splitString_OnlyDelimiters) {
     auto result = splitString("   ");
     EXPECT_TRUE(result.empty());
 }
+
+TEST(StringUtils, splitFields_ViewsIntoTheOriginal) {
+    const std::string line = "  D1 45\t128  7400 ";
+    std::array<std::string_view, 6> fields;
+
+    ASSERT_EQ(splitFields(line, fields), 4);
+    EXPECT_EQ(fields[0], "D1");
+    EXPECT_EQ(fields[1], "45");
+    EXPECT_EQ(fields[2], "128");
+    EXPECT_EQ(fields[3], "7400");
+
+    // No copies, they point right back into the line
+    EXPECT_EQ(fields[0].data(), line.data() + 2);
+}
+
+TEST(StringUtils, splitFields_CountsWhatDoesNotFit) {
+    std::array<std::string_view, 2> fields;
+
+    EXPECT_EQ(splitFields("a b c d", fields), 4);
+    EXPECT_EQ(fields[0], "a");
+    EXPECT_EQ(fields[1], "b");
+}
+
+TEST(StringUtils, splitFields_OnlyDelimiters) {
+    std::array<std::string_view, 2> fields;
+    EXPECT_EQ(splitFields("", fields), 0);
+    EXPECT_EQ(splitFields("   ", fields), 0);
+}
+
+TEST(StringUtils, stringToDouble_StopsAtTheEndOfTheView) {
+    // A view in the middle of a line isn't terminated where it ends
+    std::string_view line = "12.5 3.25";
+    EXPECT_DOUBLE_EQ(stringToDouble(line.substr(0, 3)), 12.0);
+    EXPECT_DOUBLE_EQ(stringToDouble(line.substr(5)), 3.25);
+    EXPECT_TRUE(std::isnan(stringToDouble("carrots")));
+}
+
+TEST(StringUtils, stringToU32_StopsAtTheEndOfTheView) {
+    std::string_view line = "1234";
+    EXPECT_EQ(stringToU32(line.substr(0, 2)), 12);
+}
@@ -0,0 +1,134 @@
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LoadGenerator.h"
+#include "dmx/E131Client.h"
+
+using creatures::loadgen::ChannelPattern;
+using creatures::loadgen::PacketImpairer;
+using creatures::loadgen::parseUniverses;
+using creatures::loadgen::Pattern;
+using creatures::loadgen::patternFromString;
+
+TEST(LoadGenerator, ParsesListsAndRangesOfUniverses) {
+    auto result = parseUniverses("1,2,10-12");
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(result.getValue().value(), (std::vector<u16>{1, 2, 10, 11, 12}));
+
+    EXPECT_FALSE(parseUniverses("").isSuccess());
+    EXPECT_FALSE(parseUniverses("0").isSuccess());
+    EXPECT_FALSE(parseUniverses("64000").isSuccess());
+    EXPECT_FALSE(parseUniverses("12-10").isSuccess());
+    EXPECT_FALSE(parseUniverses("bunny").isSuccess());
+    EXPECT_FALSE(parseUniverses("3x").isSuccess());
+}
+
+TEST(LoadGenerator, UsesTheSameGroupsTheClientJoins) {
+    // 239.255.0.1 and 239.255.1.0
+    EXPECT_EQ(creatures::dmx::E131Client::multicastGroup(1), 0xEFFF0001U);
+    EXPECT_EQ(creatures::dmx::E131Client::multicastGroup(256), 0xEFFF0100U);
+}
+
+TEST(LoadGenerator, KnowsItsPatterns) {
+    EXPECT_EQ(patternFromString("sine"), Pattern::sine);
+    EXPECT_EQ(patternFromString("step"), Pattern::step);
+    EXPECT_EQ(patternFromString("random"), Pattern::random);
+    EXPECT_EQ(patternFromString("recorded"), Pattern::recorded);
+    EXPECT_FALSE(patternFromString("carrot").has_value());
+}
+
+TEST(LoadGenerator, StepPatternFlipsOnceASecond) {
+    ChannelPattern pattern(Pattern::step, 10.0, 1);
+    std::array<u8, 5> first{};
+    std::array<u8, 5> sameSecond{};
+    std::array<u8, 5> nextSecond{};
+
+    pattern.fill(0, 0, first);
+    pattern.fill(9, 0, sameSecond);
+    pattern.fill(10, 0, nextSecond);
+
+    EXPECT_EQ(first[0], 0); // Start code
+    EXPECT_EQ(first, sameSecond);
+    for (size_t channel = 1; channel < first.size(); channel++) {
+        EXPECT_EQ(first[channel] ^ nextSecond[channel], 255);
+    }
+}
+
+TEST(LoadGenerator, RecordedPatternLoopsThroughTheFrames) {
+    ChannelPattern pattern(Pattern::recorded, 44.0, 1);
+    pattern.setRecordedFrames({std::string("\x00\x01\x02", 3), std::string("\x00\x03", 2)});
+
+    std::array<u8, 4> slots{};
+    pattern.fill(0, 0, slots);
+    EXPECT_EQ(slots, (std::array<u8, 4>{0, 1, 2, 0}));
+
+    // The second frame is short, so what it doesn't have stays at zero
+    pattern.fill(1, 0, slots);
+    EXPECT_EQ(slots, (std::array<u8, 4>{0, 3, 0, 0}));
+
+    pattern.fill(2, 0, slots);
+    EXPECT_EQ(slots, (std::array<u8, 4>{0, 1, 2, 0}));
+}
+
+TEST(LoadGenerator, ImpairerPassesEverythingWhenItsPerfect) {
+    PacketImpairer impairer(1, 0.0, 0.0, 1);
+    std::vector<PacketImpairer::Packet> out;
+
+    for (u8 sequence = 0; sequence < 100; sequence++) {
+        impairer.pass({0, sequence, sequence}, out);
+        ASSERT_EQ(out.size(), 1U);
+        EXPECT_EQ(out[0].sequence, sequence);
+    }
+    EXPECT_EQ(impairer.getDropped(), 0U);
+    EXPECT_EQ(impairer.getReordered(), 0U);
+}
+
+TEST(LoadGenerator, ImpairerSwapsHeldBackPackets) {
+    PacketImpairer impairer(2, 0.0, 100.0, 1);
+    std::vector<PacketImpairer::Packet> out;
+
+    // Held back...
+    impairer.pass({0, 1, 1}, out);
+    EXPECT_TRUE(out.empty());
+
+    // ...and each universe holds its own
+    impairer.pass({1, 7, 1}, out);
+    EXPECT_TRUE(out.empty());
+
+    // ...then sent after the next one
+    impairer.pass({0, 2, 2}, out);
+    ASSERT_EQ(out.size(), 2U);
+    EXPECT_EQ(out[0].sequence, 2);
+    EXPECT_EQ(out[1].sequence, 1);
+    EXPECT_EQ(impairer.getReordered(), 1U);
+}
+
+TEST(LoadGenerator, ImpairerDropsAboutAsManyAsAskedAndIsRepeatable) {
+    std::multiset<u64> firstRun;
+    u64 dropped = 0;
+
+    for (int run = 0; run < 2; run++) {
+        PacketImpairer impairer(1, 25.0, 0.0, 42);
+        std::vector<PacketImpairer::Packet> out;
+        std::multiset<u64> seen;
+        for (u64 frame = 0; frame < 4000; frame++) {
+            impairer.pass({0, static_cast<u8>(frame), frame}, out);
+            for (const auto &packet : out) {
+                seen.insert(packet.frameNumber);
+            }
+        }
+        if (run == 0) {
+            firstRun = seen;
+            dropped = impairer.getDropped();
+        } else {
+            EXPECT_EQ(seen, firstRun);
+        }
+    }
+
+    EXPECT_GT(dropped, 800U);
+    EXPECT_LT(dropped, 1200U);
+}
@@ -0,0 +1,48 @@
+
+#include <gtest/gtest.h>
+
+#include "util/Histogram.h"
+
+TEST(Histogram, EmptyIsAllZeros) {
+    creatures::Histogram histogram;
+
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.percentile(99), 0u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST(Histogram, ValuesLandInPowerOfTwoBuckets) {
+    EXPECT_EQ(creatures::Histogram::bucketFor(0), 0u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(1), 1u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(2), 2u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(3), 2u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(4), 3u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(1000), 10u);
+    EXPECT_EQ(creatures::Histogram::bucketFor(UINT64_MAX), creatures::Histogram::NumberOfBuckets - 1);
+
+    EXPECT_EQ(creatures::Histogram::bucketUpperBound(10), 1023u);
+}
+
+TEST(Histogram, PercentilesFindTheRightBucket) {
+    creatures::Histogram histogram;
+
+    // 98 quick ones and a couple of stragglers
+    for (int i = 0; i < 98; i++) {
+        histogram.record(5);
+    }
+    histogram.record(600);
+    histogram.record(3000);
+
+    EXPECT_EQ(histogram.count(), 100u);
+    EXPECT_EQ(histogram.max(), 3000u);
+    EXPECT_EQ(histogram.percentile(50), 7u);
+    EXPECT_EQ(histogram.percentile(99), 1023u);
+    EXPECT_EQ(histogram.percentile(100), 3000u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), (98.0 * 5 + 600 + 3000) / 100.0);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.bucketCount(3), 0u);
+}
@@ -0,0 +1,112 @@
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "util/LatestValueMailbox.h"
+
+TEST(LatestValueMailbox, EmptyUntilSomethingIsPosted) {
+    creatures::LatestValueMailbox<int> mailbox;
+
+    EXPECT_EQ(mailbox.take(), nullptr);
+
+    mailbox.post(42);
+    const int *value = mailbox.take();
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 42);
+
+    // Taking doesn't hand back the same value twice
+    EXPECT_EQ(mailbox.take(), nullptr);
+}
+
+TEST(LatestValueMailbox, OnlyTheNewestValueSurvives) {
+    creatures::LatestValueMailbox<int> mailbox;
+
+    for (int i = 0; i < 10; i++) {
+        mailbox.post(i);
+    }
+
+    const int *value = mailbox.take();
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 9);
+    EXPECT_EQ(mailbox.posted(), 10u);
+    EXPECT_EQ(mailbox.overwritten(), 9u);
+}
+
+TEST(LatestValueMailbox, TakenValueStaysPutWhileTheProducerKeepsGoing) {
+    creatures::LatestValueMailbox<int> mailbox;
+
+    mailbox.post(1);
+    const int *value = mailbox.take();
+    ASSERT_NE(value, nullptr);
+
+    // The producer can't touch the slot we're reading from
+    for (int i = 2; i < 20; i++) {
+        mailbox.post(i);
+    }
+    EXPECT_EQ(*value, 1);
+
+    value = mailbox.take();
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 19);
+}
+
+TEST(LatestValueMailbox, TakeTimeoutTimesOut) {
+    creatures::LatestValueMailbox<int> mailbox;
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(mailbox.take_timeout(std::chrono::milliseconds(20)), nullptr);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST(LatestValueMailbox, ShutdownWakesAWaitingConsumer) {
+    creatures::LatestValueMailbox<int> mailbox;
+
+    std::thread consumer([&mailbox] { EXPECT_EQ(mailbox.take_timeout(std::chrono::seconds(10)), nullptr); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto start = std::chrono::steady_clock::now();
+    mailbox.request_shutdown();
+    consumer.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(LatestValueMailbox, FramesNeverTearAcrossThreads) {
+    // Every byte of a frame is the same, so a torn read would show up as a mix
+    using Frame = std::array<unsigned char, 512>;
+    creatures::LatestValueMailbox<Frame> mailbox;
+    constexpr int frames = 20000;
+
+    std::thread producer([&mailbox] {
+        Frame frame{};
+        for (int i = 1; i <= frames; i++) {
+            frame.fill(static_cast<unsigned char>(i));
+            mailbox.post(frame);
+        }
+    });
+
+    int seen = 0;
+    unsigned char last = 0;
+    while (mailbox.posted() < frames || seen == 0) {
+        const Frame *frame = mailbox.take_timeout(std::chrono::milliseconds(10));
+        if (frame == nullptr) {
+            continue;
+        }
+        seen++;
+        for (unsigned char byte : *frame) {
+            ASSERT_EQ(byte, (*frame)[0]);
+        }
+        last = (*frame)[0];
+    }
+    producer.join();
+
+    // Whatever was still sitting in the mailbox is the very last frame
+    if (const Frame *frame = mailbox.take()) {
+        last = (*frame)[0];
+    }
+    EXPECT_EQ(last, static_cast<unsigned char>(frames));
+    EXPECT_EQ(mailbox.posted(), static_cast<std::uint64_t>(frames));
+    EXPECT_GT(seen, 0);
+}
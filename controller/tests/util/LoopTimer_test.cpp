@@ -0,0 +1,51 @@
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "util/LoopTimer.h"
+
+using namespace std::chrono_literals;
+
+TEST(LoopTimer, WaitsUntilTheNextTick) {
+    creatures::LoopTimer timer(5ms);
+    timer.start();
+
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < 4; i++) {
+        const auto late = timer.waitForNextTick();
+        EXPECT_GE(late.count(), 0);
+    }
+
+    // Four ticks can't come any sooner than four periods
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 20ms - 1ms);
+    EXPECT_EQ(timer.getOverruns(), 0u);
+}
+
+TEST(LoopTimer, SkipsTicksItMissedInsteadOfBursting) {
+    creatures::LoopTimer timer(2ms);
+    timer.start();
+
+    // Fall well behind
+    std::this_thread::sleep_for(11ms);
+    const auto late = timer.waitForNextTick();
+
+    // We're never more than a period late, and the rest were skipped
+    EXPECT_LT(late, 2ms);
+    EXPECT_GE(timer.getOverruns(), 4u);
+
+    // So the next one is a real wait rather than another catch up
+    const auto before = std::chrono::steady_clock::now();
+    timer.waitForNextTick();
+    EXPECT_GT(std::chrono::steady_clock::now() - before, 0ms);
+}
+
+TEST(LoopTimer, SpinningStillLandsOnTheDeadline) {
+    creatures::LoopTimer timer(3ms, 1ms);
+    timer.start();
+
+    const auto started = std::chrono::steady_clock::now();
+    timer.waitForNextTick();
+    EXPECT_GE(std::chrono::steady_clock::now() - started, 3ms - 100us);
+}
@@ -0,0 +1,116 @@
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/SpscQueue.h"
+
+TEST(SpscQueue, SingleThreadPushPop) {
+    creatures::SpscQueue<int> queue(8);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_EQ(queue.size(), 2u);
+
+    EXPECT_EQ(queue.try_pop(), 1);
+    EXPECT_EQ(queue.pop_timeout(std::chrono::milliseconds(10)), 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, CapacityRoundsUpToPowerOfTwo) {
+    creatures::SpscQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8u);
+}
+
+TEST(SpscQueue, FullRingDropsAndCounts) {
+    creatures::SpscQueue<int> queue(4);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(99));
+    EXPECT_EQ(queue.dropped(), 1u);
+
+    // The messages that made it in are untouched and still in order
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(queue.try_pop(), i);
+    }
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(SpscQueue, WrapsAround) {
+    creatures::SpscQueue<std::string> queue(4);
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(queue.push(std::to_string(i)));
+        EXPECT_TRUE(queue.push(std::to_string(i + 1000)));
+        EXPECT_EQ(queue.try_pop(), std::to_string(i));
+        EXPECT_EQ(queue.try_pop(), std::to_string(i + 1000));
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, PopTimeoutTimesOut) {
+    creatures::SpscQueue<int> queue(4);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = queue.pop_timeout(std::chrono::milliseconds(20));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_FALSE(result.has_value());
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+}
+
+TEST(SpscQueue, ShutdownWakesParkedConsumer) {
+    creatures::SpscQueue<int> queue(4);
+
+    std::thread stopper([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.request_shutdown();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = queue.pop_timeout(std::chrono::seconds(10));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+
+    EXPECT_FALSE(result.has_value());
+    EXPECT_LT(elapsed, std::chrono::seconds(5));
+    EXPECT_FALSE(queue.push(1));
+}
+
+TEST(SpscQueue, MultiThreadedPushPopKeepsOrder) {
+    constexpr int count = 100000;
+    creatures::SpscQueue<int> queue(64);
+    std::vector<int> popped;
+    popped.reserve(count);
+
+    std::thread consumer([&] {
+        while (popped.size() < static_cast<size_t>(count)) {
+            auto msg = queue.pop_timeout(std::chrono::milliseconds(1000));
+            if (msg.has_value()) {
+                popped.push_back(*msg);
+            }
+        }
+    });
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; i++) {
+            // Spin until there's room rather than dropping
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    ASSERT_EQ(popped.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(popped[i], i);
+    }
+}
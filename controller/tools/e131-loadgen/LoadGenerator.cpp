@@ -0,0 +1,159 @@
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "LoadGenerator.h"
+
+namespace creatures::loadgen {
+
+namespace {
+
+// The biggest universe E1.31 allows
+constexpr long MaxUniverse = 63999;
+
+std::optional<long> parseUniverse(const std::string &text) {
+    try {
+        size_t used = 0;
+        const long universe = std::stol(text, &used);
+        if (used != text.size() || universe < 1 || universe > MaxUniverse) {
+            return std::nullopt;
+        }
+        return universe;
+    } catch (const std::exception &) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+std::optional<Pattern> patternFromString(const std::string &name) {
+    if (name == "sine") {
+        return Pattern::sine;
+    }
+    if (name == "step") {
+        return Pattern::step;
+    }
+    if (name == "random") {
+        return Pattern::random;
+    }
+    if (name == "recorded") {
+        return Pattern::recorded;
+    }
+    return std::nullopt;
+}
+
+Result<std::vector<u16>> parseUniverses(const std::string &list) {
+    std::vector<u16> universes;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        const auto dash = item.find('-');
+        const auto first = parseUniverse(item.substr(0, dash));
+        const auto last = dash == std::string::npos ? first : parseUniverse(item.substr(dash + 1));
+
+        if (!first.has_value() || !last.has_value() || *last < *first) {
+            return Result<std::vector<u16>>{ControllerError(
+                ControllerError::InvalidConfiguration, fmt::format("'{}' isn't a universe or a range of them", item))};
+        }
+        for (long universe = *first; universe <= *last; universe++) {
+            universes.push_back(static_cast<u16>(universe));
+        }
+    }
+
+    if (universes.empty()) {
+        return Result<std::vector<u16>>{ControllerError(ControllerError::InvalidConfiguration, "no universes given")};
+    }
+    return Result<std::vector<u16>>{universes};
+}
+
+ChannelPattern::ChannelPattern(Pattern _pattern, double _framesPerSecond, u32 seed)
+    : pattern(_pattern), framesPerSecond(_framesPerSecond), random(seed) {}
+
+void ChannelPattern::setRecordedFrames(std::vector<std::string> frames) { recordedFrames = std::move(frames); }
+
+void ChannelPattern::fill(u64 frameNumber, size_t universeIndex, std::span<u8> slots) {
+    if (slots.empty()) {
+        return;
+    }
+    slots[0] = 0; // Start code
+    const size_t channels = slots.size() - 1;
+
+    switch (pattern) {
+    case Pattern::sine: {
+        // Half a wave a second, with each channel a little behind the last
+        const double seconds = static_cast<double>(frameNumber) / framesPerSecond;
+        for (size_t channel = 1; channel <= channels; channel++) {
+            const double phase = static_cast<double>(channel + universeIndex * 7) / static_cast<double>(channels);
+            const double wave = std::sin(2.0 * std::numbers::pi * (seconds * 0.5 + phase));
+            slots[channel] = static_cast<u8>(std::lround(127.5 + 127.5 * wave));
+        }
+        break;
+    }
+    case Pattern::step: {
+        // Neighbors go opposite ways, so every servo is always fighting the
+        // one next to it
+        const auto second = static_cast<u64>(static_cast<double>(frameNumber) / framesPerSecond);
+        for (size_t channel = 1; channel <= channels; channel++) {
+            slots[channel] = ((second + channel + universeIndex) % 2 == 0) ? 0 : 255;
+        }
+        break;
+    }
+    case Pattern::random: {
+        std::uniform_int_distribution<int> value(0, 255);
+        for (size_t channel = 1; channel <= channels; channel++) {
+            slots[channel] = static_cast<u8>(value(random));
+        }
+        break;
+    }
+    case Pattern::recorded: {
+        std::fill(slots.begin() + 1, slots.end(), 0);
+        if (recordedFrames.empty()) {
+            break;
+        }
+        const std::string &frame = recordedFrames[frameNumber % recordedFrames.size()];
+        for (size_t channel = 1; channel <= channels && channel < frame.size(); channel++) {
+            slots[channel] = static_cast<u8>(frame[channel]);
+        }
+        break;
+    }
+    }
+}
+
+PacketImpairer::PacketImpairer(size_t universes, double _lossPercent, double _reorderPercent, u32 seed)
+    : lossPercent(_lossPercent), reorderPercent(_reorderPercent), random(seed), heldBack(universes) {}
+
+void PacketImpairer::pass(const Packet &packet, std::vector<Packet> &out) {
+    out.clear();
+
+    if (lossPercent > 0.0 && percent(random) < lossPercent) {
+        dropped++;
+        return;
+    }
+
+    auto &held = heldBack[packet.universeIndex];
+
+    // Something's waiting to go out late, and this is what it was waiting for
+    if (held.has_value()) {
+        out.push_back(packet);
+        out.push_back(*held);
+        held.reset();
+        reordered++;
+        return;
+    }
+
+    if (reorderPercent > 0.0 && percent(random) < reorderPercent) {
+        held = packet;
+        return;
+    }
+
+    out.push_back(packet);
+}
+
+} // namespace creatures::loadgen
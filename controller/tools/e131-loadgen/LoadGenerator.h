@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "controller-config.h"
+#include "util/Result.h"
+
+namespace creatures::loadgen {
+
+/**
+ * What the channels do from one frame to the next
+ */
+enum class Pattern {
+    sine,     // Smooth waves, a little out of phase from channel to channel
+    step,     // Every channel slams between 0 and 255 once a second
+    random,   // Every channel gets a new random value every frame
+    recorded, // Frames out of a capture file, over and over
+};
+
+std::optional<Pattern> patternFromString(const std::string &name);
+
+/**
+ * Turn "1,2,10-12" into 1, 2, 10, 11, 12
+ *
+ * @return the universes, in the order given, or an error if any of them
+ *         aren't valid (1 - 63999)
+ */
+Result<std::vector<u16>> parseUniverses(const std::string &list);
+
+/**
+ * Fills in each frame's channels
+ */
+class ChannelPattern {
+  public:
+    /**
+     * @param pattern what the channels should do
+     * @param framesPerSecond how fast frames go out, so the waves and steps
+     *                        keep the same pace at any rate
+     * @param seed for the random pattern
+     */
+    ChannelPattern(Pattern pattern, double framesPerSecond, u32 seed);
+
+    /**
+     * The frames to play for `Pattern::recorded`. Each is the slots starting
+     * from slot 0 (the start code), same as a capture stores them.
+     */
+    void setRecordedFrames(std::vector<std::string> frames);
+
+    /**
+     * Fill in the slots for a frame
+     *
+     * @param frameNumber which frame this is, counting from 0
+     * @param universeIndex which of our universes it's for, so they don't all
+     *                      look the same
+     * @param slots the frame, start code first. The start code is always 0.
+     */
+    void fill(u64 frameNumber, size_t universeIndex, std::span<u8> slots);
+
+  private:
+    Pattern pattern;
+    double framesPerSecond;
+    std::mt19937 random;
+    std::vector<std::string> recordedFrames;
+};
+
+/**
+ * Makes the network look worse than it is
+ *
+ * Each packet that goes through is either dropped, held back until the next
+ * one for the same universe has gone (so the two arrive swapped), or sent
+ * along as is.
+ */
+class PacketImpairer {
+  public:
+    struct Packet {
+        size_t universeIndex = 0;
+        u8 sequence = 0;
+        u64 frameNumber = 0;
+    };
+
+    /**
+     * @param universes how many universes there are
+     * @param lossPercent how many packets to drop
+     * @param reorderPercent how many packets to hold back and send late
+     * @param seed so a run can be repeated
+     */
+    PacketImpairer(size_t universes, double lossPercent, double reorderPercent, u32 seed);
+
+    /**
+     * Run a packet through
+     *
+     * @param packet the packet that's next in line
+     * @param out what should actually go out now, in order (cleared first)
+     */
+    void pass(const Packet &packet, std::vector<Packet> &out);
+
+    [[nodiscard]] u64 getDropped() const { return dropped; }
+    [[nodiscard]] u64 getReordered() const { return reordered; }
+
+  private:
+    double lossPercent;
+    double reorderPercent;
+    std::mt19937 random;
+    std::uniform_real_distribution<double> percent{0.0, 100.0};
+
+    // A packet being held back for each universe, if there is one
+    std::vector<std::optional<Packet>> heldBack;
+
+    u64 dropped = 0;
+    u64 reordered = 0;
+};
+
+} // namespace creatures::loadgen
@@ -0,0 +1,287 @@
+/**
+ * @file main.cpp
+ * @brief A load generator for the e1.31 client
+ *
+ * Sends sACN (e1.31) frames to the same multicast groups the controller
+ * listens on, as fast and as badly as we ask it to. Lost packets, packets
+ * that show up out of order, and bursts of packets all at once are the
+ * things a real network does to us on show day, so this makes it easy to
+ * see how the controller copes without dragging a lighting desk into it.
+ *
+ * The controller's side of things (what it took, what it threw out, and how
+ * busy it was) is on its /metrics endpoint. This only reports what it sent,
+ * and how much CPU that took.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <argparse/argparse.hpp>
+#include <e131.h>
+
+#include "LoadGenerator.h"
+#include "config/CommandLine.h"
+#include "dmx/E131Client.h"
+#include "logging/SpdlogLogger.h"
+#include "replay/CaptureReader.h"
+
+using namespace creatures;
+
+namespace {
+
+std::atomic<bool> stopRequested(false);
+
+void signal_handler(int) { stopRequested.store(true); }
+
+/**
+ * How much CPU we've used so far, user and system together
+ */
+double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto toSeconds = [](const timeval &tv) {
+        return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1'000'000.0;
+    };
+    return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+}
+
+/**
+ * Pull every input frame out of a capture, for the recorded pattern
+ */
+Result<std::vector<std::string>> loadRecordedFrames(const std::shared_ptr<Logger> &logger, const std::string &path) {
+    replay::CaptureReader reader(logger, path);
+    auto openResult = reader.open();
+    if (!openResult.isSuccess()) {
+        return Result<std::vector<std::string>>{openResult.getError().value()};
+    }
+
+    std::vector<std::string> frames;
+    replay::CaptureRecord record;
+    while (true) {
+        auto nextResult = reader.next(record);
+        if (!nextResult.isSuccess()) {
+            return Result<std::vector<std::string>>{nextResult.getError().value()};
+        }
+        if (!nextResult.getValue().value()) {
+            break;
+        }
+        if (record.kind == replay::RecordKind::inputFrame) {
+            frames.push_back(record.payload);
+        }
+    }
+
+    if (frames.empty()) {
+        return Result<std::vector<std::string>>{
+            ControllerError(ControllerError::InvalidData, fmt::format("{} doesn't have any frames in it", path))};
+    }
+    return Result<std::vector<std::string>>{frames};
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    auto logger = std::make_shared<SpdlogLogger>();
+    logger->init("loadgen");
+
+    argparse::ArgumentParser program("creature-e131-loadgen", CommandLine::getVersion());
+
+    program.add_argument("--universes").help("Universes to send to, like 1,2,10-12").default_value(std::string("1"));
+
+    program.add_argument("--rate").help("Frames per second, per universe").default_value(44.0).scan<'g', double>();
+
+    program.add_argument("--channels").help("Channels in each frame (1 - 512)").default_value(512).scan<'i', int>();
+
+    program.add_argument("--pattern")
+        .help("What the channels do: sine, step, random, or recorded")
+        .default_value(std::string("sine"));
+
+    program.add_argument("--capture")
+        .help("Capture file to take the frames from, for --pattern recorded")
+        .default_value(std::string(""));
+
+    program.add_argument("--loss").help("Percent of packets to drop").default_value(0.0).scan<'g', double>();
+
+    program.add_argument("--reorder")
+        .help("Percent of packets to hold back and send after the next one")
+        .default_value(0.0)
+        .scan<'g', double>();
+
+    program.add_argument("--burst")
+        .help("Send this many frames back to back, then wait for them all to be due")
+        .default_value(1)
+        .scan<'i', int>();
+
+    program.add_argument("--duration")
+        .help("How many seconds to run for (0 runs until stopped)")
+        .default_value(10.0)
+        .scan<'g', double>();
+
+    program.add_argument("--interface-address")
+        .help("Address of the interface to send from")
+        .default_value(std::string("127.0.0.1"));
+
+    program.add_argument("--seed").help("Seed for the random bits, to repeat a run").default_value(1).scan<'i', int>();
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << "\n\n" << program;
+        return EXIT_FAILURE;
+    }
+
+    auto universesResult = loadgen::parseUniverses(program.get<std::string>("--universes"));
+    if (!universesResult.isSuccess()) {
+        logger->critical(universesResult.getError()->getMessage());
+        return EXIT_FAILURE;
+    }
+    const auto universes = universesResult.getValue().value();
+
+    const auto rate = program.get<double>("--rate");
+    const auto channels = program.get<int>("--channels");
+    const auto burst = program.get<int>("--burst");
+    const auto duration = program.get<double>("--duration");
+    const auto seed = static_cast<u32>(program.get<int>("--seed"));
+
+    if (rate <= 0.0 || channels < 1 || channels > 512 || burst < 1 || duration < 0.0) {
+        logger->critical("--rate and --burst need to be positive, --channels has to be 1 - 512, and --duration "
+                         "can't be negative");
+        return EXIT_FAILURE;
+    }
+
+    auto pattern = loadgen::patternFromString(program.get<std::string>("--pattern"));
+    if (!pattern.has_value()) {
+        logger->critical("unknown pattern: {}", program.get<std::string>("--pattern"));
+        return EXIT_FAILURE;
+    }
+
+    loadgen::ChannelPattern channelPattern(*pattern, rate, seed);
+    if (*pattern == loadgen::Pattern::recorded) {
+        auto framesResult = loadRecordedFrames(logger, program.get<std::string>("--capture"));
+        if (!framesResult.isSuccess()) {
+            logger->critical(framesResult.getError()->getMessage());
+            return EXIT_FAILURE;
+        }
+        logger->info("playing {} recorded frames on a loop", framesResult.getValue().value().size());
+        channelPattern.setRecordedFrames(framesResult.getValue().value());
+    }
+
+    loadgen::PacketImpairer impairer(universes.size(), program.get<double>("--loss"), program.get<double>("--reorder"),
+                                     seed);
+
+    // Set up the socket
+    int sockfd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sockfd < 0) {
+        logger->critical("unable to create a socket: {}", std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    in_addr interfaceAddress{};
+    if (inet_pton(AF_INET, program.get<std::string>("--interface-address").c_str(), &interfaceAddress) != 1) {
+        logger->critical("{} isn't an IPv4 address", program.get<std::string>("--interface-address"));
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+
+    // Loop is on so a controller on this same box hears us
+    const u8 loop = 1;
+    const u8 ttl = 1;
+    if (setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_IF, &interfaceAddress, sizeof(interfaceAddress)) < 0 ||
+        setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0 ||
+        setsockopt(sockfd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0) {
+        logger->critical("unable to set up multicast on the socket: {}", std::strerror(errno));
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+
+    // One packet and one destination per universe. The packets are reused for
+    // every frame, only the sequence number and the channels change.
+    std::vector<e131_packet_t> packets(universes.size());
+    std::vector<sockaddr_in> destinations(universes.size());
+    for (size_t i = 0; i < universes.size(); i++) {
+        e131_pkt_init(&packets[i], universes[i], static_cast<u16>(channels));
+        std::strncpy(reinterpret_cast<char *>(packets[i].frame.source_name), "creature-e131-loadgen",
+                     sizeof(packets[i].frame.source_name) - 1);
+
+        destinations[i].sin_family = AF_INET;
+        destinations[i].sin_port = htons(E131_DEFAULT_PORT);
+        destinations[i].sin_addr.s_addr = htonl(dmx::E131Client::multicastGroup(universes[i]));
+    }
+    const size_t packetLength = offsetof(e131_packet_t, dmp.prop_val) + static_cast<size_t>(channels) + 1;
+
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    logger->info("sending {} universe(s) at {} fps, {} channels, {} loss, {} reordered, bursts of {}", universes.size(),
+                 rate, channels, program.get<double>("--loss"), program.get<double>("--reorder"), burst);
+
+    std::vector<u8> sequences(universes.size(), 0);
+    std::vector<loadgen::PacketImpairer::Packet> toSend;
+    u64 sent = 0;
+    u64 sendErrors = 0;
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / rate));
+    const auto startedAt = std::chrono::steady_clock::now();
+    const double cpuAtStart = cpuSeconds();
+
+    u64 frameNumber = 0;
+    while (!stopRequested.load()) {
+
+        // Each frame is due a period after the last one. We go by when it's due,
+        // not when the last one went out, so a slow send doesn't slow us down.
+        const auto due = startedAt + period * static_cast<std::int64_t>(frameNumber);
+        if (duration > 0.0 && due - startedAt >= std::chrono::duration<double>(duration)) {
+            break;
+        }
+        if (frameNumber % static_cast<u64>(burst) == 0) {
+            std::this_thread::sleep_until(due + period * (burst - 1));
+        }
+
+        for (size_t i = 0; i < universes.size(); i++) {
+            impairer.pass({i, sequences[i]++, frameNumber}, toSend);
+
+            for (const auto &packet : toSend) {
+                auto &e131Packet = packets[packet.universeIndex];
+                e131Packet.frame.seq_number = packet.sequence;
+                channelPattern.fill(packet.frameNumber, packet.universeIndex,
+                                    std::span<u8>(e131Packet.dmp.prop_val, static_cast<size_t>(channels) + 1));
+
+                if (sendto(sockfd, &e131Packet, packetLength, 0,
+                           reinterpret_cast<const sockaddr *>(&destinations[packet.universeIndex]),
+                           sizeof(sockaddr_in)) < 0) {
+                    sendErrors++;
+                } else {
+                    sent++;
+                }
+            }
+        }
+        frameNumber++;
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startedAt).count();
+    const double cpuUsed = cpuSeconds() - cpuAtStart;
+    close(sockfd);
+
+    logger->info("sent {} packets in {:.3f}s ({:.1f} packets/s), {} send errors", sent, elapsed,
+                 static_cast<double>(sent) / std::max(elapsed, 0.001), sendErrors);
+    logger->info("dropped {} on purpose, sent {} out of order", impairer.getDropped(), impairer.getReordered());
+    logger->info("used {:.3f}s of CPU ({:.1f}% of one core)", cpuUsed, 100.0 * cpuUsed / std::max(elapsed, 0.001));
+
+    return sendErrors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
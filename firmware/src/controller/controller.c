@@ -268,16 +268,10 @@ u8 getMotorMapIndex(const char *motor_id) {
     return motor_number;
 }
 
-bool requestServoPosition(const char *motor_id, const u16 requestedMicroseconds) {
-    if (motor_id == NULL || motor_id[0] == '\0') {
-        warning("motor_id is null while requesting servo position");
-        return false;
-    }
-
-    // Get the index in the array
-    const u8 motor_id_index = getMotorMapIndex(motor_id);
-    if (motor_id_index == INVALID_MOTOR_ID) {
-        warning("Invalid motor ID: %s", motor_id);
+bool requestServoPositionByPin(const u8 pin, const u16 requestedMicroseconds) {
+    // Make sure the controller requested a valid motor
+    if (pin >= CONTROLLER_MOTORS_PER_MODULE) {
+        warning("Invalid motor pin: %u", pin);
         return false;
     }
 
@@ -286,17 +280,17 @@ bool requestServoPosition(const char *motor_id, const u16 requestedMicroseconds)
     // Take the mutex to ensure thread-safe access
     if (xSemaphoreTake(motor_map_mutex, portMAX_DELAY) == pdTRUE) {
         // Make sure the motor is allowed to move to this position
-        if (requestedMicroseconds < motor_map[motor_id_index].min_microseconds ||
-            requestedMicroseconds > motor_map[motor_id_index].max_microseconds) {
-            error("Invalid position requested for %s: %u (valid is: %u - %u)", motor_id, requestedMicroseconds,
-                  motor_map[motor_id_index].min_microseconds, motor_map[motor_id_index].max_microseconds);
+        if (requestedMicroseconds < motor_map[pin].min_microseconds ||
+            requestedMicroseconds > motor_map[pin].max_microseconds) {
+            error("Invalid position requested for pin %u: %u (valid is: %u - %u)", pin, requestedMicroseconds,
+                  motor_map[pin].min_microseconds, motor_map[pin].max_microseconds);
             xSemaphoreGive(motor_map_mutex);
             return false;
         }
 
         // Update the number of microseconds we're set to for the status lights
         // to use
-        motor_map[motor_id_index].current_microseconds = requestedMicroseconds;
+        motor_map[pin].current_microseconds = requestedMicroseconds;
 
         // What percentage of the frame is going to be set to on?
         const double frame_active = (float)requestedMicroseconds / (float)frame_length_microseconds;
@@ -304,14 +298,14 @@ bool requestServoPosition(const char *motor_id, const u16 requestedMicroseconds)
         // ...and what counter value is that?
         const u32 desired_ticks = (u32)((float)pwm_resolution * frame_active);
 
-        verbose("Requested position for %s: %u ticks -> %u microseconds", motor_id, desired_ticks,
+        verbose("Requested position for pin %u: %u ticks -> %u microseconds", pin, desired_ticks,
                 requestedMicroseconds);
-        motor_map[motor_id_index].requested_position = desired_ticks;
+        motor_map[pin].requested_position = desired_ticks;
 
         result = true;
         xSemaphoreGive(motor_map_mutex);
     } else {
-        warning("Failed to take motor_map_mutex in requestServoPosition");
+        warning("Failed to take motor_map_mutex in requestServoPositionByPin");
     }
 
     return result;
@@ -452,8 +446,13 @@ void firmware_configuration_received() {
     controller_firmware_state = running;
     controller_safe_to_run = true;
 
-    // Let the controller know we're ready
+    // Let the controller know we're ready. Over USB we can also take binary
+    // frames, but the UART reader on the older boards only knows text.
+#ifdef CC_VER2
     send_to_controller("READY\t1");
+#else
+    send_to_controller("READY\t1\tBIN");
+#endif
 }
 
 void first_frame_received(const bool yesOrNo) {
@@ -127,19 +127,24 @@ void controller_start();
  * The function validates that the requested position is within the
  * configured min/max limits for the servo before applying it.
  *
- * @param motor_id The motor ID string (e.g., "0", "1", etc.)
+ * Both the text and binary POS handlers land here. The text handler turns its
+ * motor ID into a pin with getMotorMapIndex() first; binary frames already
+ * carry the pin.
+ *
+ * @param pin The servo's pin (its index in the motor map, 0 to
+ * CONTROLLER_MOTORS_PER_MODULE - 1)
  * @param requestedMicroseconds The pulse width in microseconds (typically
  * 1000-2000)
  * @return true if the position was set successfully, false if there was an
  * error
  */
-bool requestServoPosition(const char *motor_id, u16 requestedMicroseconds);
+bool requestServoPositionByPin(u8 pin, u16 requestedMicroseconds);
 
 /**
  * @brief Configure the minimum and maximum position limits for a servo
  *
  * Sets the valid range of motion for a servo in microseconds. These limits
- * are used by requestServoPosition() to prevent commanding positions that
+ * are used by requestServoPositionByPin() to prevent commanding positions that
  * could damage the mechanical system.
  *
  * @param motor_id The motor ID string (e.g., "0", "1", etc.)
@@ -9,6 +9,7 @@
 
 #include "io/usb_serial.h"
 #include "logging/logging.h"
+#include "messaging/binary_framing.h"
 #include "usb/usb.h"
 
 #include "types.h"
@@ -74,6 +75,9 @@ void tud_cdc_rx_cb(uint8_t itf) {
     // (through its newline) is dropped instead of enqueued, so a truncated,
     // checksum-failing fragment never reaches the parser.
     static bool overflowed = false;
+    // Set while we're between the delimiters of a binary frame. Inside one,
+    // bells and newlines are just data; only a zero ends it.
+    static bool inBinaryFrame = false;
 
     // Drain the CDC RX FIFO in fixed-size chunks. This callback runs inside
     // tud_task() on the timer-daemon stack, so a FIFO-sized VLA here (the RX
@@ -101,6 +105,54 @@ void tud_cdc_rx_cb(uint8_t itf) {
             // Account for this character
             usb_serial_characters_received = usb_serial_characters_received + 1;
 
+            // A zero starts or ends a binary frame. Text lines never have one,
+            // so it's also a handy place to get back in sync.
+            if (ch == BINARY_FRAME_DELIMITER) {
+
+                // Back-to-back zeros (the end of one frame and the start of the
+                // next) or a fresh start - either way a new frame begins here
+                if (!inBinaryFrame || bufferIndex <= 1) {
+                    if (!inBinaryFrame && bufferIndex > 0) {
+                        warning("discarding partial text line interrupted by a binary frame");
+                    }
+                    lineBuffer[0] = (char)BINARY_FRAME_MARKER;
+                    bufferIndex = 1;
+                    overflowed = false;
+                    inBinaryFrame = true;
+                    continue;
+                }
+
+                inBinaryFrame = false;
+                if (overflowed) {
+                    warning("discarding over-length binary frame from sender");
+                    bufferIndex = 0;
+                    overflowed = false;
+                    continue;
+                }
+
+                // COBS made sure there are no zeros in the frame, so it can
+                // ride the same string queue as the text lines
+                lineBuffer[bufferIndex] = '\0';
+                if (xQueueSendToBack(usb_serial_incoming_commands, lineBuffer, 0) != pdTRUE)
+                    incoming_messages_dropped++;
+
+                bufferIndex = 0;
+                continue;
+            }
+
+            if (inBinaryFrame) {
+                if (overflowed) {
+                    continue;
+                } else if (bufferIndex < USB_SERIAL_INCOMING_MESSAGE_MAX_LENGTH - 1) {
+                    lineBuffer[bufferIndex++] = ch;
+                } else {
+                    overflowed = true;
+                    incoming_messages_dropped++;
+                    warning("buffer overflow on incoming binary frame; discarding it");
+                }
+                continue;
+            }
+
             // Is this our reset character?
             if (ch == 0x07) {
 
@@ -0,0 +1,105 @@
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "controller/config.h"
+#include "logging/logging.h"
+#include "messaging/binary_framing.h"
+
+#include "messaging/processors/position_message.h"
+
+#include "types.h"
+
+// These live in messaging.c so binary frames show up in the same stats as text
+extern volatile u64 successful_messages_parsed;
+extern volatile u64 failed_messages_parsed;
+extern volatile u64 checksum_errors;
+
+u16 calculateCrc16(const u8 *data, size_t length) {
+    u16 crc = 0xFFFF;
+
+    if (data != NULL) {
+        for (size_t i = 0; i < length; i++) {
+            crc ^= (u16)(data[i] << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? (u16)((crc << 1) ^ 0x1021) : (u16)(crc << 1);
+            }
+        }
+    }
+
+    return crc;
+}
+
+size_t decodeCobs(const u8 *input, size_t length, u8 *output) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        const u8 code = input[inIndex++];
+
+        // Zeros aren't allowed in a block, and a run can't go past the end
+        if (code == 0 || inIndex + code - 1 > length) {
+            return 0;
+        }
+
+        for (u8 i = 1; i < code; i++) {
+            if (input[inIndex] == 0) {
+                return 0;
+            }
+            output[outIndex++] = input[inIndex++];
+        }
+
+        // A short run means there was a zero here, unless it's the very end
+        if (code != 0xFF && inIndex < length) {
+            output[outIndex++] = 0;
+        }
+    }
+
+    return outIndex;
+}
+
+bool processBinaryFrame(const u8 *frame, size_t length) {
+
+    verbose("processing a %u byte binary frame", (unsigned int)length);
+
+    // COBS never makes anything bigger when decoding
+    u8 decoded[USB_SERIAL_INCOMING_MESSAGE_MAX_LENGTH];
+    if (frame == NULL || length > sizeof(decoded)) {
+        error("binary frame is too long to decode: %u bytes", (unsigned int)length);
+        failed_messages_parsed = failed_messages_parsed + 1;
+        return false;
+    }
+
+    const size_t decodedLength = decodeCobs(frame, length, decoded);
+    if (decodedLength < BINARY_FRAME_MIN_LENGTH) {
+        error("unable to decode binary frame (%u bytes in, %u out)", (unsigned int)length,
+              (unsigned int)decodedLength);
+        failed_messages_parsed = failed_messages_parsed + 1;
+        return false;
+    }
+    successful_messages_parsed = successful_messages_parsed + 1;
+
+    // The last two bytes are the CRC of everything before them
+    const size_t bodyLength = decodedLength - 2;
+    const u16 expectedCrc = (u16)(decoded[bodyLength] | (decoded[bodyLength + 1] << 8));
+    const u16 calculatedCrc = calculateCrc16(decoded, bodyLength);
+    if (expectedCrc != calculatedCrc) {
+        warning("binary frame CRC mismatch: 0x%04X != 0x%04X", expectedCrc, calculatedCrc);
+        checksum_errors = checksum_errors + 1;
+        return false;
+    }
+
+    switch (decoded[0]) {
+        case BINARY_FRAME_TYPE_POSITION:
+            if (handleBinaryPositionFrame(&decoded[1], bodyLength - 1)) {
+                verbose("binary POS frame handled!");
+                return true;
+            }
+            warning("binary POS frame handler failed!");
+            return false;
+
+        default:
+            warning("unknown binary frame type: 0x%02X", decoded[0]);
+            return false;
+    }
+}
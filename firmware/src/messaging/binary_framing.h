@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "types.h"
+
+/*
+ * Binary framing for the controller -> firmware link
+ *
+ * Newer controllers can send position frames as binary instead of text once
+ * we've told them we understand it (by adding "BIN" to our READY message). A
+ * binary frame on the wire looks like this:
+ *
+ *     0x00  COBS( type | body ... | crc16 (LE) )  0x00
+ *
+ * COBS means there are never any zeros inside a frame, so a zero always marks
+ * the start or end of one. The CRC is CRC-16/CCITT-FALSE over the type and
+ * body.
+ *
+ * The controller's encoder lives in `io/BinaryFraming.cpp` over in the
+ * controller. Keep the two in step!
+ */
+
+// Starts and ends every binary frame on the wire
+#define BINARY_FRAME_DELIMITER 0x00
+
+// The USB reader puts this in front of a binary frame before queueing it, so
+// processMessage() can tell it apart from a text line. Text lines never start
+// with a byte this high.
+#define BINARY_FRAME_MARKER 0x80
+
+// What's in the frame, the first byte after decoding
+#define BINARY_FRAME_TYPE_POSITION 0x01
+
+// The smallest decoded frame we'll look at: a type and a CRC
+#define BINARY_FRAME_MIN_LENGTH 3
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ *
+ * @param data the bytes to checksum
+ * @param length how many bytes there are
+ * @return the CRC
+ */
+u16 calculateCrc16(const u8 *data, size_t length);
+
+/**
+ * Decode a COBS block (without its delimiters)
+ *
+ * @param input the encoded bytes
+ * @param length how many encoded bytes there are
+ * @param output where to put the decoded bytes, must have room for `length`
+ * @return how many bytes were decoded, or 0 if it wasn't valid COBS
+ */
+size_t decodeCobs(const u8 *input, size_t length, u8 *output);
+
+/**
+ * Decode, check, and dispatch one binary frame
+ *
+ * @param frame the COBS block as it came off the wire, without delimiters
+ * @param length how long the block is
+ * @return true if the frame was good and its handler accepted it
+ */
+bool processBinaryFrame(const u8 *frame, size_t length);
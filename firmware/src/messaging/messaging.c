@@ -5,6 +5,7 @@
 
 
 #include "logging/logging.h"
+#include "messaging/binary_framing.h"
 #include "messaging/messaging.h"
 #include "util/string_utils.h"
 
@@ -115,6 +116,12 @@ bool parseMessage(const char *rawMessage, GenericMessage *outMessage) {
 
 void processMessage(const char *rawMessage) {
 
+    // Binary frames come to us with a marker in front, so hand those off
+    if ((u8)rawMessage[0] == BINARY_FRAME_MARKER) {
+        processBinaryFrame((const u8 *)&rawMessage[1], strlen(&rawMessage[1]));
+        return;
+    }
+
     verbose("processing message: %s", rawMessage);
 
     // Create a message object and null it out for safety
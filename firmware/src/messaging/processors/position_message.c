@@ -16,15 +16,59 @@ extern volatile u64 position_messages_processed;
 extern volatile bool controller_safe_to_run;
 extern volatile bool has_first_frame_been_received;
 
+/**
+ * The safety gate is checked once up front for every frame, text or binary;
+ * dropping for safety is not a malformed-message condition, so the frame is
+ * "handled" without dispatch.
+ *
+ * @return true if the frame should be dropped
+ */
+static bool droppedForSafety(void) {
+    if (!controller_safe_to_run) {
+        warning("dropping position message because we haven't been told it's safe");
+        position_messages_processed = position_messages_processed + 1;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Called once every position in a frame has been accepted
+ */
+static void positionFrameAccepted(void) {
+    // Was this the first frame we've received? Only signal once we know the
+    // whole frame was accepted.
+    if (!has_first_frame_been_received) {
+        first_frame_received(true);
+    }
+
+    position_messages_processed = position_messages_processed + 1;
+}
+
+/**
+ * Move a PWM servo from a text token. The motor ID is turned into a pin here,
+ * so the text and binary frames both end up in requestServoPositionByPin().
+ *
+ * @return true if the servo took the position
+ */
+static bool requestPwmPosition(const int token, const char *motor_id, const char *value) {
+    const u8 pin = getMotorMapIndex(motor_id);
+    if (pin == INVALID_MOTOR_ID) {
+        warning("rejecting POS frame: token %d has an invalid motor ID (%s)", token, motor_id);
+        return false;
+    }
+    if (!requestServoPositionByPin(pin, stringToU16(value))) {
+        warning("rejecting POS frame: requestServoPositionByPin(%u, %s) failed", pin, value);
+        return false;
+    }
+    return true;
+}
+
 bool handlePositionMessage(const GenericMessage *msg) {
 
     verbose("handling position message");
 
-    // The safety gate is checked once up front; dropping for safety is not a
-    // malformed-message condition, so the frame is "handled" without dispatch.
-    if (!controller_safe_to_run) {
-        warning("dropping position message because we haven't been told it's safe");
-        position_messages_processed = position_messages_processed + 1;
+    if (droppedForSafety()) {
         return true;
     }
 
@@ -75,26 +119,96 @@ bool handlePositionMessage(const GenericMessage *msg) {
             }
         } else {
             // PWM: <pin> <microseconds>
-            if (!requestServoPosition(position, stringToU16(value))) {
-                warning("rejecting POS frame: requestServoPosition(%s, %s) failed", position, value);
+            if (!requestPwmPosition(i, position, value)) {
                 return false;
             }
         }
 #else
-        if (!requestServoPosition(position, stringToU16(value))) {
-            warning("rejecting POS frame: requestServoPosition(%s, %s) failed", position, value);
+        if (!requestPwmPosition(i, position, value)) {
             return false;
         }
 #endif
     }
 
-    // Was this the first frame we've received? Only signal once we know the
-    // whole frame was accepted.
-    if (!has_first_frame_been_received) {
-        first_frame_received(true);
+    positionFrameAccepted();
+
+    return true;
+}
+
+bool handleBinaryPositionFrame(const u8 *body, const size_t length) {
+
+    verbose("handling binary position frame");
+
+    if (droppedForSafety()) {
+        return true;
     }
 
-    position_messages_processed = position_messages_processed + 1;
+    size_t index = 0;
+
+    // PWM servos first: a count, then (pin, microseconds) for each
+    if (index >= length) {
+        warning("rejecting binary POS frame: no PWM count");
+        return false;
+    }
+    const u8 pwmCount = body[index++];
+    if (index + (size_t)pwmCount * 3 > length) {
+        warning("rejecting binary POS frame: %u PWM servos don't fit in %u bytes", pwmCount, (unsigned int)length);
+        return false;
+    }
+
+    for (u8 i = 0; i < pwmCount; i++) {
+        const u8 pin = body[index];
+        const u16 microseconds = (u16)(body[index + 1] | (body[index + 2] << 8));
+        index += 3;
+
+        verbose("incoming binary position: %u %u", pin, microseconds);
+        if (!requestServoPositionByPin(pin, microseconds)) {
+            warning("rejecting binary POS frame: requestServoPositionByPin(%u, %u) failed", pin, microseconds);
+            return false;
+        }
+    }
+
+    // ...and then the Dynamixels, the same way
+    if (index >= length) {
+        warning("rejecting binary POS frame: no Dynamixel count");
+        return false;
+    }
+    const u8 dxlCount = body[index++];
+    if (index + (size_t)dxlCount * 3 != length) {
+        warning("rejecting binary POS frame: %u Dynamixels don't match the %u bytes left", dxlCount,
+                (unsigned int)(length - index));
+        return false;
+    }
+
+#ifdef CC_VER4
+    for (u8 i = 0; i < dxlCount; i++) {
+        const u8 dxl_id = body[index];
+        const u32 dxl_pos = (u32)(body[index + 1] | (body[index + 2] << 8));
+        index += 3;
+
+        if (dxl_id == 0 || dxl_id > DXL_MAX_ID) {
+            warning("rejecting binary POS frame: Dynamixel ID %u out of range [1-%u]", dxl_id, DXL_MAX_ID);
+            return false;
+        }
+        if (dxl_pos > DXL_POSITION_MAX) {
+            warning("rejecting binary POS frame: Dynamixel %u position %lu out of range [0-%u]", dxl_id,
+                    (unsigned long)dxl_pos, DXL_POSITION_MAX);
+            return false;
+        }
+        if (!requestDynamixelPosition(dxl_id, dxl_pos)) {
+            warning("rejecting binary POS frame: requestDynamixelPosition(%u, %lu) failed", dxl_id,
+                    (unsigned long)dxl_pos);
+            return false;
+        }
+    }
+#else
+    if (dxlCount > 0) {
+        warning("rejecting binary POS frame: %u Dynamixels requested but this board has no Dynamixel bus", dxlCount);
+        return false;
+    }
+#endif
+
+    positionFrameAccepted();
 
     return true;
 }
@@ -1,8 +1,23 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #include "logging/logging.h"
 #include "messaging/messaging.h"
 
 
 bool handlePositionMessage(const GenericMessage *msg);
+
+/**
+ * Handle the body of a binary position frame (see binary_framing.h)
+ *
+ * The body is everything after the type byte and before the CRC:
+ *
+ *     pwmCount | (pin, us LE16) * pwmCount | dxlCount | (id, position LE16) * dxlCount
+ *
+ * @param body the decoded body
+ * @param length how long the body is
+ * @return true if every position in the frame was accepted
+ */
+bool handleBinaryPositionFrame(const u8 *body, size_t length);
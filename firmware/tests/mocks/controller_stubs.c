@@ -52,16 +52,17 @@ void controller_stubs_set_configure_dxl_return(bool value) {
     controller_stub_state.last_configure_dxl.return_value = value;
 }
 
-bool requestServoPosition(const char *motor_id, u16 requestedMicroseconds) {
-    controller_stub_state.last_request_servo.call_count++;
-    if (motor_id != NULL) {
-        strncpy(controller_stub_state.last_request_servo.motor_id, motor_id,
-                sizeof(controller_stub_state.last_request_servo.motor_id) - 1);
-        controller_stub_state.last_request_servo
-                .motor_id[sizeof(controller_stub_state.last_request_servo.motor_id) - 1] = '\0';
-    } else {
-        controller_stub_state.last_request_servo.motor_id[0] = '\0';
+u8 getMotorMapIndex(const char *motor_id) {
+    /* Same rules as the real one: a single digit, 0 up to the motor count. */
+    if (motor_id == NULL || motor_id[0] < '0' || motor_id[0] >= '0' + CONTROLLER_MOTORS_PER_MODULE) {
+        return INVALID_MOTOR_ID;
     }
+    return (u8)(motor_id[0] - '0');
+}
+
+bool requestServoPositionByPin(u8 pin, u16 requestedMicroseconds) {
+    controller_stub_state.last_request_servo.call_count++;
+    controller_stub_state.last_request_servo.pin = pin;
     controller_stub_state.last_request_servo.microseconds = requestedMicroseconds;
     return controller_stub_state.last_request_servo.return_value;
 }
@@ -12,7 +12,7 @@
 
 typedef struct {
     u32 call_count;
-    char motor_id[16];
+    u8 pin;
     u16 microseconds;
     bool return_value;
 } request_servo_call_t;
@@ -5,6 +5,7 @@
 
 #include "messaging/messaging.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 
 // Mock implementations of the message handler functions
@@ -61,4 +62,13 @@ bool handleEmergencyStopMessage(const GenericMessage *msg) {
     }
 
     return true;
-}
\ No newline at end of file
+}
+bool handleBinaryPositionFrame(const u8 *body, size_t length) {
+    if (body == NULL) {
+        printf("WARNING: handleBinaryPositionFrame called with NULL body\n");
+        return false;
+    }
+
+    (void)length;
+    return true;
+}
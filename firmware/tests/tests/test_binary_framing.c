@@ -0,0 +1,154 @@
+/**
+ * @file test_binary_framing.c
+ * @brief Tests for the binary frame decoder in binary_framing.c
+ */
+
+#include "unity.h"
+#include "freertos_mocks.h"
+#include "hardware_mocks.h"
+#include "logging_mocks.h"
+#include "messaging/binary_framing.h"
+#include "messaging/messaging.h"
+#include "types.h"
+#include <string.h>
+
+#include "stubs.h"
+
+// These live in messaging.c
+extern volatile u64 failed_messages_parsed;
+extern volatile u64 checksum_errors;
+
+static u8 decoded[64];
+
+// A COBS-encoded POS frame with one PWM servo (pin 2, 1234us) and one
+// Dynamixel (ID 3, position 2048), made by the controller's encoder
+static const u8 position_frame_body[] = {0x01, 0x01, 0x02, 0xD2, 0x04, 0x01, 0x03, 0x00, 0x08};
+
+/**
+ * Build a COBS frame by hand: body + CRC, then stuffed
+ */
+static size_t build_frame(const u8 *body, size_t length, u8 *out) {
+    u8 raw[64];
+    memcpy(raw, body, length);
+    const u16 crc = calculateCrc16(body, length);
+    raw[length] = (u8)(crc & 0xFF);
+    raw[length + 1] = (u8)(crc >> 8);
+    length += 2;
+
+    // Simple COBS encoder, fine for frames under 254 bytes
+    size_t code_index = 0;
+    size_t out_index = 1;
+    u8 code = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (raw[i] == 0) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        } else {
+            out[out_index++] = raw[i];
+            code++;
+        }
+    }
+    out[code_index] = code;
+    return out_index;
+}
+
+void setUp(void) {
+    reset_log_mocks();
+    memset(decoded, 0, sizeof(decoded));
+    failed_messages_parsed = 0;
+    checksum_errors = 0;
+}
+
+void tearDown(void) {}
+
+void test_crc16_known_answer(void) {
+    // The standard check value for CRC-16/CCITT-FALSE
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, calculateCrc16((const u8 *)"123456789", 9));
+}
+
+void test_crc16_null_input(void) {
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, calculateCrc16(NULL, 10));
+}
+
+void test_decodeCobs_known_vectors(void) {
+    const u8 one_zero[] = {0x01, 0x01};
+    TEST_ASSERT_EQUAL_UINT32(1, decodeCobs(one_zero, sizeof(one_zero), decoded));
+    TEST_ASSERT_EQUAL_UINT8(0x00, decoded[0]);
+
+    const u8 mixed[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    const u8 expected[] = {0x11, 0x22, 0x00, 0x33};
+    TEST_ASSERT_EQUAL_UINT32(sizeof(expected), decodeCobs(mixed, sizeof(mixed), decoded));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, decoded, sizeof(expected));
+}
+
+void test_decodeCobs_rejects_garbage(void) {
+    const u8 embedded_zero[] = {0x02, 0x00};
+    TEST_ASSERT_EQUAL_UINT32(0, decodeCobs(embedded_zero, sizeof(embedded_zero), decoded));
+
+    const u8 overrun[] = {0x05, 0x11, 0x22};
+    TEST_ASSERT_EQUAL_UINT32(0, decodeCobs(overrun, sizeof(overrun), decoded));
+}
+
+void test_processBinaryFrame_accepts_good_frame(void) {
+    u8 frame[64];
+    const size_t length = build_frame(position_frame_body, sizeof(position_frame_body), frame);
+
+    TEST_ASSERT_TRUE(processBinaryFrame(frame, length));
+    TEST_ASSERT_EQUAL_UINT64(0, checksum_errors);
+    TEST_ASSERT_EQUAL_UINT64(0, failed_messages_parsed);
+}
+
+void test_processBinaryFrame_rejects_bad_crc(void) {
+    u8 frame[64];
+    const size_t length = build_frame(position_frame_body, sizeof(position_frame_body), frame);
+
+    // Flip a bit in the microseconds
+    frame[4] ^= 0x01;
+
+    TEST_ASSERT_FALSE(processBinaryFrame(frame, length));
+    TEST_ASSERT_EQUAL_UINT64(1, checksum_errors);
+}
+
+void test_processBinaryFrame_rejects_unknown_type(void) {
+    const u8 body[] = {0x7F, 0x01};
+    u8 frame[64];
+    const size_t length = build_frame(body, sizeof(body), frame);
+
+    TEST_ASSERT_FALSE(processBinaryFrame(frame, length));
+    TEST_ASSERT_EQUAL_UINT64(0, checksum_errors);
+}
+
+void test_processBinaryFrame_rejects_runt(void) {
+    const u8 frame[] = {0x02, 0x01};
+
+    TEST_ASSERT_FALSE(processBinaryFrame(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT64(1, failed_messages_parsed);
+}
+
+void test_processMessage_dispatches_marked_frames(void) {
+    // This is what the USB reader puts on the queue: the marker, then the frame
+    char message[64] = {0};
+    message[0] = (char)BINARY_FRAME_MARKER;
+    build_frame(position_frame_body, sizeof(position_frame_body), (u8 *)&message[1]);
+
+    processMessage(message);
+    TEST_ASSERT_EQUAL_UINT64(0, checksum_errors);
+    TEST_ASSERT_EQUAL_UINT64(0, failed_messages_parsed);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc16_known_answer);
+    RUN_TEST(test_crc16_null_input);
+    RUN_TEST(test_decodeCobs_known_vectors);
+    RUN_TEST(test_decodeCobs_rejects_garbage);
+    RUN_TEST(test_processBinaryFrame_accepts_good_frame);
+    RUN_TEST(test_processBinaryFrame_rejects_bad_crc);
+    RUN_TEST(test_processBinaryFrame_rejects_unknown_type);
+    RUN_TEST(test_processBinaryFrame_rejects_runt);
+    RUN_TEST(test_processMessage_dispatches_marked_frames);
+
+    return UNITY_END();
+}
@@ -46,20 +46,20 @@ void tearDown(void) {}
 /* ---------------------------------------------------------------- POS happy paths */
 
 void test_position_pwm_only_dispatches_each_token(void) {
-    const char *tokens[] = {"B0 1500", "B1 1750"};
+    const char *tokens[] = {"0 1500", "1 1750"};
     set_tokens("POS", tokens, 2);
 
     TEST_ASSERT_TRUE(handlePositionMessage(&msg));
     TEST_ASSERT_EQUAL_UINT32(2, controller_stub_state.last_request_servo.call_count);
     /* Last call wins in the snapshot. */
-    TEST_ASSERT_EQUAL_STRING("B1", controller_stub_state.last_request_servo.motor_id);
+    TEST_ASSERT_EQUAL_UINT8(1, controller_stub_state.last_request_servo.pin);
     TEST_ASSERT_EQUAL_UINT16(1750, controller_stub_state.last_request_servo.microseconds);
     TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.last_request_dxl.call_count);
     TEST_ASSERT_EQUAL_UINT32(1, controller_stub_state.first_frame_received_count);
 }
 
 void test_position_mixed_pwm_and_dxl_dispatches_both(void) {
-    const char *tokens[] = {"B0 1500", "D1 2048", "D2 1024"};
+    const char *tokens[] = {"0 1500", "D1 2048", "D2 1024"};
     set_tokens("POS", tokens, 3);
 
     TEST_ASSERT_TRUE(handlePositionMessage(&msg));
@@ -80,7 +80,7 @@ void test_position_dxl_max_id_and_max_position_accepted(void) {
 }
 
 void test_position_safety_gate_drops_silently(void) {
-    const char *tokens[] = {"B0 1500"};
+    const char *tokens[] = {"0 1500"};
     set_tokens("POS", tokens, 1);
     controller_safe_to_run = false;
 
@@ -89,10 +89,77 @@ void test_position_safety_gate_drops_silently(void) {
     TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.first_frame_received_count);
 }
 
+/* ---------------------------------------------------------------- binary POS */
+
+void test_binary_position_mixed_pwm_and_dxl_dispatches_both(void) {
+    /* Two PWM (pins 0 and 1) then one Dynamixel (ID 2 at 1024) */
+    const u8 body[] = {2, 0, 0xDC, 0x05, 1, 0xD6, 0x06, 1, 2, 0x00, 0x04};
+
+    TEST_ASSERT_TRUE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(2, controller_stub_state.last_request_servo.call_count);
+    TEST_ASSERT_EQUAL_UINT8(1, controller_stub_state.last_request_servo.pin);
+    TEST_ASSERT_EQUAL_UINT16(1750, controller_stub_state.last_request_servo.microseconds);
+    TEST_ASSERT_EQUAL_UINT32(1, controller_stub_state.last_request_dxl.call_count);
+    TEST_ASSERT_EQUAL_UINT8(2, controller_stub_state.last_request_dxl.dxl_id);
+    TEST_ASSERT_EQUAL_UINT32(1024, controller_stub_state.last_request_dxl.position);
+    TEST_ASSERT_EQUAL_UINT32(1, controller_stub_state.first_frame_received_count);
+}
+
+void test_binary_position_passes_the_pin_straight_through(void) {
+    /* Any pin the wire format can carry goes to the controller as a number;
+       it's the controller's job to know which ones it has. */
+    const u8 body[] = {1, 12, 0xDC, 0x05, 0};
+
+    TEST_ASSERT_TRUE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(1, controller_stub_state.last_request_servo.call_count);
+    TEST_ASSERT_EQUAL_UINT8(12, controller_stub_state.last_request_servo.pin);
+    TEST_ASSERT_EQUAL_UINT16(1500, controller_stub_state.last_request_servo.microseconds);
+}
+
+void test_binary_position_safety_gate_drops_silently(void) {
+    const u8 body[] = {1, 0, 0xDC, 0x05, 0};
+    controller_safe_to_run = false;
+
+    TEST_ASSERT_TRUE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.last_request_servo.call_count);
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.first_frame_received_count);
+}
+
+void test_binary_position_rejects_short_frame(void) {
+    /* Says there are two PWM servos but only has room for one */
+    const u8 body[] = {2, 0, 0xDC, 0x05, 0};
+
+    TEST_ASSERT_FALSE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.first_frame_received_count);
+}
+
+void test_binary_position_rejects_trailing_bytes(void) {
+    const u8 body[] = {1, 0, 0xDC, 0x05, 0, 0xFF};
+
+    TEST_ASSERT_FALSE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.first_frame_received_count);
+}
+
+void test_binary_position_rejects_dxl_id_zero(void) {
+    const u8 body[] = {0, 1, 0, 0x00, 0x04};
+
+    TEST_ASSERT_FALSE(handleBinaryPositionFrame(body, sizeof(body)));
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.last_request_dxl.call_count);
+}
+
 /* ---------------------------------------------------------------- POS rejections */
 
 void test_position_rejects_empty_value(void) {
-    const char *tokens[] = {"B0"};
+    const char *tokens[] = {"0"};
+    set_tokens("POS", tokens, 1);
+
+    TEST_ASSERT_FALSE(handlePositionMessage(&msg));
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.last_request_servo.call_count);
+    TEST_ASSERT_EQUAL_UINT32(0, controller_stub_state.first_frame_received_count);
+}
+
+void test_position_rejects_invalid_motor_id(void) {
+    const char *tokens[] = {"X 1500"};
     set_tokens("POS", tokens, 1);
 
     TEST_ASSERT_FALSE(handlePositionMessage(&msg));
@@ -136,7 +203,7 @@ void test_position_bad_token_aborts_whole_frame(void) {
     /* First token is fine; second is bad. The valid first dispatch happens
        before we discover the bad token, but the handler must still return
        false and must NOT count the frame as processed. */
-    const char *tokens[] = {"B0 1500", "D0 2048"};
+    const char *tokens[] = {"0 1500", "D0 2048"};
     set_tokens("POS", tokens, 2);
     const u64 before = position_messages_processed;
 
@@ -148,7 +215,7 @@ void test_position_bad_token_aborts_whole_frame(void) {
 }
 
 void test_position_request_servo_failure_aborts_frame(void) {
-    const char *tokens[] = {"B0 1500", "B1 1750"};
+    const char *tokens[] = {"0 1500", "1 1750"};
     set_tokens("POS", tokens, 2);
     controller_stubs_set_request_servo_return(false);
 
@@ -235,7 +302,14 @@ int main(void) {
     RUN_TEST(test_position_mixed_pwm_and_dxl_dispatches_both);
     RUN_TEST(test_position_dxl_max_id_and_max_position_accepted);
     RUN_TEST(test_position_safety_gate_drops_silently);
+    RUN_TEST(test_binary_position_mixed_pwm_and_dxl_dispatches_both);
+    RUN_TEST(test_binary_position_passes_the_pin_straight_through);
+    RUN_TEST(test_binary_position_safety_gate_drops_silently);
+    RUN_TEST(test_binary_position_rejects_short_frame);
+    RUN_TEST(test_binary_position_rejects_trailing_bytes);
+    RUN_TEST(test_binary_position_rejects_dxl_id_zero);
     RUN_TEST(test_position_rejects_empty_value);
+    RUN_TEST(test_position_rejects_invalid_motor_id);
     RUN_TEST(test_position_rejects_d_with_no_id);
     RUN_TEST(test_position_rejects_dxl_id_zero);
     RUN_TEST(test_position_rejects_dxl_id_above_max);